@@ -132,6 +132,16 @@
         #define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
     #endif
 
+    /* The 90/270 degree rotations of `lv_draw_sw_rotate()` walk the image in square tiles of this size [px].
+     * 32 x 32 ARGB8888 pixels are 4 kB, i.e. a source and a destination tile fit in the L1 cache. */
+    #define LV_DRAW_SW_ROTATE_TILE_SIZE 32
+
+    /* 1: Keep I1/I2/I4/I8 images indexed in the image cache and convert them with their palette while drawing.
+     * 0: Convert them to ARGB8888 when they are decoded (up to 32x more memory)
+     * The other draw units which use the decoded images need to support indexed images too
+     * (not supported by Dave2D). */
+    #define LV_DRAW_SW_KEEP_INDEXED     0
+
     #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_NONE
 
     #if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_CUSTOM
@@ -291,6 +301,48 @@
  *The main logic is like `LV_CACHE_DEF_SIZE` but for image headers.*/
 #define LV_IMAGE_HEADER_CACHE_DEF_CNT 0
 
+/*1: Use a scan resistant (segmented LRU) cache for the images and image headers.
+ *Images used only once (e.g. while scrolling a long list) won't push out the images used again and again.*/
+#define LV_IMAGE_CACHE_SCAN_RESISTANT 0
+
+/*Split the image and image header caches to this many independently locked shards by the hash of the image source.
+ *Useful with multiple draw units (e.g. `LV_DRAW_SW_DRAW_UNIT_CNT > 1`) as they won't wait for each other on cache hits.
+ *Each shard has 1/LV_IMAGE_CACHE_SHARD_CNT of the cache size so a single image can't be larger than that.*/
+#define LV_IMAGE_CACHE_SHARD_CNT 1
+
+/*Size of a second image cache tier in bytes. The images evicted from the image cache are kept here compressed
+ *and are decompressed on the next use which is much faster than decoding a PNG or JPG again.
+ *Uses LZ4 if `LV_USE_LZ4_INTERNAL` or `LV_USE_LZ4_EXTERNAL` is enabled, else RLE (`LV_USE_RLE`).
+ *0: disable the compressed tier*/
+#define LV_IMAGE_CACHE_COMPRESSED_SIZE 0
+
+/*1: Decode the images which are not in the cache on worker threads and draw a placeholder meanwhile.
+ *Needs an OS and `LV_CACHE_DEF_SIZE > 0`. Enable it at run time with `lv_image_decoder_async_set_enabled(true)`*/
+#define LV_USE_IMAGE_DECODER_ASYNC 0
+#if LV_USE_IMAGE_DECODER_ASYNC
+    /*Number of worker threads*/
+    #define LV_IMAGE_DECODER_ASYNC_WORKER_CNT 1
+
+    /*Max number of images waiting for decoding. If the queue is full, the images are decoded while drawing*/
+    #define LV_IMAGE_DECODER_ASYNC_QUEUE_DEPTH 8
+
+    /*Color of the placeholder drawn while the image is being decoded*/
+    #define LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_COLOR 0xC0C0C0
+#endif
+
+/*Decode the images larger than this many bytes in bands of rows instead of decoding them at once.
+ *Used by the decoders which support it (`LV_USE_LIBPNG` and `LV_USE_LIBJPEG_TURBO`).
+ *The images which don't fit into the image cache are always decoded in bands. 0: use only the cache size*/
+#define LV_IMAGE_DECODER_STREAM_THRESHOLD 0
+
+/*Number of rows decoded at once when an image is decoded in bands*/
+#define LV_IMAGE_DECODER_STREAM_BAND_HEIGHT 16
+
+/*1: Cache 1/2, 1/4 or 1/8 sized versions (mipmaps) of the images drawn at less than half of their size
+ *and draw them instead of the original images. It's faster and has less aliasing.
+ *Needs `LV_CACHE_DEF_SIZE > 0`. Enable it at run time with `lv_image_cache_set_mipmap_enabled(true)`*/
+#define LV_USE_IMAGE_MIPMAP 0
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #define LV_GRADIENT_MAX_STOPS   2
@@ -432,6 +484,15 @@
 /*Enable drawing placeholders when glyph dsc is not found*/
 #define LV_USE_FONT_PLACEHOLDER 1
 
+/*Size of the cache in bytes to store the decoded glyph bitmaps of the built-in and binary fonts (0: to disable)
+ *Useful mainly with compressed fonts as this way the glyphs don't need to be decompressed on every redraw.
+ *Therefore a small cache is used by default if compressed fonts are enabled.*/
+#define LV_FONT_GLYPH_CACHE_SIZE (LV_USE_FONT_COMPRESSED ? (8 * 1024) : 0)
+
+/*Enable packing the glyphs of selected fonts into a single A8 texture (see `lv_font_glyph_atlas_create()`)
+ *so that the glyphs of a label can be drawn in batches from it*/
+#define LV_USE_FONT_GLYPH_ATLAS 0
+
 /*=================
  *  TEXT SETTINGS
  *=================*/
@@ -525,6 +586,7 @@
 #if LV_USE_LABEL
     #define LV_LABEL_TEXT_SELECTION 1 /*Enable selecting text of the label*/
     #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
+    #define LV_LABEL_LINE_INDEX 0     /*Store the start of each line (8 bytes/line) to draw and edit very long wrapped texts faster*/
     #define LV_LABEL_WAIT_CHAR_COUNT 3  /*The count of wait chart*/
 #endif
 
@@ -623,6 +685,7 @@
     #define LV_FS_POSIX_LETTER '\0'     /*Set an upper cased letter on which the drive will accessible (e.g. 'A')*/
     #define LV_FS_POSIX_PATH ""         /*Set the working directory. File/directory paths will be appended to it.*/
     #define LV_FS_POSIX_CACHE_SIZE 0    /*>0 to cache this number of bytes in lv_fs_read()*/
+    #define LV_FS_POSIX_MMAP 0          /*1: Support lv_fs_map() with mmap() to use e.g. .bin images without copying them to RAM*/
 #endif
 
 /*API for CreateFile, ReadFile, etc*/
@@ -703,6 +766,9 @@
     #define LV_FREETYPE_CACHE_FT_FACES 8
     #define LV_FREETYPE_CACHE_FT_SIZES 8
     #define LV_FREETYPE_CACHE_FT_GLYPH_CNT 256
+
+    /* Stack size of the thread pre-rendering the glyphs if LV_USE_OS is enabled [bytes] */
+    #define LV_FREETYPE_PRERENDER_STACK_SIZE (8 * 1024)
 #endif
 
 /* Built-in TTF decoder */
@@ -710,6 +776,12 @@
 #if LV_USE_TINY_TTF
     /* Enable loading TTF data from files */
     #define LV_TINY_TTF_FILE_SUPPORT 0
+    /* Size of the cache of the rendered glyphs shared by all Tiny TTF fonts and font sizes [bytes] */
+    #define LV_TINY_TTF_CACHE_SIZE (64 * 1024)
+    /* Number of letters whose metrics are remembered by each font (28 bytes each). Power of 2 or 0 to disable */
+    #define LV_TINY_TTF_GLYPH_MEMO_CNT 128
+    /* Number of letter pairs whose kerning is remembered by each font (8 bytes each). Power of 2 or 0 to disable */
+    #define LV_TINY_TTF_KERN_MEMO_CNT 256
 #endif
 
 /*Rlottie library*/
@@ -32,9 +32,8 @@ extern "C" {
 #include "../others/sysmon/lv_sysmon.h"
 #include "../stdlib/builtin/lv_tlsf.h"
 
-#if LV_USE_FONT_COMPRESSED
 #include "../font/lv_font_fmt_txt.h"
-#endif
+#include "../font/lv_font_glyph_atlas.h"
 
 #include "../tick/lv_tick.h"
 #include "../layouts/lv_layout.h"
@@ -107,10 +106,18 @@ typedef struct _lv_global_t {
     lv_cache_t * img_cache;
 #endif
 
+#if LV_USE_IMAGE_MIPMAP
+    bool img_mipmap_enabled;
+#endif
+
 #if LV_IMAGE_HEADER_CACHE_DEF_CNT > 0
     lv_cache_t * img_header_cache;
 #endif
 
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+    lv_cache_t * img_cache_compressed;
+#endif
+
     lv_draw_global_info_t draw_info;
 #if defined(LV_DRAW_SW_SHADOW_CACHE_SIZE) && LV_DRAW_SW_SHADOW_CACHE_SIZE > 0
     lv_draw_sw_shadow_cache_t sw_shadow_cache;
@@ -171,8 +178,20 @@ typedef struct _lv_global_t {
     lv_cache_t * tiny_ttf_cache;
 #endif
 
-#if LV_USE_FONT_COMPRESSED
-    lv_font_fmt_rle_t font_fmt_rle;
+    lv_font_fmt_txt_glyph_id_table_t * font_fmt_txt_glyph_id_tables;
+    lv_mutex_t font_fmt_txt_glyph_id_table_lock;
+
+#if LV_FONT_GLYPH_CACHE_SIZE > 0
+    lv_cache_t * font_glyph_cache;
+#endif
+
+#if LV_USE_FONT_GLYPH_ATLAS
+    lv_font_glyph_atlas_t * font_glyph_atlases;
+    lv_mutex_t font_glyph_atlases_lock;
+#endif
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+    struct _lv_image_decoder_async_t * img_decoder_async;
 #endif
 
 #if LV_USE_SPAN != 0
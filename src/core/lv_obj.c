@@ -706,6 +706,9 @@ static void lv_obj_event(const lv_obj_class_t * class_p, lv_event_t * e)
         int32_t d = lv_obj_calculate_ext_draw_size(obj, LV_PART_MAIN);
         lv_event_set_ext_draw_size(e, d);
     }
+    else if(code == LV_EVENT_GET_IMAGE_SRCS) {
+        lv_event_add_image_src(e, lv_obj_get_style_bg_image_src(obj, LV_PART_MAIN));
+    }
     else if(code == LV_EVENT_DRAW_MAIN || code == LV_EVENT_DRAW_POST || code == LV_EVENT_COVER_CHECK) {
         lv_obj_draw(e);
     }
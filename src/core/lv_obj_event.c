@@ -275,6 +275,31 @@ lv_point_t * lv_event_get_self_size_info(lv_event_t * e)
     }
 }
 
+void lv_event_add_image_src(lv_event_t * e, const void * src)
+{
+    if(e->code != LV_EVENT_GET_IMAGE_SRCS) {
+        LV_LOG_WARN("Not interpreted with this event code");
+        return;
+    }
+
+    if(src == NULL) return;
+
+    lv_image_src_t src_type = lv_image_src_get_type(src);
+    if(src_type != LV_IMAGE_SRC_FILE && src_type != LV_IMAGE_SRC_VARIABLE) return;
+
+    /*Add each source only once, so the images used by several objects are counted only once*/
+    lv_array_t * srcs = lv_event_get_param(e);
+    uint32_t i;
+    for(i = 0; i < lv_array_size(srcs); i++) {
+        const void * added = *(const void **)lv_array_at(srcs, i);
+        if(added == src) return;
+        if(src_type == LV_IMAGE_SRC_FILE && lv_image_src_get_type(added) == LV_IMAGE_SRC_FILE &&
+           lv_strcmp(added, src) == 0) return;
+    }
+
+    lv_array_push_back(srcs, &src);
+}
+
 lv_hit_test_info_t * lv_event_get_hit_test_info(lv_event_t * e)
 {
     if(e->code == LV_EVENT_HIT_TEST) {
@@ -394,6 +419,7 @@ static bool event_is_bubbled(lv_event_t * e)
         case LV_EVENT_SIZE_CHANGED:
         case LV_EVENT_STYLE_CHANGED:
         case LV_EVENT_GET_SELF_SIZE:
+        case LV_EVENT_GET_IMAGE_SRCS:
             return false;
         default:
             return true;
@@ -173,6 +173,14 @@ void lv_event_set_ext_draw_size(lv_event_t * e, int32_t size);
  */
 lv_point_t * lv_event_get_self_size_info(lv_event_t * e);
 
+/**
+ * Add an image source used by a widget. Can be used in `LV_EVENT_GET_IMAGE_SRCS`.
+ * `NULL`, symbol sources and sources which were already added are ignored.
+ * @param e     pointer to an event
+ * @param src   an image source (path to a file or pointer to an `lv_image_dsc_t`)
+ */
+void lv_event_add_image_src(lv_event_t * e, const void * src);
+
 /**
  * Get a pointer to an `lv_hit_test_info_t` variable in which the hit test result should be saved. Can be used in `LV_EVENT_HIT_TEST`
  * @param e     pointer to an event
@@ -16,6 +16,7 @@
 #include "../misc/lv_anim.h"
 #include "../misc/lv_async.h"
 #include "../core/lv_global.h"
+#include "../misc/lv_array.h"
 
 /*********************
  *      DEFINES
@@ -37,6 +38,7 @@ static void obj_delete_core(lv_obj_t * obj);
 static lv_obj_tree_walk_res_t walk_core(lv_obj_t * obj, lv_obj_tree_walk_cb_t cb, void * user_data);
 static lv_obj_tree_walk_res_t dump_tree_core(lv_obj_t * obj, int32_t depth);
 static lv_obj_t * lv_obj_get_first_not_deleting_child(lv_obj_t * obj);
+static lv_obj_tree_walk_res_t prefetch_images_cb(lv_obj_t * obj, void * user_data);
 
 /**********************
  *  STATIC VARIABLES
@@ -456,6 +458,23 @@ void lv_obj_tree_walk(lv_obj_t * start_obj, lv_obj_tree_walk_cb_t cb, void * use
     walk_core(start_obj, cb, user_data);
 }
 
+uint32_t lv_obj_tree_prefetch_images(lv_obj_t * start_obj, lv_image_cache_prefetch_prio_t prio)
+{
+    LV_ASSERT_OBJ(start_obj, MY_CLASS);
+
+    lv_array_t srcs;
+    lv_array_init(&srcs, 8, sizeof(const void *));
+    lv_obj_tree_walk(start_obj, prefetch_images_cb, &srcs);
+
+    uint32_t cnt = 0;
+    if(!lv_array_is_empty(&srcs)) {
+        cnt = lv_image_cache_prefetch(lv_array_front(&srcs), lv_array_size(&srcs), prio);
+    }
+
+    lv_array_deinit(&srcs);
+    return cnt;
+}
+
 void lv_obj_dump_tree(lv_obj_t * start_obj)
 {
     if(start_obj == NULL) {
@@ -648,3 +667,11 @@ static lv_obj_t * lv_obj_get_first_not_deleting_child(lv_obj_t * obj)
 
     return NULL;
 }
+
+static lv_obj_tree_walk_res_t prefetch_images_cb(lv_obj_t * obj, void * user_data)
+{
+    /*The widgets add their own image sources in their event handler*/
+    lv_obj_send_event(obj, LV_EVENT_GET_IMAGE_SRCS, user_data);
+
+    return LV_OBJ_TREE_WALK_NEXT;
+}
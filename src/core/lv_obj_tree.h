@@ -18,6 +18,7 @@ extern "C" {
 #include "../misc/lv_types.h"
 #include "../misc/lv_anim.h"
 #include "../display/lv_display.h"
+#include "../misc/cache/lv_image_cache.h"
 
 /*********************
  *      DEFINES
@@ -222,6 +223,16 @@ int32_t lv_obj_get_index_by_type(const lv_obj_t * obj, const lv_obj_class_t * cl
  */
 void lv_obj_tree_walk(lv_obj_t * start_obj, lv_obj_tree_walk_cb_t cb, void * user_data);
 
+/**
+ * Prefetch the images of an object and its children with `lv_image_cache_prefetch()`.
+ * The sources are collected with `LV_EVENT_GET_IMAGE_SRCS`, e.g. the background images
+ * and the sources of the images and image buttons.
+ * @param start_obj     pointer to an object, e.g. a screen not loaded yet
+ * @param prio          priority of the decoding
+ * @return              number of images queued (or decoded) to the cache
+ */
+uint32_t lv_obj_tree_prefetch_images(lv_obj_t * start_obj, lv_image_cache_prefetch_prio_t prio);
+
 /**
  * Iterate through all children of any object and print their ID.
  * @param start_obj     start integrating from this object
@@ -16,6 +16,7 @@
 #include "../misc/lv_profiler.h"
 #include "../draw/lv_draw.h"
 #include "../font/lv_font_fmt_txt.h"
+#include "../misc/cache/lv_image_cache.h"
 #include "../stdlib/lv_string.h"
 #include "lv_global.h"
 
@@ -378,6 +379,9 @@ void _lv_display_refr_timer(lv_timer_t * tmr)
     /*If refresh happened ...*/
     lv_display_send_event(disp_refr, LV_EVENT_RENDER_READY, NULL);
 
+    /*The images drawn in the next refresh are used again*/
+    lv_image_cache_next_period();
+
     if(!lv_display_is_double_buffered(disp_refr) ||
        disp_refr->render_mode != LV_DISPLAY_RENDER_MODE_DIRECT) goto refr_clean_up;
 
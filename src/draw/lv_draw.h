@@ -20,6 +20,7 @@ extern "C" {
 #include "../misc/lv_text.h"
 #include "../misc/lv_profiler.h"
 #include "lv_image_decoder.h"
+#include "lv_image_decoder_async.h"
 #include "../osal/lv_os.h"
 #include "lv_draw_buf.h"
 
@@ -7,6 +7,8 @@
  *      INCLUDES
  *********************/
 #include "lv_draw_image.h"
+#include "lv_draw_rect.h"
+#include "lv_image_decoder_async.h"
 #include "../display/lv_display.h"
 #include "../misc/lv_log.h"
 #include "../misc/lv_math.h"
@@ -30,6 +32,13 @@ static void img_decode_and_draw(lv_draw_unit_t * draw_unit, const lv_draw_image_
                                 lv_image_decoder_dsc_t * decoder_dsc, lv_area_t * relative_decoded_area,
                                 const lv_area_t * img_area, const lv_area_t * clipped_img_area,
                                 lv_draw_image_core_cb draw_core_cb);
+static const lv_image_decoder_args_t * get_decoder_args(const lv_draw_image_dsc_t * draw_dsc,
+                                                        lv_image_decoder_args_t * args);
+static bool get_downscaled_dsc(const lv_draw_image_dsc_t * draw_dsc, const lv_draw_buf_t * decoded,
+                               const lv_area_t * coords, lv_draw_image_dsc_t * new_dsc, lv_area_t * new_coords);
+#if LV_USE_IMAGE_DECODER_ASYNC
+    static void draw_placeholder(lv_layer_t * layer, const lv_draw_image_dsc_t * dsc, const lv_area_t * area);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -98,13 +107,26 @@ void lv_draw_image(lv_layer_t * layer, const lv_draw_image_dsc_t * dsc, const lv
         return;
     }
 
+    lv_area_t real_area;
+    _lv_image_buf_get_transformed_area(&real_area, lv_area_get_width(coords), lv_area_get_height(coords),
+                                       dsc->rotation, dsc->scale_x, dsc->scale_y, &dsc->pivot);
+    lv_area_move(&real_area, coords->x1, coords->y1);
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+    /*The draw opens the downscaled version if it's drawn smaller, so that one has to be cached*/
+    lv_image_decoder_args_t args;
+    if(lv_image_decoder_async_request(dsc->src, get_decoder_args(new_image_dsc, &args), layer, &real_area)) {
+        lv_free(new_image_dsc);
+        draw_placeholder(layer, dsc, &real_area);
+        LV_PROFILER_END;
+        return;
+    }
+#endif
+
     lv_draw_task_t * t = lv_draw_add_task(layer, coords);
     t->draw_dsc = new_image_dsc;
     t->type = LV_DRAW_TASK_TYPE_IMAGE;
-
-    _lv_image_buf_get_transformed_area(&t->_real_area, lv_area_get_width(coords), lv_area_get_height(coords),
-                                       dsc->rotation, dsc->scale_x, dsc->scale_y, &dsc->pivot);
-    lv_area_move(&t->_real_area, coords->x1, coords->y1);
+    t->_real_area = real_area;
 
     lv_draw_finalize_task_creation(layer, t);
     LV_PROFILER_END;
@@ -155,13 +177,22 @@ void _lv_draw_image_normal_helper(lv_draw_unit_t * draw_unit, const lv_draw_imag
         return;
     }
 
+    lv_image_decoder_args_t args;
     lv_image_decoder_dsc_t decoder_dsc;
-    lv_result_t res = lv_image_decoder_open(&decoder_dsc, draw_dsc->src, NULL);
+    lv_result_t res = lv_image_decoder_open(&decoder_dsc, draw_dsc->src, get_decoder_args(draw_dsc, &args));
     if(res != LV_RESULT_OK) {
         LV_LOG_ERROR("Failed to open image");
         return;
     }
 
+    /*Scale up the image less if it was decoded downscaled*/
+    lv_draw_image_dsc_t downscaled_dsc;
+    lv_area_t downscaled_coords;
+    if(get_downscaled_dsc(draw_dsc, decoder_dsc.decoded, coords, &downscaled_dsc, &downscaled_coords)) {
+        draw_dsc = &downscaled_dsc;
+        coords = &downscaled_coords;
+    }
+
     img_decode_and_draw(draw_unit, draw_dsc, &decoder_dsc, NULL, coords, &clipped_img_area, draw_core_cb);
 
     lv_image_decoder_close(&decoder_dsc);
@@ -293,3 +324,81 @@ static void img_decode_and_draw(lv_draw_unit_t * draw_unit, const lv_draw_image_
         }
     }
 }
+
+/**
+ * Ask the decoder to decode a smaller image if the image is drawn downscaled.
+ * Only the decoders of image files can do it, so other images are opened with the default args
+ * unless a mipmap of them can be used.
+ * @param draw_dsc  the image draw descriptor
+ * @param args      the args to fill
+ * @return          `args` or NULL to use the default args
+ */
+static const lv_image_decoder_args_t * get_decoder_args(const lv_draw_image_dsc_t * draw_dsc,
+                                                        lv_image_decoder_args_t * args)
+{
+    if(draw_dsc->scale_x >= LV_SCALE_NONE && draw_dsc->scale_y >= LV_SCALE_NONE) return NULL;
+    if(lv_image_src_get_type(draw_dsc->src) != LV_IMAGE_SRC_FILE && !lv_image_cache_is_mipmap_enabled()) return NULL;
+
+    lv_memzero(args, sizeof(lv_image_decoder_args_t));
+    args->stride_align = LV_DRAW_BUF_STRIDE_ALIGN != 1;
+    args->use_indexed = LV_IMAGE_DECODER_USE_INDEXED_DEF;
+    args->target_w = (draw_dsc->header.w * LV_MIN(draw_dsc->scale_x, LV_SCALE_NONE) + 255) >> 8;
+    args->target_h = (draw_dsc->header.h * LV_MIN(draw_dsc->scale_y, LV_SCALE_NONE) + 255) >> 8;
+
+    return args;
+}
+
+/**
+ * If the decoded image is smaller than the image, adjust the transformation to draw it at the same place and size.
+ * The pivot stays at the same place and the scale is increased by the ratio of the sizes.
+ * @param draw_dsc      the image draw descriptor
+ * @param decoded       the decoded image
+ * @param coords        the coordinates of the original sized image
+ * @param new_dsc       store the adjusted draw descriptor here
+ * @param new_coords    store the coordinates of the decoded image here
+ * @return              true: the image was downscaled and `new_dsc` and `new_coords` are set
+ */
+static bool get_downscaled_dsc(const lv_draw_image_dsc_t * draw_dsc, const lv_draw_buf_t * decoded,
+                               const lv_area_t * coords, lv_draw_image_dsc_t * new_dsc, lv_area_t * new_coords)
+{
+    if(decoded == NULL) return false;
+
+    int32_t w = lv_area_get_width(coords);
+    int32_t h = lv_area_get_height(coords);
+    int32_t dec_w = decoded->header.w;
+    int32_t dec_h = decoded->header.h;
+    if(dec_w <= 0 || dec_h <= 0 || dec_w > w || dec_h > h) return false;
+    if(dec_w == w && dec_h == h) return false;
+
+    *new_dsc = *draw_dsc;
+    new_dsc->header.w = dec_w;
+    new_dsc->header.h = dec_h;
+    new_dsc->scale_x = draw_dsc->scale_x * w / dec_w;
+    new_dsc->scale_y = draw_dsc->scale_y * h / dec_h;
+    new_dsc->pivot.x = draw_dsc->pivot.x * dec_w / w;
+    new_dsc->pivot.y = draw_dsc->pivot.y * dec_h / h;
+
+    new_coords->x1 = coords->x1 + draw_dsc->pivot.x - new_dsc->pivot.x;
+    new_coords->y1 = coords->y1 + draw_dsc->pivot.y - new_dsc->pivot.y;
+    new_coords->x2 = new_coords->x1 + dec_w - 1;
+    new_coords->y2 = new_coords->y1 + dec_h - 1;
+
+    return true;
+}
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+/**
+ * Draw a rectangle instead of an image which is being decoded in the background
+ * @param layer     the layer to draw on
+ * @param dsc       the descriptor of the image
+ * @param area      the area of the image with its transformation (rotation, scale)
+ */
+static void draw_placeholder(lv_layer_t * layer, const lv_draw_image_dsc_t * dsc, const lv_area_t * area)
+{
+    lv_draw_rect_dsc_t rect_dsc;
+    lv_draw_rect_dsc_init(&rect_dsc);
+    rect_dsc.bg_color = lv_color_hex(LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_COLOR);
+    rect_dsc.bg_opa = dsc->opa;
+    lv_draw_rect(layer, &rect_dsc, area);
+}
+#endif
@@ -9,27 +9,59 @@
 #include "../core/lv_obj.h"
 #include "lv_draw_label.h"
 #include "../misc/lv_math.h"
+#include "../font/lv_font_fmt_txt.h"
 #include "../core/lv_obj_event.h"
 #include "../misc/lv_bidi.h"
 #include "../misc/lv_assert.h"
 #include "../stdlib/lv_mem.h"
 #include "../stdlib/lv_string.h"
+#include "../core/lv_global.h"
 
 /*********************
  *      DEFINES
  *********************/
 #define LABEL_RECOLOR_PAR_LENGTH 6
 #define LV_LABEL_HINT_UPDATE_TH 1024 /*Update the "hint" if the label's y coordinates have changed more then this*/
+#define font_glyph_cache_p (LV_GLOBAL_DEFAULT()->font_glyph_cache)
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    lv_cache_slot_size_t slot;
+
+    const lv_font_t * font;
+    uint32_t letter;
+    lv_font_glyph_format_t format;
+
+    lv_draw_buf_t * draw_buf;
+} glyph_cache_data_t;
+
+typedef struct {
+    lv_draw_glyph_batch_t batch;
+    lv_draw_glyph_batch_cb_t cb;
+#if LV_USE_FONT_GLYPH_ATLAS
+    lv_font_glyph_atlas_t * atlas;
+#endif
+} glyph_batcher_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_label_dsc_t * dsc,
+                               const lv_area_t * coords, lv_draw_glyph_cb_t cb, bool packed,
+                               lv_draw_glyph_batch_cb_t batch_cb);
 static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,  const lv_point_t * pos,
-                        const lv_font_t * font, uint32_t letter, lv_draw_glyph_cb_t cb);
+                        const lv_font_t * font, uint32_t letter, lv_draw_glyph_cb_t cb, bool packed,
+                        glyph_batcher_t * batcher);
+static void batch_flush(lv_draw_unit_t * draw_unit, glyph_batcher_t * batcher);
+
+#if LV_FONT_GLYPH_CACHE_SIZE > 0
+    static lv_cache_entry_t * glyph_cache_acquire(lv_font_glyph_dsc_t * g, uint32_t letter);
+    static bool glyph_cache_create_cb(glyph_cache_data_t * data, void * user_data);
+    static void glyph_cache_free_cb(glyph_cache_data_t * data, void * user_data);
+    static lv_cache_compare_res_t glyph_cache_compare_cb(const glyph_cache_data_t * lhs, const glyph_cache_data_t * rhs);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -47,6 +79,33 @@ static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,
  *   GLOBAL FUNCTIONS
  **********************/
 
+void _lv_draw_label_init(void)
+{
+#if LV_FONT_GLYPH_CACHE_SIZE > 0
+    font_glyph_cache_p = lv_cache_create(&lv_cache_class_lru_rb_size,
+    sizeof(glyph_cache_data_t), LV_FONT_GLYPH_CACHE_SIZE, (lv_cache_ops_t) {
+        .compare_cb = (lv_cache_compare_cb_t)glyph_cache_compare_cb,
+        .create_cb = (lv_cache_create_cb_t)glyph_cache_create_cb,
+        .free_cb = (lv_cache_free_cb_t)glyph_cache_free_cb,
+    });
+#endif
+}
+
+void _lv_draw_label_deinit(void)
+{
+#if LV_FONT_GLYPH_CACHE_SIZE > 0
+    lv_cache_destroy(font_glyph_cache_p, NULL);
+    font_glyph_cache_p = NULL;
+#endif
+}
+
+void lv_draw_label_glyph_cache_drop_all(void)
+{
+#if LV_FONT_GLYPH_CACHE_SIZE > 0
+    lv_cache_drop_all(font_glyph_cache_p, NULL);
+#endif
+}
+
 void lv_draw_label_dsc_init(lv_draw_label_dsc_t * dsc)
 {
     lv_memzero(dsc, sizeof(lv_draw_label_dsc_t));
@@ -141,6 +200,30 @@ void LV_ATTRIBUTE_FAST_MEM lv_draw_character(lv_layer_t * layer, lv_draw_label_d
 void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_label_dsc_t * dsc,
                                       const lv_area_t * coords,
                                       lv_draw_glyph_cb_t cb)
+{
+    iterate_characters(draw_unit, dsc, coords, cb, false, NULL);
+}
+
+void lv_draw_label_iterate_characters_packed(lv_draw_unit_t * draw_unit, const lv_draw_label_dsc_t * dsc,
+                                             const lv_area_t * coords, lv_draw_glyph_cb_t cb)
+{
+    iterate_characters(draw_unit, dsc, coords, cb, true, NULL);
+}
+
+void lv_draw_label_iterate_characters_batched(lv_draw_unit_t * draw_unit, const lv_draw_label_dsc_t * dsc,
+                                              const lv_area_t * coords, lv_draw_glyph_cb_t cb,
+                                              lv_draw_glyph_batch_cb_t batch_cb)
+{
+    iterate_characters(draw_unit, dsc, coords, cb, true, batch_cb);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_label_dsc_t * dsc,
+                               const lv_area_t * coords, lv_draw_glyph_cb_t cb, bool packed,
+                               lv_draw_glyph_batch_cb_t batch_cb)
 {
     const lv_font_t * font = dsc->font;
     int32_t w;
@@ -154,10 +237,20 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
 
     lv_bidi_calculate_align(&align, &base_dir, dsc->text);
 
+    /*If the lines are known they can be used instead of wrapping the text again*/
+    const lv_text_line_index_t * line_index = dsc->line_index;
+    if(line_index && !lv_text_line_index_is_valid(line_index, font, dsc->letter_space, lv_area_get_width(coords),
+                                                  dsc->flag)) {
+        line_index = NULL;
+    }
+
     if((dsc->flag & LV_TEXT_FLAG_EXPAND) == 0) {
         /*Normally use the label's width as width*/
         w = lv_area_get_width(coords);
     }
+    else if(line_index) {
+        w = line_index->max_line_width;
+    }
     else {
         /*If EXPAND is enabled then not limit the text's width to the object's width*/
         lv_point_t p;
@@ -168,6 +261,16 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
 
     int32_t line_height_font = lv_font_get_line_height(font);
     int32_t line_height = line_height_font + dsc->line_space;
+    if(line_height <= 0) line_index = NULL;
+
+#if LV_USE_BIDI
+    /*If the visual order of the lines is known only the letters need to be read from it*/
+    const lv_bidi_cache_t * bidi_cache = dsc->bidi_cache;
+    if(bidi_cache && !_lv_bidi_cache_is_valid(bidi_cache, font, dsc->letter_space, lv_area_get_width(coords),
+                                              dsc->flag, base_dir)) {
+        bidi_cache = NULL;
+    }
+#endif
 
     /*Init variables for the first line*/
     int32_t line_width = 0;
@@ -181,53 +284,72 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
     pos.y += y_ofs;
 
     uint32_t line_start     = 0;
-    int32_t last_line_start = -1;
-
-    /*Check the hint to use the cached info*/
-    if(dsc->hint && y_ofs == 0 && coords->y1 < 0) {
-        /*If the label changed too much recalculate the hint.*/
-        if(LV_ABS(dsc->hint->coord_y - coords->y1) > LV_LABEL_HINT_UPDATE_TH - 2 * line_height) {
-            dsc->hint->line_start = -1;
+    uint32_t line_end;
+    uint32_t line_id = 0;
+
+    if(line_index) {
+        /*All lines have the same height so the first visible line can be calculated*/
+        if(line_index->line_cnt == 0) return;
+        int32_t dist = draw_unit->clip_area->y1 - (pos.y + line_height_font);
+        if(dist > 0) {
+            line_id = (dist + line_height - 1) / line_height;
+            if(line_id >= line_index->line_cnt) return;
+            pos.y += line_id * line_height;
         }
-        last_line_start = dsc->hint->line_start;
+        line_start = line_index->line_starts[line_id];
+        line_end = line_id + 1 < line_index->line_cnt ? line_index->line_starts[line_id + 1] : line_index->txt_len;
     }
+    else {
+        int32_t last_line_start = -1;
 
-    /*Use the hint if it's valid*/
-    if(dsc->hint && last_line_start >= 0) {
-        line_start = last_line_start;
-        pos.y += dsc->hint->y;
-    }
+        /*Check the hint to use the cached info*/
+        if(dsc->hint && y_ofs == 0 && coords->y1 < 0) {
+            /*If the label changed too much recalculate the hint.*/
+            if(LV_ABS(dsc->hint->coord_y - coords->y1) > LV_LABEL_HINT_UPDATE_TH - 2 * line_height) {
+                dsc->hint->line_start = -1;
+            }
+            last_line_start = dsc->hint->line_start;
+        }
 
-    uint32_t line_end = line_start + _lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL,
-                                                            dsc->flag);
+        /*Use the hint if it's valid*/
+        if(dsc->hint && last_line_start >= 0) {
+            line_start = last_line_start;
+            pos.y += dsc->hint->y;
+        }
 
-    /*Go the first visible line*/
-    while(pos.y + line_height_font < draw_unit->clip_area->y1) {
-        /*Go to next line*/
-        line_start = line_end;
-        line_end += _lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
-        pos.y += line_height;
+        line_end = line_start + _lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL,
+                                                       dsc->flag);
+
+        /*Go the first visible line*/
+        while(pos.y + line_height_font < draw_unit->clip_area->y1) {
+            /*Go to next line*/
+            line_start = line_end;
+            line_end += _lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+            pos.y += line_height;
+
+            /*Save at the threshold coordinate*/
+            if(dsc->hint && pos.y >= -LV_LABEL_HINT_UPDATE_TH && dsc->hint->line_start < 0) {
+                dsc->hint->line_start = line_start;
+                dsc->hint->y          = pos.y - coords->y1;
+                dsc->hint->coord_y    = coords->y1;
+            }
 
-        /*Save at the threshold coordinate*/
-        if(dsc->hint && pos.y >= -LV_LABEL_HINT_UPDATE_TH && dsc->hint->line_start < 0) {
-            dsc->hint->line_start = line_start;
-            dsc->hint->y          = pos.y - coords->y1;
-            dsc->hint->coord_y    = coords->y1;
+            if(dsc->text[line_start] == '\0') return;
         }
-
-        if(dsc->text[line_start] == '\0') return;
     }
 
     /*Align to middle*/
     if(align == LV_TEXT_ALIGN_CENTER) {
-        line_width = lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+        line_width = line_index ? line_index->line_widths[line_id] :
+                     lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
 
         pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
     }
     /*Align to the right*/
     else if(align == LV_TEXT_ALIGN_RIGHT) {
-        line_width = lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+        line_width = line_index ? line_index->line_widths[line_id] :
+                     lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
         pos.x += lv_area_get_width(coords) - line_width;
     }
 
@@ -249,6 +371,25 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
     lv_draw_fill_dsc_t fill_dsc;
     lv_draw_fill_dsc_init(&fill_dsc);
     fill_dsc.opa = dsc->opa;
+
+    /*Collect the glyphs of the atlas to draw them together*/
+    glyph_batcher_t * batcher = NULL;
+#if LV_USE_FONT_GLYPH_ATLAS
+    glyph_batcher_t batcher_local;
+    if(batch_cb) {
+        batcher_local.atlas = lv_font_glyph_atlas_acquire(font);
+        if(batcher_local.atlas) {
+            batcher_local.cb = batch_cb;
+            batcher_local.batch.atlas = batcher_local.atlas->draw_buf;
+            batcher_local.batch.opa = dsc->opa;
+            batcher_local.batch.item_cnt = 0;
+            batcher = &batcher_local;
+        }
+    }
+#else
+    LV_UNUSED(batch_cb);
+#endif
+
     int32_t underline_width = font->underline_thickness ? font->underline_thickness : 1;
     int32_t line_start_x;
     uint32_t i;
@@ -262,9 +403,29 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
         /*Write all letter of a line*/
         i = 0;
 #if LV_USE_BIDI
-        char * bidi_txt = lv_malloc(line_end - line_start + 1);
-        LV_ASSERT_MALLOC(bidi_txt);
-        _lv_bidi_process_paragraph(dsc->text + line_start, bidi_txt, line_end - line_start, base_dir, NULL, 0);
+        char * bidi_buf = NULL;
+        const char * bidi_txt;
+        const uint16_t * bidi_pos_conv = NULL;
+        uint32_t line_letter_start = 0;
+        uint32_t visual_letter_id = 0;
+        if(bidi_cache && line_end <= bidi_cache->txt_len) {
+            if(sel_start != 0xFFFF && sel_end != 0xFFFF) {
+                line_letter_start = _lv_text_encoded_get_char_id(dsc->text, line_start);
+            }
+            if(bidi_cache->txt) {
+                bidi_txt = bidi_cache->txt + line_start;
+                bidi_pos_conv = bidi_cache->pos_conv + line_letter_start;
+            }
+            else {
+                bidi_txt = dsc->text + line_start;
+            }
+        }
+        else {
+            bidi_buf = lv_malloc(line_end - line_start + 1);
+            LV_ASSERT_MALLOC(bidi_buf);
+            _lv_bidi_process_paragraph(dsc->text + line_start, bidi_buf, line_end - line_start, base_dir, NULL, 0);
+            bidi_txt = bidi_buf;
+        }
 #else
         const char * bidi_txt = dsc->text + line_start;
 #endif
@@ -273,9 +434,16 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
             uint32_t logical_char_pos = 0;
             if(sel_start != 0xFFFF && sel_end != 0xFFFF) {
 #if LV_USE_BIDI
-                logical_char_pos = _lv_text_encoded_get_char_id(dsc->text, line_start);
-                uint32_t t = _lv_text_encoded_get_char_id(bidi_txt, i);
-                logical_char_pos += _lv_bidi_get_logical_pos(bidi_txt, NULL, line_end - line_start, base_dir, t, NULL);
+                if(bidi_buf == NULL) {
+                    logical_char_pos = line_letter_start;
+                    logical_char_pos += bidi_pos_conv ? bidi_pos_conv[visual_letter_id] : visual_letter_id;
+                }
+                else {
+                    logical_char_pos = _lv_text_encoded_get_char_id(dsc->text, line_start);
+                    uint32_t t = _lv_text_encoded_get_char_id(bidi_txt, i);
+                    logical_char_pos += _lv_bidi_get_logical_pos(bidi_txt, NULL, line_end - line_start, base_dir, t, NULL);
+                }
+                visual_letter_id++;
 #else
                 logical_char_pos = _lv_text_encoded_get_char_id(dsc->text, line_start + i);
 #endif
@@ -302,6 +470,7 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
                     fill_area.y2 = fill_area.y1 + underline_width - 1;
 
                     fill_dsc.color = dsc->color;
+                    batch_flush(draw_unit, batcher);
                     cb(draw_unit, NULL, &fill_dsc, &fill_area);
                 }
                 if(dsc->decor & LV_TEXT_DECOR_STRIKETHROUGH) {
@@ -312,6 +481,7 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
                     fill_area.y2 = fill_area.y1 + underline_width - 1;
 
                     fill_dsc.color = dsc->color;
+                    batch_flush(draw_unit, batcher);
                     cb(draw_unit, NULL, &fill_dsc, &fill_area);
                 }
             }
@@ -319,13 +489,14 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
             if(sel_start != 0xFFFF && sel_end != 0xFFFF && logical_char_pos >= sel_start && logical_char_pos < sel_end) {
                 draw_letter_dsc.color = dsc->sel_color;
                 fill_dsc.color = dsc->sel_bg_color;
+                batch_flush(draw_unit, batcher);
                 cb(draw_unit, NULL, &fill_dsc, &bg_coords);
             }
             else {
                 draw_letter_dsc.color = dsc->color;
             }
 
-            draw_letter(draw_unit, &draw_letter_dsc, &pos, font, letter, cb);
+            draw_letter(draw_unit, &draw_letter_dsc, &pos, font, letter, cb, packed, batcher);
 
             if(letter_w > 0) {
                 pos.x += letter_w + dsc->letter_space;
@@ -333,25 +504,31 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
         }
 
 #if LV_USE_BIDI
-        lv_free(bidi_txt);
-        bidi_txt = NULL;
+        if(bidi_buf) lv_free(bidi_buf);
 #endif
         /*Go to next line*/
         line_start = line_end;
-        line_end += _lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        if(line_index) {
+            line_id++;
+            if(line_id >= line_index->line_cnt) break;
+            line_end = line_id + 1 < line_index->line_cnt ? line_index->line_starts[line_id + 1] : line_index->txt_len;
+        }
+        else {
+            line_end += _lv_text_get_next_line(&dsc->text[line_start], font, dsc->letter_space, w, NULL, dsc->flag);
+        }
 
         pos.x = coords->x1;
         /*Align to middle*/
         if(align == LV_TEXT_ALIGN_CENTER) {
-            line_width =
-                lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+            line_width = line_index ? line_index->line_widths[line_id] :
+                         lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
 
             pos.x += (lv_area_get_width(coords) - line_width) / 2;
         }
         /*Align to the right*/
         else if(align == LV_TEXT_ALIGN_RIGHT) {
-            line_width =
-                lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
+            line_width = line_index ? line_index->line_widths[line_id] :
+                         lv_text_get_width(&dsc->text[line_start], line_end - line_start, font, dsc->letter_space);
             pos.x += lv_area_get_width(coords) - line_width;
         }
 
@@ -361,17 +538,18 @@ void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_
         if(pos.y > draw_unit->clip_area->y2) break;
     }
 
+    batch_flush(draw_unit, batcher);
+#if LV_USE_FONT_GLYPH_ATLAS
+    if(batcher) lv_font_glyph_atlas_release(batcher->atlas);
+#endif
     if(draw_letter_dsc._draw_buf) lv_draw_buf_destroy(draw_letter_dsc._draw_buf);
 
     LV_ASSERT_MEM_INTEGRITY();
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-
 static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,  const lv_point_t * pos,
-                        const lv_font_t * font, uint32_t letter, lv_draw_glyph_cb_t cb)
+                        const lv_font_t * font, uint32_t letter, lv_draw_glyph_cb_t cb, bool packed,
+                        glyph_batcher_t * batcher)
 {
     lv_font_glyph_dsc_t g;
 
@@ -404,7 +582,50 @@ static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,
         return;
     }
 
-    if(g.resolved_font) {
+#if LV_USE_FONT_GLYPH_ATLAS
+    if(batcher) {
+        lv_area_t atlas_area;
+        if(lv_font_glyph_atlas_get_glyph(batcher->atlas, &g, letter, &atlas_area)) {
+            if(batcher->batch.item_cnt == LV_DRAW_GLYPH_BATCH_MAX) batch_flush(draw_unit, batcher);
+
+            lv_draw_glyph_batch_item_t * item = &batcher->batch.items[batcher->batch.item_cnt];
+            item->atlas_area = atlas_area;
+            item->letter_coords = letter_coords;
+            item->color = dsc->color;
+            batcher->batch.item_cnt++;
+            LV_PROFILER_END;
+            return;
+        }
+    }
+#endif
+
+    /*Keep the drawing order*/
+    batch_flush(draw_unit, batcher);
+
+    dsc->packed = 0;
+    if(packed && g.resolved_font && g.resolved_font->get_glyph_bitmap == lv_font_get_bitmap_fmt_txt &&
+       (g.format == LV_FONT_GLYPH_FORMAT_A1 || g.format == LV_FONT_GLYPH_FORMAT_A2 || g.format == LV_FONT_GLYPH_FORMAT_A4)) {
+        /*Pass the bitmap stored in the font as it is, the draw unit will convert it on the fly*/
+        dsc->glyph_data = (void *)lv_font_get_packed_bitmap_fmt_txt(&g, letter);
+        dsc->packed = dsc->glyph_data != NULL;
+    }
+
+#if LV_FONT_GLYPH_CACHE_SIZE > 0
+    lv_cache_entry_t * cache_entry = NULL;
+    if(!dsc->packed) cache_entry = glyph_cache_acquire(&g, letter);
+#endif
+
+    if(dsc->packed) {
+        dsc->format = g.format;
+    }
+#if LV_FONT_GLYPH_CACHE_SIZE > 0
+    else if(cache_entry) {
+        glyph_cache_data_t * cached_data = lv_cache_entry_get_data(cache_entry);
+        dsc->glyph_data = cached_data->draw_buf;
+        dsc->format = g.format;
+    }
+#endif
+    else if(g.resolved_font) {
         lv_draw_buf_t * draw_buf = NULL;
         if(LV_FONT_GLYPH_FORMAT_NONE < g.format && g.format < LV_FONT_GLYPH_FORMAT_IMAGE) {
             /*Only check draw buf for bitmap glyph*/
@@ -432,8 +653,87 @@ static void draw_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc,
     dsc->g = &g;
     cb(draw_unit, dsc, NULL, NULL);
 
+#if LV_FONT_GLYPH_CACHE_SIZE > 0
+    if(cache_entry) lv_cache_release(font_glyph_cache_p, cache_entry, NULL);
+#endif
+
     if(g.resolved_font && font->release_glyph) {
         font->release_glyph(font, &g);
     }
     LV_PROFILER_END;
 }
+
+static void batch_flush(lv_draw_unit_t * draw_unit, glyph_batcher_t * batcher)
+{
+    if(batcher == NULL || batcher->batch.item_cnt == 0) return;
+
+    batcher->cb(draw_unit, &batcher->batch);
+    batcher->batch.item_cnt = 0;
+}
+
+#if LV_FONT_GLYPH_CACHE_SIZE > 0
+
+/**
+ * Get the decoded A8 bitmap of a glyph from the glyph cache. Decode and add it to the cache if not found.
+ * Only the glyphs of the `lv_font_fmt_txt` based fonts are cached as other fonts (e.g. FreeType)
+ * manage their own cache.
+ * @param g         the glyph's descriptor
+ * @param letter    the UNICODE letter
+ * @return          the acquired cache entry or NULL if the glyph can't be cached
+ */
+static lv_cache_entry_t * glyph_cache_acquire(lv_font_glyph_dsc_t * g, uint32_t letter)
+{
+    if(g->resolved_font == NULL || g->resolved_font->get_glyph_bitmap != lv_font_get_bitmap_fmt_txt) return NULL;
+    if(g->format < LV_FONT_GLYPH_FORMAT_A1 || g->format > LV_FONT_GLYPH_FORMAT_A8) return NULL;
+
+    glyph_cache_data_t search_key = {
+        .slot.size = lv_draw_buf_width_to_stride(g->box_w, LV_COLOR_FORMAT_A8) * g->box_h,
+        .font = g->resolved_font,
+        .letter = letter,
+        .format = g->format,
+    };
+
+    /*Don't let a huge glyph flush the whole cache*/
+    if(search_key.slot.size > lv_cache_get_max_size(font_glyph_cache_p, NULL)) return NULL;
+
+    return lv_cache_acquire_or_create(font_glyph_cache_p, &search_key, g);
+}
+
+static bool glyph_cache_create_cb(glyph_cache_data_t * data, void * user_data)
+{
+    lv_font_glyph_dsc_t * g = user_data;
+
+    lv_draw_buf_t * draw_buf = lv_draw_buf_create(g->box_w, g->box_h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
+    if(draw_buf == NULL) return false;
+
+    if(lv_font_get_glyph_bitmap(g, data->letter, draw_buf) == NULL) {
+        lv_draw_buf_destroy(draw_buf);
+        return false;
+    }
+
+    data->draw_buf = draw_buf;
+    return true;
+}
+
+static void glyph_cache_free_cb(glyph_cache_data_t * data, void * user_data)
+{
+    LV_UNUSED(user_data);
+    lv_draw_buf_destroy(data->draw_buf);
+    data->draw_buf = NULL;
+}
+
+static lv_cache_compare_res_t glyph_cache_compare_cb(const glyph_cache_data_t * lhs, const glyph_cache_data_t * rhs)
+{
+    if(lhs->font != rhs->font) {
+        return lhs->font > rhs->font ? 1 : -1;
+    }
+    if(lhs->letter != rhs->letter) {
+        return lhs->letter > rhs->letter ? 1 : -1;
+    }
+    if(lhs->format != rhs->format) {
+        return lhs->format > rhs->format ? 1 : -1;
+    }
+    return 0;
+}
+
+#endif /*LV_FONT_GLYPH_CACHE_SIZE > 0*/
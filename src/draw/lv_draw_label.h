@@ -24,6 +24,9 @@ extern "C" {
  *********************/
 #define LV_DRAW_LABEL_NO_TXT_SEL (0xFFFF)
 
+/*Max. number of glyphs passed to a `lv_draw_glyph_batch_cb_t` at once*/
+#define LV_DRAW_GLYPH_BATCH_MAX 16
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -70,6 +73,14 @@ typedef struct {
      * 0: `text` is const and it's pointer will be valid during rendering.*/
     uint8_t text_local : 1;
     lv_draw_label_hint_t * hint;
+    /**
+     * The lines of the text if already known. Used only if it was created with
+     * the same font, letter space, width and flags. Allows skipping the invisible lines quickly.*/
+    const lv_text_line_index_t * line_index;
+    /**
+     * The lines of the text in visual order if already known. Used only if it was created with
+     * the same font, letter space, width, flags and base direction. Allows skipping the bidi processing.*/
+    const lv_bidi_cache_t * bidi_cache;
 } lv_draw_label_dsc_t;
 
 typedef struct {
@@ -80,6 +91,7 @@ typedef struct {
     const lv_font_glyph_dsc_t * g;
     lv_color_t color;
     lv_opa_t opa;
+    uint8_t packed : 1; /*1: `glyph_data` is a packed 1, 2 or 4 bpp bitmap, see `lv_font_get_packed_bitmap_fmt_txt`*/
     lv_draw_buf_t * _draw_buf; /*a shared draw buf for get_bitmap, do not use it directly, use glyph_data instead*/
 } lv_draw_glyph_dsc_t;
 
@@ -98,10 +110,49 @@ typedef struct {
 typedef void(*lv_draw_glyph_cb_t)(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * dsc, lv_draw_fill_dsc_t * fill_dsc,
                                   const lv_area_t * fill_area);
 
+/** A glyph to copy from the texture of a glyph atlas*/
+typedef struct {
+    lv_area_t atlas_area;       /**< Area of the glyph on the texture*/
+    lv_area_t letter_coords;    /**< Where to draw the glyph*/
+    lv_color_t color;
+} lv_draw_glyph_batch_item_t;
+
+/** Glyphs to draw from the same glyph atlas (see `lv_font_glyph_atlas_create()`)*/
+typedef struct {
+    const lv_draw_buf_t * atlas;    /**< The A8 texture of the glyph atlas*/
+    lv_opa_t opa;
+    uint32_t item_cnt;
+    lv_draw_glyph_batch_item_t items[LV_DRAW_GLYPH_BATCH_MAX];
+} lv_draw_glyph_batch_t;
+
+/**
+ * Passed as a parameter to `lv_draw_label_iterate_characters_batched` to
+ * draw glyphs of a glyph atlas together
+ * @param draw_unit     pointer to a draw unit
+ * @param batch         the glyphs to draw
+ */
+typedef void(*lv_draw_glyph_batch_cb_t)(lv_draw_unit_t * draw_unit, const lv_draw_glyph_batch_t * batch);
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 
+/**
+ * Initialize the label drawing module (e.g. create the glyph cache)
+ */
+void _lv_draw_label_init(void);
+
+/**
+ * Deinitialize the label drawing module
+ */
+void _lv_draw_label_deinit(void);
+
+/**
+ * Drop all the glyph bitmaps stored in the glyph cache (see `LV_FONT_GLYPH_CACHE_SIZE`).
+ * Needs to be called before a font is deleted whose glyphs might be cached.
+ */
+void lv_draw_label_glyph_cache_drop_all(void);
+
 /**
  * Initialize a label draw descriptor
  * @param dsc       pointer to a draw descriptor
@@ -152,6 +203,33 @@ void /* LV_ATTRIBUTE_FAST_MEM */ lv_draw_character(lv_layer_t * layer, lv_draw_l
 void lv_draw_label_iterate_characters(lv_draw_unit_t * draw_unit, const lv_draw_label_dsc_t * dsc,
                                       const lv_area_t * coords, lv_draw_glyph_cb_t cb);
 
+/**
+ * Same as `lv_draw_label_iterate_characters` but the glyphs of not compressed 1, 2 and 4 bpp
+ * `lv_font_fmt_txt` fonts are not converted to A8. Instead `glyph_data` points to the packed
+ * bitmap in the font and the `packed` flag of the glyph draw descriptor is set.
+ * Can be used by draw units which can blend packed bitmaps directly.
+ * @param draw_unit     pointer to a draw unit
+ * @param dsc           pointer to draw descriptor
+ * @param coords        coordinates of the label
+ * @param cb            a callback to call to draw each glyphs one by one
+ */
+void lv_draw_label_iterate_characters_packed(lv_draw_unit_t * draw_unit, const lv_draw_label_dsc_t * dsc,
+                                             const lv_area_t * coords, lv_draw_glyph_cb_t cb);
+
+/**
+ * Same as `lv_draw_label_iterate_characters_packed` but if the font has a glyph atlas
+ * (see `lv_font_glyph_atlas_create()`) its glyphs are collected and passed to `batch_cb` together.
+ * The other glyphs, the placeholders and the fills are passed to `cb` as usual.
+ * @param draw_unit     pointer to a draw unit
+ * @param dsc           pointer to draw descriptor
+ * @param coords        coordinates of the label
+ * @param cb            a callback to call to draw the glyphs not in the atlas one by one
+ * @param batch_cb      a callback to call to draw the glyphs of the atlas
+ */
+void lv_draw_label_iterate_characters_batched(lv_draw_unit_t * draw_unit, const lv_draw_label_dsc_t * dsc,
+                                              const lv_area_t * coords, lv_draw_glyph_cb_t cb,
+                                              lv_draw_glyph_batch_cb_t batch_cb);
+
 /***********************
  * GLOBAL VARIABLES
  ***********************/
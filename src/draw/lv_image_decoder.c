@@ -10,6 +10,8 @@
 #include "../misc/lv_assert.h"
 #include "../draw/lv_draw_image.h"
 #include "../misc/lv_ll.h"
+#include "../misc/cache/lv_image_cache_compressed.h"
+#include "../stdlib/lv_mem.h"
 #include "../stdlib/lv_string.h"
 #include "../core/lv_global.h"
 
@@ -20,6 +22,14 @@
 #define img_cache_p (LV_GLOBAL_DEFAULT()->img_cache)
 #define img_header_cache_p (LV_GLOBAL_DEFAULT()->img_header_cache)
 
+#if LV_IMAGE_CACHE_SCAN_RESISTANT
+    #define IMAGE_CACHE_CLASS_SIZE  &lv_cache_class_slru_rb_size
+    #define IMAGE_CACHE_CLASS_COUNT &lv_cache_class_slru_rb_count
+#else
+    #define IMAGE_CACHE_CLASS_SIZE  &lv_cache_class_lru_rb_size
+    #define IMAGE_CACHE_CLASS_COUNT &lv_cache_class_lru_rb_count
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -42,14 +52,25 @@ static lv_image_decoder_t * image_decoder_get_info(const void * src, lv_image_he
 static lv_cache_compare_res_t image_decoder_header_cache_compare_cb(const lv_image_header_cache_data_t * lhs,
                                                                     const lv_image_header_cache_data_t * rhs);
 static void image_decoder_header_cache_free_cb(lv_image_header_cache_data_t * entry, void * user_data);
+static uint32_t image_decoder_header_cache_hash_cb(const lv_image_header_cache_data_t * key);
 #endif
 
 #if LV_CACHE_DEF_SIZE > 0
 static lv_cache_compare_res_t image_decoder_cache_compare_cb(const lv_image_cache_data_t * lhs,
                                                              const lv_image_cache_data_t * rhs);
 static void image_decoder_cache_free_cb(lv_image_cache_data_t * entry, void * user_data);
+static uint32_t image_decoder_cache_hash_cb(const lv_image_cache_data_t * key);
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+    static void image_decoder_cache_evict_cb(lv_image_cache_data_t * entry, void * user_data);
+#endif
 
 static lv_result_t try_cache(lv_image_decoder_dsc_t * dsc);
+static lv_result_t try_cache_downscaled(lv_image_decoder_dsc_t * dsc, uint32_t downscale);
+#endif
+
+#if LV_USE_IMAGE_MIPMAP
+    static void use_mipmap(lv_image_decoder_dsc_t * dsc);
+    static lv_draw_buf_t * mipmap_create(const lv_draw_buf_t * decoded, uint32_t downscale);
 #endif
 /**********************
  *  STATIC VARIABLES
@@ -71,22 +92,30 @@ void _lv_image_decoder_init(void)
     _lv_ll_init(img_decoder_ll_p, sizeof(lv_image_decoder_t));
 
 #if LV_CACHE_DEF_SIZE > 0
-    img_cache_p = lv_cache_create(&lv_cache_class_lru_rb_size,
+    img_cache_p = lv_cache_create_sharded(IMAGE_CACHE_CLASS_SIZE,
     sizeof(lv_image_cache_data_t), LV_CACHE_DEF_SIZE, (lv_cache_ops_t) {
         .compare_cb = (lv_cache_compare_cb_t)image_decoder_cache_compare_cb,
         .create_cb = NULL,
         .free_cb = (lv_cache_free_cb_t)image_decoder_cache_free_cb,
-    });
+        .hash_cb = (lv_cache_hash_cb_t)image_decoder_cache_hash_cb,
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+        .evict_cb = (lv_cache_evict_cb_t)image_decoder_cache_evict_cb,
+#endif
+    }, LV_IMAGE_CACHE_SHARD_CNT);
 
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+    _lv_image_cache_compressed_init();
+#endif
 #endif
 
 #if LV_IMAGE_HEADER_CACHE_DEF_CNT > 0
-    img_header_cache_p = lv_cache_create(&lv_cache_class_lru_rb_count,
+    img_header_cache_p = lv_cache_create_sharded(IMAGE_CACHE_CLASS_COUNT,
     sizeof(lv_image_header_cache_data_t), LV_IMAGE_HEADER_CACHE_DEF_CNT, (lv_cache_ops_t) {
         .compare_cb = (lv_cache_compare_cb_t)image_decoder_header_cache_compare_cb,
         .create_cb = NULL,
-        .free_cb = (lv_cache_free_cb_t)image_decoder_header_cache_free_cb
-    });
+        .free_cb = (lv_cache_free_cb_t)image_decoder_header_cache_free_cb,
+        .hash_cb = (lv_cache_hash_cb_t)image_decoder_header_cache_hash_cb,
+    }, LV_IMAGE_CACHE_SHARD_CNT);
 #endif
 }
 
@@ -99,6 +128,10 @@ void _lv_image_decoder_deinit(void)
     lv_cache_destroy(img_cache_p, NULL);
 #endif
 
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+    _lv_image_cache_compressed_deinit();
+#endif
+
 #if LV_IMAGE_HEADER_CACHE_DEF_CNT > 0
     lv_cache_destroy(img_header_cache_p, NULL);
 #endif
@@ -121,14 +154,32 @@ lv_result_t lv_image_decoder_open(lv_image_decoder_dsc_t * dsc, const void * src
     dsc->src = src;
     dsc->src_type = lv_image_src_get_type(src);
 
+    /*Make a copy of args*/
+    dsc->args = args ? *args : (lv_image_decoder_args_t) {
+        .stride_align = LV_DRAW_BUF_STRIDE_ALIGN != 1,
+        .premultiply = false,
+        .no_cache = false,
+        .use_indexed = LV_IMAGE_DECODER_USE_INDEXED_DEF,
+    };
+
 #if LV_CACHE_DEF_SIZE > 0
     dsc->cache = img_cache_p;
     /*Try cache first, unless we are told to ignore cache.*/
-    if(!(args && args->no_cache)) {
+    if(!dsc->args.no_cache) {
+        /*The size of the image is needed to find its downscaled version*/
+        if(dsc->args.target_w > 0 || dsc->args.target_h > 0) {
+            if(image_decoder_get_info(src, &dsc->header) == NULL) return LV_RESULT_INVALID;
+        }
+
         /*
         * Check the cache first
         * If the image is found in the cache, just return it.*/
-        if(try_cache(dsc) == LV_RESULT_OK) return LV_RESULT_OK;
+        if(try_cache(dsc) == LV_RESULT_OK) {
+#if LV_USE_IMAGE_MIPMAP
+            use_mipmap(dsc);
+#endif
+            return LV_RESULT_OK;
+        }
     }
 #endif
 
@@ -136,14 +187,6 @@ lv_result_t lv_image_decoder_open(lv_image_decoder_dsc_t * dsc, const void * src
     dsc->decoder = image_decoder_get_info(src, &dsc->header);
     if(dsc->decoder == NULL) return LV_RESULT_INVALID;
 
-    /*Make a copy of args*/
-    dsc->args = args ? *args : (lv_image_decoder_args_t) {
-        .stride_align = LV_DRAW_BUF_STRIDE_ALIGN != 1,
-        .premultiply = false,
-        .no_cache = false,
-        .use_indexed = false,
-    };
-
     /*
      * We assume that if a decoder can get the info, it can open the image.
      * If decoder open failed, free the source and return error.
@@ -151,6 +194,10 @@ lv_result_t lv_image_decoder_open(lv_image_decoder_dsc_t * dsc, const void * src
      * */
     lv_result_t res = dsc->decoder->open_cb(dsc->decoder, dsc);
 
+#if LV_USE_IMAGE_MIPMAP
+    if(res == LV_RESULT_OK) use_mipmap(dsc);
+#endif
+
     return res;
 }
 
@@ -245,11 +292,113 @@ lv_cache_entry_t * lv_image_decoder_add_to_cache(lv_image_decoder_t * decoder,
     }
     cached_data->user_data = user_data; /*Need to free data on cache invalidate instead of decoder_close*/
     cached_data->decoder = decoder;
+    cached_data->core_created = 0;
 
     return cache_entry;
 }
 #endif
 
+uint32_t lv_image_decoder_get_downscale(const lv_image_decoder_dsc_t * dsc)
+{
+    int32_t target_w = dsc->args.target_w;
+    int32_t target_h = dsc->args.target_h;
+    if(target_w <= 0 && target_h <= 0) return 0;
+
+    uint32_t downscale = 0;
+    while(downscale < LV_IMAGE_DECODER_DOWNSCALE_MAX) {
+        uint32_t next = downscale + 1;
+        int32_t w = (dsc->header.w + (1 << next) - 1) >> next;
+        int32_t h = (dsc->header.h + (1 << next) - 1) >> next;
+        if(w < target_w || h < target_h || (w == 1 && h == 1)) break;
+        downscale = next;
+    }
+
+    return downscale;
+}
+
+void lv_image_decoder_downscale_add_row(uint32_t * sums, const uint8_t * row, int32_t w, lv_color_format_t cf,
+                                        bool weighted, uint32_t downscale)
+{
+    uint32_t px_size = lv_color_format_get_size(cf);
+    const uint8_t * px = row;
+    int32_t x;
+    for(x = 0; x < w; x++) {
+        uint32_t * sum = &sums[(x >> downscale) * 4];
+        if(cf == LV_COLOR_FORMAT_RGB565) {
+            uint16_t c = px[0] | (px[1] << 8);
+            sum[0] += c & 0x1F;
+            sum[1] += (c >> 5) & 0x3F;
+            sum[2] += c >> 11;
+        }
+        else if(px_size == 1) {
+            sum[0] += px[0];
+        }
+        else {
+            uint32_t a = weighted ? px[3] : 1;
+            sum[0] += px[0] * a;
+            sum[1] += px[1] * a;
+            sum[2] += px[2] * a;
+            if(cf == LV_COLOR_FORMAT_ARGB8888) sum[3] += px[3];
+        }
+        px += px_size;
+    }
+}
+
+void lv_image_decoder_downscale_write_row(uint8_t * dest, const uint32_t * sums, int32_t w, int32_t row_cnt,
+                                          lv_color_format_t cf, bool weighted, uint32_t downscale)
+{
+    uint32_t px_size = lv_color_format_get_size(cf);
+    int32_t dest_w = (w + (1 << downscale) - 1) >> downscale;
+    int32_t x;
+    for(x = 0; x < dest_w; x++) {
+        const uint32_t * sum = &sums[x * 4];
+        int32_t sx1 = x << downscale;
+        uint32_t px_cnt = (LV_MIN(sx1 + (1 << downscale), w) - sx1) * row_cnt;
+
+        /*Weighted colors are divided by the sum of the opacities*/
+        uint32_t div = px_cnt;
+        if(weighted) {
+            div = sum[3] ? sum[3] : 1;
+        }
+
+        if(cf == LV_COLOR_FORMAT_RGB565) {
+            uint16_t c = ((sum[0] + div / 2) / div)
+                         | (((sum[1] + div / 2) / div) << 5)
+                         | (((sum[2] + div / 2) / div) << 11);
+            dest[0] = c & 0xFF;
+            dest[1] = c >> 8;
+        }
+        else if(px_size == 1) {
+            dest[0] = (sum[0] + div / 2) / div;
+        }
+        else {
+            dest[0] = (sum[0] + div / 2) / div;
+            dest[1] = (sum[1] + div / 2) / div;
+            dest[2] = (sum[2] + div / 2) / div;
+            if(cf == LV_COLOR_FORMAT_ARGB8888) dest[3] = (sum[3] + px_cnt / 2) / px_cnt;
+            else if(cf == LV_COLOR_FORMAT_XRGB8888) dest[3] = 0xFF;
+        }
+        dest += px_size;
+    }
+}
+
+bool lv_image_decoder_is_streamed(const lv_image_decoder_dsc_t * dsc, uint32_t decoded_size)
+{
+    LV_UNUSED(dsc);
+    LV_UNUSED(decoded_size);
+
+#if LV_IMAGE_DECODER_STREAM_THRESHOLD > 0
+    if(decoded_size > LV_IMAGE_DECODER_STREAM_THRESHOLD) return true;
+#endif
+
+#if LV_CACHE_DEF_SIZE > 0
+    /*The cache would refuse it and the image couldn't be drawn at all*/
+    if(!dsc->args.no_cache && decoded_size > lv_cache_get_max_entry_size(dsc->cache, NULL)) return true;
+#endif
+
+    return false;
+}
+
 lv_draw_buf_t * lv_image_decoder_post_process(lv_image_decoder_dsc_t * dsc, lv_draw_buf_t * decoded)
 {
     if(decoded == NULL) return NULL; /*No need to adjust*/
@@ -400,6 +549,30 @@ inline static lv_cache_compare_res_t image_decoder_common_compare(const void * l
     }
     return lhs_src_type > rhs_src_type ? 1 : -1;
 }
+
+/**
+ * Hash an image source consistently with `image_decoder_common_compare()`
+ */
+static uint32_t image_decoder_common_hash(const void * src, lv_image_src_t src_type)
+{
+    /*FNV-1a*/
+    uint32_t hash = 2166136261U;
+    if(src_type == LV_IMAGE_SRC_FILE) {
+        const uint8_t * s = src;
+        while(*s) {
+            hash = (hash ^ *s) * 16777619U;
+            s++;
+        }
+    }
+    else if(src_type == LV_IMAGE_SRC_VARIABLE) {
+        /*The low bits of the pointers are the same due to alignment*/
+        lv_uintptr_t p = (lv_uintptr_t)src;
+        hash = (hash ^ (uint32_t)(p >> 4)) * 16777619U;
+        hash = (hash ^ (uint32_t)(p >> 20)) * 16777619U;
+    }
+
+    return hash;
+}
 #endif
 
 #if LV_IMAGE_HEADER_CACHE_DEF_CNT > 0
@@ -416,6 +589,11 @@ static void image_decoder_header_cache_free_cb(lv_image_header_cache_data_t * en
 
     if(entry->src_type == LV_IMAGE_SRC_FILE) lv_free((void *)entry->src);
 }
+
+static uint32_t image_decoder_header_cache_hash_cb(const lv_image_header_cache_data_t * key)
+{
+    return image_decoder_common_hash(key->src, key->src_type);
+}
 #endif
 
 #if LV_CACHE_DEF_SIZE > 0
@@ -423,15 +601,21 @@ static lv_cache_compare_res_t image_decoder_cache_compare_cb(
     const lv_image_cache_data_t * lhs,
     const lv_image_cache_data_t * rhs)
 {
+    if(lhs->downscale != rhs->downscale) return lhs->downscale > rhs->downscale ? 1 : -1;
     return image_decoder_common_compare(lhs->src, lhs->src_type, rhs->src, rhs->src_type);
 }
 
+static uint32_t image_decoder_cache_hash_cb(const lv_image_cache_data_t * key)
+{
+    return image_decoder_common_hash(key->src, key->src_type);
+}
+
 static void image_decoder_cache_free_cb(lv_image_cache_data_t * entry, void * user_data)
 {
     const lv_image_decoder_t * decoder = entry->decoder;
     if(decoder == NULL) return; /* Why ? */
 
-    if(decoder->cache_free_cb) {
+    if(decoder->cache_free_cb && !entry->core_created) {
         /* Decoder wants to free the cache by itself. */
         decoder->cache_free_cb(entry, user_data);
     }
@@ -447,13 +631,37 @@ static void image_decoder_cache_free_cb(lv_image_cache_data_t * entry, void * us
     }
 }
 
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+/**
+ * Keep the evicted images compressed as decompressing is faster than decoding them again.
+ * It's called without holding the lock of the image cache, so the other draw units aren't blocked.
+ */
+static void image_decoder_cache_evict_cb(lv_image_cache_data_t * entry, void * user_data)
+{
+    LV_UNUSED(user_data);
+    _lv_image_cache_compressed_store(entry);
+}
+#endif
+
 static lv_result_t try_cache(lv_image_decoder_dsc_t * dsc)
+{
+    uint32_t downscale = lv_image_decoder_get_downscale(dsc);
+    if(try_cache_downscaled(dsc, downscale) == LV_RESULT_OK) return LV_RESULT_OK;
+
+    /*The original size is good too, e.g. if the decoder can't downscale*/
+    if(downscale > 0) return try_cache_downscaled(dsc, 0);
+
+    return LV_RESULT_INVALID;
+}
+
+static lv_result_t try_cache_downscaled(lv_image_decoder_dsc_t * dsc, uint32_t downscale)
 {
     lv_cache_t * cache = dsc->cache;
 
     lv_image_cache_data_t search_key;
     search_key.src_type = dsc->src_type;
     search_key.src = dsc->src;
+    search_key.downscale = (uint8_t)downscale;
 
     lv_cache_entry_t * entry = lv_cache_acquire(cache, &search_key, NULL);
 
@@ -465,6 +673,113 @@ static lv_result_t try_cache(lv_image_decoder_dsc_t * dsc)
         return LV_RESULT_OK;
     }
 
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+    return _lv_image_cache_compressed_restore(dsc, downscale);
+#else
     return LV_RESULT_INVALID;
+#endif
 }
 #endif
+
+#if LV_USE_IMAGE_MIPMAP
+/**
+ * If the image was opened larger than the target size, replace it with a downscaled version
+ * and add that to the cache to use it next time.
+ * @param dsc   an opened decoder descriptor
+ */
+static void use_mipmap(lv_image_decoder_dsc_t * dsc)
+{
+    if(!lv_image_cache_is_mipmap_enabled() || dsc->args.no_cache) return;
+
+    const lv_draw_buf_t * decoded = dsc->decoded;
+    if(decoded == NULL) return;
+
+    /*Already downscaled by the decoder or from the cache*/
+    if(decoded->header.w != dsc->header.w || decoded->header.h != dsc->header.h) return;
+
+    /*The content of the not cached buffers might change, e.g. of a canvas*/
+    if(dsc->cache_entry == NULL && (decoded->header.flags & LV_IMAGE_FLAGS_MODIFIABLE)) return;
+
+    uint32_t downscale = lv_image_decoder_get_downscale(dsc);
+    if(downscale == 0) return;
+
+    lv_draw_buf_t * mipmap = mipmap_create(decoded, downscale);
+    if(mipmap == NULL) return;
+
+    lv_image_cache_data_t search_key;
+    search_key.src_type = dsc->src_type;
+    search_key.src = dsc->src;
+    search_key.downscale = (uint8_t)downscale;
+    search_key.slot.size = mipmap->data_size;
+
+    lv_cache_entry_t * entry = lv_image_decoder_add_to_cache(dsc->decoder, &search_key, mipmap, NULL);
+    if(entry == NULL) {
+        lv_draw_buf_destroy(mipmap);
+        return;
+    }
+
+    /*Not the decoder's own buffer, so don't free it with the decoder's cache free callback*/
+    ((lv_image_cache_data_t *)lv_cache_entry_get_data(entry))->core_created = 1;
+
+    /*Continue like the mipmap was found in the cache*/
+    lv_image_decoder_close(dsc);
+    dsc->user_data = NULL;
+    dsc->decoded = mipmap;
+    dsc->cache_entry = entry;
+}
+
+/**
+ * Average the `2^downscale` x `2^downscale` blocks of an image.
+ * Not premultiplied colors are weighted by their opacity.
+ * @param decoded       the original image
+ * @param downscale     halve the size this many times
+ * @return              the new draw buffer or NULL if the color format is not supported
+ */
+static lv_draw_buf_t * mipmap_create(const lv_draw_buf_t * decoded, uint32_t downscale)
+{
+    lv_color_format_t cf = decoded->header.cf;
+    bool supported = cf == LV_COLOR_FORMAT_ARGB8888
+                     || cf == LV_COLOR_FORMAT_XRGB8888
+                     || cf == LV_COLOR_FORMAT_RGB888
+                     || cf == LV_COLOR_FORMAT_RGB565
+                     || cf == LV_COLOR_FORMAT_A8
+                     || cf == LV_COLOR_FORMAT_L8;
+    if(!supported) return NULL;
+
+    bool weighted = cf == LV_COLOR_FORMAT_ARGB8888 && !(decoded->header.flags & LV_IMAGE_FLAGS_PREMULTIPLIED);
+    int32_t src_w = decoded->header.w;
+    int32_t src_h = decoded->header.h;
+    int32_t w = (src_w + (1 << downscale) - 1) >> downscale;
+    int32_t h = (src_h + (1 << downscale) - 1) >> downscale;
+
+    lv_draw_buf_t * mipmap = lv_draw_buf_create(w, h, cf, 0);
+    if(mipmap == NULL) return NULL;
+
+    /*B, G, R, A sums of the blocks in a row*/
+    uint32_t * sums = lv_malloc(w * 4 * sizeof(uint32_t));
+    if(sums == NULL) {
+        lv_draw_buf_destroy(mipmap);
+        return NULL;
+    }
+
+    int32_t y;
+    for(y = 0; y < h; y++) {
+        lv_memzero(sums, w * 4 * sizeof(uint32_t));
+        int32_t sy1 = y << downscale;
+        int32_t sy2 = LV_MIN(sy1 + (1 << downscale), src_h);
+        int32_t sy;
+        for(sy = sy1; sy < sy2; sy++) {
+            const uint8_t * row = decoded->data + sy * decoded->header.stride;
+            lv_image_decoder_downscale_add_row(sums, row, src_w, cf, weighted, downscale);
+        }
+
+        uint8_t * dest = mipmap->data + y * mipmap->header.stride;
+        lv_image_decoder_downscale_write_row(dest, sums, src_w, sy2 - sy1, cf, weighted, downscale);
+    }
+
+    lv_free(sums);
+
+    mipmap->header.flags |= decoded->header.flags & LV_IMAGE_FLAGS_PREMULTIPLIED;
+    return mipmap;
+}
+#endif /*LV_USE_IMAGE_MIPMAP*/
@@ -25,6 +25,15 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+/*The images can be decoded halved at most this many times, i.e. to 1/8 size like the JPEG DCT scaling*/
+#define LV_IMAGE_DECODER_DOWNSCALE_MAX 3
+
+/*Whether the indexed images are kept indexed with the default args, see `LV_DRAW_SW_KEEP_INDEXED`*/
+#if LV_USE_DRAW_SW && LV_DRAW_SW_KEEP_INDEXED
+#define LV_IMAGE_DECODER_USE_INDEXED_DEF true
+#else
+#define LV_IMAGE_DECODER_USE_INDEXED_DEF false
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -56,13 +65,18 @@ typedef struct _lv_image_decoder_dsc_t lv_image_decoder_dsc_t;
  * args are used.
  *
  * Default args:
- * all field are zero or false.
+ * all field are zero or false, except `stride_align` and `use_indexed` (see `LV_IMAGE_DECODER_USE_INDEXED_DEF`).
  */
 typedef struct _lv_image_decoder_args_t {
     bool stride_align;      /*Whether stride should be aligned*/
     bool premultiply;       /*Whether image should be premultiplied or not after decoding*/
     bool no_cache;          /*When set, decoded image won't be put to cache, and decoder open will also ignore cache.*/
     bool use_indexed;       /*Decoded indexed image as is. Convert to ARGB8888 if false.*/
+
+    /*The size the image will be drawn at. The decoders which support it decode a downscaled image
+     *which is still at least this large. 0: the original size. See `lv_image_decoder_get_downscale()`*/
+    int32_t target_w;
+    int32_t target_h;
 } lv_image_decoder_args_t;
 
 /**
@@ -119,6 +133,8 @@ typedef struct _lv_image_decoder_cache_data_t {
 
     const void * src;
     lv_image_src_t src_type;
+    uint8_t downscale;          /*The decoded image is halved this many times*/
+    uint8_t core_created;       /*Created by LVGL (e.g. a mipmap), not by `decoder`, so it's free'ed in the general way*/
 
     const lv_draw_buf_t * decoded;
     const lv_image_decoder_t * decoder;
@@ -304,6 +320,51 @@ lv_cache_entry_t * lv_image_decoder_add_to_cache(lv_image_decoder_t * decoder,
  */
 lv_draw_buf_t * lv_image_decoder_post_process(lv_image_decoder_dsc_t * dsc, lv_draw_buf_t * decoded);
 
+/**
+ * Check if a decoder should decode an image in bands of rows in its `get_area_cb` instead of
+ * decoding the whole image in `open_cb`. It's true if the image is larger than
+ * `LV_IMAGE_DECODER_STREAM_THRESHOLD` or if it wouldn't fit into the image cache anyway.
+ * @param dsc           pointer to a decoder descriptor
+ * @param decoded_size  size of the whole decoded image in bytes
+ * @return              true: decode the image in bands and don't add it to the cache
+ */
+bool lv_image_decoder_is_streamed(const lv_image_decoder_dsc_t * dsc, uint32_t decoded_size);
+
+/**
+ * Get how many times a decoder should halve the image to get closer to the target size in `args`
+ * without going below it. The decoders which support downscaling decode `ceil(w / 2^n)` x `ceil(h / 2^n)`
+ * pixels and set `downscale` to `n` when they add the image to the cache.
+ * @param dsc       pointer to a decoder descriptor with the `header` set
+ * @return          0..LV_IMAGE_DECODER_DOWNSCALE_MAX
+ */
+uint32_t lv_image_decoder_get_downscale(const lv_image_decoder_dsc_t * dsc);
+
+/**
+ * Add a row of pixels to the sums of the `2^downscale` wide blocks to average them with
+ * `lv_image_decoder_downscale_write_row()`. Supports ARGB8888, XRGB8888, RGB888, RGB565, A8 and L8.
+ * @param sums      B, G, R, A sums of each block, `4 * ceil(w / 2^downscale)` values zeroed before the first row
+ * @param row       the pixels of a row
+ * @param w         number of pixels in the row
+ * @param cf        color format of the pixels
+ * @param weighted  true: weight the colors by their opacity (not premultiplied ARGB8888)
+ * @param downscale halve the row this many times
+ */
+void lv_image_decoder_downscale_add_row(uint32_t * sums, const uint8_t * row, int32_t w, lv_color_format_t cf,
+                                        bool weighted, uint32_t downscale);
+
+/**
+ * Write the average of the blocks summed with `lv_image_decoder_downscale_add_row()`
+ * @param dest      the downscaled row
+ * @param sums      B, G, R, A sums of the blocks
+ * @param w         number of pixels in the original rows
+ * @param row_cnt   number of rows added to the sums
+ * @param cf        color format of the pixels
+ * @param weighted  true: the colors were weighted by their opacity
+ * @param downscale halve the row this many times
+ */
+void lv_image_decoder_downscale_write_row(uint8_t * dest, const uint32_t * sums, int32_t w, int32_t row_cnt,
+                                          lv_color_format_t cf, bool weighted, uint32_t downscale);
+
 /**********************
  *      MACROS
  **********************/
@@ -0,0 +1,601 @@
+/**
+ * @file lv_image_decoder_async.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_image_decoder_async.h"
+#if LV_USE_IMAGE_DECODER_ASYNC
+
+#include "lv_image_decoder.h"
+#include "lv_draw_image.h"
+#include "../core/lv_global.h"
+#include "../core/lv_refr.h"
+#include "../display/lv_display.h"
+#include "../display/lv_display_private.h"
+#include "../misc/lv_assert.h"
+#include "../misc/lv_ll.h"
+#include "../misc/lv_timer.h"
+#include "../osal/lv_os.h"
+#include "../stdlib/lv_mem.h"
+#include "../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define async_ctx LV_GLOBAL_DEFAULT()->img_decoder_async
+#define img_cache_p (LV_GLOBAL_DEFAULT()->img_cache)
+
+/*The decoders can use a lot of stack (e.g. libpng)*/
+#define WORKER_STACK_SIZE   (32 * 1024)
+
+/*Check the finished images this often*/
+#define DONE_TIMER_PERIOD   30
+
+/*The images to draw are decoded before the prefetched ones*/
+#define JOB_PRIO_DRAW       (LV_IMAGE_CACHE_PREFETCH_PRIO_HIGH + 1)
+
+/*Remember this many areas per image where the placeholder was drawn. More areas are merged.*/
+#define PLACEHOLDER_AREA_MAX    8
+
+/*Remember this many sources which can't be cached*/
+#define SYNC_SRC_MAX        16
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_display_t * disp;
+    lv_area_t area;
+} placeholder_area_t;
+
+typedef struct {
+    const void * src;           /**< File names are duplicated*/
+    lv_image_src_t src_type;
+    uint8_t prio;               /**< `lv_image_cache_prefetch_prio_t` or `JOB_PRIO_DRAW`*/
+    bool running;               /**< A worker is decoding it*/
+    lv_ll_t placeholder_ll;     /**< `placeholder_area_t`: the areas to invalidate when it's decoded*/
+} async_src_t;
+
+typedef enum {
+    ENQUEUE_FAILED,             /**< Draw it directly*/
+    ENQUEUE_ADDED,
+    ENQUEUE_PENDING,            /**< It was already queued*/
+} enqueue_res_t;
+
+typedef struct {
+    struct _lv_image_decoder_async_t * ctx;
+    lv_thread_t thread;
+    lv_thread_sync_t sync;
+} async_worker_t;
+
+typedef struct _lv_image_decoder_async_t {
+    bool enabled;
+    uint32_t worker_cnt;        /**< Number of the started workers*/
+    volatile bool exit;
+    lv_mutex_t lock;            /**< Protects the lists*/
+    lv_ll_t job_ll;             /**< The queued and running decodes*/
+    lv_ll_t done_ll;            /**< The decoded sources whose placeholders need to be invalidated*/
+    lv_ll_t sync_ll;            /**< The recently seen sources which can't be cached so they are opened by the
+                                 *   draw directly. The most recent is the head.*/
+    lv_timer_t * timer;         /**< Invalidates the decoded images*/
+    async_worker_t workers[LV_IMAGE_DECODER_ASYNC_WORKER_CNT];
+} lv_image_decoder_async_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static enqueue_res_t enqueue(lv_image_decoder_async_t * ctx, const void * src, lv_image_src_t src_type,
+                             uint8_t prio, const placeholder_area_t * placeholder);
+static bool placeholder_get_area(lv_layer_t * layer, const lv_area_t * coords, placeholder_area_t * placeholder);
+static void placeholder_add(async_src_t * job, const placeholder_area_t * placeholder);
+static void placeholder_invalidate(async_src_t * src);
+static void sync_add(lv_image_decoder_async_t * ctx, async_src_t * job);
+static void job_set_prio(lv_image_decoder_async_t * ctx, async_src_t * job, uint8_t prio);
+static uint32_t get_job_cnt(lv_image_decoder_async_t * ctx, uint8_t min_prio);
+static lv_result_t workers_start(lv_image_decoder_async_t * ctx);
+static void worker_thread_cb(void * ptr);
+static void decode(lv_image_decoder_async_t * ctx, async_src_t * job);
+static void done_timer_cb(lv_timer_t * timer);
+static bool is_slow_to_open(const void * src, lv_image_src_t src_type);
+static bool is_cached(const void * src, lv_image_src_t src_type, uint32_t downscale);
+static uint32_t get_downscale(const void * src, const lv_image_decoder_args_t * args);
+static async_src_t * find_src(lv_ll_t * ll, const void * src, lv_image_src_t src_type);
+static bool src_equal(const void * src1, lv_image_src_t src_type1, const void * src2, lv_image_src_t src_type2);
+static void src_free(async_src_t * item);
+static void free_src_ll(lv_ll_t * ll);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_image_decoder_async_init(void)
+{
+    lv_image_decoder_async_t * ctx = lv_malloc_zeroed(sizeof(lv_image_decoder_async_t));
+    LV_ASSERT_MALLOC(ctx);
+    if(ctx == NULL) return;
+
+    lv_mutex_init(&ctx->lock);
+    _lv_ll_init(&ctx->job_ll, sizeof(async_src_t));
+    _lv_ll_init(&ctx->done_ll, sizeof(async_src_t));
+    _lv_ll_init(&ctx->sync_ll, sizeof(async_src_t));
+
+    ctx->timer = lv_timer_create(done_timer_cb, DONE_TIMER_PERIOD, ctx);
+    LV_ASSERT_MALLOC(ctx->timer);
+    lv_timer_pause(ctx->timer);
+
+    async_ctx = ctx;
+}
+
+void _lv_image_decoder_async_deinit(void)
+{
+    lv_image_decoder_async_t * ctx = async_ctx;
+    if(ctx == NULL) return;
+
+    ctx->exit = true;
+    uint32_t i;
+    for(i = 0; i < ctx->worker_cnt; i++) {
+        lv_thread_sync_signal(&ctx->workers[i].sync);
+        lv_thread_delete(&ctx->workers[i].thread);
+        lv_thread_sync_delete(&ctx->workers[i].sync);
+    }
+
+    if(ctx->timer) lv_timer_delete(ctx->timer);
+
+    free_src_ll(&ctx->job_ll);
+    free_src_ll(&ctx->done_ll);
+    free_src_ll(&ctx->sync_ll);
+    lv_mutex_delete(&ctx->lock);
+    lv_free(ctx);
+
+    async_ctx = NULL;
+}
+
+void lv_image_decoder_async_set_enabled(bool en)
+{
+    lv_image_decoder_async_t * ctx = async_ctx;
+    if(ctx) ctx->enabled = en;
+}
+
+bool lv_image_decoder_async_is_enabled(void)
+{
+    lv_image_decoder_async_t * ctx = async_ctx;
+    return ctx ? ctx->enabled : false;
+}
+
+bool lv_image_decoder_async_request(const void * src, const lv_image_decoder_args_t * args, lv_layer_t * layer,
+                                    const lv_area_t * coords)
+{
+    lv_image_decoder_async_t * ctx = async_ctx;
+    if(ctx == NULL || ctx->timer == NULL || !ctx->enabled) return false;
+
+    placeholder_area_t placeholder;
+    if(layer && !placeholder_get_area(layer, coords, &placeholder)) return false;
+
+    lv_image_src_t src_type = lv_image_src_get_type(src);
+    if(!is_slow_to_open(src, src_type)) return false;
+    if(is_cached(src, src_type, get_downscale(src, args))) return false;
+
+    return enqueue(ctx, src, src_type, JOB_PRIO_DRAW, layer ? &placeholder : NULL) != ENQUEUE_FAILED;
+}
+
+bool lv_image_decoder_async_prefetch(const void * src, lv_image_cache_prefetch_prio_t prio)
+{
+    lv_image_decoder_async_t * ctx = async_ctx;
+    if(ctx == NULL || ctx->timer == NULL) return false;
+
+    lv_image_src_t src_type = lv_image_src_get_type(src);
+    if(!is_slow_to_open(src, src_type)) return false;
+    if(is_cached(src, src_type, 0)) return false;
+
+    return enqueue(ctx, src, src_type, (uint8_t)prio, NULL) == ENQUEUE_ADDED;
+}
+
+uint32_t lv_image_decoder_async_get_pending_cnt(void)
+{
+    lv_image_decoder_async_t * ctx = async_ctx;
+    if(ctx == NULL) return 0;
+
+    lv_mutex_lock(&ctx->lock);
+    uint32_t cnt = _lv_ll_get_len(&ctx->job_ll);
+    lv_mutex_unlock(&ctx->lock);
+
+    return cnt;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Add a source to the queue or raise the priority of its job if it's already queued.
+ * @param placeholder   the area where a placeholder is drawn instead of the image or NULL
+ * @return              ENQUEUE_ADDED or ENQUEUE_PENDING if the source is being decoded
+ */
+static enqueue_res_t enqueue(lv_image_decoder_async_t * ctx, const void * src, lv_image_src_t src_type,
+                             uint8_t prio, const placeholder_area_t * placeholder)
+{
+    lv_mutex_lock(&ctx->lock);
+    async_src_t * sync = find_src(&ctx->sync_ll, src, src_type);
+    if(sync) {
+        _lv_ll_move_before(&ctx->sync_ll, sync, _lv_ll_get_head(&ctx->sync_ll));
+        lv_mutex_unlock(&ctx->lock);
+        return ENQUEUE_FAILED;
+    }
+
+    async_src_t * job = find_src(&ctx->job_ll, src, src_type);
+    if(job) {
+        job_set_prio(ctx, job, prio);
+        if(placeholder) placeholder_add(job, placeholder);
+        lv_mutex_unlock(&ctx->lock);
+        return ENQUEUE_PENDING;
+    }
+
+    /*A worker might have finished it since the caller checked the cache.
+     *The workers add the original sized images to the cache before removing their job.*/
+    if(is_cached(src, src_type, 0)) {
+        lv_mutex_unlock(&ctx->lock);
+        return ENQUEUE_FAILED;
+    }
+
+    /*Draw it directly instead of waiting too long. The prefetches count the images to draw too,
+     *so they can't fill the queue while the images to draw are still waiting.*/
+    uint8_t min_prio = prio == JOB_PRIO_DRAW ? JOB_PRIO_DRAW : 0;
+    if(get_job_cnt(ctx, min_prio) >= LV_IMAGE_DECODER_ASYNC_QUEUE_DEPTH) {
+        lv_mutex_unlock(&ctx->lock);
+        return ENQUEUE_FAILED;
+    }
+
+    const void * src_dup = src_type == LV_IMAGE_SRC_FILE ? lv_strdup(src) : src;
+    job = src_dup ? _lv_ll_ins_tail(&ctx->job_ll) : NULL;
+    if(job == NULL) {
+        if(src_dup != src) lv_free((void *)src_dup);
+        lv_mutex_unlock(&ctx->lock);
+        return ENQUEUE_FAILED;
+    }
+
+    job->src = src_dup;
+    job->src_type = src_type;
+    job->prio = 0;
+    job->running = false;
+    _lv_ll_init(&job->placeholder_ll, sizeof(placeholder_area_t));
+    job_set_prio(ctx, job, prio);
+    if(placeholder) placeholder_add(job, placeholder);
+    lv_mutex_unlock(&ctx->lock);
+
+    if(workers_start(ctx) != LV_RESULT_OK) {
+        lv_mutex_lock(&ctx->lock);
+        _lv_ll_remove(&ctx->job_ll, job);
+        lv_mutex_unlock(&ctx->lock);
+        src_free(job);
+        lv_free(job);
+        return ENQUEUE_FAILED;
+    }
+
+    lv_timer_resume(ctx->timer);
+    uint32_t i;
+    for(i = 0; i < ctx->worker_cnt; i++) {
+        lv_thread_sync_signal(&ctx->workers[i].sync);
+    }
+
+    return ENQUEUE_ADDED;
+}
+
+/**
+ * Raise the priority of a job and move it before the waiting jobs having lower priority.
+ * The jobs are ordered by priority, so the workers take the first not running job.
+ */
+static void job_set_prio(lv_image_decoder_async_t * ctx, async_src_t * job, uint8_t prio)
+{
+    if(job->prio > prio) return;
+    job->prio = prio;
+    if(job->running) return;
+
+    async_src_t * next;
+    _LV_LL_READ(&ctx->job_ll, next) {
+        if(next == job) return;
+        if(!next->running && next->prio < prio) break;
+    }
+
+    _lv_ll_move_before(&ctx->job_ll, job, next);
+}
+
+static uint32_t get_job_cnt(lv_image_decoder_async_t * ctx, uint8_t min_prio)
+{
+    uint32_t cnt = 0;
+    async_src_t * job;
+    _LV_LL_READ(&ctx->job_ll, job) {
+        if(job->prio >= min_prio) cnt++;
+    }
+
+    return cnt;
+}
+
+/**
+ * Start the workers on the first request. If not all of them can be created, use the ones which are started.
+ */
+static lv_result_t workers_start(lv_image_decoder_async_t * ctx)
+{
+    while(ctx->worker_cnt < LV_IMAGE_DECODER_ASYNC_WORKER_CNT) {
+        async_worker_t * worker = &ctx->workers[ctx->worker_cnt];
+        worker->ctx = ctx;
+        lv_thread_sync_init(&worker->sync);
+        if(lv_thread_init(&worker->thread, LV_THREAD_PRIO_LOW, worker_thread_cb, WORKER_STACK_SIZE,
+                          worker) != LV_RESULT_OK) {
+            LV_LOG_WARN("couldn't create an image decoder worker thread");
+            lv_thread_sync_delete(&worker->sync);
+            break;
+        }
+        ctx->worker_cnt++;
+    }
+
+    return ctx->worker_cnt > 0 ? LV_RESULT_OK : LV_RESULT_INVALID;
+}
+
+static void worker_thread_cb(void * ptr)
+{
+    async_worker_t * worker = ptr;
+    lv_image_decoder_async_t * ctx = worker->ctx;
+
+    while(!ctx->exit) {
+        lv_mutex_lock(&ctx->lock);
+        async_src_t * job;
+        _LV_LL_READ(&ctx->job_ll, job) {
+            if(!job->running) break;
+        }
+        if(job) job->running = true;
+        lv_mutex_unlock(&ctx->lock);
+
+        if(job) decode(ctx, job);
+        else lv_thread_sync_wait(&worker->sync);
+    }
+}
+
+/**
+ * Open the image to add it to the cache. Only this worker uses the job while it's running.
+ */
+static void decode(lv_image_decoder_async_t * ctx, async_src_t * job)
+{
+    bool cached = false;
+    lv_image_decoder_dsc_t decoder_dsc;
+    if(lv_image_decoder_open(&decoder_dsc, job->src, NULL) == LV_RESULT_OK) {
+        cached = decoder_dsc.cache_entry != NULL;
+        lv_image_decoder_close(&decoder_dsc);
+    }
+
+    lv_mutex_lock(&ctx->lock);
+    _lv_ll_remove(&ctx->job_ll, job);
+
+    /*If it's not in the cache the draw would wait for it anyway, so open it directly next time*/
+    if(!cached) sync_add(ctx, job);
+    else if(job->src_type == LV_IMAGE_SRC_FILE) lv_free((void *)job->src);
+
+    /*Redraw the placeholders with the decoded image. Only the areas are needed for it.*/
+    async_src_t * done = _lv_ll_get_head(&job->placeholder_ll) ? _lv_ll_ins_tail(&ctx->done_ll) : NULL;
+    if(done) {
+        *done = *job;
+        done->src = NULL;
+        done->src_type = LV_IMAGE_SRC_UNKNOWN;
+    }
+    else {
+        _lv_ll_clear(&job->placeholder_ll);
+    }
+    lv_free(job);
+    lv_mutex_unlock(&ctx->lock);
+}
+
+/**
+ * Invalidate the placeholders of the images which are decoded since the last call
+ */
+static void done_timer_cb(lv_timer_t * timer)
+{
+    lv_image_decoder_async_t * ctx = lv_timer_get_user_data(timer);
+
+    while(1) {
+        lv_mutex_lock(&ctx->lock);
+        async_src_t * done = _lv_ll_get_head(&ctx->done_ll);
+        if(done == NULL) {
+            if(_lv_ll_get_head(&ctx->job_ll) == NULL) lv_timer_pause(timer);
+            lv_mutex_unlock(&ctx->lock);
+            break;
+        }
+        async_src_t src = *done;
+        _lv_ll_remove(&ctx->done_ll, done);
+        lv_free(done);
+        lv_mutex_unlock(&ctx->lock);
+
+        placeholder_invalidate(&src);
+        src_free(&src);
+    }
+}
+
+/**
+ * Get where the placeholder of an image will be visible.
+ * @param layer         the layer to draw the placeholder on
+ * @param coords        the area covered by the transformed image
+ * @param placeholder   store the display and the area to invalidate here
+ * @return              true: the layer belongs to the display being refreshed; false: e.g. it's a canvas
+ *                      which won't be redrawn so the image should be drawn directly
+ */
+static bool placeholder_get_area(lv_layer_t * layer, const lv_area_t * coords, placeholder_area_t * placeholder)
+{
+    lv_display_t * disp = _lv_refr_get_disp_refreshing();
+    if(disp == NULL) return false;
+
+    lv_layer_t * root = layer;
+    while(root->parent) root = root->parent;
+    if(root != disp->layer_head) return false;
+
+    placeholder->disp = disp;
+    if(layer == root) {
+        if(!_lv_area_intersect(&placeholder->area, coords, &layer->_clip_area)) return false;
+    }
+    else {
+        /*The layer can be transformed so use the area of its parent being redrawn*/
+        placeholder->area = root->_clip_area;
+    }
+
+    return true;
+}
+
+/**
+ * Remember an area to invalidate when the image of a job is decoded
+ */
+static void placeholder_add(async_src_t * job, const placeholder_area_t * placeholder)
+{
+    uint32_t cnt = 0;
+    placeholder_area_t * last_same_disp = NULL;
+    placeholder_area_t * item;
+    _LV_LL_READ(&job->placeholder_ll, item) {
+        if(item->disp != placeholder->disp) continue;
+        if(_lv_area_is_in(&placeholder->area, &item->area, 0)) return;
+        last_same_disp = item;
+        cnt++;
+    }
+
+    if(cnt >= PLACEHOLDER_AREA_MAX) {
+        _lv_area_join(&last_same_disp->area, &last_same_disp->area, &placeholder->area);
+        return;
+    }
+
+    item = _lv_ll_ins_tail(&job->placeholder_ll);
+    if(item) *item = *placeholder;
+}
+
+/**
+ * Invalidate the areas where the placeholder of an image was drawn, if their display still exists
+ */
+static void placeholder_invalidate(async_src_t * src)
+{
+    placeholder_area_t * item;
+    _LV_LL_READ(&src->placeholder_ll, item) {
+        lv_display_t * disp = lv_display_get_next(NULL);
+        while(disp && disp != item->disp) disp = lv_display_get_next(disp);
+        if(disp) _lv_inv_area(disp, &item->area);
+    }
+}
+
+/**
+ * Remember a source which can't be cached. Forget the least recently seen ones if there are too many.
+ * The source of the job is taken over.
+ */
+static void sync_add(lv_image_decoder_async_t * ctx, async_src_t * job)
+{
+    async_src_t * sync = _lv_ll_ins_head(&ctx->sync_ll);
+    if(sync == NULL) {
+        if(job->src_type == LV_IMAGE_SRC_FILE) lv_free((void *)job->src);
+        return;
+    }
+
+    *sync = *job;
+    sync->running = false;
+    _lv_ll_init(&sync->placeholder_ll, sizeof(placeholder_area_t));
+
+    if(_lv_ll_get_len(&ctx->sync_ll) > SYNC_SRC_MAX) {
+        async_src_t * oldest = _lv_ll_get_tail(&ctx->sync_ll);
+        _lv_ll_remove(&ctx->sync_ll, oldest);
+        src_free(oldest);
+        lv_free(oldest);
+    }
+}
+
+/**
+ * Not compressed C arrays and symbols are used directly so there is nothing to wait for
+ */
+static bool is_slow_to_open(const void * src, lv_image_src_t src_type)
+{
+    if(src_type == LV_IMAGE_SRC_FILE) return true;
+    if(src_type != LV_IMAGE_SRC_VARIABLE) return false;
+
+    const lv_image_dsc_t * img_dsc = src;
+    return (img_dsc->header.flags & LV_IMAGE_FLAGS_COMPRESSED) ||
+           img_dsc->header.cf == LV_COLOR_FORMAT_RAW ||
+           img_dsc->header.cf == LV_COLOR_FORMAT_RAW_ALPHA;
+}
+
+/**
+ * Check if the image is cached at a size which is opened without decoding.
+ * @param downscale     the downscaled version requested by the draw. The original size is good too,
+ *                      as the decoders fall back to it, and it's what the workers decode.
+ */
+static bool is_cached(const void * src, lv_image_src_t src_type, uint32_t downscale)
+{
+    lv_image_cache_data_t search_key;
+    lv_memzero(&search_key, sizeof(search_key));
+    search_key.src = src;
+    search_key.src_type = src_type;
+    search_key.downscale = (uint8_t)downscale;
+
+    lv_cache_entry_t * entry = lv_cache_acquire(img_cache_p, &search_key, NULL);
+    if(entry == NULL && downscale > 0) {
+        search_key.downscale = 0;
+        entry = lv_cache_acquire(img_cache_p, &search_key, NULL);
+    }
+
+    if(entry == NULL) return false;
+
+    lv_cache_release(img_cache_p, entry, NULL);
+    return true;
+}
+
+/**
+ * Get the downscaled version which is looked up first by opening the image with `args`
+ */
+static uint32_t get_downscale(const void * src, const lv_image_decoder_args_t * args)
+{
+    if(args == NULL || (args->target_w <= 0 && args->target_h <= 0)) return 0;
+
+    lv_image_decoder_dsc_t dsc;
+    lv_memzero(&dsc, sizeof(dsc));
+    if(lv_image_decoder_get_info(src, &dsc.header) != LV_RESULT_OK) return 0;
+    dsc.args = *args;
+
+    return lv_image_decoder_get_downscale(&dsc);
+}
+
+static async_src_t * find_src(lv_ll_t * ll, const void * src, lv_image_src_t src_type)
+{
+    async_src_t * item;
+    _LV_LL_READ(ll, item) {
+        if(src_equal(item->src, item->src_type, src, src_type)) return item;
+    }
+
+    return NULL;
+}
+
+static bool src_equal(const void * src1, lv_image_src_t src_type1, const void * src2, lv_image_src_t src_type2)
+{
+    if(src_type1 != src_type2) return false;
+    if(src_type1 == LV_IMAGE_SRC_FILE) return lv_strcmp(src1, src2) == 0;
+    return src1 == src2;
+}
+
+/**
+ * Free the duplicated file name and the placeholder areas of a source
+ */
+static void src_free(async_src_t * item)
+{
+    if(item->src_type == LV_IMAGE_SRC_FILE) lv_free((void *)item->src);
+    _lv_ll_clear(&item->placeholder_ll);
+}
+
+static void free_src_ll(lv_ll_t * ll)
+{
+    async_src_t * item;
+    _LV_LL_READ(ll, item) {
+        src_free(item);
+    }
+    _lv_ll_clear(ll);
+}
+
+#endif /*LV_USE_IMAGE_DECODER_ASYNC*/
@@ -0,0 +1,114 @@
+/**
+ * @file lv_image_decoder_async.h
+ *
+ */
+
+#ifndef LV_IMAGE_DECODER_ASYNC_H
+#define LV_IMAGE_DECODER_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "../misc/lv_area.h"
+#include "../misc/cache/lv_image_cache.h"
+#include "lv_image_decoder.h"
+
+#if LV_USE_OS == LV_OS_NONE
+#error "LV_USE_IMAGE_DECODER_ASYNC requires LV_USE_OS"
+#endif
+
+#if LV_CACHE_DEF_SIZE == 0
+#error "LV_USE_IMAGE_DECODER_ASYNC requires LV_CACHE_DEF_SIZE > 0"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the asynchronous image decoding. Called by `lv_init()`.
+ */
+void _lv_image_decoder_async_init(void);
+
+/**
+ * Stop the workers and free the queues. Called by `lv_deinit()`.
+ */
+void _lv_image_decoder_async_deinit(void);
+
+/**
+ * Enable or disable asynchronous image decoding. It's disabled by default.
+ * When enabled, images which are not in the cache are decoded by worker threads
+ * and a placeholder is drawn meanwhile. The areas where the placeholder was drawn
+ * are invalidated when the image is decoded.
+ * @param en        true: enable; false: disable
+ */
+void lv_image_decoder_async_set_enabled(bool en);
+
+/**
+ * Check if asynchronous image decoding is enabled
+ * @return          true: enabled
+ */
+bool lv_image_decoder_async_is_enabled(void);
+
+/**
+ * Check if an image is ready to be drawn. If it needs to be decoded, queue it for the workers.
+ * Sources which are fast to open (e.g. not compressed C arrays), or which can't be cached,
+ * are always drawn directly. If the queue is full the image is drawn directly too.
+ * @param src       the image source
+ * @param args      the args the image will be opened with or NULL. Only the cached images decoded
+ *                  at the size requested by `target_w/h` or at the original size are ready.
+ * @param layer     the layer to draw the image on. The visible part of `coords` is invalidated
+ *                  when the image is decoded. Images on layers which are not refreshed by a display
+ *                  (e.g. a canvas) are drawn directly. NULL to only queue the image.
+ * @param coords    the area covered by the image with its transformation (rotation, scale), i.e.
+ *                  where the placeholder is drawn
+ * @return          true: the image is being decoded, draw a placeholder instead of it
+ */
+bool lv_image_decoder_async_request(const void * src, const lv_image_decoder_args_t * args, lv_layer_t * layer,
+                                    const lv_area_t * coords);
+
+/**
+ * Queue an image to be decoded into the cache before it's drawn. It works even if
+ * the asynchronous drawing is disabled. Use `lv_image_cache_prefetch()` instead to respect the cache size.
+ * @param src       the image source
+ * @param prio      priority of the decoding. The images to draw are decoded first anyway.
+ * @return          true: the image is queued; false: it's already cached or queued, fast to open
+ *                  or `LV_IMAGE_DECODER_ASYNC_QUEUE_DEPTH` images are already waiting
+ */
+bool lv_image_decoder_async_prefetch(const void * src, lv_image_cache_prefetch_prio_t prio);
+
+/**
+ * Get the number of images being decoded or waiting for a worker
+ * @return          the number of pending images
+ */
+uint32_t lv_image_decoder_async_get_pending_cnt(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_IMAGE_DECODER_ASYNC*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_IMAGE_DECODER_ASYNC_H*/
@@ -12,6 +12,9 @@
 /*********************
  *      DEFINES
  *********************/
+#if LV_USE_DRAW_SW && LV_DRAW_SW_KEEP_INDEXED
+    #error "Dave2D can't draw indexed images. Disable LV_DRAW_SW_KEEP_INDEXED"
+#endif
 
 /**********************
  *      TYPEDEFS
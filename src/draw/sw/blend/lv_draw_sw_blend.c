@@ -10,12 +10,16 @@
 #include "lv_draw_sw_blend_to_rgb565.h"
 #include "lv_draw_sw_blend_to_argb8888.h"
 #include "lv_draw_sw_blend_to_rgb888.h"
+#include "../../../stdlib/lv_mem.h"
+#include "../../../misc/lv_math.h"
 
 #if LV_USE_DRAW_SW
 
 /*********************
  *      DEFINES
  *********************/
+/*Convert this many bytes of indexed images to ARGB8888 at once. It's on the stack of the draw unit.*/
+#define INDEXED_BUF_SIZE    1024
 
 /**********************
  *      TYPEDEFS
@@ -24,6 +28,12 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void blend_image(lv_color_format_t dest_cf, _lv_draw_sw_blend_image_dsc_t * image_dsc);
+static void blend_indexed(lv_color_format_t dest_cf, _lv_draw_sw_blend_image_dsc_t * image_dsc,
+                          const lv_draw_sw_blend_dsc_t * blend_dsc, const lv_area_t * blend_area);
+static void indexed_line_to_argb8888(lv_color32_t * dest, const uint8_t * src, const lv_color32_t * palette,
+                                     uint32_t bpp, int32_t x, int32_t w);
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -108,12 +118,6 @@ void lv_draw_sw_blend(lv_draw_unit_t * draw_unit, const lv_draw_sw_blend_dsc_t *
         image_dsc.src_stride = blend_dsc->src_stride;
         image_dsc.src_color_format = blend_dsc->src_color_format;
 
-        const uint8_t * src_buf = blend_dsc->src_buf;
-        uint32_t src_px_size = lv_color_format_get_size(blend_dsc->src_color_format);
-        src_buf += image_dsc.src_stride * (blend_area.y1 - blend_dsc->src_area->y1);
-        src_buf += (blend_area.x1 - blend_dsc->src_area->x1) * src_px_size;
-        image_dsc.src_buf = src_buf;
-
         if(blend_dsc->mask_buf == NULL) image_dsc.mask_buf = NULL;
         else if(blend_dsc->mask_res == LV_DRAW_SW_MASK_RES_FULL_COVER) image_dsc.mask_buf = NULL;
         else image_dsc.mask_buf = blend_dsc->mask_buf;
@@ -128,29 +132,142 @@ void lv_draw_sw_blend(lv_draw_unit_t * draw_unit, const lv_draw_sw_blend_dsc_t *
         image_dsc.dest_buf = lv_draw_layer_go_to_xy(layer, blend_area.x1 - layer->buf_area.x1,
                                                     blend_area.y1 - layer->buf_area.y1);
 
-        switch(layer->color_format) {
-            case LV_COLOR_FORMAT_RGB565:
-            case LV_COLOR_FORMAT_RGB565A8:
-                lv_draw_sw_blend_image_to_rgb565(&image_dsc);
-                break;
-            case LV_COLOR_FORMAT_ARGB8888:
-                lv_draw_sw_blend_image_to_argb8888(&image_dsc);
-                break;
-            case LV_COLOR_FORMAT_RGB888:
-                lv_draw_sw_blend_image_to_rgb888(&image_dsc, 3);
-                break;
-            case LV_COLOR_FORMAT_XRGB8888:
-                lv_draw_sw_blend_image_to_rgb888(&image_dsc, 4);
-                break;
-            default:
-                break;
+        if(LV_COLOR_FORMAT_IS_INDEXED(blend_dsc->src_color_format)) {
+            blend_indexed(layer->color_format, &image_dsc, blend_dsc, &blend_area);
+        }
+        else {
+            const uint8_t * src_buf = blend_dsc->src_buf;
+            uint32_t src_px_size = lv_color_format_get_size(blend_dsc->src_color_format);
+            src_buf += image_dsc.src_stride * (blend_area.y1 - blend_dsc->src_area->y1);
+            src_buf += (blend_area.x1 - blend_dsc->src_area->x1) * src_px_size;
+            image_dsc.src_buf = src_buf;
+
+            blend_image(layer->color_format, &image_dsc);
         }
     }
     LV_PROFILER_END;
 }
 
+void lv_draw_sw_indexed_to_argb8888(void * dest_buf, int32_t dest_stride, const void * src_buf, int32_t src_stride,
+                                    lv_color_format_t src_cf, const lv_area_t * src_area)
+{
+    const lv_color32_t * palette = src_buf;
+    const uint8_t * src_u8 = src_buf;
+    src_u8 += LV_COLOR_INDEXED_PALETTE_SIZE(src_cf) * sizeof(lv_color32_t);
+    src_u8 += src_stride * src_area->y1;
+
+    uint8_t * dest_u8 = dest_buf;
+    uint32_t bpp = lv_color_format_get_bpp(src_cf);
+    int32_t w = lv_area_get_width(src_area);
+    int32_t y;
+    for(y = src_area->y1; y <= src_area->y2; y++) {
+        indexed_line_to_argb8888((lv_color32_t *)dest_u8, src_u8, palette, bpp, src_area->x1, w);
+        src_u8 += src_stride;
+        dest_u8 += dest_stride;
+    }
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+static void blend_image(lv_color_format_t dest_cf, _lv_draw_sw_blend_image_dsc_t * image_dsc)
+{
+    switch(dest_cf) {
+        case LV_COLOR_FORMAT_RGB565:
+        case LV_COLOR_FORMAT_RGB565A8:
+            lv_draw_sw_blend_image_to_rgb565(image_dsc);
+            break;
+        case LV_COLOR_FORMAT_ARGB8888:
+            lv_draw_sw_blend_image_to_argb8888(image_dsc);
+            break;
+        case LV_COLOR_FORMAT_RGB888:
+            lv_draw_sw_blend_image_to_rgb888(image_dsc, 3);
+            break;
+        case LV_COLOR_FORMAT_XRGB8888:
+            lv_draw_sw_blend_image_to_rgb888(image_dsc, 4);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Convert tiles of an indexed image to ARGB8888 with the palette and blend them one by one.
+ * This way the indexed images can be cached and drawn without converting the whole image,
+ * and the callers blending row by row don't need to allocate anything.
+ */
+static void blend_indexed(lv_color_format_t dest_cf, _lv_draw_sw_blend_image_dsc_t * image_dsc,
+                          const lv_draw_sw_blend_dsc_t * blend_dsc, const lv_area_t * blend_area)
+{
+    lv_color32_t buf[INDEXED_BUF_SIZE / sizeof(lv_color32_t)];
+    int32_t buf_px = INDEXED_BUF_SIZE / sizeof(lv_color32_t);
+
+    int32_t w = image_dsc->dest_w;
+    int32_t h = image_dsc->dest_h;
+    int32_t tile_w = LV_MIN(w, buf_px);
+    int32_t tile_h = LV_CLAMP(1, buf_px / tile_w, h);
+    uint32_t buf_stride = tile_w * sizeof(lv_color32_t);
+    uint32_t dest_px_size = lv_color_format_get_size(dest_cf);
+
+    uint8_t * dest_buf = image_dsc->dest_buf;
+    const lv_opa_t * mask_buf = image_dsc->mask_buf;
+
+    /*The area of the image to convert*/
+    lv_area_t src_area = *blend_area;
+    lv_area_move(&src_area, -blend_dsc->src_area->x1, -blend_dsc->src_area->y1);
+
+    image_dsc->src_buf = buf;
+    image_dsc->src_stride = buf_stride;
+    image_dsc->src_color_format = LV_COLOR_FORMAT_ARGB8888;
+
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < h; y += tile_h) {
+        lv_area_t tile_area;
+        tile_area.y1 = src_area.y1 + y;
+        tile_area.y2 = tile_area.y1 + LV_MIN(tile_h, h - y) - 1;
+        image_dsc->dest_h = lv_area_get_height(&tile_area);
+
+        for(x = 0; x < w; x += tile_w) {
+            tile_area.x1 = src_area.x1 + x;
+            tile_area.x2 = tile_area.x1 + LV_MIN(tile_w, w - x) - 1;
+            lv_draw_sw_indexed_to_argb8888(buf, buf_stride, blend_dsc->src_buf, blend_dsc->src_stride,
+                                           blend_dsc->src_color_format, &tile_area);
+
+            image_dsc->dest_w = lv_area_get_width(&tile_area);
+            image_dsc->dest_buf = dest_buf + image_dsc->dest_stride * y + dest_px_size * x;
+            if(mask_buf) image_dsc->mask_buf = mask_buf + image_dsc->mask_stride * y + x;
+            blend_image(dest_cf, image_dsc);
+        }
+    }
+}
+
+static void indexed_line_to_argb8888(lv_color32_t * dest, const uint8_t * src, const lv_color32_t * palette,
+                                     uint32_t bpp, int32_t x, int32_t w)
+{
+    int32_t i;
+    if(bpp == 8) {
+        src += x;
+        for(i = 0; i < w; i++) {
+            dest[i] = palette[src[i]];
+        }
+        return;
+    }
+
+    /*The first pixel is in the most significant bits*/
+    uint32_t px_per_byte = 8 / bpp;
+    uint32_t mask = (1 << bpp) - 1;
+    int32_t shift = 8 - bpp - (x % px_per_byte) * bpp;
+    src += x / px_per_byte;
+    for(i = 0; i < w; i++) {
+        dest[i] = palette[(*src >> shift) & mask];
+        shift -= bpp;
+        if(shift < 0) {
+            shift = 8 - bpp;
+            src++;
+        }
+    }
+}
+
 #endif
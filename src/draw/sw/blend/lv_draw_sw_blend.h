@@ -80,6 +80,18 @@ typedef struct {
  */
 void lv_draw_sw_blend(lv_draw_unit_t * draw_unit, const lv_draw_sw_blend_dsc_t * dsc);
 
+/**
+ * Convert an area of an indexed image to ARGB8888 with its palette.
+ * @param dest_buf      ARGB8888 buffer to store the pixels of `src_area`
+ * @param dest_stride   stride of `dest_buf` in bytes
+ * @param src_buf       the indexed image starting with its palette
+ * @param src_stride    stride of the indices in bytes
+ * @param src_cf        LV_COLOR_FORMAT_I1/I2/I4/I8
+ * @param src_area      the area to convert relative to the image
+ */
+void lv_draw_sw_indexed_to_argb8888(void * dest_buf, int32_t dest_stride, const void * src_buf, int32_t src_stride,
+                                    lv_color_format_t src_cf, const lv_area_t * src_area);
+
 /**********************
  *      MACROS
  **********************/
@@ -34,6 +34,10 @@
  *********************/
 #define DRAW_UNIT_ID_SW     1
 
+/*The 90/270 degree rotations walk the image in square tiles
+ *so that the source columns and destination rows of a tile stay in the cache.*/
+#define ROTATE_TILE_SIZE    LV_DRAW_SW_ROTATE_TILE_SIZE
+
 #ifndef LV_DRAW_SW_RGB565_SWAP
     #define LV_DRAW_SW_RGB565_SWAP(...) LV_RESULT_INVALID
 #endif
@@ -460,12 +464,17 @@ static void rotate90_argb8888(const uint32_t * src, uint32_t * dst, int32_t srcW
     srcStride /= sizeof(uint32_t);
     dstStride /= sizeof(uint32_t);
 
-    for(int32_t x = 0; x < srcWidth; ++x) {
-        int32_t dstIndex = x * dstStride;
-        int32_t srcIndex = x;
-        for(int32_t y = 0; y < srcHeight; ++y) {
-            dst[dstIndex + (srcHeight - y - 1)] = src[srcIndex];
-            srcIndex += srcStride;
+    for(int32_t by = 0; by < srcHeight; by += ROTATE_TILE_SIZE) {
+        int32_t by_end = LV_MIN(by + ROTATE_TILE_SIZE, srcHeight);
+        for(int32_t bx = 0; bx < srcWidth; bx += ROTATE_TILE_SIZE) {
+            int32_t bx_end = LV_MIN(bx + ROTATE_TILE_SIZE, srcWidth);
+            for(int32_t x = bx; x < bx_end; ++x) {
+                int32_t srcIndex = by * srcStride + x;
+                for(int32_t y = by; y < by_end; ++y) {
+                    dst[x * dstStride + (srcHeight - y - 1)] = src[srcIndex];
+                    srcIndex += srcStride;
+                }
+            }
         }
     }
 }
@@ -500,12 +509,17 @@ static void rotate270_argb8888(const uint32_t * src, uint32_t * dst, int32_t src
     srcStride /= sizeof(uint32_t);
     dstStride /= sizeof(uint32_t);
 
-    for(int32_t x = 0; x < srcWidth; ++x) {
-        int32_t dstIndex = (srcWidth - x - 1);
-        int32_t srcIndex = x;
-        for(int32_t y = 0; y < srcHeight; ++y) {
-            dst[dstIndex * dstStride + y] = src[srcIndex];
-            srcIndex += srcStride;
+    for(int32_t by = 0; by < srcHeight; by += ROTATE_TILE_SIZE) {
+        int32_t by_end = LV_MIN(by + ROTATE_TILE_SIZE, srcHeight);
+        for(int32_t bx = 0; bx < srcWidth; bx += ROTATE_TILE_SIZE) {
+            int32_t bx_end = LV_MIN(bx + ROTATE_TILE_SIZE, srcWidth);
+            for(int32_t x = bx; x < bx_end; ++x) {
+                int32_t srcIndex = by * srcStride + x;
+                for(int32_t y = by; y < by_end; ++y) {
+                    dst[(srcWidth - x - 1) * dstStride + y] = src[srcIndex];
+                    srcIndex += srcStride;
+                }
+            }
         }
     }
 }
@@ -517,13 +531,19 @@ static void rotate90_rgb888(const uint8_t * src, uint8_t * dst, int32_t srcWidth
         return ;
     }
 
-    for(int32_t x = 0; x < srcWidth; ++x) {
-        for(int32_t y = 0; y < srcHeight; ++y) {
-            int32_t srcIndex = y * srcStride + x * 3;
-            int32_t dstIndex = (srcWidth - x - 1) * dstStride + y * 3;
-            dst[dstIndex] = src[srcIndex];       /*Red*/
-            dst[dstIndex + 1] = src[srcIndex + 1]; /*Green*/
-            dst[dstIndex + 2] = src[srcIndex + 2]; /*Blue*/
+    for(int32_t by = 0; by < srcHeight; by += ROTATE_TILE_SIZE) {
+        int32_t by_end = LV_MIN(by + ROTATE_TILE_SIZE, srcHeight);
+        for(int32_t bx = 0; bx < srcWidth; bx += ROTATE_TILE_SIZE) {
+            int32_t bx_end = LV_MIN(bx + ROTATE_TILE_SIZE, srcWidth);
+            for(int32_t x = bx; x < bx_end; ++x) {
+                for(int32_t y = by; y < by_end; ++y) {
+                    int32_t srcIndex = y * srcStride + x * 3;
+                    int32_t dstIndex = (srcWidth - x - 1) * dstStride + y * 3;
+                    dst[dstIndex] = src[srcIndex];       /*Red*/
+                    dst[dstIndex + 1] = src[srcIndex + 1]; /*Green*/
+                    dst[dstIndex + 2] = src[srcIndex + 2]; /*Blue*/
+                }
+            }
         }
     }
 }
@@ -553,13 +573,19 @@ static void rotate270_rgb888(const uint8_t * src, uint8_t * dst, int32_t width,
         return ;
     }
 
-    for(int32_t x = 0; x < width; ++x) {
-        for(int32_t y = 0; y < height; ++y) {
-            int32_t srcIndex = y * srcStride + x * 3;
-            int32_t dstIndex = x * dstStride + (height - y - 1) * 3;
-            dst[dstIndex] = src[srcIndex];       /*Red*/
-            dst[dstIndex + 1] = src[srcIndex + 1]; /*Green*/
-            dst[dstIndex + 2] = src[srcIndex + 2]; /*Blue*/
+    for(int32_t by = 0; by < height; by += ROTATE_TILE_SIZE) {
+        int32_t by_end = LV_MIN(by + ROTATE_TILE_SIZE, height);
+        for(int32_t bx = 0; bx < width; bx += ROTATE_TILE_SIZE) {
+            int32_t bx_end = LV_MIN(bx + ROTATE_TILE_SIZE, width);
+            for(int32_t x = bx; x < bx_end; ++x) {
+                for(int32_t y = by; y < by_end; ++y) {
+                    int32_t srcIndex = y * srcStride + x * 3;
+                    int32_t dstIndex = x * dstStride + (height - y - 1) * 3;
+                    dst[dstIndex] = src[srcIndex];       /*Red*/
+                    dst[dstIndex + 1] = src[srcIndex + 1]; /*Green*/
+                    dst[dstIndex + 2] = src[srcIndex + 2]; /*Blue*/
+                }
+            }
         }
     }
 }
@@ -575,12 +601,17 @@ static void rotate90_rgb565(const uint16_t * src, uint16_t * dst, int32_t srcWid
     srcStride /= sizeof(uint16_t);
     dstStride /= sizeof(uint16_t);
 
-    for(int32_t x = 0; x < srcWidth; ++x) {
-        int32_t dstIndex = x * dstStride;
-        int32_t srcIndex = x;
-        for(int32_t y = 0; y < srcHeight; ++y) {
-            dst[dstIndex + (srcHeight - y - 1)] = src[srcIndex];
-            srcIndex += srcStride;
+    for(int32_t by = 0; by < srcHeight; by += ROTATE_TILE_SIZE) {
+        int32_t by_end = LV_MIN(by + ROTATE_TILE_SIZE, srcHeight);
+        for(int32_t bx = 0; bx < srcWidth; bx += ROTATE_TILE_SIZE) {
+            int32_t bx_end = LV_MIN(bx + ROTATE_TILE_SIZE, srcWidth);
+            for(int32_t x = bx; x < bx_end; ++x) {
+                int32_t srcIndex = by * srcStride + x;
+                for(int32_t y = by; y < by_end; ++y) {
+                    dst[x * dstStride + (srcHeight - y - 1)] = src[srcIndex];
+                    srcIndex += srcStride;
+                }
+            }
         }
     }
 }
@@ -615,12 +646,17 @@ static void rotate270_rgb565(const uint16_t * src, uint16_t * dst, int32_t srcWi
     srcStride /= sizeof(uint16_t);
     dstStride /= sizeof(uint16_t);
 
-    for(int32_t x = 0; x < srcWidth; ++x) {
-        int32_t dstIndex = (srcWidth - x - 1);
-        int32_t srcIndex = x;
-        for(int32_t y = 0; y < srcHeight; ++y) {
-            dst[dstIndex * dstStride + y] = src[srcIndex];
-            srcIndex += srcStride;
+    for(int32_t by = 0; by < srcHeight; by += ROTATE_TILE_SIZE) {
+        int32_t by_end = LV_MIN(by + ROTATE_TILE_SIZE, srcHeight);
+        for(int32_t bx = 0; bx < srcWidth; bx += ROTATE_TILE_SIZE) {
+            int32_t bx_end = LV_MIN(bx + ROTATE_TILE_SIZE, srcWidth);
+            for(int32_t x = bx; x < bx_end; ++x) {
+                int32_t srcIndex = by * srcStride + x;
+                for(int32_t y = by; y < by_end; ++y) {
+                    dst[(srcWidth - x - 1) * dstStride + y] = src[srcIndex];
+                    srcIndex += srcStride;
+                }
+            }
         }
     }
 }
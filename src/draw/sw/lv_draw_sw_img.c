@@ -226,7 +226,8 @@ static void img_draw_core(lv_draw_unit_t * draw_unit, const lv_draw_image_dsc_t
         blend_dsc.src_color_format = LV_COLOR_FORMAT_RGB565;
         lv_draw_sw_blend(draw_unit, &blend_dsc);
     }
-    /*The simplest case just copy the pixels into the draw_buf. Blending will convert the colors if needed*/
+    /*The simplest case just copy the pixels into the draw_buf. Blending will convert the colors if needed
+     *(also the indexed colors with the palette)*/
     else if(!transformed && !masked && draw_dsc->recolor_opa <= LV_OPA_MIN) {
         blend_dsc.src_area = img_coords;
         blend_dsc.src_buf = src_buf;
@@ -234,7 +235,7 @@ static void img_draw_core(lv_draw_unit_t * draw_unit, const lv_draw_image_dsc_t
         blend_dsc.src_color_format = cf;
         lv_draw_sw_blend(draw_unit, &blend_dsc);
     }
-    /*Handle masked RGB565, RGB888, XRGB888, or ARGB8888 images*/
+    /*Handle masked RGB565, RGB888, XRGB888, ARGB8888, or indexed images*/
     else if(!transformed && masked && draw_dsc->recolor_opa <= LV_OPA_MIN) {
         blend_dsc.src_area = img_coords;
         blend_dsc.src_buf = src_buf;
@@ -273,7 +274,11 @@ static void img_draw_core(lv_draw_unit_t * draw_unit, const lv_draw_image_dsc_t
         int32_t blend_h = lv_area_get_height(&blend_area);
 
         lv_color_format_t cf_final = cf;
-        if(transformed) {
+        if(LV_COLOR_FORMAT_IS_INDEXED(cf)) {
+            /*Indexed images are converted with their palette only in these smaller chunks*/
+            cf_final = LV_COLOR_FORMAT_ARGB8888;
+        }
+        else if(transformed) {
             if(cf == LV_COLOR_FORMAT_RGB888 || cf == LV_COLOR_FORMAT_XRGB8888) cf_final = LV_COLOR_FORMAT_ARGB8888;
             else if(cf == LV_COLOR_FORMAT_RGB565) cf_final = LV_COLOR_FORMAT_RGB565A8;
         }
@@ -351,6 +356,9 @@ static void img_draw_core(lv_draw_unit_t * draw_unit, const lv_draw_image_dsc_t
                         a_dest_buf += blend_w;
                     }
                 }
+                else if(LV_COLOR_FORMAT_IS_INDEXED(cf)) {
+                    lv_draw_sw_indexed_to_argb8888(tmp_buf, blend_w * px_size, src_buf, img_stride, cf, &relative_area);
+                }
                 else if(cf_final != LV_COLOR_FORMAT_A8) {
                     const uint8_t * src_buf_tmp = src_buf + img_stride * relative_area.y1 + relative_area.x1 * px_size;
                     uint8_t * dest_buf_tmp = tmp_buf;
@@ -15,12 +15,18 @@
 #include "../../misc/lv_area.h"
 #include "../../misc/lv_style.h"
 #include "../../font/lv_font.h"
+#include "../../font/lv_font_fmt_txt.h"
 #include "../../core/lv_refr.h"
 #include "../../stdlib/lv_string.h"
 
 /*********************
  *      DEFINES
  *********************/
+/*Size of the stack buffer in bytes where the rows of the packed glyphs are converted to A8 before blending*/
+#define PACKED_GLYPH_MASK_BUF_SIZE  512
+
+/*Size of the stack buffer in bytes where the glyphs of a glyph atlas are merged before blending*/
+#define GLYPH_RUN_MASK_BUF_SIZE     1024
 
 /**********************
  *      TYPEDEFS
@@ -32,6 +38,12 @@
 
 static void /* LV_ATTRIBUTE_FAST_MEM */ draw_letter_cb(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * glyph_draw_dsc,
                                                        lv_draw_fill_dsc_t * fill_draw_dsc, const lv_area_t * fill_area);
+static void /* LV_ATTRIBUTE_FAST_MEM */ draw_packed_letter(lv_draw_unit_t * draw_unit,
+                                                           lv_draw_glyph_dsc_t * glyph_draw_dsc);
+static void /* LV_ATTRIBUTE_FAST_MEM */ draw_glyph_batch_cb(lv_draw_unit_t * draw_unit,
+                                                            const lv_draw_glyph_batch_t * batch);
+static void /* LV_ATTRIBUTE_FAST_MEM */ draw_glyph_run(lv_draw_unit_t * draw_unit, const lv_draw_glyph_batch_t * batch,
+                                                       uint32_t start, uint32_t end, const lv_area_t * run_area);
 
 /**********************
  *  STATIC VARIABLES
@@ -54,7 +66,7 @@ void lv_draw_sw_label(lv_draw_unit_t * draw_unit, const lv_draw_label_dsc_t * ds
     if(dsc->opa <= LV_OPA_MIN) return;
 
     LV_PROFILER_BEGIN;
-    lv_draw_label_iterate_characters(draw_unit, dsc, coords, draw_letter_cb);
+    lv_draw_label_iterate_characters_batched(draw_unit, dsc, coords, draw_letter_cb, draw_glyph_batch_cb);
     LV_PROFILER_END;
 }
 
@@ -83,6 +95,11 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_cb(lv_draw_unit_t * draw_unit, lv_
             case LV_FONT_GLYPH_FORMAT_A2:
             case LV_FONT_GLYPH_FORMAT_A4:
             case LV_FONT_GLYPH_FORMAT_A8: {
+                    if(glyph_draw_dsc->packed) {
+                        draw_packed_letter(draw_unit, glyph_draw_dsc);
+                        break;
+                    }
+
                     lv_area_t mask_area = *glyph_draw_dsc->letter_coords;
                     mask_area.x2 = mask_area.x1 + lv_draw_buf_width_to_stride(lv_area_get_width(&mask_area), LV_COLOR_FORMAT_A8) - 1;
                     lv_draw_sw_blend_dsc_t blend_dsc;
@@ -123,4 +140,165 @@ static void LV_ATTRIBUTE_FAST_MEM draw_letter_cb(lv_draw_unit_t * draw_unit, lv_
     }
 }
 
+/**
+ * Blend the glyphs of a glyph atlas. The glyphs of a line having the same color are merged
+ * into a common mask from the texture and blended together.
+ */
+static void LV_ATTRIBUTE_FAST_MEM draw_glyph_batch_cb(lv_draw_unit_t * draw_unit, const lv_draw_glyph_batch_t * batch)
+{
+    uint32_t i = 0;
+    while(i < batch->item_cnt) {
+        const lv_draw_glyph_batch_item_t * first = &batch->items[i];
+        lv_area_t run_area = first->letter_coords;
+
+        /*Collect the next glyphs in the same line with the same color*/
+        uint32_t end = i + 1;
+        while(end < batch->item_cnt) {
+            const lv_draw_glyph_batch_item_t * item = &batch->items[end];
+            if(!lv_color_eq(item->color, first->color)) break;
+            if(item->letter_coords.y1 > run_area.y2 || item->letter_coords.y2 < run_area.y1) break;
+            run_area.x1 = LV_MIN(run_area.x1, item->letter_coords.x1);
+            run_area.y1 = LV_MIN(run_area.y1, item->letter_coords.y1);
+            run_area.x2 = LV_MAX(run_area.x2, item->letter_coords.x2);
+            run_area.y2 = LV_MAX(run_area.y2, item->letter_coords.y2);
+            end++;
+        }
+
+        draw_glyph_run(draw_unit, batch, i, end, &run_area);
+        i = end;
+    }
+}
+
+/**
+ * Merge the glyphs of a batch into a mask in bands of rows and blend each band once.
+ * Overlapping glyphs (e.g. due to kerning) are merged by taking the larger opacity.
+ * @param draw_unit     pointer to a draw unit
+ * @param batch         the batch
+ * @param start         index of the first item to draw
+ * @param end           index after the last item to draw
+ * @param run_area      the bounding box of the items
+ */
+static void LV_ATTRIBUTE_FAST_MEM draw_glyph_run(lv_draw_unit_t * draw_unit, const lv_draw_glyph_batch_t * batch,
+                                                 uint32_t start, uint32_t end, const lv_area_t * run_area)
+{
+    const lv_draw_buf_t * atlas = batch->atlas;
+
+    lv_area_t clipped_area;
+    if(!_lv_area_intersect(&clipped_area, run_area, draw_unit->clip_area)) return;
+
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memzero(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.opa = batch->opa;
+    blend_dsc.color = batch->items[start].color;
+    blend_dsc.mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
+
+    uint32_t i;
+    int32_t run_w = lv_area_get_width(&clipped_area);
+    if(run_w > GLYPH_RUN_MASK_BUF_SIZE) {
+        /*Too wide for the mask buffer, blend the glyphs directly from the texture*/
+        blend_dsc.mask_stride = atlas->header.stride;
+        for(i = start; i < end; i++) {
+            const lv_draw_glyph_batch_item_t * item = &batch->items[i];
+            blend_dsc.mask_buf = lv_draw_buf_goto_xy(atlas, item->atlas_area.x1, item->atlas_area.y1);
+            blend_dsc.mask_area = &item->letter_coords;
+            blend_dsc.blend_area = &item->letter_coords;
+            lv_draw_sw_blend(draw_unit, &blend_dsc);
+        }
+        return;
+    }
+
+    lv_opa_t mask_buf[GLYPH_RUN_MASK_BUF_SIZE];
+    int32_t band_rows = GLYPH_RUN_MASK_BUF_SIZE / run_w;
+
+    lv_area_t band_area;
+    band_area.x1 = clipped_area.x1;
+    band_area.x2 = clipped_area.x2;
+    blend_dsc.mask_buf = mask_buf;
+    blend_dsc.mask_stride = run_w;
+    blend_dsc.mask_area = &band_area;
+    blend_dsc.blend_area = &band_area;
+
+    int32_t y;
+    for(y = clipped_area.y1; y <= clipped_area.y2; y += band_rows) {
+        band_area.y1 = y;
+        band_area.y2 = LV_MIN(y + band_rows - 1, clipped_area.y2);
+        lv_memzero(mask_buf, run_w * lv_area_get_height(&band_area));
+
+        for(i = start; i < end; i++) {
+            const lv_draw_glyph_batch_item_t * item = &batch->items[i];
+            lv_area_t glyph_area;
+            if(!_lv_area_intersect(&glyph_area, &item->letter_coords, &band_area)) continue;
+
+            int32_t glyph_w = lv_area_get_width(&glyph_area);
+            int32_t row;
+            for(row = glyph_area.y1; row <= glyph_area.y2; row++) {
+                const lv_opa_t * src = lv_draw_buf_goto_xy(atlas,
+                                                           item->atlas_area.x1 + glyph_area.x1 - item->letter_coords.x1,
+                                                           item->atlas_area.y1 + row - item->letter_coords.y1);
+                lv_opa_t * dest = &mask_buf[(row - band_area.y1) * run_w + glyph_area.x1 - band_area.x1];
+                int32_t x;
+                for(x = 0; x < glyph_w; x++) {
+                    if(src[x] > dest[x]) dest[x] = src[x];
+                }
+            }
+        }
+
+        lv_draw_sw_blend(draw_unit, &blend_dsc);
+    }
+}
+
+/**
+ * Blend a glyph directly from the packed 1, 2 or 4 bpp bitmap of the font.
+ * Only the visible part is converted to A8, in batches of rows into a small stack buffer,
+ * so no glyph sized draw buffer needs to be written and read back.
+ */
+static void LV_ATTRIBUTE_FAST_MEM draw_packed_letter(lv_draw_unit_t * draw_unit, lv_draw_glyph_dsc_t * glyph_draw_dsc)
+{
+    const lv_area_t * letter_coords = glyph_draw_dsc->letter_coords;
+    lv_area_t clipped_coords;
+    if(!_lv_area_intersect(&clipped_coords, letter_coords, draw_unit->clip_area)) return;
+
+    const uint8_t * bitmap = glyph_draw_dsc->glyph_data;
+    uint8_t bpp = glyph_draw_dsc->format; /*A1, A2 and A4 are 1, 2 and 4*/
+    int32_t box_w = lv_area_get_width(letter_coords);
+
+    lv_opa_t mask_buf[PACKED_GLYPH_MASK_BUF_SIZE];
+
+    lv_draw_sw_blend_dsc_t blend_dsc;
+    lv_memzero(&blend_dsc, sizeof(blend_dsc));
+    blend_dsc.color = glyph_draw_dsc->color;
+    blend_dsc.opa = glyph_draw_dsc->opa;
+    blend_dsc.mask_buf = mask_buf;
+    blend_dsc.mask_res = LV_DRAW_SW_MASK_RES_CHANGED;
+
+    /*Very wide glyphs are processed in vertical stripes*/
+    int32_t x;
+    for(x = clipped_coords.x1; x <= clipped_coords.x2; x += PACKED_GLYPH_MASK_BUF_SIZE) {
+        lv_area_t batch_area;
+        batch_area.x1 = x;
+        batch_area.x2 = LV_MIN(x + PACKED_GLYPH_MASK_BUF_SIZE - 1, clipped_coords.x2);
+        int32_t batch_w = lv_area_get_width(&batch_area);
+        int32_t batch_rows = PACKED_GLYPH_MASK_BUF_SIZE / batch_w;
+
+        int32_t y;
+        for(y = clipped_coords.y1; y <= clipped_coords.y2; y += batch_rows) {
+            batch_area.y1 = y;
+            batch_area.y2 = LV_MIN(y + batch_rows - 1, clipped_coords.y2);
+
+            int32_t row;
+            lv_opa_t * mask_row = mask_buf;
+            for(row = batch_area.y1; row <= batch_area.y2; row++) {
+                uint32_t px_ofs = (row - letter_coords->y1) * box_w + (batch_area.x1 - letter_coords->x1);
+                lv_font_fmt_txt_unpack_pixels(bitmap, px_ofs * bpp, bpp, mask_row, batch_w);
+                mask_row += batch_w;
+            }
+
+            blend_dsc.blend_area = &batch_area;
+            blend_dsc.mask_area = &batch_area;
+            blend_dsc.mask_stride = batch_w;
+            lv_draw_sw_blend(draw_unit, &blend_dsc);
+        }
+    }
+}
+
 #endif /*LV_USE_DRAW_SW*/
@@ -67,6 +67,16 @@ static void transform_a8(const uint8_t * src, int32_t src_w, int32_t src_h, int3
                          int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
                          int32_t x_end, uint8_t * abuf, bool aa);
 
+static void transform_indexed(const uint8_t * src, int32_t src_w, int32_t src_h, int32_t src_stride,
+                              int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                              int32_t x_end, uint8_t * dest_buf, bool aa, lv_color_format_t cf);
+
+static inline lv_color32_t argb8888_aa(lv_color32_t px, lv_color32_t px_hor, lv_color32_t px_ver,
+                                       int32_t xs_fract, int32_t ys_fract);
+
+static inline lv_color32_t indexed_get_px(const uint8_t * indices, int32_t stride, uint32_t bpp,
+                                          const lv_color32_t * palette, int32_t x, int32_t y);
+
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -114,7 +124,7 @@ void lv_draw_sw_transform(lv_draw_unit_t * draw_unit, const lv_area_t * dest_are
 
     int32_t dest_stride_a8 = dest_w;
     int32_t dest_stride;
-    if(src_cf == LV_COLOR_FORMAT_RGB888) {
+    if(src_cf == LV_COLOR_FORMAT_RGB888 || LV_COLOR_FORMAT_IS_INDEXED(src_cf)) {
         dest_stride = dest_w * lv_color_format_get_size(LV_COLOR_FORMAT_ARGB8888);
     }
     else if(src_cf == LV_COLOR_FORMAT_RGB565A8) {
@@ -228,6 +238,13 @@ void lv_draw_sw_transform(lv_draw_unit_t * draw_unit, const lv_area_t * dest_are
                                    (uint16_t *)dest_buf,
                                    alpha_buf, true, aa);
                 break;
+            case LV_COLOR_FORMAT_I1:
+            case LV_COLOR_FORMAT_I2:
+            case LV_COLOR_FORMAT_I4:
+            case LV_COLOR_FORMAT_I8:
+                transform_indexed(src_buf, src_w, src_h, src_stride, xs_ups, ys_ups, xs_step_256, ys_step_256, dest_w, dest_buf,
+                                  aa, src_cf);
+                break;
             default:
                 break;
         }
@@ -396,23 +413,7 @@ static void transform_argb8888(const uint8_t * src, int32_t src_w, int32_t src_h
             lv_color32_t px_hor = src_c32[x_next];
             lv_color32_t px_ver = *(const lv_color32_t *)((uint8_t *)src_c32 + y_next * src_stride);
 
-            if(px_ver.alpha == 0) {
-                dest_c32[x].alpha = (dest_c32[x].alpha * (0xFF - ys_fract)) >> 8;
-            }
-            else if(!lv_color32_eq(dest_c32[x], px_ver)) {
-                dest_c32[x].alpha = ((px_ver.alpha * ys_fract) + (dest_c32[x].alpha * (0xFF - ys_fract))) >> 8;
-                px_ver.alpha = ys_fract;
-                dest_c32[x] = lv_color_mix32(px_ver, dest_c32[x]);
-            }
-
-            if(px_hor.alpha == 0) {
-                dest_c32[x].alpha = (dest_c32[x].alpha * (0xFF - xs_fract)) >> 8;
-            }
-            else if(!lv_color32_eq(dest_c32[x], px_hor)) {
-                dest_c32[x].alpha = ((px_hor.alpha * xs_fract) + (dest_c32[x].alpha * (0xFF - xs_fract))) >> 8;
-                px_hor.alpha = xs_fract;
-                dest_c32[x] = lv_color_mix32(px_hor, dest_c32[x]);
-            }
+            dest_c32[x] = argb8888_aa(dest_c32[x], px_hor, px_ver, xs_fract, ys_fract);
         }
         /*Partially out of the image*/
         else {
@@ -426,6 +427,39 @@ static void transform_argb8888(const uint8_t * src, int32_t src_w, int32_t src_h
     }
 }
 
+/**
+ * Mix a pixel with its vertical and horizontal neighbors for anti-aliasing
+ * @param px        the pixel
+ * @param px_hor    the horizontal neighbor
+ * @param px_ver    the vertical neighbor
+ * @param xs_fract  weight of the horizontal neighbor (0x00..0x7F)
+ * @param ys_fract  weight of the vertical neighbor (0x00..0x7F)
+ * @return          the mixed pixel
+ */
+static inline lv_color32_t argb8888_aa(lv_color32_t px, lv_color32_t px_hor, lv_color32_t px_ver,
+                                       int32_t xs_fract, int32_t ys_fract)
+{
+    if(px_ver.alpha == 0) {
+        px.alpha = (px.alpha * (0xFF - ys_fract)) >> 8;
+    }
+    else if(!lv_color32_eq(px, px_ver)) {
+        px.alpha = ((px_ver.alpha * ys_fract) + (px.alpha * (0xFF - ys_fract))) >> 8;
+        px_ver.alpha = ys_fract;
+        px = lv_color_mix32(px_ver, px);
+    }
+
+    if(px_hor.alpha == 0) {
+        px.alpha = (px.alpha * (0xFF - xs_fract)) >> 8;
+    }
+    else if(!lv_color32_eq(px, px_hor)) {
+        px.alpha = ((px_hor.alpha * xs_fract) + (px.alpha * (0xFF - xs_fract))) >> 8;
+        px_hor.alpha = xs_fract;
+        px = lv_color_mix32(px_hor, px);
+    }
+
+    return px;
+}
+
 static void transform_rgb565a8(const uint8_t * src, int32_t src_w, int32_t src_h, int32_t src_stride,
                                int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
                                int32_t x_end, uint16_t * cbuf, uint8_t * abuf, bool src_has_a8, bool aa)
@@ -611,6 +645,94 @@ static void transform_a8(const uint8_t * src, int32_t src_w, int32_t src_h, int3
     }
 }
 
+/**
+ * Like `transform_argb8888` but the pixels are looked up from the palette.
+ * `src` starts with the palette and the result is ARGB8888.
+ */
+static void transform_indexed(const uint8_t * src, int32_t src_w, int32_t src_h, int32_t src_stride,
+                              int32_t xs_ups, int32_t ys_ups, int32_t xs_step, int32_t ys_step,
+                              int32_t x_end, uint8_t * dest_buf, bool aa, lv_color_format_t cf)
+{
+    int32_t xs_ups_start = xs_ups;
+    int32_t ys_ups_start = ys_ups;
+    lv_color32_t * dest_c32 = (lv_color32_t *) dest_buf;
+    const lv_color32_t * palette = (const lv_color32_t *)src;
+    const uint8_t * indices = src + LV_COLOR_INDEXED_PALETTE_SIZE(cf) * sizeof(lv_color32_t);
+    uint32_t bpp = lv_color_format_get_bpp(cf);
+
+    int32_t x;
+    for(x = 0; x < x_end; x++) {
+        xs_ups = xs_ups_start + ((xs_step * x) >> 8);
+        ys_ups = ys_ups_start + ((ys_step * x) >> 8);
+
+        int32_t xs_int = xs_ups >> 8;
+        int32_t ys_int = ys_ups >> 8;
+
+        /*Fully out of the image*/
+        if(xs_int < 0 || xs_int >= src_w || ys_int < 0 || ys_int >= src_h) {
+            ((uint32_t *)dest_buf)[x] = 0x00000000;
+            continue;
+        }
+
+        /*Get the direction the hor and ver neighbor
+         *`fract` will be in range of 0x00..0xFF and `next` (+/-1) indicates the direction*/
+        int32_t xs_fract = xs_ups & 0xFF;
+        int32_t ys_fract = ys_ups & 0xFF;
+
+        int32_t x_next;
+        int32_t y_next;
+        if(xs_fract < 0x80) {
+            x_next = -1;
+            xs_fract = 0x7F - xs_fract;
+        }
+        else {
+            x_next = 1;
+            xs_fract = xs_fract - 0x80;
+        }
+        if(ys_fract < 0x80) {
+            y_next = -1;
+            ys_fract = 0x7F - ys_fract;
+        }
+        else {
+            y_next = 1;
+            ys_fract = ys_fract - 0x80;
+        }
+
+        dest_c32[x] = indexed_get_px(indices, src_stride, bpp, palette, xs_int, ys_int);
+
+        if(aa &&
+           xs_int + x_next >= 0 &&
+           xs_int + x_next <= src_w - 1 &&
+           ys_int + y_next >= 0 &&
+           ys_int + y_next <= src_h - 1) {
+
+            lv_color32_t px_hor = indexed_get_px(indices, src_stride, bpp, palette, xs_int + x_next, ys_int);
+            lv_color32_t px_ver = indexed_get_px(indices, src_stride, bpp, palette, xs_int, ys_int + y_next);
+
+            dest_c32[x] = argb8888_aa(dest_c32[x], px_hor, px_ver, xs_fract, ys_fract);
+        }
+        /*Partially out of the image*/
+        else {
+            if((xs_int == 0 && x_next < 0) || (xs_int == src_w - 1 && x_next > 0))  {
+                dest_c32[x].alpha = (dest_c32[x].alpha * (0x7F - xs_fract)) >> 7;
+            }
+            else if((ys_int == 0 && y_next < 0) || (ys_int == src_h - 1 && y_next > 0))  {
+                dest_c32[x].alpha = (dest_c32[x].alpha * (0x7F - ys_fract)) >> 7;
+            }
+        }
+    }
+}
+
+static inline lv_color32_t indexed_get_px(const uint8_t * indices, int32_t stride, uint32_t bpp,
+                                          const lv_color32_t * palette, int32_t x, int32_t y)
+{
+    /*The first pixel is in the most significant bits*/
+    uint32_t bit = x * bpp;
+    uint8_t byte = indices[y * stride + (bit >> 3)];
+    uint32_t shift = 8 - bpp - (bit & 0x7);
+    return palette[(byte >> shift) & ((1 << bpp) - 1)];
+}
+
 static void transform_point_upscaled(point_transform_dsc_t * t, int32_t xin, int32_t yin, int32_t * xout,
                                      int32_t * yout)
 {
@@ -18,11 +18,27 @@
  *      TYPEDEFS
  **********************/
 typedef struct {
-    lv_fs_file_t * fp;
-    int8_t bit_pos;
-    uint8_t byte_value;
+    const uint8_t * data;
+    uint32_t bit_pos;
 } bit_iterator_t;
 
+typedef struct {
+    lv_font_fmt_txt_dsc_t dsc;      /*Has to be the first member*/
+
+    /*Used only if the glyphs are loaded on demand*/
+    lv_fs_file_t file;              /*The font file kept open to read the glyphs*/
+#if LV_USE_FS_MEMFS
+    lv_fs_path_ex_t mempath;        /*The path of the font if loaded from a buffer*/
+#endif
+    lv_mutex_t lock;                /*Protect `file` as the glyphs can be loaded from multiple draw threads*/
+    uint32_t * glyph_offset;        /*Start of the glyphs in the `glyf` table, `loca_count + 1` elements*/
+    uint32_t glyph_start;           /*Start of the `glyf` table in the file*/
+    uint8_t glyph_header_bits;      /*Length of the glyph descriptors before the bitmaps*/
+    uint8_t lazy : 1;
+
+    lv_font_fmt_txt_glyph_id_table_t * glyph_id_table;  /*Pointed by `dsc.glyph_id_table`*/
+} binfont_dsc_t;
+
 typedef struct font_header_bin {
     uint32_t version;
     uint16_t tables_count;
@@ -63,12 +79,15 @@ typedef struct cmap_table_bin {
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static bit_iterator_t init_bit_iterator(lv_fs_file_t * fp);
+static lv_font_t * binfont_create(const char * path, bool lazy, const void * buffer, uint32_t size);
+static bit_iterator_t init_bit_iterator(const uint8_t * data);
 static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font);
 int32_t load_kern(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, uint8_t format, uint32_t start);
+static bool read_glyph_bitmap(lv_fs_file_t * fp, uint32_t pos, uint32_t header_bits, uint8_t * out, uint32_t size);
+static uint8_t * load_glyph_bitmap_cb(const lv_font_t * font, uint32_t glyph_id);
 
-static int read_bits_signed(bit_iterator_t * it, int n_bits, lv_fs_res_t * res);
-static unsigned int read_bits(bit_iterator_t * it, int n_bits, lv_fs_res_t * res);
+static int read_bits_signed(bit_iterator_t * it, int n_bits);
+static unsigned int read_bits(bit_iterator_t * it, int n_bits);
 
 /**********************
  *      MACROS
@@ -82,36 +101,32 @@ lv_font_t * lv_binfont_create(const char * path)
 {
     LV_ASSERT_NULL(path);
 
-    lv_fs_file_t file;
-    lv_fs_res_t fs_res = lv_fs_open(&file, path, LV_FS_MODE_RD);
-    if(fs_res != LV_FS_RES_OK) return NULL;
-
-    lv_font_t * font = lv_malloc_zeroed(sizeof(lv_font_t));
-    LV_ASSERT_MALLOC(font);
+    return binfont_create(path, false, NULL, 0);
+}
 
-    if(!lvgl_load_font(&file, font)) {
-        LV_LOG_WARN("Error loading font file: %s", path);
-        /*
-        * When `lvgl_load_font` fails it can leak some pointers.
-        * All non-null pointers can be assumed as allocated and
-        * `lv_binfont_destroy` should free them correctly.
-        */
-        lv_binfont_destroy(font);
-        font = NULL;
-    }
+lv_font_t * lv_binfont_create_lazy(const char * path)
+{
+    LV_ASSERT_NULL(path);
 
-    lv_fs_close(&file);
+#if LV_FONT_GLYPH_CACHE_SIZE == 0
+    LV_LOG_WARN("LV_FONT_GLYPH_CACHE_SIZE is 0 so the glyphs will be read from the file every time they are drawn");
+#endif
 
-    return font;
+    return binfont_create(path, true, NULL, 0);
 }
 
 #if LV_USE_FS_MEMFS
 lv_font_t * lv_binfont_create_from_buffer(void * buffer, uint32_t size)
 {
-    lv_fs_path_ex_t mempath;
+    return binfont_create(NULL, false, buffer, size);
+}
 
-    lv_fs_make_path_from_buffer(&mempath, LV_FS_MEMFS_LETTER, buffer, size);
-    return lv_binfont_create((const char *)&mempath);
+lv_font_t * lv_binfont_create_lazy_from_buffer(void * buffer, uint32_t size)
+{
+#if LV_FONT_GLYPH_CACHE_SIZE == 0
+    LV_LOG_WARN("LV_FONT_GLYPH_CACHE_SIZE is 0 so the glyphs will be read from the buffer every time they are drawn");
+#endif
+    return binfont_create(NULL, true, buffer, size);
 }
 #endif
 
@@ -122,6 +137,20 @@ void lv_binfont_destroy(lv_font_t * font)
     const lv_font_fmt_txt_dsc_t * dsc = font->dsc;
     if(dsc == NULL) return;
 
+    binfont_dsc_t * binfont_dsc = (binfont_dsc_t *)dsc;
+    if(binfont_dsc->lazy) {
+        lv_fs_close(&binfont_dsc->file);
+        lv_mutex_delete(&binfont_dsc->lock);
+        lv_free(binfont_dsc->glyph_offset);
+    }
+
+    /*The glyphs of this font might be cached, drop them as the font's address might be reused later*/
+    lv_draw_label_glyph_cache_drop_all();
+#if LV_USE_FONT_GLYPH_ATLAS
+    lv_font_glyph_atlas_delete(font);
+#endif
+    lv_font_fmt_txt_glyph_id_table_delete(font);
+
     if(dsc->kern_classes == 0) {
         const lv_font_fmt_txt_kern_pair_t * kern_dsc = dsc->kern_dsc;
         if(NULL != kern_dsc) {
@@ -159,46 +188,154 @@ void lv_binfont_destroy(lv_font_t * font)
  *   STATIC FUNCTIONS
  **********************/
 
-static bit_iterator_t init_bit_iterator(lv_fs_file_t * fp)
+static lv_font_t * binfont_create(const char * path, bool lazy, const void * buffer, uint32_t size)
+{
+    lv_font_t * font = lv_malloc_zeroed(sizeof(lv_font_t));
+    LV_ASSERT_MALLOC(font);
+    if(font == NULL) return NULL;
+
+    binfont_dsc_t * binfont_dsc = lv_malloc_zeroed(sizeof(binfont_dsc_t));
+    LV_ASSERT_MALLOC(binfont_dsc);
+    if(binfont_dsc == NULL) {
+        lv_free(font);
+        return NULL;
+    }
+    font->dsc = binfont_dsc;
+    binfont_dsc->dsc.glyph_id_table = &binfont_dsc->glyph_id_table;
+
+#if LV_USE_FS_MEMFS
+    /*The path has to be kept if the file remains open*/
+    if(buffer) {
+        lv_fs_make_path_from_buffer(&binfont_dsc->mempath, LV_FS_MEMFS_LETTER, buffer, size);
+        path = (const char *)&binfont_dsc->mempath;
+    }
+#else
+    LV_UNUSED(buffer);
+    LV_UNUSED(size);
+#endif
+
+    lv_fs_file_t * fp = &binfont_dsc->file;
+    lv_fs_res_t fs_res = lv_fs_open(fp, path, LV_FS_MODE_RD);
+    if(fs_res != LV_FS_RES_OK) {
+        lv_free(binfont_dsc);
+        lv_free(font);
+        return NULL;
+    }
+
+    if(lazy) {
+        lv_mutex_init(&binfont_dsc->lock);
+        binfont_dsc->lazy = 1;
+    }
+
+    if(!lvgl_load_font(fp, font)) {
+        LV_LOG_WARN("Error loading font file: %s", buffer ? "from buffer" : path);
+        /*
+        * When `lvgl_load_font` fails it can leak some pointers.
+        * All non-null pointers can be assumed as allocated and
+        * `lv_binfont_destroy` should free them correctly.
+        */
+        if(!lazy) lv_fs_close(fp);
+        lv_binfont_destroy(font);
+        return NULL;
+    }
+
+    /*Keep the file open only if the glyphs are loaded from it later*/
+    if(!lazy) lv_fs_close(fp);
+
+    return font;
+}
+
+static bit_iterator_t init_bit_iterator(const uint8_t * data)
 {
     bit_iterator_t it;
-    it.fp = fp;
-    it.bit_pos = -1;
-    it.byte_value = 0;
+    it.data = data;
+    it.bit_pos = 0;
     return it;
 }
 
-static unsigned int read_bits(bit_iterator_t * it, int n_bits, lv_fs_res_t * res)
+static unsigned int read_bits(bit_iterator_t * it, int n_bits)
 {
     unsigned int value = 0;
     while(n_bits--) {
-        it->byte_value = it->byte_value << 1;
-        it->bit_pos--;
-
-        if(it->bit_pos < 0) {
-            it->bit_pos = 7;
-            *res = lv_fs_read(it->fp, &(it->byte_value), 1, NULL);
-            if(*res != LV_FS_RES_OK) {
-                return 0;
-            }
-        }
-        int8_t bit = (it->byte_value & 0x80) ? 1 : 0;
+        uint8_t byte_value = it->data[it->bit_pos >> 3];
+        int8_t bit = (byte_value >> (7 - (it->bit_pos & 0x7))) & 0x1;
+        it->bit_pos++;
 
         value |= (bit << n_bits);
     }
-    *res = LV_FS_RES_OK;
     return value;
 }
 
-static int read_bits_signed(bit_iterator_t * it, int n_bits, lv_fs_res_t * res)
+static int read_bits_signed(bit_iterator_t * it, int n_bits)
 {
-    unsigned int value = read_bits(it, n_bits, res);
+    unsigned int value = read_bits(it, n_bits);
     if(value & (1 << (n_bits - 1))) {
         value |= ~0u << n_bits;
     }
     return value;
 }
 
+/**
+ * Read the bitmap of a glyph which is stored after the glyph's descriptor.
+ * As the descriptor's length is not necessarily a multiple of 8 bits, the bitmap is shifted to start on a byte boundary.
+ * @param fp            the font file
+ * @param pos           position of the glyph (its descriptor) in the file
+ * @param header_bits   length of the glyph's descriptor in bits
+ * @param out           store the bitmap here
+ * @param size          size of the bitmap in bytes
+ * @return              true on success
+ */
+static bool read_glyph_bitmap(lv_fs_file_t * fp, uint32_t pos, uint32_t header_bits, uint8_t * out, uint32_t size)
+{
+    if(size == 0) return true;
+
+    if(lv_fs_seek(fp, pos + header_bits / 8, LV_FS_SEEK_SET) != LV_FS_RES_OK ||
+       lv_fs_read(fp, out, size, NULL) != LV_FS_RES_OK) {
+        return false;
+    }
+
+    uint32_t shift = header_bits % 8;
+    if(shift != 0) {
+        uint32_t i;
+        for(i = 0; i < size - 1; i++) {
+            out[i] = (uint8_t)((out[i] << shift) | (out[i + 1] >> (8 - shift)));
+        }
+        out[size - 1] = (uint8_t)(out[size - 1] << shift);
+    }
+
+    return true;
+}
+
+/**
+ * Load the bitmap of a glyph from the font file. Used as `load_glyph_bitmap` of lazily loaded fonts.
+ */
+static uint8_t * load_glyph_bitmap_cb(const lv_font_t * font, uint32_t glyph_id)
+{
+    binfont_dsc_t * binfont_dsc = (binfont_dsc_t *)font->dsc;
+
+    uint32_t glyph_ofs = binfont_dsc->glyph_offset[glyph_id];
+    uint32_t size = binfont_dsc->glyph_offset[glyph_id + 1] - glyph_ofs - binfont_dsc->glyph_header_bits / 8;
+
+    /*The decoders might read 1 byte more*/
+    uint8_t * bitmap = lv_malloc(size + 1);
+    LV_ASSERT_MALLOC(bitmap);
+    if(bitmap == NULL) return NULL;
+    bitmap[size] = 0;
+
+    lv_mutex_lock(&binfont_dsc->lock);
+    bool res = read_glyph_bitmap(&binfont_dsc->file, binfont_dsc->glyph_start + glyph_ofs,
+                                 binfont_dsc->glyph_header_bits, bitmap, size);
+    lv_mutex_unlock(&binfont_dsc->lock);
+
+    if(!res) {
+        LV_LOG_WARN("Couldn't load glyph %" LV_PRIu32, glyph_id);
+        lv_free(bitmap);
+        return NULL;
+    }
+
+    return bitmap;
+}
+
 static int read_label(lv_fs_file_t * fp, int start, const char * label)
 {
     lv_fs_seek(fp, start, LV_FS_SEEK_SET);
@@ -312,14 +449,19 @@ static int32_t load_cmaps(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc, u
     return success ? cmaps_length : -1;
 }
 
-static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
+static int32_t load_glyph(lv_fs_file_t * fp, binfont_dsc_t * binfont_dsc,
                           uint32_t start, uint32_t * glyph_offset, uint32_t loca_count, font_header_bin_t * header)
 {
+    lv_font_fmt_txt_dsc_t * font_dsc = &binfont_dsc->dsc;
+
     int32_t glyph_length = read_label(fp, start, "glyf");
     if(glyph_length < 0) {
         return -1;
     }
 
+    /*The end of the last glyph*/
+    glyph_offset[loca_count] = glyph_length;
+
     lv_font_fmt_txt_glyph_dsc_t * glyph_dsc = (lv_font_fmt_txt_glyph_dsc_t *)
                                               lv_malloc(loca_count * sizeof(lv_font_fmt_txt_glyph_dsc_t));
 
@@ -327,6 +469,15 @@ static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
 
     font_dsc->glyph_dsc = glyph_dsc;
 
+    /*Read the descriptor of each glyph at once*/
+    uint8_t header_buf[16];
+    int nbits = header->advance_width_bits + 2 * header->xy_bits + 2 * header->wh_bits;
+    uint32_t header_bytes = (nbits + 7) / 8;
+    if(header_bytes > sizeof(header_buf)) {
+        LV_LOG_WARN("Too long glyph descriptors: %d bits", nbits);
+        return -1;
+    }
+
     int cur_bmp_size = 0;
 
     for(unsigned int i = 0; i < loca_count; ++i) {
@@ -337,45 +488,29 @@ static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
             return -1;
         }
 
-        bit_iterator_t bit_it = init_bit_iterator(fp);
+        if(lv_fs_read(fp, header_buf, header_bytes, NULL) != LV_FS_RES_OK) {
+            return -1;
+        }
+
+        bit_iterator_t bit_it = init_bit_iterator(header_buf);
 
         if(header->advance_width_bits == 0) {
             gdsc->adv_w = header->default_advance_width;
         }
         else {
-            gdsc->adv_w = read_bits(&bit_it, header->advance_width_bits, &res);
-            if(res != LV_FS_RES_OK) {
-                return -1;
-            }
+            gdsc->adv_w = read_bits(&bit_it, header->advance_width_bits);
         }
 
         if(header->advance_width_format == 0) {
             gdsc->adv_w *= 16;
         }
 
-        gdsc->ofs_x = read_bits_signed(&bit_it, header->xy_bits, &res);
-        if(res != LV_FS_RES_OK) {
-            return -1;
-        }
-
-        gdsc->ofs_y = read_bits_signed(&bit_it, header->xy_bits, &res);
-        if(res != LV_FS_RES_OK) {
-            return -1;
-        }
-
-        gdsc->box_w = read_bits(&bit_it, header->wh_bits, &res);
-        if(res != LV_FS_RES_OK) {
-            return -1;
-        }
-
-        gdsc->box_h = read_bits(&bit_it, header->wh_bits, &res);
-        if(res != LV_FS_RES_OK) {
-            return -1;
-        }
+        gdsc->ofs_x = read_bits_signed(&bit_it, header->xy_bits);
+        gdsc->ofs_y = read_bits_signed(&bit_it, header->xy_bits);
+        gdsc->box_w = read_bits(&bit_it, header->wh_bits);
+        gdsc->box_h = read_bits(&bit_it, header->wh_bits);
 
-        int nbits = header->advance_width_bits + 2 * header->xy_bits + 2 * header->wh_bits;
-        int next_offset = (i < loca_count - 1) ? glyph_offset[i + 1] : (uint32_t)glyph_length;
-        int bmp_size = next_offset - glyph_offset[i] - nbits / 8;
+        int bmp_size = glyph_offset[i + 1] - glyph_offset[i] - nbits / 8;
 
         if(i == 0) {
             gdsc->adv_w = 0;
@@ -391,6 +526,14 @@ static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
         }
     }
 
+    /*Only the glyph descriptors are loaded, the bitmaps are read from the file when needed*/
+    if(binfont_dsc->lazy) {
+        binfont_dsc->glyph_start = start;
+        binfont_dsc->glyph_header_bits = (uint8_t)nbits;
+        font_dsc->load_glyph_bitmap = load_glyph_bitmap_cb;
+        return glyph_length;
+    }
+
     uint8_t * glyph_bmp = (uint8_t *)lv_malloc(sizeof(uint8_t) * cur_bmp_size);
 
     font_dsc->glyph_bitmap = glyph_bmp;
@@ -398,46 +541,14 @@ static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
     cur_bmp_size = 0;
 
     for(unsigned int i = 1; i < loca_count; ++i) {
-        lv_fs_res_t res = lv_fs_seek(fp, start + glyph_offset[i], LV_FS_SEEK_SET);
-        if(res != LV_FS_RES_OK) {
-            return -1;
-        }
-        bit_iterator_t bit_it = init_bit_iterator(fp);
-
-        int nbits = header->advance_width_bits + 2 * header->xy_bits + 2 * header->wh_bits;
-
-        read_bits(&bit_it, nbits, &res);
-        if(res != LV_FS_RES_OK) {
-            return -1;
-        }
-
         if(glyph_dsc[i].box_w * glyph_dsc[i].box_h == 0) {
             continue;
         }
 
-        int next_offset = (i < loca_count - 1) ? glyph_offset[i + 1] : (uint32_t)glyph_length;
-        int bmp_size = next_offset - glyph_offset[i] - nbits / 8;
-
-        if(nbits % 8 == 0) {  /*Fast path*/
-            if(lv_fs_read(fp, &glyph_bmp[cur_bmp_size], bmp_size, NULL) != LV_FS_RES_OK) {
-                return -1;
-            }
-        }
-        else {
-            for(int k = 0; k < bmp_size - 1; ++k) {
-                glyph_bmp[cur_bmp_size + k] = read_bits(&bit_it, 8, &res);
-                if(res != LV_FS_RES_OK) {
-                    return -1;
-                }
-            }
-            glyph_bmp[cur_bmp_size + bmp_size - 1] = read_bits(&bit_it, 8 - nbits % 8, &res);
-            if(res != LV_FS_RES_OK) {
-                return -1;
-            }
-
-            /*The last fragment should be on the MSB but read_bits() will place it to the LSB*/
-            glyph_bmp[cur_bmp_size + bmp_size - 1] = glyph_bmp[cur_bmp_size + bmp_size - 1] << (nbits % 8);
+        int bmp_size = glyph_offset[i + 1] - glyph_offset[i] - nbits / 8;
 
+        if(!read_glyph_bitmap(fp, start + glyph_offset[i], nbits, &glyph_bmp[cur_bmp_size], bmp_size)) {
+            return -1;
         }
 
         cur_bmp_size += bmp_size;
@@ -459,12 +570,8 @@ static int32_t load_glyph(lv_fs_file_t * fp, lv_font_fmt_txt_dsc_t * font_dsc,
  */
 static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
 {
-    lv_font_fmt_txt_dsc_t * font_dsc = (lv_font_fmt_txt_dsc_t *)
-                                       lv_malloc(sizeof(lv_font_fmt_txt_dsc_t));
-
-    memset(font_dsc, 0, sizeof(lv_font_fmt_txt_dsc_t));
-
-    font->dsc = font_dsc;
+    binfont_dsc_t * binfont_dsc = (binfont_dsc_t *)font->dsc;
+    lv_font_fmt_txt_dsc_t * font_dsc = &binfont_dsc->dsc;
 
     /*header*/
     int32_t header_length = read_label(fp, 0, "head");
@@ -510,15 +617,23 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
 
     bool failed = false;
     uint32_t * glyph_offset = lv_malloc(sizeof(uint32_t) * (loca_count + 1));
+    LV_ASSERT_MALLOC(glyph_offset);
+    if(glyph_offset == NULL) return false;
+
+    /*Lazily loaded fonts need the offsets to find the glyphs later*/
+    if(binfont_dsc->lazy) binfont_dsc->glyph_offset = glyph_offset;
 
     if(font_header.index_to_loc_format == 0) {
-        for(unsigned int i = 0; i < loca_count; ++i) {
-            uint16_t offset;
-            if(lv_fs_read(fp, &offset, sizeof(uint16_t), NULL) != LV_FS_RES_OK) {
-                failed = true;
-                break;
+        /*Read all the 16 bit offsets at once as bytes and widen them from the end to not overwrite the unread ones*/
+        uint8_t * offset8 = (uint8_t *)glyph_offset;
+        if(lv_fs_read(fp, offset8, loca_count * sizeof(uint16_t), NULL) != LV_FS_RES_OK) {
+            failed = true;
+        }
+        else {
+            for(unsigned int i = loca_count; i > 0; --i) {
+                const uint8_t * p = &offset8[(i - 1) * 2];
+                glyph_offset[i - 1] = (uint32_t)p[0] | ((uint32_t)p[1] << 8);
             }
-            glyph_offset[i] = offset;
         }
     }
     else if(font_header.index_to_loc_format == 1) {
@@ -532,16 +647,16 @@ static bool lvgl_load_font(lv_fs_file_t * fp, lv_font_t * font)
     }
 
     if(failed) {
-        lv_free(glyph_offset);
+        if(!binfont_dsc->lazy) lv_free(glyph_offset);
         return false;
     }
 
     /*glyph*/
     uint32_t glyph_start = loca_start + loca_length;
     int32_t glyph_length = load_glyph(
-                               fp, font_dsc, glyph_start, glyph_offset, loca_count, &font_header);
+                               fp, binfont_dsc, glyph_start, glyph_offset, loca_count, &font_header);
 
-    lv_free(glyph_offset);
+    if(!binfont_dsc->lazy) lv_free(glyph_offset);
 
     if(glyph_length < 0) {
         return false;
@@ -45,7 +45,30 @@ lv_font_t * lv_binfont_create_from_buffer(void * buffer, uint32_t size);
 #endif
 
 /**
- * Frees the memory allocated by the `lv_binfont_create()` function
+ * Loads a `lv_font_t` object from a binary font file but keep the file open and load the glyphs' bitmap
+ * only when they are drawn. Only the character maps, the glyph descriptors and the kerning values are
+ * loaded into the RAM. It's useful for large fonts (e.g. CJK) to load them quickly and with less memory.
+ * Without `LV_FONT_GLYPH_CACHE_SIZE` each drawn glyph allocates a buffer, seeks and reads the file,
+ * so enable it to not read the frequently used glyphs again and again.
+ * @param path          path where the font file is located
+ * @return              pointer to font where to load
+ */
+lv_font_t * lv_binfont_create_lazy(const char * path);
+
+#if LV_USE_FS_MEMFS
+/**
+ * Loads a `lv_font_t` object from a memory buffer containing the binary font file,
+ * but load the glyphs' bitmap from the buffer only when they are drawn.
+ * Requires LV_USE_FS_MEMFS
+ * @param buffer        address of the font file in the memory. It must be valid while the font is used.
+ * @param size          size of the font file buffer
+ * @return              pointer to font where to load
+ */
+lv_font_t * lv_binfont_create_lazy_from_buffer(void * buffer, uint32_t size);
+#endif
+
+/**
+ * Frees the memory allocated by the `lv_binfont_create()` function and close the font file of lazily loaded fonts
  * @param font          lv_font_t object created by the lv_binfont_create function
  */
 void lv_binfont_destroy(lv_font_t * font);
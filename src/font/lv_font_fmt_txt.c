@@ -14,14 +14,29 @@
 #include "../misc/lv_log.h"
 #include "../misc/lv_utils.h"
 #include "../stdlib/lv_mem.h"
+#include "../stdlib/lv_string.h"
 
 /*********************
  *      DEFINES
  *********************/
 #if LV_USE_FONT_COMPRESSED
-    #define font_rle LV_GLOBAL_DEFAULT()->font_fmt_rle
+    /*Glyphs up to this width are decompressed with line buffers on the stack*/
+    #define DECOMPRESS_LINE_BUF_SIZE 128
 #endif /*LV_USE_FONT_COMPRESSED*/
 
+#define glyph_id_tables LV_GLOBAL_DEFAULT()->font_fmt_txt_glyph_id_tables
+#define glyph_id_table_lock LV_GLOBAL_DEFAULT()->font_fmt_txt_glyph_id_table_lock
+
+/*The tables and kerning hashes are read by the draw threads without locking,
+ *so publish them only when they are complete*/
+#if defined(__GNUC__) || defined(__clang__)
+    #define TABLE_LOAD(p)       __atomic_load_n(p, __ATOMIC_ACQUIRE)
+    #define TABLE_STORE(p, v)   __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#else
+    #define TABLE_LOAD(p)       (*(p))
+    #define TABLE_STORE(p, v)   (*(p) = (v))
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -34,6 +49,12 @@ typedef struct {
  *  STATIC PROTOTYPES
  **********************/
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
+static uint32_t search_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
+static void glyph_id_table_free(lv_font_fmt_txt_glyph_id_table_t * table);
+static inline lv_font_fmt_txt_glyph_id_table_t * glyph_id_table_get(const lv_font_t * font);
+static lv_result_t glyph_id_table_create(const lv_font_t * font, lv_font_fmt_txt_glyph_id_table_t ** table_out);
+static void kern_hash_create(lv_font_fmt_txt_glyph_id_table_t * table);
+static inline uint32_t kern_hash_index(uint32_t key, uint32_t mask);
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right);
 static int32_t unicode_list_compare(const void * ref, const void * element);
 static int32_t kern_pair_8_compare(const void * ref, const void * element);
@@ -41,10 +62,10 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
 
 #if LV_USE_FONT_COMPRESSED
     static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h, uint8_t bpp, bool prefilter);
-    static inline void decompress_line(uint8_t * out, int32_t w);
+    static inline void decompress_line(lv_font_fmt_rle_t * rle, uint8_t * out, int32_t w);
     static inline uint8_t get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len);
-    static inline void rle_init(const uint8_t * in,  uint8_t bpp);
-    static inline uint8_t rle_next(void);
+    static inline void rle_init(lv_font_fmt_rle_t * rle, const uint8_t * in,  uint8_t bpp);
+    static inline uint8_t rle_next(lv_font_fmt_rle_t * rle);
 #endif /*LV_USE_FONT_COMPRESSED*/
 
 /**********************
@@ -63,6 +84,16 @@ static const uint8_t opa3_table[8] = {0, 36, 73, 109, 146, 182, 218, 255};
 
 static const uint8_t opa2_table[4] = {0, 85, 170, 255};
 
+static const uint8_t opa1_table[2] = {0, 255};
+
+/*The opacity of 4 pixels of a 1 bpp bitmap for each nibble*/
+static const uint8_t opa1_nibble_table[16][4] = {
+    {0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x00, 0xff}, {0x00, 0x00, 0xff, 0x00}, {0x00, 0x00, 0xff, 0xff},
+    {0x00, 0xff, 0x00, 0x00}, {0x00, 0xff, 0x00, 0xff}, {0x00, 0xff, 0xff, 0x00}, {0x00, 0xff, 0xff, 0xff},
+    {0xff, 0x00, 0x00, 0x00}, {0xff, 0x00, 0x00, 0xff}, {0xff, 0x00, 0xff, 0x00}, {0xff, 0x00, 0xff, 0xff},
+    {0xff, 0xff, 0x00, 0x00}, {0xff, 0xff, 0x00, 0xff}, {0xff, 0xff, 0xff, 0x00}, {0xff, 0xff, 0xff, 0xff},
+};
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -92,80 +123,211 @@ const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, uint32_t un
     int32_t gsize = (int32_t) gdsc->box_w * gdsc->box_h;
     if(gsize == 0) return NULL;
 
+    const uint8_t * bitmap_in;
+    uint8_t * loaded_bitmap = NULL;
+    if(fdsc->glyph_bitmap) {
+        bitmap_in = &fdsc->glyph_bitmap[gdsc->bitmap_index];
+    }
+    else {
+        /*The glyphs are loaded on demand*/
+        if(fdsc->load_glyph_bitmap == NULL) return NULL;
+        loaded_bitmap = fdsc->load_glyph_bitmap(font, gid);
+        if(loaded_bitmap == NULL) return NULL;
+        bitmap_in = loaded_bitmap;
+    }
+
+    const void * res = NULL;
     if(fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN) {
-        const uint8_t * bitmap_in = &fdsc->glyph_bitmap[gdsc->bitmap_index];
-        uint8_t * bitmap_out_tmp = bitmap_out;
-        int32_t i = 0;
-        int32_t x, y;
         uint32_t stride = lv_draw_buf_width_to_stride(gdsc->box_w, LV_COLOR_FORMAT_A8);
-
-        if(fdsc->bpp == 1) {
-            for(y = 0; y < gdsc->box_h; y ++) {
-                for(x = 0; x < gdsc->box_w; x++, i++) {
-                    i = i & 0x7;
-                    if(i == 0) bitmap_out_tmp[x] = (*bitmap_in) & 0x80 ? 0xff : 0x00;
-                    else if(i == 1) bitmap_out_tmp[x] = (*bitmap_in) & 0x40 ? 0xff : 0x00;
-                    else if(i == 2) bitmap_out_tmp[x] = (*bitmap_in) & 0x20 ? 0xff : 0x00;
-                    else if(i == 3) bitmap_out_tmp[x] = (*bitmap_in) & 0x10 ? 0xff : 0x00;
-                    else if(i == 4) bitmap_out_tmp[x] = (*bitmap_in) & 0x08 ? 0xff : 0x00;
-                    else if(i == 5) bitmap_out_tmp[x] = (*bitmap_in) & 0x04 ? 0xff : 0x00;
-                    else if(i == 6) bitmap_out_tmp[x] = (*bitmap_in) & 0x02 ? 0xff : 0x00;
-                    else if(i == 7) {
-                        bitmap_out_tmp[x] = (*bitmap_in) & 0x01 ? 0xff : 0x00;
-                        bitmap_in++;
-                    }
-                }
-                bitmap_out_tmp += stride;
-            }
-        }
-        else if(fdsc->bpp == 2) {
-            for(y = 0; y < gdsc->box_h; y ++) {
-                for(x = 0; x < gdsc->box_w; x++, i++) {
-                    i = i & 0x3;
-                    if(i == 0) bitmap_out_tmp[x] = opa2_table[(*bitmap_in) >> 6];
-                    else if(i == 1) bitmap_out_tmp[x] = opa2_table[((*bitmap_in) >> 4) & 0x3];
-                    else if(i == 2) bitmap_out_tmp[x] = opa2_table[((*bitmap_in) >> 2) & 0x3];
-                    else if(i == 3) {
-                        bitmap_out_tmp[x] = opa2_table[((*bitmap_in) >> 0) & 0x3];
-                        bitmap_in++;
-                    }
-                }
-                bitmap_out_tmp += stride;
-            }
-
+        uint32_t bit_ofs = 0;
+        int32_t y;
+        for(y = 0; y < gdsc->box_h; y++) {
+            lv_font_fmt_txt_unpack_pixels(bitmap_in, bit_ofs, (uint8_t)fdsc->bpp, bitmap_out, gdsc->box_w);
+            bit_ofs += (uint32_t)gdsc->box_w * fdsc->bpp;
+            bitmap_out += stride;
         }
-        else if(fdsc->bpp == 4) {
-            for(y = 0; y < gdsc->box_h; y ++) {
-                for(x = 0; x < gdsc->box_w; x++, i++) {
-                    i = i & 0x1;
-                    if(i == 0) {
-                        bitmap_out_tmp[x] = opa4_table[(*bitmap_in) >> 4];
-                    }
-                    else if(i == 1) {
-                        bitmap_out_tmp[x] = opa4_table[(*bitmap_in) & 0xF];
-                        bitmap_in++;
-                    }
-                }
-                bitmap_out_tmp += stride;
-            }
-        }
-        return draw_buf;
+        res = draw_buf;
     }
     /*Handle compressed bitmap*/
     else {
 #if LV_USE_FONT_COMPRESSED
         bool prefilter = fdsc->bitmap_format == LV_FONT_FMT_TXT_COMPRESSED;
-        decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], bitmap_out, gdsc->box_w, gdsc->box_h,
-                   (uint8_t)fdsc->bpp, prefilter);
-        return draw_buf;
+        decompress(bitmap_in, bitmap_out, gdsc->box_w, gdsc->box_h, (uint8_t)fdsc->bpp, prefilter);
+        res = draw_buf;
 #else /*!LV_USE_FONT_COMPRESSED*/
         LV_LOG_WARN("Compressed fonts is used but LV_USE_FONT_COMPRESSED is not enabled in lv_conf.h");
-        return NULL;
 #endif
     }
 
-    /*If not returned earlier then the letter is not found in this font*/
-    return NULL;
+    if(loaded_bitmap) lv_free(loaded_bitmap);
+
+    return res;
+}
+
+const uint8_t * lv_font_get_packed_bitmap_fmt_txt(const lv_font_glyph_dsc_t * g_dsc, uint32_t unicode_letter)
+{
+    const lv_font_t * font = g_dsc->resolved_font;
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+
+    if(fdsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN || fdsc->glyph_bitmap == NULL) return NULL;
+    if(fdsc->bpp != 1 && fdsc->bpp != 2 && fdsc->bpp != 4) return NULL;
+
+    if(unicode_letter == '\t') unicode_letter = ' ';
+
+    uint32_t gid = get_glyph_dsc_id(font, unicode_letter);
+    if(!gid) return NULL;
+
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+    if(gdsc->box_w == 0 || gdsc->box_h == 0) return NULL;
+
+    return &fdsc->glyph_bitmap[gdsc->bitmap_index];
+}
+
+void LV_ATTRIBUTE_FAST_MEM lv_font_fmt_txt_unpack_pixels(const uint8_t * bitmap, uint32_t bit_ofs, uint8_t bpp,
+                                                         uint8_t * out, int32_t px_cnt)
+{
+    const uint8_t * opa_table;
+    uint8_t px_mask;
+    switch(bpp) {
+        case 1:
+            opa_table = opa1_table;
+            px_mask = 0x1;
+            break;
+        case 2:
+            opa_table = opa2_table;
+            px_mask = 0x3;
+            break;
+        case 4:
+            opa_table = opa4_table;
+            px_mask = 0xF;
+            break;
+        case 8:
+            lv_memcpy(out, &bitmap[bit_ofs >> 3], px_cnt);
+            return;
+        default:
+            LV_LOG_WARN("%d bpp is not handled", bpp);
+            return;
+    }
+
+    /*Convert the pixels one by one until reaching a byte boundary*/
+    while(px_cnt > 0 && (bit_ofs & 0x7)) {
+        uint8_t shift = 8 - bpp - (bit_ofs & 0x7);
+        *out = opa_table[(bitmap[bit_ofs >> 3] >> shift) & px_mask];
+        out++;
+        bit_ofs += bpp;
+        px_cnt--;
+    }
+
+    /*Convert whole bytes with table lookups*/
+    const uint8_t * bitmap_in = &bitmap[bit_ofs >> 3];
+    if(bpp == 1) {
+        while(px_cnt >= 8) {
+            lv_memcpy(out, opa1_nibble_table[*bitmap_in >> 4], 4);
+            lv_memcpy(out + 4, opa1_nibble_table[*bitmap_in & 0xF], 4);
+            bitmap_in++;
+            out += 8;
+            px_cnt -= 8;
+        }
+    }
+    else if(bpp == 2) {
+        while(px_cnt >= 4) {
+            out[0] = opa2_table[*bitmap_in >> 6];
+            out[1] = opa2_table[(*bitmap_in >> 4) & 0x3];
+            out[2] = opa2_table[(*bitmap_in >> 2) & 0x3];
+            out[3] = opa2_table[*bitmap_in & 0x3];
+            bitmap_in++;
+            out += 4;
+            px_cnt -= 4;
+        }
+    }
+    else {
+        while(px_cnt >= 2) {
+            out[0] = opa4_table[*bitmap_in >> 4];
+            out[1] = opa4_table[*bitmap_in & 0xF];
+            bitmap_in++;
+            out += 2;
+            px_cnt -= 2;
+        }
+    }
+
+    /*Convert the remaining pixels of the last byte*/
+    uint8_t shift = 8;
+    while(px_cnt > 0) {
+        shift -= bpp;
+        *out = opa_table[(*bitmap_in >> shift) & px_mask];
+        out++;
+        px_cnt--;
+    }
+}
+
+lv_result_t lv_font_fmt_txt_glyph_id_table_create(const lv_font_t * font)
+{
+    LV_ASSERT_NULL(font);
+
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    if(fdsc->glyph_id_table == NULL) {
+        LV_LOG_WARN("The font has no place for a glyph ID table (`glyph_id_table` is NULL in its descriptor)");
+        return LV_RESULT_INVALID;
+    }
+
+    if(glyph_id_table_get(font)) return LV_RESULT_OK;
+
+    lv_mutex_lock(&glyph_id_table_lock);
+    /*Another thread might have created it in the meantime*/
+    if(*fdsc->glyph_id_table) {
+        lv_mutex_unlock(&glyph_id_table_lock);
+        return LV_RESULT_OK;
+    }
+
+    lv_font_fmt_txt_glyph_id_table_t * table = NULL;
+    lv_result_t res = glyph_id_table_create(font, &table);
+    if(table) {
+        table->next = glyph_id_tables;
+        glyph_id_tables = table;
+        TABLE_STORE(fdsc->glyph_id_table, table);
+    }
+    lv_mutex_unlock(&glyph_id_table_lock);
+
+    return res;
+}
+
+void lv_font_fmt_txt_glyph_id_table_delete(const lv_font_t * font)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    if(fdsc->glyph_id_table == NULL) return;
+
+    lv_mutex_lock(&glyph_id_table_lock);
+    lv_font_fmt_txt_glyph_id_table_t * table = *fdsc->glyph_id_table;
+    if(table == NULL) {
+        lv_mutex_unlock(&glyph_id_table_lock);
+        return;
+    }
+
+    lv_font_fmt_txt_glyph_id_table_t ** prev_next = &glyph_id_tables;
+    while(*prev_next != table) prev_next = &(*prev_next)->next;
+    *prev_next = table->next;
+    TABLE_STORE(fdsc->glyph_id_table, NULL);
+    lv_mutex_unlock(&glyph_id_table_lock);
+
+    glyph_id_table_free(table);
+}
+
+void _lv_font_fmt_txt_init(void)
+{
+    lv_mutex_init(&glyph_id_table_lock);
+}
+
+void _lv_font_fmt_txt_deinit(void)
+{
+    while(glyph_id_tables) {
+        lv_font_fmt_txt_glyph_id_table_t * table = glyph_id_tables;
+        glyph_id_tables = table->next;
+        lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)table->font->dsc;
+        *fdsc->glyph_id_table = NULL;
+        glyph_id_table_free(table);
+    }
+
+    lv_mutex_delete(&glyph_id_table_lock);
 }
 
 bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
@@ -220,6 +382,99 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 {
     if(letter == '\0') return 0;
 
+    /*Use the lookup table if the font has one*/
+    lv_font_fmt_txt_glyph_id_table_t * table = glyph_id_table_get(font);
+    if(table) {
+        uint32_t page_id = (letter >> 8) - table->first_page;
+        if(page_id >= table->page_cnt || table->pages[page_id] == NULL) return 0;
+        return table->pages[page_id][letter & 0xFF];
+    }
+
+    return search_glyph_dsc_id(font, letter);
+}
+
+static inline lv_font_fmt_txt_glyph_id_table_t * glyph_id_table_get(const lv_font_t * font)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    if(fdsc->glyph_id_table == NULL) return NULL;
+
+    return TABLE_LOAD(fdsc->glyph_id_table);
+}
+
+/**
+ * Build the lookup table of a font.
+ * @param font          pointer to a font
+ * @param table_out     store the table here. Remains `NULL` if the font has no glyphs.
+ * @return              LV_RESULT_OK or LV_RESULT_INVALID if the table couldn't be created
+ */
+static lv_result_t glyph_id_table_create(const lv_font_t * font, lv_font_fmt_txt_glyph_id_table_t ** table_out)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
+    if(fdsc->cmap_num == 0) return LV_RESULT_OK;
+
+    /*Get the code point range covered by the character maps*/
+    uint32_t cp_min = UINT32_MAX;
+    uint32_t cp_max = 0;
+    uint16_t i;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &fdsc->cmaps[i];
+        if(cmap->range_length == 0) continue;
+        cp_min = LV_MIN(cp_min, cmap->range_start);
+        cp_max = LV_MAX(cp_max, cmap->range_start + cmap->range_length - 1);
+    }
+    if(cp_min > cp_max) return LV_RESULT_OK;
+
+    lv_font_fmt_txt_glyph_id_table_t * table = lv_malloc_zeroed(sizeof(lv_font_fmt_txt_glyph_id_table_t));
+    LV_ASSERT_MALLOC(table);
+    if(table == NULL) return LV_RESULT_INVALID;
+
+    lv_mutex_init(&table->kern_lock);
+    table->font = font;
+    table->first_page = cp_min >> 8;
+    table->page_cnt = (cp_max >> 8) - table->first_page + 1;
+    table->pages = lv_malloc_zeroed(table->page_cnt * sizeof(uint16_t *));
+    LV_ASSERT_MALLOC(table->pages);
+    if(table->pages == NULL) {
+        glyph_id_table_free(table);
+        return LV_RESULT_INVALID;
+    }
+
+    /*Search every code point of the ranges once in the usual way
+     *so that the table gives exactly the same result as the search*/
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cmap = &fdsc->cmaps[i];
+        uint32_t cp;
+        for(cp = cmap->range_start; cp < cmap->range_start + cmap->range_length; cp++) {
+            if(cp == '\0') continue;
+            uint32_t gid = search_glyph_dsc_id(font, cp);
+            if(gid == 0) continue;
+
+            if(gid > UINT16_MAX) {
+                LV_LOG_WARN("Too many glyphs for a glyph ID table");
+                glyph_id_table_free(table);
+                return LV_RESULT_INVALID;
+            }
+
+            uint16_t ** page = &table->pages[(cp >> 8) - table->first_page];
+            if(*page == NULL) {
+                *page = lv_malloc_zeroed(256 * sizeof(uint16_t));
+                LV_ASSERT_MALLOC(*page);
+                if(*page == NULL) {
+                    glyph_id_table_free(table);
+                    return LV_RESULT_INVALID;
+                }
+            }
+            (*page)[cp & 0xFF] = (uint16_t)gid;
+        }
+    }
+
+    *table_out = table;
+
+    return LV_RESULT_OK;
+}
+
+static uint32_t search_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
+{
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
 
     uint16_t i;
@@ -265,6 +520,86 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
 }
 
+static void glyph_id_table_free(lv_font_fmt_txt_glyph_id_table_t * table)
+{
+    uint32_t i;
+    if(table->pages) {
+        for(i = 0; i < table->page_cnt; i++) {
+            lv_free(table->pages[i]);
+        }
+    }
+    lv_free(table->pages);
+    lv_free(table->kern_keys);
+    lv_free(table->kern_values);
+    lv_mutex_delete(&table->kern_lock);
+    lv_free(table);
+}
+
+static inline uint32_t kern_hash_index(uint32_t key, uint32_t mask)
+{
+    /*Fibonacci hashing to spread the consecutive glyph IDs*/
+    return (key * 2654435761U) & mask;
+}
+
+/**
+ * Create a hash from the kerning pairs of a font.
+ * If it fails the kerning values will be binary searched as usual.
+ * @param table     the lookup table of the font
+ */
+static void kern_hash_create(lv_font_fmt_txt_glyph_id_table_t * table)
+{
+    lv_mutex_lock(&table->kern_lock);
+    /*Another thread might have created it in the meantime*/
+    if(TABLE_LOAD(&table->kern_hash_ready)) {
+        lv_mutex_unlock(&table->kern_lock);
+        return;
+    }
+
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)table->font->dsc;
+    const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
+
+    /*Keep the load factor under 50% to have short probe sequences*/
+    uint32_t slot_cnt = 16;
+    while(slot_cnt < kdsc->pair_cnt * 2) slot_cnt <<= 1;
+
+    uint32_t * keys = lv_malloc_zeroed(slot_cnt * sizeof(uint32_t));
+    int8_t * values = lv_malloc(slot_cnt * sizeof(int8_t));
+    if(keys == NULL || values == NULL) {
+        LV_LOG_WARN("Couldn't allocate the kerning hash");
+        lv_free(keys);
+        lv_free(values);
+        TABLE_STORE(&table->kern_hash_ready, 1);
+        lv_mutex_unlock(&table->kern_lock);
+        return;
+    }
+
+    uint32_t mask = slot_cnt - 1;
+    uint32_t i;
+    for(i = 0; i < kdsc->pair_cnt; i++) {
+        uint32_t key;
+        if(kdsc->glyph_ids_size == 0) {
+            const uint8_t * g_ids = kdsc->glyph_ids;
+            key = ((uint32_t)g_ids[i * 2] << 16) | g_ids[i * 2 + 1];
+        }
+        else {
+            const uint16_t * g_ids = kdsc->glyph_ids;
+            key = ((uint32_t)g_ids[i * 2] << 16) | g_ids[i * 2 + 1];
+        }
+
+        uint32_t idx = kern_hash_index(key, mask);
+        while(keys[idx] != 0 && keys[idx] != key) idx = (idx + 1) & mask;
+        keys[idx] = key;
+        values[idx] = kdsc->values[i];
+    }
+
+    table->kern_values = values;
+    table->kern_hash_mask = mask;
+    table->kern_keys = keys;
+    /*Release: the hash has to be visible before the flag*/
+    TABLE_STORE(&table->kern_hash_ready, 1);
+    lv_mutex_unlock(&table->kern_lock);
+}
+
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right)
 {
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *)font->dsc;
@@ -274,6 +609,23 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
     if(fdsc->kern_classes == 0) {
         /*Kern pairs*/
         const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
+
+        /*If the font has a lookup table use the hash of the kerning pairs*/
+        lv_font_fmt_txt_glyph_id_table_t * table = glyph_id_table_get(font);
+        if(table && kdsc->glyph_ids_size <= 1) {
+            /*Acquire: if the flag is set the hash is visible too*/
+            if(!TABLE_LOAD(&table->kern_hash_ready)) kern_hash_create(table);
+            if(table->kern_keys) {
+                uint32_t key = (gid_left << 16) | gid_right;
+                uint32_t idx = kern_hash_index(key, table->kern_hash_mask);
+                while(table->kern_keys[idx] != 0) {
+                    if(table->kern_keys[idx] == key) return table->kern_values[idx];
+                    idx = (idx + 1) & table->kern_hash_mask;
+                }
+                return 0;
+            }
+        }
+
         if(kdsc->glyph_ids_size == 0) {
             /*Use binary search to find the kern value.
              *The pairs are ordered left_id first, then right_id secondly.*/
@@ -370,17 +722,23 @@ static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h,
             return;
     }
 
-    rle_init(in, bpp);
-
-    uint8_t * line_buf1 = lv_malloc(w);
-
-    uint8_t * line_buf2 = NULL;
-
-    if(prefilter) {
-        line_buf2 = lv_malloc(w);
+    /*The state is local so glyphs can be decompressed by multiple draw units in parallel*/
+    lv_font_fmt_rle_t rle;
+    rle_init(&rle, in, bpp);
+
+    uint8_t line_buf_stack[2][DECOMPRESS_LINE_BUF_SIZE];
+    uint8_t * line_buf_alloc = NULL;
+    uint8_t * line_buf1 = line_buf_stack[0];
+    uint8_t * line_buf2 = line_buf_stack[1];
+    if(w > DECOMPRESS_LINE_BUF_SIZE) {
+        line_buf_alloc = lv_malloc(prefilter ? w * 2 : w);
+        LV_ASSERT_MALLOC(line_buf_alloc);
+        if(line_buf_alloc == NULL) return;
+        line_buf1 = line_buf_alloc;
+        line_buf2 = line_buf_alloc + w;
     }
 
-    decompress_line(line_buf1, w);
+    decompress_line(&rle, line_buf1, w);
 
     int32_t y;
     int32_t x;
@@ -393,7 +751,7 @@ static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h,
 
     for(y = 1; y < h; y++) {
         if(prefilter) {
-            decompress_line(line_buf2, w);
+            decompress_line(&rle, line_buf2, w);
 
             for(x = 0; x < w; x++) {
                 line_buf1[x] = line_buf2[x] ^ line_buf1[x];
@@ -401,7 +759,7 @@ static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h,
             }
         }
         else {
-            decompress_line(line_buf1, w);
+            decompress_line(&rle, line_buf1, w);
 
             for(x = 0; x < w; x++) {
                 out[x] = opa_table[line_buf1[x]];
@@ -410,20 +768,20 @@ static void decompress(const uint8_t * in, uint8_t * out, int32_t w, int32_t h,
         out += stride;
     }
 
-    lv_free(line_buf1);
-    lv_free(line_buf2);
+    lv_free(line_buf_alloc);
 }
 
 /**
  * Decompress one line. Store one pixel per byte
+ * @param rle the state of the decompression
  * @param out output buffer
  * @param w width of the line in pixel count
  */
-static inline void decompress_line(uint8_t * out, int32_t w)
+static inline void decompress_line(lv_font_fmt_rle_t * rle, uint8_t * out, int32_t w)
 {
     int32_t i;
     for(i = 0; i < w; i++) {
-        out[i] = rle_next();
+        out[i] = rle_next(rle);
     }
 }
 
@@ -469,9 +827,8 @@ static inline uint8_t get_bits(const uint8_t * in, uint32_t bit_pos, uint8_t len
     }
 }
 
-static inline void rle_init(const uint8_t * in,  uint8_t bpp)
+static inline void rle_init(lv_font_fmt_rle_t * rle, const uint8_t * in,  uint8_t bpp)
 {
-    lv_font_fmt_rle_t * rle = &font_rle;
     rle->in = in;
     rle->bpp = bpp;
     rle->state = RLE_STATE_SINGLE;
@@ -480,11 +837,10 @@ static inline void rle_init(const uint8_t * in,  uint8_t bpp)
     rle->count = 0;
 }
 
-static inline uint8_t rle_next(void)
+static inline uint8_t rle_next(lv_font_fmt_rle_t * rle)
 {
     uint8_t v = 0;
     uint8_t ret = 0;
-    lv_font_fmt_rle_t * rle = &font_rle;
 
     if(rle->state == RLE_STATE_SINGLE) {
         ret = get_bits(rle->in, rle->rdp, rle->bpp);
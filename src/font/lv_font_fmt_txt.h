@@ -17,6 +17,7 @@ extern "C" {
 #include <stddef.h>
 #include <stdbool.h>
 #include "lv_font.h"
+#include "../osal/lv_os.h"
 
 /*********************
  *      DEFINES
@@ -191,8 +192,41 @@ typedef struct {
      * from `lv_font_fmt_txt_bitmap_format_t`
      */
     uint16_t bitmap_format  : 2;
+
+    /**
+     * Optional callback to load the bitmap of a glyph on demand (e.g. from a file) if `glyph_bitmap` is `NULL`.
+     * It should return the glyph's bitmap in a buffer allocated by `lv_malloc` with at least 1 extra byte
+     * after the bitmap. The caller frees the buffer when the glyph is decoded.
+     */
+    uint8_t * (*load_glyph_bitmap)(const lv_font_t * font, uint32_t glyph_id);
+
+    /**
+     * Optional place of the lookup table created by `lv_font_fmt_txt_glyph_id_table_create()`.
+     * As the descriptor is usually constant it should point to a `NULL` initialized variable, e.g.
+     * `static lv_font_fmt_txt_glyph_id_table_t * glyph_id_table;` and `.glyph_id_table = &glyph_id_table`.
+     */
+    struct _lv_font_fmt_txt_glyph_id_table_t ** glyph_id_table;
 } lv_font_fmt_txt_dsc_t;
 
+/**
+ * Precomputed code point to glyph ID lookup table of a font.
+ * Created by `lv_font_fmt_txt_glyph_id_table_create()`
+ */
+typedef struct _lv_font_fmt_txt_glyph_id_table_t {
+    struct _lv_font_fmt_txt_glyph_id_table_t * next;    /**< The next table in the list of tables (to free them on deinit)*/
+    const lv_font_t * font;                             /**< The font of this table*/
+    uint32_t first_page;                                /**< Code point of the first page >> 8*/
+    uint32_t page_cnt;                                  /**< Number of pages*/
+    uint16_t ** pages;                                  /**< 256 glyph IDs per page. NULL if there are no glyphs on the page*/
+
+    /*Open addressing hash of the kerning pairs. Created on the first kerning lookup.*/
+    uint32_t * kern_keys;                               /**< `gid_left << 16 | gid_right`, 0: empty slot*/
+    int8_t * kern_values;                               /**< Kerning value for each key*/
+    uint32_t kern_hash_mask;                            /**< Number of slots - 1 (the number of slots is a power of 2)*/
+    lv_mutex_t kern_lock;                               /**< Protects the creation of the hash*/
+    uint8_t kern_hash_ready;                            /**< 1: the hash is created (or can't be created). Accessed atomically*/
+} lv_font_fmt_txt_glyph_id_table_t;
+
 #if LV_USE_FONT_COMPRESSED
 typedef enum {
     RLE_STATE_SINGLE = 0,
@@ -224,6 +258,26 @@ typedef struct {
 const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, uint32_t unicode_letter,
                                         lv_draw_buf_t * draw_buf);
 
+/**
+ * Get the packed (1, 2 or 4 bpp) bitmap of a glyph without converting it to A8.
+ * The rows are not byte aligned: pixel (x, y) starts at bit `(y * box_w + x) * bpp`, MSB first.
+ * @param g_dsc         the glyph descriptor including which font to use etc.
+ * @param unicode_letter a UNICODE character code
+ * @return pointer to the packed bitmap or NULL if the glyph is not found, compressed or not 1, 2 or 4 bpp
+ */
+const uint8_t * lv_font_get_packed_bitmap_fmt_txt(const lv_font_glyph_dsc_t * g_dsc, uint32_t unicode_letter);
+
+/**
+ * Convert consecutive pixels of a packed 1, 2, 4 or 8 bpp bitmap to 8 bit opacity values.
+ * @param bitmap        pointer to a packed bitmap
+ * @param bit_ofs       index of the bit where the first pixel starts
+ * @param bpp           bit per pixel (1, 2, 4 or 8)
+ * @param out           store the opacity values here
+ * @param px_cnt        number of pixels to convert
+ */
+void lv_font_fmt_txt_unpack_pixels(const uint8_t * bitmap, uint32_t bit_ofs, uint8_t bpp, uint8_t * out,
+                                   int32_t px_cnt);
+
 /**
  * Used as `get_glyph_dsc` callback in lvgl's native font format if the font is uncompressed.
  * @param font pointer to font
@@ -236,6 +290,38 @@ const void * lv_font_get_bitmap_fmt_txt(lv_font_glyph_dsc_t * g_dsc, uint32_t un
 bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter,
                                    uint32_t unicode_letter_next);
 
+/**
+ * Build a two-level page table to find the glyphs of a font by code point in constant time
+ * instead of searching in the character maps. It's useful for fonts with many sparse ranges,
+ * e.g. CJK fonts. Each 256 code point page having at least one glyph takes 512 bytes.
+ * If the font stores kerning pairs, a hash of them is also created on the first kerning lookup
+ * to avoid binary searching the pairs for each letter (5 bytes per slot, 2 slots per pair).
+ * The table is stored where the `glyph_id_table` field of the font's descriptor points
+ * so the fonts without it can't have a table. The built-in CJK font has it.
+ * Call it once when the font is registered, e.g. after `lv_init()`. The tables are freed by `lv_deinit()`.
+ * @param font          pointer to an `lv_font_fmt_txt` based font
+ * @return              LV_RESULT_OK: the table is created (or already exists);
+ *                      LV_RESULT_INVALID: out of memory or the font has no `glyph_id_table`
+ */
+lv_result_t lv_font_fmt_txt_glyph_id_table_create(const lv_font_t * font);
+
+/**
+ * Delete the lookup table of a font created by `lv_font_fmt_txt_glyph_id_table_create()`.
+ * It must not be called while the font is being used for rendering.
+ * @param font          pointer to a font. Nothing happens if it has no lookup table.
+ */
+void lv_font_fmt_txt_glyph_id_table_delete(const lv_font_t * font);
+
+/**
+ * Initialize the glyph ID tables. Called by `lv_init()`.
+ */
+void _lv_font_fmt_txt_init(void);
+
+/**
+ * Delete all the glyph ID tables. Called by `lv_deinit()`.
+ */
+void _lv_font_fmt_txt_deinit(void);
+
 /**********************
  *      MACROS
  **********************/
@@ -0,0 +1,414 @@
+/**
+ * @file lv_font_glyph_atlas.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_font_glyph_atlas.h"
+#if LV_USE_FONT_GLYPH_ATLAS
+
+#include "../core/lv_global.h"
+#include "../misc/lv_assert.h"
+#include "../misc/lv_log.h"
+#include "../misc/lv_math.h"
+#include "../stdlib/lv_mem.h"
+#include "../stdlib/lv_string.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define glyph_atlases LV_GLOBAL_DEFAULT()->font_glyph_atlases
+#define glyph_atlases_lock LV_GLOBAL_DEFAULT()->font_glyph_atlases_lock
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t letter;
+    lv_area_t area;     /*Area on the texture. Zero sized if the glyph is not on the texture*/
+} atlas_glyph_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_font_glyph_atlas_t * atlas_alloc(const lv_font_t * font, uint32_t w, uint32_t h);
+static void atlas_free(lv_font_glyph_atlas_t * atlas);
+static lv_font_glyph_atlas_t * atlas_find(const lv_font_t * font, lv_font_glyph_atlas_t *** prev_next);
+static void atlas_unref(lv_font_glyph_atlas_t * atlas);
+static bool add_glyph(lv_font_glyph_atlas_t * atlas, lv_font_glyph_dsc_t * g, uint32_t letter, lv_area_t * area);
+static bool skyline_alloc(lv_font_glyph_atlas_t * atlas, int32_t w, int32_t h, lv_point_t * pos);
+static int32_t skyline_fit(const lv_font_glyph_atlas_t * atlas, uint32_t i, int32_t w, int32_t h);
+static lv_rb_compare_res_t glyph_compare_cb(const atlas_glyph_t * lhs, const atlas_glyph_t * rhs);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_result_t lv_font_glyph_atlas_create(const lv_font_t * font, uint32_t w, uint32_t h)
+{
+    LV_ASSERT_NULL(font);
+
+    lv_mutex_lock(&glyph_atlases_lock);
+    bool exists = atlas_find(font, NULL) != NULL;
+    lv_mutex_unlock(&glyph_atlases_lock);
+    if(exists) return LV_RESULT_OK;
+
+    /*The skyline is stored on 16 bit*/
+    if(w == 0 || h == 0 || w > UINT16_MAX || h > UINT16_MAX) {
+        LV_LOG_WARN("invalid atlas size: %" LV_PRIu32 "x%" LV_PRIu32, w, h);
+        return LV_RESULT_INVALID;
+    }
+
+    lv_font_glyph_atlas_t * atlas = atlas_alloc(font, w, h);
+    if(atlas == NULL) return LV_RESULT_INVALID;
+
+    /*An other thread might have created an atlas for this font meanwhile*/
+    lv_mutex_lock(&glyph_atlases_lock);
+    if(atlas_find(font, NULL) == NULL) {
+        atlas->next = glyph_atlases;
+        glyph_atlases = atlas;
+        atlas = NULL;
+    }
+    lv_mutex_unlock(&glyph_atlases_lock);
+
+    if(atlas) atlas_free(atlas);
+
+    return LV_RESULT_OK;
+}
+
+void lv_font_glyph_atlas_invalidate(const lv_font_t * font)
+{
+    lv_mutex_lock(&glyph_atlases_lock);
+    lv_font_glyph_atlas_t * old_atlas = atlas_find(font, NULL);
+    uint32_t w = old_atlas ? old_atlas->draw_buf->header.w : 0;
+    uint32_t h = old_atlas ? old_atlas->draw_buf->header.h : 0;
+    lv_mutex_unlock(&glyph_atlases_lock);
+    if(old_atlas == NULL) return;
+
+    lv_font_glyph_atlas_t * atlas = atlas_alloc(font, w, h);
+
+    /*Replace the old atlas if it wasn't deleted meanwhile. Without memory just delete it.*/
+    lv_mutex_lock(&glyph_atlases_lock);
+    lv_font_glyph_atlas_t ** prev_next;
+    old_atlas = atlas_find(font, &prev_next);
+    if(old_atlas) {
+        if(atlas) {
+            atlas->next = old_atlas->next;
+            *prev_next = atlas;
+            atlas = NULL;
+        }
+        else {
+            *prev_next = old_atlas->next;
+        }
+        atlas_unref(old_atlas);
+    }
+    lv_mutex_unlock(&glyph_atlases_lock);
+
+    if(atlas) atlas_free(atlas);
+}
+
+void lv_font_glyph_atlas_delete(const lv_font_t * font)
+{
+    lv_mutex_lock(&glyph_atlases_lock);
+    lv_font_glyph_atlas_t ** prev_next;
+    lv_font_glyph_atlas_t * atlas = atlas_find(font, &prev_next);
+    if(atlas) {
+        *prev_next = atlas->next;
+        atlas_unref(atlas);
+    }
+    lv_mutex_unlock(&glyph_atlases_lock);
+}
+
+lv_font_glyph_atlas_t * lv_font_glyph_atlas_acquire(const lv_font_t * font)
+{
+    lv_mutex_lock(&glyph_atlases_lock);
+    lv_font_glyph_atlas_t * atlas = atlas_find(font, NULL);
+    if(atlas) atlas->ref_cnt++;
+    lv_mutex_unlock(&glyph_atlases_lock);
+
+    return atlas;
+}
+
+void lv_font_glyph_atlas_release(lv_font_glyph_atlas_t * atlas)
+{
+    LV_ASSERT_NULL(atlas);
+
+    lv_mutex_lock(&glyph_atlases_lock);
+    atlas_unref(atlas);
+    lv_mutex_unlock(&glyph_atlases_lock);
+}
+
+bool lv_font_glyph_atlas_get_glyph(lv_font_glyph_atlas_t * atlas, lv_font_glyph_dsc_t * g, uint32_t letter,
+                                   lv_area_t * area)
+{
+    LV_ASSERT_NULL(atlas);
+
+    lv_mutex_lock(&atlas->lock);
+
+    atlas_glyph_t search_key;
+    search_key.letter = letter;
+    lv_rb_node_t * node = lv_rb_find(&atlas->glyphs, &search_key);
+
+    bool res;
+    if(node) {
+        atlas_glyph_t * glyph = node->data;
+        *area = glyph->area;
+        res = lv_area_get_size(area) > 0;
+    }
+    else {
+        res = add_glyph(atlas, g, letter, area);
+    }
+
+    lv_mutex_unlock(&atlas->lock);
+
+    return res;
+}
+
+void _lv_font_glyph_atlas_init(void)
+{
+    lv_mutex_init(&glyph_atlases_lock);
+}
+
+void _lv_font_glyph_atlas_deinit(void)
+{
+    lv_mutex_lock(&glyph_atlases_lock);
+    while(glyph_atlases) {
+        lv_font_glyph_atlas_t * atlas = glyph_atlases;
+        glyph_atlases = atlas->next;
+        atlas_unref(atlas);
+    }
+    lv_mutex_unlock(&glyph_atlases_lock);
+
+    lv_mutex_delete(&glyph_atlases_lock);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Allocate an empty atlas. It's not added to the list.
+ * @param font      pointer to a font
+ * @param w         width of the texture in pixels
+ * @param h         height of the texture in pixels
+ * @return          the new atlas or NULL if out of memory
+ */
+static lv_font_glyph_atlas_t * atlas_alloc(const lv_font_t * font, uint32_t w, uint32_t h)
+{
+    lv_font_glyph_atlas_t * atlas = lv_malloc_zeroed(sizeof(lv_font_glyph_atlas_t));
+    LV_ASSERT_MALLOC(atlas);
+    if(atlas == NULL) return NULL;
+
+    atlas->font = font;
+    atlas->draw_buf = lv_draw_buf_create(w, h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
+    /*In the worst case each column has its own segment, +1 for inserting a new segment*/
+    atlas->skyline = lv_malloc((w + 1) * sizeof(lv_font_glyph_atlas_skyline_t));
+    if(atlas->draw_buf == NULL || atlas->skyline == NULL) {
+        LV_LOG_WARN("couldn't allocate the atlas");
+        if(atlas->draw_buf) lv_draw_buf_destroy(atlas->draw_buf);
+        lv_free(atlas->skyline);
+        lv_free(atlas);
+        return NULL;
+    }
+
+    lv_draw_buf_clear(atlas->draw_buf, NULL);
+    atlas->skyline[0].x = 0;
+    atlas->skyline[0].y = 0;
+    atlas->skyline[0].w = (uint16_t)w;
+    atlas->skyline_cnt = 1;
+
+    lv_rb_init(&atlas->glyphs, (lv_rb_compare_t)glyph_compare_cb, sizeof(atlas_glyph_t));
+    lv_mutex_init(&atlas->lock);
+    atlas->ref_cnt = 1; /*Referenced by the list*/
+
+    return atlas;
+}
+
+static void atlas_free(lv_font_glyph_atlas_t * atlas)
+{
+    lv_rb_destroy(&atlas->glyphs);
+    lv_mutex_delete(&atlas->lock);
+    lv_draw_buf_destroy(atlas->draw_buf);
+    lv_free(atlas->skyline);
+    lv_free(atlas);
+}
+
+/**
+ * Find the atlas of a font in the list. Should be called with `glyph_atlases_lock` locked.
+ * @param font          pointer to a font
+ * @param prev_next     if not NULL store the pointer pointing to the atlas in the list here
+ * @return              the atlas or NULL if not found
+ */
+static lv_font_glyph_atlas_t * atlas_find(const lv_font_t * font, lv_font_glyph_atlas_t *** prev_next)
+{
+    lv_font_glyph_atlas_t ** p = &glyph_atlases;
+    while(*p) {
+        if((*p)->font == font) {
+            if(prev_next) *prev_next = p;
+            return *p;
+        }
+        p = &(*p)->next;
+    }
+
+    return NULL;
+}
+
+/**
+ * Drop a reference of an atlas and free it if it was the last one.
+ * Should be called with `glyph_atlases_lock` locked.
+ */
+static void atlas_unref(lv_font_glyph_atlas_t * atlas)
+{
+    LV_ASSERT(atlas->ref_cnt > 0);
+    atlas->ref_cnt--;
+    if(atlas->ref_cnt == 0) atlas_free(atlas);
+}
+
+/**
+ * Render a glyph to the texture and remember where it is.
+ * If it can't be added it's remembered too to not try it again on every redraw.
+ */
+static bool add_glyph(lv_font_glyph_atlas_t * atlas, lv_font_glyph_dsc_t * g, uint32_t letter, lv_area_t * area)
+{
+    atlas_glyph_t glyph;
+    glyph.letter = letter;
+    lv_area_set(&glyph.area, 0, 0, -1, -1);
+
+    bool bitmap_glyph = g->resolved_font && g->format >= LV_FONT_GLYPH_FORMAT_A1 &&
+                        g->format <= LV_FONT_GLYPH_FORMAT_A8 && g->box_w > 0 && g->box_h > 0;
+
+    lv_point_t pos;
+    if(bitmap_glyph && skyline_alloc(atlas, g->box_w, g->box_h, &pos)) {
+        lv_draw_buf_t * tmp_buf = lv_draw_buf_create(g->box_w, g->box_h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
+        const lv_draw_buf_t * bitmap = tmp_buf ? lv_font_get_glyph_bitmap(g, letter, tmp_buf) : NULL;
+
+        if(bitmap) {
+            int32_t y;
+            for(y = 0; y < g->box_h; y++) {
+                lv_memcpy(lv_draw_buf_goto_xy(atlas->draw_buf, pos.x, pos.y + y),
+                          bitmap->data + y * bitmap->header.stride, g->box_w);
+            }
+            lv_area_set(&glyph.area, pos.x, pos.y, pos.x + g->box_w - 1, pos.y + g->box_h - 1);
+            lv_draw_buf_invalidate_cache(atlas->draw_buf, &glyph.area);
+            atlas->glyph_cnt++;
+        }
+        /*Else the allocated space is wasted but it's rare*/
+
+        if(g->entry && g->resolved_font->release_glyph) g->resolved_font->release_glyph(g->resolved_font, g);
+        if(tmp_buf) lv_draw_buf_destroy(tmp_buf);
+    }
+
+    lv_rb_node_t * node = lv_rb_insert(&atlas->glyphs, &glyph);
+    if(node) lv_memcpy(node->data, &glyph, sizeof(glyph));
+
+    *area = glyph.area;
+    return lv_area_get_size(area) > 0;
+}
+
+/**
+ * Find the place of a rectangle using the bottom-left skyline heuristic: put it where its top is the lowest
+ * and raise the skyline there.
+ * @param atlas     pointer to an atlas
+ * @param w         width of the rectangle
+ * @param h         height of the rectangle
+ * @param pos       store the top left corner of the rectangle here
+ * @return          true: there was enough space
+ */
+static bool skyline_alloc(lv_font_glyph_atlas_t * atlas, int32_t w, int32_t h, lv_point_t * pos)
+{
+    lv_font_glyph_atlas_skyline_t * skyline = atlas->skyline;
+
+    int32_t best_bottom = INT32_MAX;
+    int32_t best_w = INT32_MAX;
+    uint32_t best_i = 0;
+    uint32_t i;
+    for(i = 0; i < atlas->skyline_cnt; i++) {
+        int32_t y = skyline_fit(atlas, i, w, h);
+        if(y < 0) continue;
+
+        if(y + h < best_bottom || (y + h == best_bottom && skyline[i].w < best_w)) {
+            best_bottom = y + h;
+            best_w = skyline[i].w;
+            best_i = i;
+            pos->x = skyline[i].x;
+            pos->y = y;
+        }
+    }
+
+    if(best_bottom == INT32_MAX) return false;
+
+    /*Insert the new segment and shrink or remove the segments covered by it*/
+    lv_memmove(&skyline[best_i + 1], &skyline[best_i], (atlas->skyline_cnt - best_i) * sizeof(skyline[0]));
+    skyline[best_i].x = (uint16_t)pos->x;
+    skyline[best_i].y = (uint16_t)best_bottom;
+    skyline[best_i].w = (uint16_t)w;
+    atlas->skyline_cnt++;
+
+    int32_t right = pos->x + w;
+    i = best_i + 1;
+    while(i < atlas->skyline_cnt && skyline[i].x < right) {
+        int32_t seg_right = skyline[i].x + skyline[i].w;
+        if(seg_right <= right) {
+            lv_memmove(&skyline[i], &skyline[i + 1], (atlas->skyline_cnt - i - 1) * sizeof(skyline[0]));
+            atlas->skyline_cnt--;
+        }
+        else {
+            skyline[i].w = (uint16_t)(seg_right - right);
+            skyline[i].x = (uint16_t)right;
+            break;
+        }
+    }
+
+    /*Merge the neighbors having the same height*/
+    for(i = 0; i + 1 < atlas->skyline_cnt;) {
+        if(skyline[i].y == skyline[i + 1].y) {
+            skyline[i].w += skyline[i + 1].w;
+            lv_memmove(&skyline[i + 1], &skyline[i + 2], (atlas->skyline_cnt - i - 2) * sizeof(skyline[0]));
+            atlas->skyline_cnt--;
+        }
+        else {
+            i++;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Get where a rectangle could be placed if its left side is at the start of a skyline segment
+ * @return      the top of the rectangle or -1 if it doesn't fit there
+ */
+static int32_t skyline_fit(const lv_font_glyph_atlas_t * atlas, uint32_t i, int32_t w, int32_t h)
+{
+    const lv_font_glyph_atlas_skyline_t * skyline = atlas->skyline;
+    if(skyline[i].x + w > (int32_t)atlas->draw_buf->header.w) return -1;
+
+    int32_t y = 0;
+    int32_t w_left = w;
+    while(w_left > 0) {
+        y = LV_MAX(y, skyline[i].y);
+        if(y + h > (int32_t)atlas->draw_buf->header.h) return -1;
+        w_left -= skyline[i].w;
+        i++;
+    }
+
+    return y;
+}
+
+static lv_rb_compare_res_t glyph_compare_cb(const atlas_glyph_t * lhs, const atlas_glyph_t * rhs)
+{
+    if(lhs->letter == rhs->letter) return 0;
+    return lhs->letter > rhs->letter ? 1 : -1;
+}
+
+#endif /*LV_USE_FONT_GLYPH_ATLAS*/
@@ -0,0 +1,136 @@
+/**
+ * @file lv_font_glyph_atlas.h
+ *
+ */
+
+#ifndef LV_FONT_GLYPH_ATLAS_H
+#define LV_FONT_GLYPH_ATLAS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../lv_conf_internal.h"
+
+#if LV_USE_FONT_GLYPH_ATLAS
+
+#include "lv_font.h"
+#include "../misc/lv_area.h"
+#include "../misc/lv_rb.h"
+#include "../osal/lv_os.h"
+#include "../draw/lv_draw_buf.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * A segment of the skyline: the top of the already allocated area in a column range of the atlas
+ */
+typedef struct {
+    uint16_t x;
+    uint16_t y;
+    uint16_t w;
+} lv_font_glyph_atlas_skyline_t;
+
+/**
+ * A single A8 texture holding the glyphs of a font.
+ * The glyphs are added on their first use and stay there until the atlas is deleted.
+ * Created by `lv_font_glyph_atlas_create()`
+ */
+typedef struct _lv_font_glyph_atlas_t {
+    struct _lv_font_glyph_atlas_t * next;       /**< The next atlas in the list of atlases*/
+    const lv_font_t * font;                     /**< The font of this atlas*/
+    lv_draw_buf_t * draw_buf;                   /**< The A8 texture*/
+    lv_rb_t glyphs;                             /**< Letter -> area on the texture (empty area if it didn't fit)*/
+    lv_font_glyph_atlas_skyline_t * skyline;    /**< The skyline segments ordered by `x`*/
+    uint32_t skyline_cnt;                       /**< Number of skyline segments*/
+    uint32_t glyph_cnt;                         /**< Number of glyphs stored on the texture*/
+    uint32_t ref_cnt;                           /**< The list and each draw using the atlas hold a reference*/
+    lv_mutex_t lock;                            /**< Protects adding glyphs as draw units can run in parallel*/
+} lv_font_glyph_atlas_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a glyph atlas for a font. Labels using this font (not as a fallback) will draw
+ * the glyphs from the atlas in batches if the draw unit supports it.
+ * Only the bitmap glyphs (A1, A2, A4 and A8) are added to the atlas.
+ * @param font      pointer to a font
+ * @param w         width of the texture in pixels
+ * @param h         height of the texture in pixels
+ * @return          LV_RESULT_OK: the atlas is created or already exists; LV_RESULT_INVALID: out of memory
+ */
+lv_result_t lv_font_glyph_atlas_create(const lv_font_t * font, uint32_t w, uint32_t h);
+
+/**
+ * Delete the glyph atlas of a font created by `lv_font_glyph_atlas_create()`.
+ * Should be called before the font is deleted.
+ * If a draw unit is still using the atlas it's freed when the draw unit releases it.
+ * @param font      pointer to a font
+ */
+void lv_font_glyph_atlas_delete(const lv_font_t * font);
+
+/**
+ * Drop the glyphs of the atlas of a font, e.g. when the size of the font has changed.
+ * The atlas is replaced by an empty one of the same size. The draw units still using
+ * the old atlas keep it until they release it.
+ * @param font      pointer to a font
+ */
+void lv_font_glyph_atlas_invalidate(const lv_font_t * font);
+
+/**
+ * Get the glyph atlas of a font and keep it alive until `lv_font_glyph_atlas_release()` is called.
+ * @param font      pointer to a font
+ * @return          the atlas or NULL if the font has no atlas
+ */
+lv_font_glyph_atlas_t * lv_font_glyph_atlas_acquire(const lv_font_t * font);
+
+/**
+ * Release an atlas acquired by `lv_font_glyph_atlas_acquire()`.
+ * Free it if it was deleted in the meantime.
+ * @param atlas     pointer to an atlas
+ */
+void lv_font_glyph_atlas_release(lv_font_glyph_atlas_t * atlas);
+
+/**
+ * Get the area of a glyph on the texture of an atlas. Add the glyph to the atlas if it's not there yet.
+ * @param atlas     pointer to an atlas
+ * @param g         the descriptor of the glyph returned by `lv_font_get_glyph_dsc()`
+ * @param letter    the UNICODE letter
+ * @param area      store the area of the glyph on the texture here
+ * @return          true: the glyph is on the texture; false: it's not a bitmap glyph or it doesn't fit
+ */
+bool lv_font_glyph_atlas_get_glyph(lv_font_glyph_atlas_t * atlas, lv_font_glyph_dsc_t * g, uint32_t letter,
+                                   lv_area_t * area);
+
+/**
+ * Initialize the list of glyph atlases. Called by `lv_init()`.
+ */
+void _lv_font_glyph_atlas_init(void);
+
+/**
+ * Delete all the glyph atlases. Called by `lv_deinit()`.
+ */
+void _lv_font_glyph_atlas_deinit(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_FONT_GLYPH_ATLAS*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_FONT_GLYPH_ATLAS_H*/
@@ -23726,6 +23726,9 @@ static const lv_font_fmt_txt_cmap_t cmaps[] = {
  *  ALL CUSTOM DATA
  *--------------------*/
 
+/*Place of the glyph ID lookup table, see `lv_font_fmt_txt_glyph_id_table_create()`*/
+static lv_font_fmt_txt_glyph_id_table_t * glyph_id_table;
+
 #if LVGL_VERSION_MAJOR >= 8
 /*Store all the custom data of the font*/
 
@@ -23742,6 +23745,7 @@ static lv_font_fmt_txt_dsc_t font_dsc = {
     .bpp = 4,
     .kern_classes = 0,
     .bitmap_format = 0,
+    .glyph_id_table = &glyph_id_table,
 
 };
 
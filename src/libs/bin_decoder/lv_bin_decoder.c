@@ -50,6 +50,9 @@ typedef struct {
     lv_draw_buf_t * decompressed;       /*Decompressed data could be used directly, thus must also be draw buf*/
     lv_draw_buf_t c_array;              /*An C-array image that need to be converted to a draw buf*/
     lv_draw_buf_t * decoded_partial;    /*A draw buf for decoded image via get_area_cb*/
+    const void * map;                   /*The content of the file mapped to the memory*/
+    uint32_t map_size;
+    lv_draw_buf_t mapped;               /*A draw buf pointing into the mapped file*/
 } decoder_data_t;
 
 /**********************
@@ -57,6 +60,7 @@ typedef struct {
  **********************/
 static decoder_data_t * get_decoder_data(lv_image_decoder_dsc_t * dsc);
 static void free_decoder_data(lv_image_decoder_dsc_t * dsc);
+static void decoder_data_delete(decoder_data_t * decoder_data);
 static lv_result_t decode_indexed(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
 static lv_result_t load_indexed(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
 #if LV_BIN_DECODER_RAM_LOAD
@@ -66,6 +70,11 @@ static lv_result_t decode_alpha_only(lv_image_decoder_t * decoder, lv_image_deco
 static lv_result_t decode_indexed_line(lv_color_format_t color_format, const lv_color32_t * palette, int32_t x,
                                        int32_t w_px, const uint8_t * in, lv_color32_t * out);
 static lv_result_t decode_compressed(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
+static lv_result_t map_file(lv_image_decoder_dsc_t * dsc);
+#if LV_CACHE_DEF_SIZE > 0
+    static void cache_mapped(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
+    static void bin_decoder_cache_free_cb(lv_image_cache_data_t * cached_data, void * user_data);
+#endif
 
 static lv_fs_res_t fs_read_file_at(lv_fs_file_t * f, uint32_t pos, void * buff, uint32_t btr, uint32_t * br);
 
@@ -101,7 +110,12 @@ void lv_bin_decoder_init(void)
     lv_image_decoder_set_open_cb(decoder, lv_bin_decoder_open);
     lv_image_decoder_set_get_area_cb(decoder, lv_bin_decoder_get_area);
     lv_image_decoder_set_close_cb(decoder, lv_bin_decoder_close);
+#if LV_CACHE_DEF_SIZE > 0
+    /*Also unmaps the mapped files*/
+    lv_image_decoder_set_cache_free_cb(decoder, (lv_cache_free_cb_t)bin_decoder_cache_free_cb);
+#else
     lv_image_decoder_set_cache_free_cb(decoder, NULL); /*Use general cache free method*/
+#endif
 }
 
 lv_result_t lv_bin_decoder_info(lv_image_decoder_t * decoder, const void * src, lv_image_header_t * header)
@@ -208,11 +222,16 @@ lv_result_t lv_bin_decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_d
 
         lv_color_format_t cf = dsc->header.cf;
 
-        if(dsc->header.flags & LV_IMAGE_FLAGS_COMPRESSED) {
+        if(map_file(dsc) == LV_RESULT_OK) {
+            res = LV_RESULT_OK;
+            use_directly = true; /*The mapped file can be used like a C array*/
+        }
+        else if(dsc->header.flags & LV_IMAGE_FLAGS_COMPRESSED) {
             res = decode_compressed(decoder, dsc);
         }
         else if(LV_COLOR_FORMAT_IS_INDEXED(cf)) {
-            if(dsc->args.use_indexed) {
+            /*Without LV_BIN_DECODER_RAM_LOAD the lines are converted one by one in get_area_cb instead*/
+            if(dsc->args.use_indexed && LV_BIN_DECODER_RAM_LOAD) {
                 /*Palette for indexed image and whole image of A8 image are always loaded to RAM for simplicity*/
                 res = load_indexed(decoder, dsc);
             }
@@ -325,7 +344,17 @@ lv_result_t lv_bin_decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_d
     }
     dsc->decoded = adjusted;
 
-    if(use_directly || dsc->args.no_cache) return LV_RESULT_OK; /*Do not put image to cache if it can be used directly.*/
+    if(dsc->args.no_cache) return LV_RESULT_OK;
+
+#if LV_CACHE_DEF_SIZE > 0
+    /*Keep the mapped files in the cache instead of mapping them again on every open*/
+    if(use_directly && dsc->src_type == LV_IMAGE_SRC_FILE) {
+        cache_mapped(decoder, dsc);
+        return LV_RESULT_OK;
+    }
+#endif
+
+    if(use_directly) return LV_RESULT_OK; /*Do not put image to cache if it can be used directly.*/
 
 #if LV_CACHE_DEF_SIZE > 0
 
@@ -333,9 +362,10 @@ lv_result_t lv_bin_decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_d
     lv_image_cache_data_t search_key;
     search_key.src_type = dsc->src_type;
     search_key.src = dsc->src;
+    search_key.downscale = 0;
     search_key.slot.size = dsc->decoded->data_size;
 
-    lv_cache_entry_t * cache_entry = lv_image_decoder_add_to_cache(decoder, &search_key, dsc->decoded, dsc->user_data);
+    lv_cache_entry_t * cache_entry = lv_image_decoder_add_to_cache(decoder, &search_key, dsc->decoded, NULL);
     if(cache_entry == NULL) {
         free_decoder_data(dsc);
         return LV_RESULT_INVALID;
@@ -535,6 +565,14 @@ static void free_decoder_data(lv_image_decoder_dsc_t * dsc)
     decoder_data_t * decoder_data = dsc->user_data;
     if(decoder_data == NULL) return;
 
+    decoder_data_delete(decoder_data);
+    dsc->user_data = NULL;
+}
+
+static void decoder_data_delete(decoder_data_t * decoder_data)
+{
+    if(decoder_data->map) lv_fs_unmap(decoder_data->f, decoder_data->map, decoder_data->map_size);
+
     if(decoder_data->f) {
         lv_fs_close(decoder_data->f);
         lv_free(decoder_data->f);
@@ -544,7 +582,6 @@ static void free_decoder_data(lv_image_decoder_dsc_t * dsc)
     if(decoder_data->decompressed) lv_draw_buf_destroy(decoder_data->decompressed);
     lv_free(decoder_data->palette);
     lv_free(decoder_data);
-    dsc->user_data = NULL;
 }
 
 static lv_result_t decode_indexed(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc)
@@ -669,17 +706,8 @@ exit_with_buf:
 
 static lv_result_t load_indexed(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc)
 {
-#if LV_BIN_DECODER_RAM_LOAD == 0
-    LV_UNUSED(decoder); /*Unused*/
-    LV_UNUSED(dsc); /*Unused*/
-    LV_LOG_ERROR("LV_BIN_DECODER_RAM_LOAD is disabled");
-    return LV_RESULT_INVALID;
-#else
-
     LV_UNUSED(decoder); /*Unused*/
 
-    lv_result_t res;
-    uint32_t rn;
     decoder_data_t * decoder_data = dsc->user_data;
 
     if(dsc->header.flags & LV_IMAGE_FLAGS_COMPRESSED) {
@@ -714,6 +742,12 @@ static lv_result_t load_indexed(lv_image_decoder_t * decoder, lv_image_decoder_d
     }
 
     if(dsc->src_type == LV_IMAGE_SRC_FILE) {
+#if LV_BIN_DECODER_RAM_LOAD == 0
+        LV_LOG_ERROR("LV_BIN_DECODER_RAM_LOAD is disabled");
+        return LV_RESULT_INVALID;
+#else
+        lv_result_t res;
+        uint32_t rn;
         lv_color_format_t cf = dsc->header.cf;
         lv_fs_file_t * f = decoder_data->f;
         lv_draw_buf_t * decoded = lv_draw_buf_create(dsc->header.w, dsc->header.h, cf, dsc->header.stride);
@@ -752,11 +786,11 @@ static lv_result_t load_indexed(lv_image_decoder_t * decoder, lv_image_decoder_d
         decoder_data->decoded = decoded;
         dsc->decoded = decoded;
         return LV_RESULT_OK;
+#endif
     }
 
     LV_LOG_ERROR("Unknown src type: %d", dsc->src_type);
     return LV_RESULT_INVALID;
-#endif
 }
 
 #if LV_BIN_DECODER_RAM_LOAD
@@ -1039,6 +1073,103 @@ static lv_result_t decode_indexed_line(lv_color_format_t color_format, const lv_
     return LV_RESULT_OK;
 }
 
+/**
+ * Use the image directly from the file mapped to the memory if the driver supports it
+ * and the image can be drawn as it's stored in the file.
+ * @return LV_RESULT_OK: `dsc->decoded` points into the file; LV_RESULT_INVALID: read the file instead
+ */
+static lv_result_t map_file(lv_image_decoder_dsc_t * dsc)
+{
+    decoder_data_t * decoder_data = dsc->user_data;
+    lv_color_format_t cf = dsc->header.cf;
+
+    if(dsc->header.flags & LV_IMAGE_FLAGS_COMPRESSED) return LV_RESULT_INVALID;
+
+    /*A1/2/4 and indexed images without `use_indexed` need to be converted*/
+    bool supported = cf == LV_COLOR_FORMAT_A8
+                     || cf == LV_COLOR_FORMAT_L8
+                     || cf == LV_COLOR_FORMAT_ARGB8888
+                     || cf == LV_COLOR_FORMAT_XRGB8888
+                     || cf == LV_COLOR_FORMAT_RGB888
+                     || cf == LV_COLOR_FORMAT_RGB565
+                     || cf == LV_COLOR_FORMAT_RGB565A8
+                     || cf == LV_COLOR_FORMAT_ARGB8565
+                     || (LV_COLOR_FORMAT_IS_INDEXED(cf) && dsc->args.use_indexed);
+    if(!supported) return LV_RESULT_INVALID;
+
+    const void * map;
+    uint32_t map_size;
+    if(lv_fs_map(decoder_data->f, &map, &map_size) != LV_FS_RES_OK) return LV_RESULT_INVALID;
+
+    uint32_t data_size = sizeof(lv_color32_t) * LV_COLOR_INDEXED_PALETTE_SIZE(cf) + dsc->header.stride * dsc->header.h;
+    if(cf == LV_COLOR_FORMAT_RGB565A8) data_size += (dsc->header.stride / 2) * dsc->header.h; /*A8 mask*/
+
+    uint8_t * data = (uint8_t *)map + sizeof(lv_image_header_t);
+    if(map_size < sizeof(lv_image_header_t) + data_size || lv_draw_buf_align(data, cf) != data) {
+        lv_fs_unmap(decoder_data->f, map, map_size);
+        return LV_RESULT_INVALID;
+    }
+
+    lv_draw_buf_t * decoded = &decoder_data->mapped;
+    lv_draw_buf_init(decoded, dsc->header.w, dsc->header.h, cf, dsc->header.stride, data, data_size);
+
+    /*The mapping is read only and not allocated by LVGL*/
+    decoded->header.flags = dsc->header.flags & ~(LV_IMAGE_FLAGS_MODIFIABLE | LV_IMAGE_FLAGS_ALLOCATED);
+
+    decoder_data->map = map;
+    decoder_data->map_size = map_size;
+    dsc->decoded = decoded;
+    return LV_RESULT_OK;
+}
+
+#if LV_CACHE_DEF_SIZE > 0
+/**
+ * Add a mapped file to the cache. The cache entry takes over the decoder data with the
+ * open file and the mapping. If it can't be cached, it's unmapped on close as before.
+ * The entry is charged with the mapped size, so the cache size limits the number of
+ * open files and mappings like it limits the decoded images.
+ */
+static void cache_mapped(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc)
+{
+    /*Only this decoder's cache free callback unmaps the files*/
+    if(decoder->cache_free_cb != (lv_cache_free_cb_t)bin_decoder_cache_free_cb) return;
+
+    /*The indexed images are mapped only with `use_indexed`, but the cache key doesn't tell it*/
+    if(LV_COLOR_FORMAT_IS_INDEXED(dsc->header.cf)) return;
+
+    decoder_data_t * decoder_data = dsc->user_data;
+    if(decoder_data == NULL || decoder_data->map == NULL || dsc->decoded != &decoder_data->mapped) return;
+
+    lv_image_cache_data_t search_key;
+    search_key.src_type = dsc->src_type;
+    search_key.src = dsc->src;
+    search_key.downscale = 0;
+    search_key.slot.size = decoder_data->map_size;
+
+    lv_cache_entry_t * cache_entry = lv_image_decoder_add_to_cache(decoder, &search_key, dsc->decoded, decoder_data);
+    if(cache_entry == NULL) return;
+
+    dsc->cache_entry = cache_entry;
+    dsc->user_data = NULL; /*Cache will take care of it*/
+}
+
+static void bin_decoder_cache_free_cb(lv_image_cache_data_t * cached_data, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    /*Only the mapped files have decoder data, and their draw buffer points into the mapping*/
+    if(cached_data->user_data) {
+        decoder_data_delete(cached_data->user_data);
+    }
+    else if(lv_draw_buf_has_flag((lv_draw_buf_t *)cached_data->decoded, LV_IMAGE_FLAGS_ALLOCATED)) {
+        lv_draw_buf_destroy((lv_draw_buf_t *)cached_data->decoded);
+    }
+
+    /*Free the duplicated file name*/
+    if(cached_data->src_type == LV_IMAGE_SRC_FILE) lv_free((void *)cached_data->src);
+}
+#endif
+
 static lv_fs_res_t fs_read_file_at(lv_fs_file_t * f, uint32_t pos, void * buff, uint32_t btr, uint32_t * br)
 {
     lv_fs_res_t res;
@@ -86,6 +86,8 @@ lv_result_t lv_freetype_init(uint32_t max_faces, uint32_t max_sizes, uint32_t ma
     error = FT_Init_FreeType(&ctx->library);
     if(error) {
         FT_ERROR_MSG("FT_Init_FreeType", error);
+        lv_free(ft_ctx);
+        ft_ctx = NULL;
         return LV_RESULT_INVALID;
     }
 
@@ -99,6 +101,8 @@ lv_result_t lv_freetype_init(uint32_t max_faces, uint32_t max_sizes, uint32_t ma
     if(error) {
         FT_ERROR_MSG("FTC_Manager_New", error);
         lv_freetype_cleanup(ctx);
+        lv_free(ft_ctx);
+        ft_ctx = NULL;
         return LV_RESULT_INVALID;
     }
 
@@ -106,9 +110,15 @@ lv_result_t lv_freetype_init(uint32_t max_faces, uint32_t max_sizes, uint32_t ma
     if(error) {
         FT_ERROR_MSG("FTC_CMapCache_New", error);
         lv_freetype_cleanup(ctx);
+        lv_free(ft_ctx);
+        ft_ctx = NULL;
         return LV_RESULT_INVALID;
     }
 
+    /*Create the lock and the pre-renderer only if FreeType could be initialized to not leak them on error*/
+    lv_mutex_init(&ctx->lock);
+    lv_freetype_prerender_init(ctx);
+
     _lv_ll_init(&ctx->face_id_ll, sizeof(face_id_node_t));
 
     lv_cache_ops_t ops = {
@@ -124,7 +134,10 @@ lv_result_t lv_freetype_init(uint32_t max_faces, uint32_t max_sizes, uint32_t ma
 void lv_freetype_uninit(void)
 {
     lv_freetype_context_t * ctx = lv_freetype_get_context();
+    if(ctx == NULL) return;
+    lv_freetype_prerender_deinit(ctx);
     lv_freetype_cleanup(ctx);
+    lv_mutex_delete(&ctx->lock);
 
     lv_free(ft_ctx);
     ft_ctx = NULL;
@@ -140,6 +153,7 @@ lv_font_t * lv_freetype_font_create(const char * pathname, lv_freetype_font_rend
     LV_ASSERT(pathname_len > 0);
 
     lv_freetype_context_t * ctx = lv_freetype_get_context();
+    lv_mutex_lock(&ctx->lock);
 
     lv_freetype_cache_node_t search_key = {
         .pathname = lv_freetype_req_face_id(ctx, pathname),
@@ -155,6 +169,7 @@ lv_font_t * lv_freetype_font_create(const char * pathname, lv_freetype_font_rend
         if(cache_node_entry == NULL) {
             lv_freetype_drop_face_id(ctx, (FTC_FaceID)search_key.pathname);
             LV_LOG_ERROR("cache node creating failed");
+            lv_mutex_unlock(&ctx->lock);
             return NULL;
         }
     }
@@ -175,6 +190,7 @@ lv_font_t * lv_freetype_font_create(const char * pathname, lv_freetype_font_rend
         lv_cache_release(ctx->cache_node_cache, dsc->cache_node_entry, NULL);
         lv_freetype_drop_face_id(ctx, dsc->face_id);
         lv_free(dsc);
+        lv_mutex_unlock(&ctx->lock);
         return NULL;
     }
     freetype_on_font_set_cbs(dsc);
@@ -192,6 +208,7 @@ lv_font_t * lv_freetype_font_create(const char * pathname, lv_freetype_font_rend
     int8_t thickness = FT_F26DOT6_TO_INT(FT_MulFix(scale, face->underline_thickness));
     font->underline_position = FT_F26DOT6_TO_INT(FT_MulFix(scale, face->underline_position));
     font->underline_thickness = thickness < 1 ? 1 : thickness;
+    lv_mutex_unlock(&ctx->lock);
 
     return font;
 }
@@ -204,12 +221,17 @@ void lv_freetype_font_delete(lv_font_t * font)
     LV_ASSERT_NULL(dsc);
     LV_ASSERT_FREETYPE_FONT_DSC(dsc);
 
+    /*Also waits for the glyph being pre-rendered right now*/
+    lv_freetype_prerender_drop_font(dsc);
+
+    lv_mutex_lock(&ctx->lock);
     lv_cache_release(ctx->cache_node_cache, dsc->cache_node_entry, NULL);
     if(lv_cache_entry_get_ref(dsc->cache_node_entry) == 0) {
         lv_cache_drop(ctx->cache_node_cache, dsc->cache_node, NULL);
     }
 
     lv_freetype_drop_face_id(dsc->context, dsc->face_id);
+    lv_mutex_unlock(&ctx->lock);
 
     /* invalidate magic number */
     lv_memzero(dsc, sizeof(lv_freetype_font_dsc_t));
@@ -131,6 +131,33 @@ uint32_t lv_freetype_outline_get_scale(const lv_font_t * font);
  */
 bool lv_freetype_is_outline_font(const lv_font_t * font);
 
+/**
+ * Render the glyphs of a text in the background to have them in the cache
+ * when the text is drawn the first time. E.g. call it before creating a screen with a lot of CJK text.
+ * With an OS (`LV_USE_OS`) the glyphs are rendered by a low priority thread,
+ * else by a timer which renders a few glyphs in each period.
+ * Only the glyph descriptors are prepared for outline fonts.
+ * @param font  a FreeType font
+ * @param txt   the text whose letters should be rendered
+ * @return LV_RESULT_OK: the letters are queued; LV_RESULT_INVALID: out of memory
+ */
+lv_result_t lv_freetype_font_prerender_text(lv_font_t * font, const char * txt);
+
+/**
+ * Render the glyphs of a range of letters in the background. See `lv_freetype_font_prerender_text()`.
+ * @param font      a FreeType font
+ * @param first     the first Unicode letter to render
+ * @param last      the last Unicode letter to render (inclusive)
+ * @return LV_RESULT_OK: the letters are queued; LV_RESULT_INVALID: out of memory
+ */
+lv_result_t lv_freetype_font_prerender_range(lv_font_t * font, uint32_t first, uint32_t last);
+
+/**
+ * Get the number of letters which are requested to be rendered but not rendered yet.
+ * @return the number of pending letters of all fonts
+ */
+uint32_t lv_freetype_prerender_get_pending_cnt(void);
+
 /**********************
  *      MACROS
  **********************/
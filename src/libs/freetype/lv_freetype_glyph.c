@@ -99,8 +99,10 @@ static bool freetype_get_glyph_dsc_cb(const lv_font_t * font, lv_font_glyph_dsc_
 
     lv_cache_t * glyph_cache = dsc->cache_node->glyph_cache;
 
+    lv_mutex_lock(&dsc->context->lock);
     lv_cache_entry_t * entry = lv_cache_acquire_or_create(glyph_cache, &search_key, dsc);
     if(entry == NULL) {
+        lv_mutex_unlock(&dsc->context->lock);
         LV_LOG_ERROR("glyph lookup failed for unicode = 0x%" LV_PRIx32, unicode_letter);
         return false;
     }
@@ -114,6 +116,7 @@ static bool freetype_get_glyph_dsc_cb(const lv_font_t * font, lv_font_glyph_dsc_
     g_dsc->entry = NULL;
 
     lv_cache_release(glyph_cache, entry, NULL);
+    lv_mutex_unlock(&dsc->context->lock);
     return true;
 }
 
@@ -86,6 +86,7 @@ static const void * freetype_get_glyph_bitmap_cb(lv_font_glyph_dsc_t * g_dsc,
     lv_freetype_font_dsc_t * dsc = (lv_freetype_font_dsc_t *)font->dsc;
     LV_ASSERT_FREETYPE_FONT_DSC(dsc);
 
+    lv_mutex_lock(&dsc->context->lock);
     FT_Face face = dsc->cache_node->face;
     FT_UInt charmap_index = FT_Get_Charmap_Index(face->charmap);
     FT_UInt glyph_index = FTC_CMapCache_Lookup(dsc->context->cmap_cache, dsc->face_id, charmap_index, unicode_letter);
@@ -98,6 +99,7 @@ static const void * freetype_get_glyph_bitmap_cb(lv_font_glyph_dsc_t * g_dsc,
     };
 
     lv_cache_entry_t * entry = lv_cache_acquire_or_create(cache, &search_key, dsc);
+    lv_mutex_unlock(&dsc->context->lock);
 
     g_dsc->entry = entry;
     lv_freetype_image_cache_data_t * cache_node = lv_cache_entry_get_data(entry);
@@ -109,7 +111,9 @@ static void freetype_image_release_cb(const lv_font_t * font, lv_font_glyph_dsc_
 {
     LV_ASSERT_NULL(font);
     lv_freetype_font_dsc_t * dsc = (lv_freetype_font_dsc_t *)font->dsc;
+    lv_mutex_lock(&dsc->context->lock);
     lv_cache_release(dsc->cache_node->draw_data_cache, g_dsc->entry, NULL);
+    lv_mutex_unlock(&dsc->context->lock);
     g_dsc->entry = NULL;
 }
 
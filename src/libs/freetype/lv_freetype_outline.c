@@ -160,7 +160,9 @@ static const void * freetype_get_glyph_bitmap_cb(lv_font_glyph_dsc_t * g_dsc,
     const lv_font_t * font = g_dsc->resolved_font;
     lv_freetype_font_dsc_t * dsc = (lv_freetype_font_dsc_t *)font->dsc;
     LV_ASSERT_FREETYPE_FONT_DSC(dsc);
+    lv_mutex_lock(&dsc->context->lock);
     lv_cache_entry_t * entry = lv_freetype_outline_lookup(dsc, unicode_letter);
+    lv_mutex_unlock(&dsc->context->lock);
     if(entry == NULL) {
         return NULL;
     }
@@ -179,7 +181,9 @@ static void freetype_release_glyph_cb(const lv_font_t * font, lv_font_glyph_dsc_
     if(g_dsc->entry == NULL) {
         return;
     }
+    lv_mutex_lock(&dsc->context->lock);
     lv_cache_release(dsc->cache_node->draw_data_cache, g_dsc->entry, NULL);
+    lv_mutex_unlock(&dsc->context->lock);
     g_dsc->entry = NULL;
 }
 
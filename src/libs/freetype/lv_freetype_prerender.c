@@ -0,0 +1,292 @@
+/**
+ * @file lv_freetype_prerender.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lv_freetype_private.h"
+
+#if LV_USE_FREETYPE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define ft_ctx LV_GLOBAL_DEFAULT()->ft_context
+
+/*Without OS the glyphs are rendered by a timer for at most this long in each period*/
+#define PRERENDER_TIMER_PERIOD  10
+#define PRERENDER_TIME_LIMIT    4
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    lv_freetype_font_dsc_t * dsc;
+    uint32_t next;      /**< The next letter to render*/
+    uint32_t last;      /**< The last letter to render (inclusive)*/
+} prerender_req_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static lv_result_t prerender_add(lv_freetype_context_t * ctx, lv_freetype_font_dsc_t * dsc, uint32_t first,
+                                 uint32_t last);
+static void prerender_start(lv_freetype_context_t * ctx);
+static bool prerender_next(lv_freetype_context_t * ctx);
+static void prerender_glyph(lv_freetype_font_dsc_t * dsc, uint32_t letter);
+
+#if LV_USE_OS
+    static void prerender_thread_cb(void * ptr);
+#else
+    static void prerender_timer_cb(lv_timer_t * timer);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lv_freetype_prerender_init(lv_freetype_context_t * ctx)
+{
+    lv_mutex_init(&ctx->prerender_lock);
+    _lv_ll_init(&ctx->prerender_ll, sizeof(prerender_req_t));
+}
+
+void lv_freetype_prerender_deinit(lv_freetype_context_t * ctx)
+{
+#if LV_USE_OS
+    if(ctx->prerender_started) {
+        ctx->prerender_exit = true;
+        lv_thread_sync_signal(&ctx->prerender_sync);
+        lv_thread_delete(&ctx->prerender_thread);
+        lv_thread_sync_delete(&ctx->prerender_sync);
+        ctx->prerender_started = false;
+    }
+#else
+    if(ctx->prerender_timer) {
+        lv_timer_delete(ctx->prerender_timer);
+        ctx->prerender_timer = NULL;
+    }
+#endif
+
+    _lv_ll_clear(&ctx->prerender_ll);
+    lv_mutex_delete(&ctx->prerender_lock);
+}
+
+void lv_freetype_prerender_drop_font(lv_freetype_font_dsc_t * dsc)
+{
+    lv_freetype_context_t * ctx = dsc->context;
+
+    lv_mutex_lock(&ctx->prerender_lock);
+    prerender_req_t * req = _lv_ll_get_head(&ctx->prerender_ll);
+    while(req) {
+        prerender_req_t * req_next = _lv_ll_get_next(&ctx->prerender_ll, req);
+        if(req->dsc == dsc) {
+            _lv_ll_remove(&ctx->prerender_ll, req);
+            lv_free(req);
+        }
+        req = req_next;
+    }
+    lv_mutex_unlock(&ctx->prerender_lock);
+}
+
+lv_result_t lv_freetype_font_prerender_text(lv_font_t * font, const char * txt)
+{
+    LV_ASSERT_NULL(font);
+    LV_ASSERT_NULL(txt);
+    lv_freetype_font_dsc_t * dsc = (lv_freetype_font_dsc_t *)font->dsc;
+    LV_ASSERT_FREETYPE_FONT_DSC(dsc);
+    lv_freetype_context_t * ctx = dsc->context;
+
+    lv_result_t res = LV_RESULT_OK;
+    lv_mutex_lock(&ctx->prerender_lock);
+    uint32_t i = 0;
+    while(txt[i] != '\0') {
+        uint32_t letter = _lv_text_encoded_next(txt, &i);
+        if(letter < 0x20) continue;
+
+        res = prerender_add(ctx, dsc, letter, letter);
+        if(res != LV_RESULT_OK) break;
+    }
+    lv_mutex_unlock(&ctx->prerender_lock);
+
+    prerender_start(ctx);
+    return res;
+}
+
+lv_result_t lv_freetype_font_prerender_range(lv_font_t * font, uint32_t first, uint32_t last)
+{
+    LV_ASSERT_NULL(font);
+    lv_freetype_font_dsc_t * dsc = (lv_freetype_font_dsc_t *)font->dsc;
+    LV_ASSERT_FREETYPE_FONT_DSC(dsc);
+    lv_freetype_context_t * ctx = dsc->context;
+
+    if(first < 0x20) first = 0x20;
+    if(first > last) return LV_RESULT_OK;
+
+    lv_mutex_lock(&ctx->prerender_lock);
+    lv_result_t res = prerender_add(ctx, dsc, first, last);
+    lv_mutex_unlock(&ctx->prerender_lock);
+
+    prerender_start(ctx);
+    return res;
+}
+
+uint32_t lv_freetype_prerender_get_pending_cnt(void)
+{
+    lv_freetype_context_t * ctx = ft_ctx;
+    if(ctx == NULL) return 0;
+
+    uint32_t cnt = 0;
+    lv_mutex_lock(&ctx->prerender_lock);
+    prerender_req_t * req;
+    _LV_LL_READ(&ctx->prerender_ll, req) {
+        cnt += req->last - req->next + 1;
+    }
+    lv_mutex_unlock(&ctx->prerender_lock);
+
+    return cnt;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Add a range of letters to the requests. Consecutive letters of a text are merged into one range.
+ * `prerender_lock` needs to be locked.
+ */
+static lv_result_t prerender_add(lv_freetype_context_t * ctx, lv_freetype_font_dsc_t * dsc, uint32_t first,
+                                 uint32_t last)
+{
+    prerender_req_t * tail = _lv_ll_get_tail(&ctx->prerender_ll);
+    if(tail && tail->dsc == dsc && tail->last != UINT32_MAX && tail->last + 1 == first) {
+        tail->last = last;
+        return LV_RESULT_OK;
+    }
+
+    prerender_req_t * req = _lv_ll_ins_tail(&ctx->prerender_ll);
+    LV_ASSERT_MALLOC(req);
+    if(req == NULL) return LV_RESULT_INVALID;
+
+    req->dsc = dsc;
+    req->next = first;
+    req->last = last;
+    return LV_RESULT_OK;
+}
+
+/**
+ * Start or wake up the thread or timer processing the requests
+ */
+static void prerender_start(lv_freetype_context_t * ctx)
+{
+#if LV_USE_OS
+    if(!ctx->prerender_started) {
+        ctx->prerender_exit = false;
+        lv_thread_sync_init(&ctx->prerender_sync);
+        if(lv_thread_init(&ctx->prerender_thread, LV_THREAD_PRIO_LOW, prerender_thread_cb, LV_FREETYPE_PRERENDER_STACK_SIZE,
+                          ctx) != LV_RESULT_OK) {
+            LV_LOG_WARN("couldn't create the pre-render thread");
+            lv_thread_sync_delete(&ctx->prerender_sync);
+            return;
+        }
+        ctx->prerender_started = true;
+    }
+    lv_thread_sync_signal(&ctx->prerender_sync);
+#else
+    if(ctx->prerender_timer == NULL) {
+        ctx->prerender_timer = lv_timer_create(prerender_timer_cb, PRERENDER_TIMER_PERIOD, ctx);
+        LV_ASSERT_MALLOC(ctx->prerender_timer);
+    }
+    else {
+        lv_timer_resume(ctx->prerender_timer);
+    }
+#endif
+}
+
+/**
+ * Render the next requested glyph
+ * @return false: there was nothing to render
+ */
+static bool prerender_next(lv_freetype_context_t * ctx)
+{
+    lv_mutex_lock(&ctx->prerender_lock);
+    prerender_req_t * req = _lv_ll_get_head(&ctx->prerender_ll);
+    if(req == NULL) {
+        lv_mutex_unlock(&ctx->prerender_lock);
+        return false;
+    }
+
+    lv_freetype_font_dsc_t * dsc = req->dsc;
+    uint32_t letter = req->next;
+    if(req->next == req->last) {
+        _lv_ll_remove(&ctx->prerender_ll, req);
+        lv_free(req);
+    }
+    else {
+        req->next++;
+    }
+
+    /*Render with the lock held to not let the font be deleted meanwhile*/
+    prerender_glyph(dsc, letter);
+    lv_mutex_unlock(&ctx->prerender_lock);
+
+    return true;
+}
+
+static void prerender_glyph(lv_freetype_font_dsc_t * dsc, uint32_t letter)
+{
+    /*Use only this font, the fallback fonts might be not thread safe*/
+    lv_font_t * font = &dsc->font;
+    lv_font_glyph_dsc_t g;
+    lv_memzero(&g, sizeof(g));
+    if(!font->get_glyph_dsc(font, &g, letter, 0) || g.is_placeholder) return;
+
+    /*The outlines are passed to the user's event callback, don't do that from the background*/
+    if(g.format != LV_FONT_GLYPH_FORMAT_A8) return;
+
+    g.resolved_font = font;
+    font->get_glyph_bitmap(&g, letter, NULL);
+    if(g.entry && font->release_glyph) font->release_glyph(font, &g);
+}
+
+#if LV_USE_OS
+static void prerender_thread_cb(void * ptr)
+{
+    lv_freetype_context_t * ctx = ptr;
+
+    while(!ctx->prerender_exit) {
+        if(!prerender_next(ctx)) {
+            lv_thread_sync_wait(&ctx->prerender_sync);
+        }
+    }
+}
+#else
+static void prerender_timer_cb(lv_timer_t * timer)
+{
+    lv_freetype_context_t * ctx = lv_timer_get_user_data(timer);
+
+    uint32_t start = lv_tick_get();
+    while(lv_tick_elaps(start) < PRERENDER_TIME_LIMIT) {
+        if(!prerender_next(ctx)) {
+            lv_timer_pause(timer);
+            break;
+        }
+    }
+}
+#endif
+
+#endif /*LV_USE_FREETYPE*/
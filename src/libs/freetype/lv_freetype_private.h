@@ -86,6 +86,21 @@ typedef struct _lv_freetype_context_t {
     lv_event_cb_t event_cb;
 
     lv_cache_t * cache_node_cache;
+
+    /*FreeType is not thread safe. Protects it when glyphs are rendered in the background.*/
+    lv_mutex_t lock;
+
+    /*Pre-rendering the glyphs of the texts which will be drawn soon*/
+    lv_mutex_t prerender_lock;      /**< Protects the requests and held while a glyph is rendered*/
+    lv_ll_t prerender_ll;           /**< The requested letter ranges*/
+#if LV_USE_OS
+    lv_thread_t prerender_thread;
+    lv_thread_sync_t prerender_sync;
+    bool prerender_started;
+    bool prerender_exit;
+#else
+    lv_timer_t * prerender_timer;
+#endif
 } lv_freetype_context_t;
 
 typedef struct _lv_freetype_font_dsc_t {
@@ -134,6 +149,15 @@ void lv_freetype_set_cbs_image_font(lv_freetype_font_dsc_t * dsc);
 lv_cache_t * lv_freetype_create_draw_data_outline(void);
 void lv_freetype_set_cbs_outline_font(lv_freetype_font_dsc_t * dsc);
 
+void lv_freetype_prerender_init(lv_freetype_context_t * ctx);
+void lv_freetype_prerender_deinit(lv_freetype_context_t * ctx);
+
+/**
+ * Remove the pending pre-render requests of a font. Waits for the glyph being rendered.
+ * @param dsc the font descriptor to be deleted
+ */
+void lv_freetype_prerender_drop_font(lv_freetype_font_dsc_t * dsc);
+
 /**********************
  *      MACROS
  **********************/
@@ -15,6 +15,10 @@
 #include <sys/types.h>
 #include <dirent.h>
 #include <unistd.h>
+#if LV_FS_POSIX_MMAP
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
 
 /*********************
  *      DEFINES
@@ -43,6 +47,10 @@ static lv_fs_res_t fs_read(lv_fs_drv_t * drv, void * file_p, void * buf, uint32_
 static lv_fs_res_t fs_write(lv_fs_drv_t * drv, void * file_p, const void * buf, uint32_t btw, uint32_t * bw);
 static lv_fs_res_t fs_seek(lv_fs_drv_t * drv, void * file_p, uint32_t pos, lv_fs_whence_t whence);
 static lv_fs_res_t fs_tell(lv_fs_drv_t * drv, void * file_p, uint32_t * pos_p);
+#if LV_FS_POSIX_MMAP
+    static lv_fs_res_t fs_map(lv_fs_drv_t * drv, void * file_p, const void ** buf_p, uint32_t * size_p);
+    static lv_fs_res_t fs_unmap(lv_fs_drv_t * drv, void * file_p, const void * buf, uint32_t size);
+#endif
 static void * fs_dir_open(lv_fs_drv_t * drv, const char * path);
 static lv_fs_res_t fs_dir_read(lv_fs_drv_t * drv, void * dir_p, char * fn, uint32_t fn_len);
 static lv_fs_res_t fs_dir_close(lv_fs_drv_t * drv, void * dir_p);
@@ -81,6 +89,10 @@ void lv_fs_posix_init(void)
     fs_drv_p->write_cb = fs_write;
     fs_drv_p->seek_cb = fs_seek;
     fs_drv_p->tell_cb = fs_tell;
+#if LV_FS_POSIX_MMAP
+    fs_drv_p->map_cb = fs_map;
+    fs_drv_p->unmap_cb = fs_unmap;
+#endif
 
     fs_drv_p->dir_close_cb = fs_dir_close;
     fs_drv_p->dir_open_cb = fs_dir_open;
@@ -212,6 +224,47 @@ static lv_fs_res_t fs_tell(lv_fs_drv_t * drv, void * file_p, uint32_t * pos_p)
     return offset < 0 ? LV_FS_RES_FS_ERR : LV_FS_RES_OK;
 }
 
+#if LV_FS_POSIX_MMAP
+/**
+ * Map the whole file to the memory
+ * @param drv       pointer to a driver where this function belongs
+ * @param file_p    a file handle variable
+ * @param buf_p     pointer to store the address of the content
+ * @param size_p    pointer to store the size of the file
+ * @return LV_FS_RES_OK or any error from lv_fs_res_t enum
+ */
+static lv_fs_res_t fs_map(lv_fs_drv_t * drv, void * file_p, const void ** buf_p, uint32_t * size_p)
+{
+    LV_UNUSED(drv);
+
+    struct stat st;
+    if(fstat(FILEP2FD(file_p), &st) < 0) return LV_FS_RES_FS_ERR;
+    if(st.st_size == 0 || (uint64_t)st.st_size > UINT32_MAX) return LV_FS_RES_NOT_IMP;
+
+    void * buf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, FILEP2FD(file_p), 0);
+    if(buf == MAP_FAILED) return LV_FS_RES_FS_ERR;
+
+    *buf_p = buf;
+    *size_p = st.st_size;
+    return LV_FS_RES_OK;
+}
+
+/**
+ * Release a mapping created by `fs_map`
+ * @param drv       pointer to a driver where this function belongs
+ * @param file_p    a file handle variable
+ * @param buf       the address of the mapped content
+ * @param size      the size of the mapped content
+ * @return LV_FS_RES_OK or any error from lv_fs_res_t enum
+ */
+static lv_fs_res_t fs_unmap(lv_fs_drv_t * drv, void * file_p, const void * buf, uint32_t size)
+{
+    LV_UNUSED(drv);
+    LV_UNUSED(file_p);
+    return munmap((void *)buf, size) < 0 ? LV_FS_RES_FS_ERR : LV_FS_RES_OK;
+}
+#endif /*LV_FS_POSIX_MMAP*/
+
 /**
  * Initialize a 'fs_read_dir_t' variable for directory reading
  * @param drv   pointer to a driver where this function belongs
@@ -21,6 +21,7 @@
 #define JPEG_PIXEL_SIZE 3 /* RGB888 */
 #define JPEG_SIGNATURE 0xFFD8FF
 #define IS_JPEG_SIGNATURE(x) (((x) & 0x00FFFFFF) == JPEG_SIGNATURE)
+#define JPEG_STREAM_BUF_SIZE 4096 /* Size of the file read buffer when decoding in bands */
 
 /**********************
  *      TYPEDEFS
@@ -30,17 +31,38 @@ typedef struct error_mgr_s {
     jmp_buf jb;
 } error_mgr_t;
 
+/*State of an image decoded in bands of rows*/
+typedef struct {
+    struct jpeg_decompress_struct cinfo;    /*Must be the first to get the stream from `cinfo`*/
+    error_mgr_t jerr;
+    struct jpeg_source_mgr src;
+    lv_fs_file_t f;
+    bool started;                           /*`jpeg_start_decompress` is called*/
+    lv_draw_buf_t * band;                   /*The last decoded rows*/
+    JOCTET buf[JPEG_STREAM_BUF_SIZE];
+} jpeg_stream_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static lv_result_t decoder_info(lv_image_decoder_t * decoder, const void * src, lv_image_header_t * header);
 static lv_result_t decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
+static lv_result_t decoder_get_area(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc,
+                                    const lv_area_t * full_area, lv_area_t * decoded_area);
 static void decoder_close(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
-static lv_draw_buf_t * decode_jpeg_file(const char * filename);
+static lv_draw_buf_t * decode_jpeg_file(const char * filename, uint32_t downscale);
+static jpeg_stream_t * stream_open(const char * filename, int32_t w);
+static bool stream_start(jpeg_stream_t * stream, bool check_orientation);
+static void stream_close(jpeg_stream_t * stream);
+static void stream_init_source(j_decompress_ptr cinfo);
+static boolean stream_fill_input_buffer(j_decompress_ptr cinfo);
+static void stream_skip_input_data(j_decompress_ptr cinfo, long num_bytes);
+static void stream_term_source(j_decompress_ptr cinfo);
 static uint8_t * read_file(const char * filename, uint32_t * size);
 static bool get_jpeg_head_info(const char * filename, uint32_t * width, uint32_t * height, uint32_t * orientation);
 static bool get_jpeg_size(uint8_t * data, uint32_t data_size, uint32_t * width, uint32_t * height);
 static bool get_jpeg_direction(uint8_t * data, uint32_t data_size, uint32_t * orientation);
+static bool get_exif_orientation(jpeg_saved_marker_ptr marker, uint32_t * orientation);
 static void rotate_buffer(lv_draw_buf_t * decoded, uint8_t * buffer, uint32_t line_index, uint32_t angle);
 static void error_exit(j_common_ptr cinfo);
 /**********************
@@ -71,6 +93,7 @@ void lv_libjpeg_turbo_init(void)
     lv_image_decoder_t * dec = lv_image_decoder_create();
     lv_image_decoder_set_info_cb(dec, decoder_info);
     lv_image_decoder_set_open_cb(dec, decoder_open);
+    lv_image_decoder_set_get_area_cb(dec, decoder_get_area);
     lv_image_decoder_set_close_cb(dec, decoder_close);
     lv_image_decoder_set_cache_free_cb(dec, NULL); /*Use general cache free method*/
 }
@@ -164,7 +187,24 @@ static lv_result_t decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_d
     /*If it's a JPEG file...*/
     if(dsc->src_type == LV_IMAGE_SRC_FILE) {
         const char * fn = dsc->src;
-        lv_draw_buf_t * decoded = decode_jpeg_file(fn);
+
+        /*Let the IDCT scale down the image if it's drawn smaller*/
+        uint32_t downscale = lv_image_decoder_get_downscale(dsc);
+        int32_t w = (dsc->header.w + (1 << downscale) - 1) >> downscale;
+        int32_t h = (dsc->header.h + (1 << downscale) - 1) >> downscale;
+
+        /*Large images are decoded in bands in `decoder_get_area` and are not cached*/
+        uint32_t decoded_size = lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_RGB888) * h;
+        if(lv_image_decoder_is_streamed(dsc, decoded_size)) {
+            jpeg_stream_t * stream = stream_open(fn, dsc->header.w);
+            if(stream) {
+                dsc->user_data = stream;
+                return LV_RESULT_OK;
+            }
+            /*Rotated images can't be decoded in bands, try to decode them at once*/
+        }
+
+        lv_draw_buf_t * decoded = decode_jpeg_file(fn, downscale);
         if(decoded == NULL) {
             LV_LOG_WARN("decode jpeg file failed");
             return LV_RESULT_INVALID;
@@ -178,6 +218,7 @@ static lv_result_t decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_d
         lv_image_cache_data_t search_key;
         search_key.src_type = dsc->src_type;
         search_key.src = dsc->src;
+        search_key.downscale = (uint8_t)downscale;
         search_key.slot.size = decoded->data_size;
 
         lv_cache_entry_t * entry = lv_image_decoder_add_to_cache(decoder, &search_key, decoded, NULL);
@@ -194,6 +235,63 @@ static lv_result_t decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_d
     return LV_RESULT_INVALID;    /*If not returned earlier then it failed*/
 }
 
+/**
+ * Decode the next band of rows of an image opened for decoding in bands
+ * @param decoder       pointer to the decoder
+ * @param dsc           pointer to the decoder descriptor
+ * @param full_area     the area of the image to decode (relative to the image)
+ * @param decoded_area  the last decoded area, updated to the newly decoded area.
+ *                      Its `y1` is `LV_COORD_MIN` on the first call.
+ * @return              LV_RESULT_OK: a new band is decoded; LV_RESULT_INVALID: no more rows or error
+ */
+static lv_result_t decoder_get_area(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc,
+                                    const lv_area_t * full_area, lv_area_t * decoded_area)
+{
+    LV_UNUSED(decoder); /*Unused*/
+
+    jpeg_stream_t * stream = dsc->user_data;
+    if(stream == NULL) return LV_RESULT_INVALID;
+
+    int32_t y = decoded_area->y1 == LV_COORD_MIN ? full_area->y1 : decoded_area->y2 + 1;
+    if(y < 0) y = 0;
+    int32_t y_max = LV_MIN(full_area->y2, (int32_t)dsc->header.h - 1);
+    if(y > y_max) return LV_RESULT_INVALID;
+
+    struct jpeg_decompress_struct * cinfo = &stream->cinfo;
+
+    /*JPEG can be read only forward so start again to go back*/
+    if(!stream->started || (uint32_t)y < cinfo->output_scanline) {
+        if(!stream_start(stream, false)) return LV_RESULT_INVALID;
+    }
+
+    if(setjmp(stream->jerr.jb)) {
+        LV_LOG_WARN("jpeg decode failed at row %" LV_PRIu32, (uint32_t)cinfo->output_scanline);
+        jpeg_abort_decompress(cinfo);
+        stream->started = false;
+        return LV_RESULT_INVALID;
+    }
+
+    if(cinfo->output_scanline < (uint32_t)y) jpeg_skip_scanlines(cinfo, y - cinfo->output_scanline);
+
+    lv_draw_buf_t * band = stream->band;
+    int32_t h = LV_MIN(LV_IMAGE_DECODER_STREAM_BAND_HEIGHT, y_max - y + 1);
+    int32_t i;
+    for(i = 0; i < h; i++) {
+        JSAMPROW row = band->data + i * band->header.stride;
+        jpeg_read_scanlines(cinfo, &row, 1);
+    }
+
+    band->header.h = h;
+
+    decoded_area->x1 = 0;
+    decoded_area->x2 = dsc->header.w - 1;
+    decoded_area->y1 = y;
+    decoded_area->y2 = y + h - 1;
+    dsc->decoded = band;
+
+    return LV_RESULT_OK;
+}
+
 /**
  * Free the allocated resources
  */
@@ -201,6 +299,12 @@ static void decoder_close(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t *
 {
     LV_UNUSED(decoder); /*Unused*/
 
+    jpeg_stream_t * stream = dsc->user_data;
+    if(stream) {
+        stream_close(stream);
+        return;
+    }
+
     if(dsc->args.no_cache || LV_CACHE_DEF_SIZE == 0)
         lv_draw_buf_destroy((lv_draw_buf_t *)dsc->decoded);
     else
@@ -262,7 +366,7 @@ failed:
     return data;
 }
 
-static lv_draw_buf_t * decode_jpeg_file(const char * filename)
+static lv_draw_buf_t * decode_jpeg_file(const char * filename, uint32_t downscale)
 {
     /* This struct contains the JPEG decompression parameters and pointers to
      * working space (which is allocated as needed by the JPEG library).
@@ -343,6 +447,10 @@ static lv_draw_buf_t * decode_jpeg_file(const char * filename)
 
     cinfo.out_color_space = JCS_EXT_BGR;
 
+    /* Output 1/2, 1/4 or 1/8 of the size directly from the IDCT */
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = 1 << downscale;
+
     /* In this example, we don't need to change any of the defaults set by
      * jpeg_read_header(), so we do nothing here.
      */
@@ -419,6 +527,149 @@ static lv_draw_buf_t * decode_jpeg_file(const char * filename)
     return decoded;
 }
 
+/**
+ * Open a JPEG file to decode it in bands of rows
+ * @param filename  the file name
+ * @param w         width of the image
+ * @return          the stream or NULL if the image can't be decoded in bands
+ */
+static jpeg_stream_t * stream_open(const char * filename, int32_t w)
+{
+    jpeg_stream_t * stream = lv_malloc_zeroed(sizeof(jpeg_stream_t));
+    LV_ASSERT_MALLOC(stream);
+    if(stream == NULL) return NULL;
+
+    if(lv_fs_open(&stream->f, filename, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+        LV_LOG_WARN("can't open %s", filename);
+        lv_free(stream);
+        return NULL;
+    }
+
+    stream->cinfo.err = jpeg_std_error(&stream->jerr.pub);
+    stream->jerr.pub.error_exit = error_exit;
+    if(setjmp(stream->jerr.jb)) {
+        lv_fs_close(&stream->f);
+        lv_free(stream);
+        return NULL;
+    }
+    jpeg_create_decompress(&stream->cinfo);
+
+    /*Read the file in small chunks instead of loading all of it*/
+    stream->src.init_source = stream_init_source;
+    stream->src.fill_input_buffer = stream_fill_input_buffer;
+    stream->src.skip_input_data = stream_skip_input_data;
+    stream->src.resync_to_restart = jpeg_resync_to_restart;
+    stream->src.term_source = stream_term_source;
+    stream->cinfo.src = &stream->src;
+
+    stream->band = lv_draw_buf_create(w, LV_IMAGE_DECODER_STREAM_BAND_HEIGHT, LV_COLOR_FORMAT_RGB888, LV_STRIDE_AUTO);
+    if(stream->band == NULL || !stream_start(stream, true)) {
+        stream_close(stream);
+        return NULL;
+    }
+
+    return stream;
+}
+
+/**
+ * Start decoding the file from the beginning
+ * @param stream                pointer to a stream
+ * @param check_orientation     true: fail if the image needs to be rotated by its Exif orientation
+ * @return                      true: ready to read the first row
+ */
+static bool stream_start(jpeg_stream_t * stream, bool check_orientation)
+{
+    struct jpeg_decompress_struct * cinfo = &stream->cinfo;
+
+    if(setjmp(stream->jerr.jb)) {
+        LV_LOG_WARN("jpeg header read failed");
+        jpeg_abort_decompress(cinfo);
+        stream->started = false;
+        return false;
+    }
+
+    jpeg_abort_decompress(cinfo);
+    stream->started = false;
+
+    if(lv_fs_seek(&stream->f, 0, LV_FS_SEEK_SET) != LV_FS_RES_OK) return false;
+    stream->src.next_input_byte = NULL;
+    stream->src.bytes_in_buffer = 0;
+
+    jpeg_save_markers(cinfo, JPEG_APP0 + 1, check_orientation ? 0xFFFF : 0);
+    jpeg_read_header(cinfo, TRUE);
+
+    if(check_orientation) {
+        uint32_t orientation = 0;
+        get_exif_orientation(cinfo->marker_list, &orientation);
+        if(orientation != 0) {
+            jpeg_abort_decompress(cinfo);
+            return false;
+        }
+    }
+
+    cinfo->out_color_space = JCS_EXT_BGR;
+    jpeg_start_decompress(cinfo);
+    stream->started = true;
+
+    if(cinfo->output_width * cinfo->output_components > stream->band->header.stride) {
+        LV_LOG_WARN("unexpected jpeg row size");
+        jpeg_abort_decompress(cinfo);
+        stream->started = false;
+        return false;
+    }
+
+    return true;
+}
+
+static void stream_close(jpeg_stream_t * stream)
+{
+    jpeg_destroy_decompress(&stream->cinfo);
+    lv_fs_close(&stream->f);
+    if(stream->band) lv_draw_buf_destroy(stream->band);
+    lv_free(stream);
+}
+
+static void stream_init_source(j_decompress_ptr cinfo)
+{
+    LV_UNUSED(cinfo);
+}
+
+static boolean stream_fill_input_buffer(j_decompress_ptr cinfo)
+{
+    jpeg_stream_t * stream = (jpeg_stream_t *)cinfo;
+    uint32_t rn = 0;
+    lv_fs_read(&stream->f, stream->buf, JPEG_STREAM_BUF_SIZE, &rn);
+
+    /*Insert a fake EOI marker at the end of the file as libjpeg suggests*/
+    if(rn == 0) {
+        stream->buf[0] = (JOCTET)0xFF;
+        stream->buf[1] = (JOCTET)JPEG_EOI;
+        rn = 2;
+    }
+
+    stream->src.next_input_byte = stream->buf;
+    stream->src.bytes_in_buffer = rn;
+    return TRUE;
+}
+
+static void stream_skip_input_data(j_decompress_ptr cinfo, long num_bytes)
+{
+    jpeg_stream_t * stream = (jpeg_stream_t *)cinfo;
+    if(num_bytes <= 0) return;
+
+    while(num_bytes > (long)stream->src.bytes_in_buffer) {
+        num_bytes -= (long)stream->src.bytes_in_buffer;
+        stream_fill_input_buffer(cinfo);
+    }
+    stream->src.next_input_byte += num_bytes;
+    stream->src.bytes_in_buffer -= num_bytes;
+}
+
+static void stream_term_source(j_decompress_ptr cinfo)
+{
+    LV_UNUSED(cinfo);
+}
+
 static bool get_jpeg_head_info(const char * filename, uint32_t * width, uint32_t * height, uint32_t * orientation)
 {
     uint8_t * data = NULL;
@@ -496,14 +747,27 @@ static bool get_jpeg_direction(uint8_t * data, uint32_t data_size, uint32_t * or
 
     cinfo.marker->read_markers(&cinfo);
 
-    jpeg_saved_marker_ptr marker = cinfo.marker_list;
+    bool res = get_exif_orientation(cinfo.marker_list, orientation);
+
+    jpeg_destroy_decompress(&cinfo);
+
+    return res;
+}
+
+/**
+ * Get the orientation from the Exif data of the saved APP1 markers
+ * @param marker        the list of the saved markers
+ * @param orientation   store the orientation here. Not changed if there is no orientation tag.
+ * @return              false: the Exif data is invalid
+ */
+static bool get_exif_orientation(jpeg_saved_marker_ptr marker, uint32_t * orientation)
+{
     while(marker != NULL) {
         if(marker->marker == JPEG_APP0 + 1) {
             JOCTET FAR * app1_data = marker->data;
             if(TRANS_32_VALUE(true, app1_data) == JPEG_EXIF) {
                 uint16_t endian_tag = TRANS_16_VALUE(true, app1_data + 4 + 2);
                 if(!(endian_tag == JPEG_LITTLE_ENDIAN_TAG || endian_tag == JPEG_BIG_ENDIAN_TAG)) {
-                    jpeg_destroy_decompress(&cinfo);
                     return false;
                 }
                 bool is_big_endian = endian_tag == JPEG_BIG_ENDIAN_TAG;
@@ -515,13 +779,11 @@ static bool get_jpeg_direction(uint8_t * data, uint32_t data_size, uint32_t * or
                     /* ifd start: 4bytes(Exif) + 2bytes(0x00) + offset value(2bytes(align) + 2bytes(tag mark) + 4bytes(offset size)) */
                     unsigned int entry_offset = 4 + 2 + offset + 2;
                     if(entry_offset >= marker->data_length) {
-                        jpeg_destroy_decompress(&cinfo);
                         return false;
                     }
                     ifd = app1_data + entry_offset;
                     unsigned short num_entries = TRANS_16_VALUE(is_big_endian, ifd - 2);
                     if(entry_offset + num_entries * 12 >= marker->data_length) {
-                        jpeg_destroy_decompress(&cinfo);
                         return false;
                     }
                     for(int i = 0; i < num_entries; i++) {
@@ -557,9 +819,7 @@ static bool get_jpeg_direction(uint8_t * data, uint32_t data_size, uint32_t * or
         marker = marker->next;
     }
 
-    jpeg_destroy_decompress(&cinfo);
-
-    return JPEG_HEADER_OK;
+    return true;
 }
 
 static void rotate_buffer(lv_draw_buf_t * decoded, uint8_t * buffer, uint32_t line_index, uint32_t angle)
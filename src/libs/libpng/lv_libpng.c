@@ -19,14 +19,30 @@
 /**********************
  *      TYPEDEFS
  **********************/
+/*State of an image decoded in bands of rows*/
+typedef struct {
+    lv_fs_file_t f;
+    png_structp png;
+    png_infop info;
+    uint32_t next_row;      /*The next row libpng will return*/
+    lv_draw_buf_t * band;   /*The last decoded rows*/
+} png_stream_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static lv_result_t decoder_info(lv_image_decoder_t * decoder, const void * src, lv_image_header_t * header);
 static lv_result_t decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
+static lv_result_t decoder_get_area(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc,
+                                    const lv_area_t * full_area, lv_area_t * decoded_area);
 static void decoder_close(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc);
 static lv_draw_buf_t * decode_png_file(const char * filename);
+static lv_draw_buf_t * decode_png_file_downscaled(const char * filename, int32_t w, int32_t h, uint32_t downscale);
+static png_stream_t * stream_open(const char * filename, int32_t w);
+static bool stream_start(png_stream_t * stream);
+static void stream_stop(png_stream_t * stream);
+static void stream_close(png_stream_t * stream);
+static void stream_read_cb(png_structp png, png_bytep data, png_size_t length);
 
 /**********************
  *  STATIC VARIABLES
@@ -48,6 +64,7 @@ void lv_libpng_init(void)
     lv_image_decoder_t * dec = lv_image_decoder_create();
     lv_image_decoder_set_info_cb(dec, decoder_info);
     lv_image_decoder_set_open_cb(dec, decoder_open);
+    lv_image_decoder_set_get_area_cb(dec, decoder_get_area);
     lv_image_decoder_set_close_cb(dec, decoder_close);
     lv_image_decoder_set_cache_free_cb(dec, NULL); /*Use general cache free method*/
 }
@@ -126,7 +143,31 @@ static lv_result_t decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_d
     /*If it's a PNG file...*/
     if(dsc->src_type == LV_IMAGE_SRC_FILE) {
         const char * fn = dsc->src;
-        lv_draw_buf_t * decoded = decode_png_file(fn);
+
+        /*Average the pixels to a smaller image if it's drawn smaller*/
+        uint32_t downscale = lv_image_decoder_get_downscale(dsc);
+        int32_t w = (dsc->header.w + (1 << downscale) - 1) >> downscale;
+        int32_t h = (dsc->header.h + (1 << downscale) - 1) >> downscale;
+
+        /*Large images are decoded in bands in `decoder_get_area` and are not cached*/
+        uint32_t decoded_size = lv_draw_buf_width_to_stride(w, LV_COLOR_FORMAT_ARGB8888) * h;
+        if(lv_image_decoder_is_streamed(dsc, decoded_size)) {
+            png_stream_t * stream = stream_open(fn, dsc->header.w);
+            if(stream) {
+                dsc->user_data = stream;
+                return LV_RESULT_OK;
+            }
+            /*E.g. interlaced images can't be decoded in bands, try to decode them at once*/
+        }
+
+        lv_draw_buf_t * decoded = NULL;
+        if(downscale > 0) {
+            decoded = decode_png_file_downscaled(fn, dsc->header.w, dsc->header.h, downscale);
+            /*E.g. interlaced images can be decoded only at once*/
+            if(decoded == NULL) downscale = 0;
+        }
+
+        if(decoded == NULL) decoded = decode_png_file(fn);
         if(decoded == NULL) {
             return LV_RESULT_INVALID;
         }
@@ -151,6 +192,7 @@ static lv_result_t decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_d
         lv_image_cache_data_t search_key;
         search_key.src_type = dsc->src_type;
         search_key.src = dsc->src;
+        search_key.downscale = (uint8_t)downscale;
         search_key.slot.size = decoded->data_size;
 
         lv_cache_entry_t * entry = lv_image_decoder_add_to_cache(decoder, &search_key, decoded, NULL);
@@ -167,6 +209,66 @@ static lv_result_t decoder_open(lv_image_decoder_t * decoder, lv_image_decoder_d
     return LV_RESULT_INVALID;    /*If not returned earlier then it failed*/
 }
 
+/**
+ * Decode the next band of rows of an image opened for decoding in bands
+ * @param decoder       pointer to the decoder
+ * @param dsc           pointer to the decoder descriptor
+ * @param full_area     the area of the image to decode (relative to the image)
+ * @param decoded_area  the last decoded area, updated to the newly decoded area.
+ *                      Its `y1` is `LV_COORD_MIN` on the first call.
+ * @return              LV_RESULT_OK: a new band is decoded; LV_RESULT_INVALID: no more rows or error
+ */
+static lv_result_t decoder_get_area(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t * dsc,
+                                    const lv_area_t * full_area, lv_area_t * decoded_area)
+{
+    LV_UNUSED(decoder); /*Unused*/
+
+    png_stream_t * stream = dsc->user_data;
+    if(stream == NULL) return LV_RESULT_INVALID;
+
+    int32_t y = decoded_area->y1 == LV_COORD_MIN ? full_area->y1 : decoded_area->y2 + 1;
+    if(y < 0) y = 0;
+    int32_t y_max = LV_MIN(full_area->y2, (int32_t)dsc->header.h - 1);
+    if(y > y_max) return LV_RESULT_INVALID;
+
+    /*PNG can be read only forward so start again to go back*/
+    if(stream->png == NULL || (uint32_t)y < stream->next_row) {
+        stream_stop(stream);
+        if(!stream_start(stream)) return LV_RESULT_INVALID;
+    }
+
+    if(setjmp(png_jmpbuf(stream->png))) {
+        LV_LOG_WARN("png decode failed at row %" LV_PRIu32, stream->next_row);
+        stream_stop(stream);
+        return LV_RESULT_INVALID;
+    }
+
+    lv_draw_buf_t * band = stream->band;
+    while(stream->next_row < (uint32_t)y) {
+        png_read_row(stream->png, band->data, NULL);
+        stream->next_row++;
+    }
+
+    int32_t h = LV_MIN(LV_IMAGE_DECODER_STREAM_BAND_HEIGHT, y_max - y + 1);
+    int32_t i;
+    for(i = 0; i < h; i++) {
+        png_read_row(stream->png, band->data + i * band->header.stride, NULL);
+    }
+    stream->next_row += h;
+
+    band->header.h = h;
+    lv_draw_buf_clear_flag(band, LV_IMAGE_FLAGS_PREMULTIPLIED);
+    if(dsc->args.premultiply) lv_draw_buf_premultiply(band);
+
+    decoded_area->x1 = 0;
+    decoded_area->x2 = dsc->header.w - 1;
+    decoded_area->y1 = y;
+    decoded_area->y2 = y + h - 1;
+    dsc->decoded = band;
+
+    return LV_RESULT_OK;
+}
+
 /**
  * Free the allocated resources
  */
@@ -174,6 +276,12 @@ static void decoder_close(lv_image_decoder_t * decoder, lv_image_decoder_dsc_t *
 {
     LV_UNUSED(decoder); /*Unused*/
 
+    png_stream_t * stream = dsc->user_data;
+    if(stream) {
+        stream_close(stream);
+        return;
+    }
+
     if(dsc->args.no_cache || LV_CACHE_DEF_SIZE == 0)
         lv_draw_buf_destroy((lv_draw_buf_t *)dsc->decoded);
     else
@@ -284,4 +392,168 @@ static lv_draw_buf_t * decode_png_file(const char * filename)
     return decoded;
 }
 
+/**
+ * Decode a PNG file row by row and average each 2^downscale x 2^downscale block of pixels to one pixel.
+ * Only one row of the original image is kept in the memory.
+ * @param filename  the file name
+ * @param w         width of the original image
+ * @param h         height of the original image
+ * @param downscale halve the image this many times
+ * @return          the downscaled image or NULL on error
+ */
+static lv_draw_buf_t * decode_png_file_downscaled(const char * filename, int32_t w, int32_t h, uint32_t downscale)
+{
+    int32_t box = 1 << downscale;
+    int32_t dest_w = (w + box - 1) >> downscale;
+    int32_t dest_h = (h + box - 1) >> downscale;
+
+    png_stream_t * stream = stream_open(filename, w);
+    if(stream == NULL) return NULL;
+
+    /*Sum of B*A, G*A, R*A and A of the pixels of a block to weight the colors by their opacity*/
+    uint32_t * sums = lv_malloc(dest_w * 4 * sizeof(uint32_t));
+    lv_draw_buf_t * decoded = lv_draw_buf_create(dest_w, dest_h, LV_COLOR_FORMAT_ARGB8888, LV_STRIDE_AUTO);
+    if(sums == NULL || decoded == NULL) {
+        LV_LOG_WARN("out of memory");
+        goto failed;
+    }
+
+    if(setjmp(png_jmpbuf(stream->png))) {
+        LV_LOG_WARN("png decode failed: %s", filename);
+        goto failed;
+    }
+
+    uint8_t * row = stream->band->data;
+    int32_t dest_y;
+    for(dest_y = 0; dest_y < dest_h; dest_y++) {
+        lv_memzero(sums, dest_w * 4 * sizeof(uint32_t));
+        int32_t box_h = LV_MIN(box, h - dest_y * box);
+
+        int32_t y;
+        for(y = 0; y < box_h; y++) {
+            png_read_row(stream->png, row, NULL);
+            lv_image_decoder_downscale_add_row(sums, row, w, LV_COLOR_FORMAT_ARGB8888, true, downscale);
+        }
+
+        uint8_t * dest = decoded->data + dest_y * decoded->header.stride;
+        lv_image_decoder_downscale_write_row(dest, sums, w, box_h, LV_COLOR_FORMAT_ARGB8888, true, downscale);
+    }
+
+    lv_free(sums);
+    stream_close(stream);
+    return decoded;
+
+failed:
+    lv_free(sums);
+    if(decoded) lv_draw_buf_destroy(decoded);
+    stream_close(stream);
+    return NULL;
+}
+
+/**
+ * Open a PNG file to decode it in bands of rows
+ * @param filename  the file name
+ * @param w         width of the image
+ * @return          the stream or NULL if the image can't be decoded in bands
+ */
+static png_stream_t * stream_open(const char * filename, int32_t w)
+{
+    png_stream_t * stream = lv_malloc_zeroed(sizeof(png_stream_t));
+    LV_ASSERT_MALLOC(stream);
+    if(stream == NULL) return NULL;
+
+    if(lv_fs_open(&stream->f, filename, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+        LV_LOG_WARN("can't open %s", filename);
+        lv_free(stream);
+        return NULL;
+    }
+
+    stream->band = lv_draw_buf_create(w, LV_IMAGE_DECODER_STREAM_BAND_HEIGHT, LV_COLOR_FORMAT_ARGB8888,
+                                      LV_STRIDE_AUTO);
+    if(stream->band == NULL || !stream_start(stream)) {
+        stream_close(stream);
+        return NULL;
+    }
+
+    return stream;
+}
+
+/**
+ * Start reading the file from the beginning
+ * @param stream    pointer to a stream
+ * @return          true: ready to read the first row
+ */
+static bool stream_start(png_stream_t * stream)
+{
+    if(lv_fs_seek(&stream->f, 0, LV_FS_SEEK_SET) != LV_FS_RES_OK) return false;
+
+    stream->next_row = 0;
+    stream->png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if(stream->png == NULL) return false;
+
+    stream->info = png_create_info_struct(stream->png);
+    if(stream->info == NULL) {
+        stream_stop(stream);
+        return false;
+    }
+
+    if(setjmp(png_jmpbuf(stream->png))) {
+        LV_LOG_WARN("png header read failed");
+        stream_stop(stream);
+        return false;
+    }
+
+    png_set_read_fn(stream->png, stream, stream_read_cb);
+    png_read_info(stream->png, stream->info);
+
+    /*The passes of interlaced images are spread over the whole file*/
+    if(png_get_interlace_type(stream->png, stream->info) != PNG_INTERLACE_NONE) {
+        stream_stop(stream);
+        return false;
+    }
+
+    /*Convert every format to BGRA, i.e. ARGB8888*/
+    png_byte color_type = png_get_color_type(stream->png, stream->info);
+    png_byte bit_depth = png_get_bit_depth(stream->png, stream->info);
+    if(bit_depth == 16) png_set_strip_16(stream->png);
+    if(color_type == PNG_COLOR_TYPE_PALETTE) png_set_palette_to_rgb(stream->png);
+    if(color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) png_set_expand_gray_1_2_4_to_8(stream->png);
+    if(png_get_valid(stream->png, stream->info, PNG_INFO_tRNS)) png_set_tRNS_to_alpha(stream->png);
+    if(color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA) png_set_gray_to_rgb(stream->png);
+    if(!(color_type & PNG_COLOR_MASK_ALPHA)) png_set_filler(stream->png, 0xff, PNG_FILLER_AFTER);
+    png_set_bgr(stream->png);
+    png_read_update_info(stream->png, stream->info);
+
+    if(png_get_rowbytes(stream->png, stream->info) > stream->band->header.stride) {
+        LV_LOG_WARN("unexpected png row size");
+        stream_stop(stream);
+        return false;
+    }
+
+    return true;
+}
+
+static void stream_stop(png_stream_t * stream)
+{
+    if(stream->png) png_destroy_read_struct(&stream->png, stream->info ? &stream->info : NULL, NULL);
+    stream->png = NULL;
+    stream->info = NULL;
+}
+
+static void stream_close(png_stream_t * stream)
+{
+    stream_stop(stream);
+    lv_fs_close(&stream->f);
+    if(stream->band) lv_draw_buf_destroy(stream->band);
+    lv_free(stream);
+}
+
+static void stream_read_cb(png_structp png, png_bytep data, png_size_t length)
+{
+    png_stream_t * stream = png_get_io_ptr(png);
+    uint32_t rn = 0;
+    lv_fs_res_t res = lv_fs_read(&stream->f, data, (uint32_t)length, &rn);
+    if(res != LV_FS_RES_OK || rn != length) png_error(png, "unexpected end of file");
+}
+
 #endif /*LV_USE_LIBPNG*/
@@ -22,6 +22,7 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static uint32_t get_repeat_cnt(const uint8_t * input, uint32_t blk_cnt, uint8_t blk_size);
 
 /**********************
  *  STATIC VARIABLES
@@ -105,8 +106,62 @@ uint32_t lv_rle_decompress(const uint8_t * input,
     return wr_len;
 }
 
+uint32_t lv_rle_compress(const uint8_t * input, uint32_t input_buff_len, uint8_t * output,
+                         uint32_t output_buff_len, uint8_t blk_size)
+{
+    uint32_t blk_cnt = input_buff_len / blk_size;
+    uint32_t wr_len = 0;
+
+    while(blk_cnt > 0) {
+        uint32_t cnt = get_repeat_cnt(input, blk_cnt, blk_size);
+        if(cnt > 1) {
+            /*A control byte and the repeated block*/
+            if(wr_len + 1 + blk_size > output_buff_len) return 0;
+            output[wr_len] = (uint8_t)cnt;
+            lv_memcpy(&output[wr_len + 1], input, blk_size);
+            wr_len += 1 + blk_size;
+        }
+        else {
+            /*Collect the blocks until the next repetition*/
+            cnt = 1;
+            while(cnt < 0x7f && cnt < blk_cnt && get_repeat_cnt(input + cnt * blk_size, blk_cnt - cnt, blk_size) == 1) {
+                cnt++;
+            }
+
+            uint32_t bytes = cnt * blk_size;
+            if(wr_len + 1 + bytes > output_buff_len) return 0;
+            output[wr_len] = (uint8_t)(0x80 | cnt);
+            lv_memcpy(&output[wr_len + 1], input, bytes);
+            wr_len += 1 + bytes;
+        }
+
+        input += cnt * blk_size;
+        blk_cnt -= cnt;
+    }
+
+    return wr_len;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Get how many times the first block is repeated (at most 127 as it's stored on 7 bits)
+ */
+static uint32_t get_repeat_cnt(const uint8_t * input, uint32_t blk_cnt, uint8_t blk_size)
+{
+    uint32_t cnt = 1;
+    while(cnt < 0x7f && cnt < blk_cnt) {
+        const uint8_t * blk = input + cnt * blk_size;
+        uint32_t i;
+        for(i = 0; i < blk_size; i++) {
+            if(blk[i] != input[i]) return cnt;
+        }
+        cnt++;
+    }
+
+    return cnt;
+}
+
 #endif /*LV_USE_RLE*/
@@ -33,6 +33,18 @@ uint32_t lv_rle_decompress(const uint8_t * input,
                            uint32_t input_buff_len, uint8_t * output,
                            uint32_t output_buff_len, uint8_t blk_size);
 
+/**
+ * Compress data to the format read by `lv_rle_decompress()`
+ * @param input             the data to compress
+ * @param input_buff_len    length of the data in bytes. Must be a multiple of `blk_size`
+ * @param output            buffer for the compressed data
+ * @param output_buff_len   size of the output buffer in bytes
+ * @param blk_size          size of the repeated blocks in bytes (e.g. bytes per pixel)
+ * @return                  length of the compressed data or 0 if it didn't fit into the output buffer
+ */
+uint32_t lv_rle_compress(const uint8_t * input, uint32_t input_buff_len, uint8_t * output,
+                         uint32_t output_buff_len, uint8_t blk_size);
+
 /**********************
  *      MACROS
  **********************/
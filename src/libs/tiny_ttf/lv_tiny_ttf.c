@@ -45,9 +45,34 @@ static void ttf_cb_stream_seek(ttf_cb_stream_t * stream, size_t position);
 #include "stb_truetype_htcw.h"
 
 #define tiny_ttf_cache LV_GLOBAL_DEFAULT()->tiny_ttf_cache
+
+#if (LV_TINY_TTF_GLYPH_MEMO_CNT & (LV_TINY_TTF_GLYPH_MEMO_CNT - 1)) != 0
+    #error "LV_TINY_TTF_GLYPH_MEMO_CNT must be a power of 2 or 0"
+#endif
+
+#if (LV_TINY_TTF_KERN_MEMO_CNT & (LV_TINY_TTF_KERN_MEMO_CNT - 1)) != 0
+    #error "LV_TINY_TTF_KERN_MEMO_CNT must be a power of 2 or 0"
+#endif
 /**********************
  *      TYPEDEFS
  **********************/
+/*The glyph index and metrics of a letter with the current size of the font*/
+typedef struct {
+    uint32_t unicode;   /*0: unused slot*/
+    int glyph_id;       /*0: the font has no glyph for the letter*/
+    int adv_w;          /*Advance width in font units*/
+    int x1;             /*Bitmap box in pixels*/
+    int y1;
+    int x2;
+    int y2;
+} ttf_glyph_memo_t;
+
+/*The kerning of a glyph pair in font units*/
+typedef struct {
+    uint32_t glyphs;    /*(left glyph << 16) | right glyph, 0: unused slot*/
+    int kern;
+} ttf_kern_memo_t;
+
 typedef struct ttf_font_desc {
     lv_fs_file_t file;
 #if LV_TINY_TTF_FILE_SUPPORT != 0
@@ -59,9 +84,18 @@ typedef struct ttf_font_desc {
     float scale;
     int ascent;
     int descent;
+    lv_mutex_t lock;    /*Protect the memos and the stream as the draw threads can measure the glyphs in parallel*/
+#if LV_TINY_TTF_GLYPH_MEMO_CNT > 0
+    ttf_glyph_memo_t glyph_memo[LV_TINY_TTF_GLYPH_MEMO_CNT];
+#endif
+#if LV_TINY_TTF_KERN_MEMO_CNT > 0
+    ttf_kern_memo_t kern_memo[LV_TINY_TTF_KERN_MEMO_CNT];
+#endif
 } ttf_font_desc_t;
 
 typedef struct _tiny_ttf_cache_data_t {
+    lv_cache_slot_size_t slot;
+
     lv_font_t * font;
     uint32_t unicode;
     uint32_t size;
@@ -79,6 +113,10 @@ static lv_font_t * lv_tiny_ttf_create(const char * path, const void * data, size
                                       int32_t font_size,
                                       size_t cache_size);
 
+static void get_glyph_memo(ttf_font_desc_t * dsc, uint32_t unicode, ttf_glyph_memo_t * memo_out);
+static int get_glyph_id(ttf_font_desc_t * dsc, uint32_t unicode);
+static int get_kern(ttf_font_desc_t * dsc, int g1, int g2);
+
 static bool tiny_ttf_cache_create_cb(tiny_ttf_cache_data_t * node, void * user_data);
 static void tiny_ttf_cache_free_cb(tiny_ttf_cache_data_t * node, void * user_data);
 static lv_cache_compare_res_t tiny_ttf_cache_compare_cb(const tiny_ttf_cache_data_t * lhs,
@@ -111,6 +149,18 @@ void lv_tiny_ttf_set_size(lv_font_t * font, int32_t font_size)
     stbtt_GetFontVMetrics(&dsc->info, &dsc->ascent, &dsc->descent, &line_gap);
     font->line_height = (int32_t)(dsc->scale * (dsc->ascent - dsc->descent + line_gap));
     font->base_line = (int32_t)(dsc->scale * (line_gap - dsc->descent));
+
+#if LV_TINY_TTF_GLYPH_MEMO_CNT > 0
+    /*The bitmap boxes depend on the size. The kerning is stored in font units so it remains valid.*/
+    lv_mutex_lock(&dsc->lock);
+    lv_memzero(dsc->glyph_memo, sizeof(dsc->glyph_memo));
+    lv_mutex_unlock(&dsc->lock);
+#endif
+
+#if LV_USE_FONT_GLYPH_ATLAS
+    /*The atlas is keyed only by the font, so drop the glyphs of the old size*/
+    lv_font_glyph_atlas_invalidate(font);
+#endif
 }
 
 void lv_tiny_ttf_destroy(lv_font_t * font)
@@ -125,6 +175,10 @@ void lv_tiny_ttf_destroy(lv_font_t * font)
         }
 #endif
         lv_cache_drop_all(tiny_ttf_cache, (void *)font->dsc);
+#if LV_USE_FONT_GLYPH_ATLAS
+        lv_font_glyph_atlas_delete(font);
+#endif
+        lv_mutex_delete(&ttf->lock);
         lv_free(ttf);
         font->dsc = NULL;
     }
@@ -140,7 +194,9 @@ void lv_tiny_ttf_init(void)
         .free_cb = (lv_cache_free_cb_t)tiny_ttf_cache_free_cb,
     };
 
-    tiny_ttf_cache = lv_cache_create(&lv_cache_class_lru_rb_count, sizeof(tiny_ttf_cache_data_t), 128, ops);
+    /*The glyphs of all fonts and sizes share one cache limited by the size of the bitmaps*/
+    tiny_ttf_cache = lv_cache_create(&lv_cache_class_lru_rb_size, sizeof(tiny_ttf_cache_data_t),
+                                     LV_TINY_TTF_CACHE_SIZE, ops);
 }
 
 void lv_tiny_ttf_deinit(void)
@@ -199,27 +255,26 @@ static bool ttf_get_glyph_dsc_cb(const lv_font_t * font, lv_font_glyph_dsc_t * d
         return true;
     }
     ttf_font_desc_t * dsc = (ttf_font_desc_t *)font->dsc;
-    int g1 = stbtt_FindGlyphIndex(&dsc->info, (int)unicode_letter);
-    if(g1 == 0) {
+    ttf_glyph_memo_t g1;
+    int k = 0;
+    lv_mutex_lock(&dsc->lock);
+    get_glyph_memo(dsc, unicode_letter, &g1);
+    if(g1.glyph_id != 0 && unicode_letter_next != 0) {
+        k = get_kern(dsc, g1.glyph_id, get_glyph_id(dsc, unicode_letter_next));
+    }
+    lv_mutex_unlock(&dsc->lock);
+
+    if(g1.glyph_id == 0) {
         /* Glyph not found */
         return false;
     }
-    int x1, y1, x2, y2;
 
-    stbtt_GetGlyphBitmapBox(&dsc->info, g1, dsc->scale, dsc->scale, &x1, &y1, &x2, &y2);
-    int g2 = 0;
-    if(unicode_letter_next != 0) {
-        g2 = stbtt_FindGlyphIndex(&dsc->info, (int)unicode_letter_next);
-    }
-    int advw, lsb;
-    stbtt_GetGlyphHMetrics(&dsc->info, g1, &advw, &lsb);
-    int k = stbtt_GetGlyphKernAdvance(&dsc->info, g1, g2);
-    dsc_out->adv_w = (uint16_t)floor((((float)advw + (float)k) * dsc->scale) +
+    dsc_out->adv_w = (uint16_t)floor((((float)g1.adv_w + (float)k) * dsc->scale) +
                                      0.5f); /*Horizontal space required by the glyph in [px]*/
-    dsc_out->box_w = (x2 - x1 + 1);         /*width of the bitmap in [px]*/
-    dsc_out->box_h = (y2 - y1 + 1);         /*height of the bitmap in [px]*/
-    dsc_out->ofs_x = x1;                    /*X offset of the bitmap in [pf]*/
-    dsc_out->ofs_y = -y2;                   /*Y offset of the bitmap measured from the as line*/
+    dsc_out->box_w = (g1.x2 - g1.x1 + 1);   /*width of the bitmap in [px]*/
+    dsc_out->box_h = (g1.y2 - g1.y1 + 1);   /*height of the bitmap in [px]*/
+    dsc_out->ofs_x = g1.x1;                 /*X offset of the bitmap in [pf]*/
+    dsc_out->ofs_y = -g1.y2;                /*Y offset of the bitmap measured from the as line*/
     dsc_out->format = LV_FONT_GLYPH_FORMAT_A8;
     dsc_out->is_placeholder = false;
     return true; /*true: glyph found; false: glyph was not found*/
@@ -235,6 +290,7 @@ static const void * ttf_get_glyph_bitmap_cb(lv_font_glyph_dsc_t * g_dsc,
         .unicode = unicode_letter,
         .size = font->line_height,
     };
+    search_key.slot.size = lv_draw_buf_width_to_stride(g_dsc->box_w, LV_COLOR_FORMAT_A8) * g_dsc->box_h;
 
     lv_cache_entry_t * entry = lv_cache_acquire_or_create(tiny_ttf_cache, &search_key, (void *)font->dsc);
 
@@ -310,6 +366,7 @@ static lv_font_t * lv_tiny_ttf_create(const char * path, const void * data, size
     out_font->get_glyph_bitmap = ttf_get_glyph_bitmap_cb;
     out_font->release_glyph = ttf_release_glyph_cb;
     out_font->dsc = dsc;
+    lv_mutex_init(&dsc->lock);
     lv_tiny_ttf_set_size(out_font, font_size);
     return out_font;
 }
@@ -332,6 +389,84 @@ lv_font_t * lv_tiny_ttf_create_data(const void * data, size_t data_size, int32_t
     return lv_tiny_ttf_create(NULL, data, data_size, font_size, 0);
 }
 
+/**
+ * Get the glyph index and metrics of a letter. Looking them up in the font's tables is slow
+ * so they are remembered in a direct mapped table. `dsc->lock` needs to be locked.
+ * @param dsc       the font's descriptor
+ * @param unicode   the letter
+ * @param memo_out  store the metrics here
+ */
+static void get_glyph_memo(ttf_font_desc_t * dsc, uint32_t unicode, ttf_glyph_memo_t * memo_out)
+{
+#if LV_TINY_TTF_GLYPH_MEMO_CNT > 0
+    ttf_glyph_memo_t * memo = &dsc->glyph_memo[unicode & (LV_TINY_TTF_GLYPH_MEMO_CNT - 1)];
+    if(memo->unicode == unicode) {
+        *memo_out = *memo;
+        return;
+    }
+#else
+    ttf_glyph_memo_t * memo = memo_out;
+#endif
+
+    lv_memzero(memo, sizeof(ttf_glyph_memo_t));
+    memo->unicode = unicode;
+    memo->glyph_id = stbtt_FindGlyphIndex(&dsc->info, (int)unicode);
+    if(memo->glyph_id != 0) {
+        int lsb;
+        stbtt_GetGlyphHMetrics(&dsc->info, memo->glyph_id, &memo->adv_w, &lsb);
+        stbtt_GetGlyphBitmapBox(&dsc->info, memo->glyph_id, dsc->scale, dsc->scale, &memo->x1, &memo->y1, &memo->x2,
+                                &memo->y2);
+    }
+
+#if LV_TINY_TTF_GLYPH_MEMO_CNT > 0
+    *memo_out = *memo;
+#endif
+}
+
+/**
+ * Get the glyph index of a letter. `dsc->lock` needs to be locked.
+ * @param dsc       the font's descriptor
+ * @param unicode   the letter
+ * @return          the glyph index or 0 if the font has no glyph for the letter
+ */
+static int get_glyph_id(ttf_font_desc_t * dsc, uint32_t unicode)
+{
+#if LV_TINY_TTF_GLYPH_MEMO_CNT > 0
+    ttf_glyph_memo_t memo;
+    get_glyph_memo(dsc, unicode, &memo);
+    return memo.glyph_id;
+#else
+    return stbtt_FindGlyphIndex(&dsc->info, (int)unicode);
+#endif
+}
+
+/**
+ * Get the kerning of two glyphs. Walking the kerning tables is slow so the
+ * recently used pairs are remembered in a direct mapped table. `dsc->lock` needs to be locked.
+ * @param dsc   the font's descriptor
+ * @param g1    index of the left glyph
+ * @param g2    index of the right glyph
+ * @return      the kerning in font units
+ */
+static int get_kern(ttf_font_desc_t * dsc, int g1, int g2)
+{
+    if(g1 == 0 || g2 == 0) return 0;
+
+#if LV_TINY_TTF_KERN_MEMO_CNT > 0
+    /*The glyph indices are 16 bit in TrueType fonts*/
+    uint32_t glyphs = ((uint32_t)g1 << 16) | (uint32_t)g2;
+    ttf_kern_memo_t * memo = &dsc->kern_memo[(glyphs ^ (glyphs >> 11)) & (LV_TINY_TTF_KERN_MEMO_CNT - 1)];
+    if(memo->glyphs != glyphs) {
+        memo->glyphs = glyphs;
+        memo->kern = stbtt_GetGlyphKernAdvance(&dsc->info, g1, g2);
+    }
+
+    return memo->kern;
+#else
+    return stbtt_GetGlyphKernAdvance(&dsc->info, g1, g2);
+#endif
+}
+
 /*-----------------
  * Cache Callbacks
  *----------------*/
@@ -342,19 +477,21 @@ static bool tiny_ttf_cache_create_cb(tiny_ttf_cache_data_t * node, void * user_d
     ttf_font_desc_t * dsc = (ttf_font_desc_t *)user_data;
     uint32_t unicode_letter = node->unicode;
 
-    const stbtt_fontinfo * info = (const stbtt_fontinfo *)&dsc->info;
-    int g1 = stbtt_FindGlyphIndex(info, (int)unicode_letter);
-    if(g1 == 0) {
+    /*The glyphs are measured without the cache's lock so use the font's lock for the stream too*/
+    lv_mutex_lock(&dsc->lock);
+    ttf_glyph_memo_t g1;
+    get_glyph_memo(dsc, unicode_letter, &g1);
+    if(g1.glyph_id == 0) {
         /* Glyph not found */
+        lv_mutex_unlock(&dsc->lock);
         return false;
     }
-    int x1, y1, x2, y2;
-    stbtt_GetGlyphBitmapBox(info, g1, dsc->scale, dsc->scale, &x1, &y1, &x2, &y2);
     int w, h;
-    w = x2 - x1 + 1;
-    h = y2 - y1 + 1;
+    w = g1.x2 - g1.x1 + 1;
+    h = g1.y2 - g1.y1 + 1;
     lv_draw_buf_t * draw_buf = lv_draw_buf_create(w, h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
     if(NULL == draw_buf) {
+        lv_mutex_unlock(&dsc->lock);
         LV_LOG_ERROR("tiny_ttf: out of memory\n");
         return false;
     }
@@ -362,7 +499,8 @@ static bool tiny_ttf_cache_create_cb(tiny_ttf_cache_data_t * node, void * user_d
     lv_draw_buf_clear(draw_buf, NULL);
 
     uint32_t stride = draw_buf->header.stride;
-    stbtt_MakeGlyphBitmap(info, draw_buf->data, w, h, stride, dsc->scale, dsc->scale, g1);
+    stbtt_MakeGlyphBitmap(&dsc->info, draw_buf->data, w, h, stride, dsc->scale, dsc->scale, g1.glyph_id);
+    lv_mutex_unlock(&dsc->lock);
 
     node->draw_buf = draw_buf;
     return true;
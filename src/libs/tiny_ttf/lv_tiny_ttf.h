@@ -33,7 +33,8 @@ extern "C" {
 /* create a font from the specified file or path with the specified line height.*/
 lv_font_t * lv_tiny_ttf_create_file(const char * path, int32_t font_size);
 
-/* create a font from the specified file or path with the specified line height with the specified cache size.*/
+/* create a font from the specified file or path with the specified line height.
+ * `cache_size` is ignored: the rendered glyphs of all fonts share a cache of `LV_TINY_TTF_CACHE_SIZE` bytes.*/
 lv_font_t * lv_tiny_ttf_create_file_ex(const char * path, int32_t font_size, size_t cache_size);
 #endif
 
@@ -44,7 +45,8 @@ void lv_tiny_ttf_deinit(void);
 /* create a font from the specified data pointer with the specified line height.*/
 lv_font_t * lv_tiny_ttf_create_data(const void * data, size_t data_size, int32_t font_size);
 
-/* create a font from the specified data pointer with the specified line height and the specified cache size.*/
+/* create a font from the specified data pointer with the specified line height.
+ * `cache_size` is ignored: the rendered glyphs of all fonts share a cache of `LV_TINY_TTF_CACHE_SIZE` bytes.*/
 lv_font_t * lv_tiny_ttf_create_data_ex(const void * data, size_t data_size, int32_t font_size, size_t cache_size);
 
 /* set the size of the font to a new font_size*/
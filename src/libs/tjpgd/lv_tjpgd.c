@@ -221,6 +221,7 @@ static lv_result_t decoder_get_area(lv_image_decoder_t * decoder, lv_image_decod
         decoded_area->y2 = my - 1;
         decoded_area->x1 = -mx;
         decoded_area->x2 = -1;
+        /*The tiles are drawn at the place of the original sized image, so `target_w/h` are ignored*/
         jd->scale = 0;
         jd->dcv[2] = jd->dcv[1] = jd->dcv[0] = 0;   /* Initialize DC values */
         jd->rst = 0;
@@ -346,6 +346,28 @@
         #endif
     #endif
 
+    /* The 90/270 degree rotations of `lv_draw_sw_rotate()` walk the image in square tiles of this size [px].
+     * 32 x 32 ARGB8888 pixels are 4 kB, i.e. a source and a destination tile fit in the L1 cache. */
+    #ifndef LV_DRAW_SW_ROTATE_TILE_SIZE
+        #ifdef CONFIG_LV_DRAW_SW_ROTATE_TILE_SIZE
+            #define LV_DRAW_SW_ROTATE_TILE_SIZE CONFIG_LV_DRAW_SW_ROTATE_TILE_SIZE
+        #else
+            #define LV_DRAW_SW_ROTATE_TILE_SIZE 32
+        #endif
+    #endif
+
+    /* 1: Keep I1/I2/I4/I8 images indexed in the image cache and convert them with their palette while drawing.
+     * 0: Convert them to ARGB8888 when they are decoded (up to 32x more memory)
+     * The other draw units which use the decoded images need to support indexed images too
+     * (not supported by Dave2D). */
+    #ifndef LV_DRAW_SW_KEEP_INDEXED
+        #ifdef CONFIG_LV_DRAW_SW_KEEP_INDEXED
+            #define LV_DRAW_SW_KEEP_INDEXED CONFIG_LV_DRAW_SW_KEEP_INDEXED
+        #else
+            #define LV_DRAW_SW_KEEP_INDEXED     0
+        #endif
+    #endif
+
     #ifndef LV_USE_DRAW_SW_ASM
         #ifdef CONFIG_LV_USE_DRAW_SW_ASM
             #define LV_USE_DRAW_SW_ASM CONFIG_LV_USE_DRAW_SW_ASM
@@ -825,6 +847,116 @@
     #endif
 #endif
 
+/*1: Use a scan resistant (segmented LRU) cache for the images and image headers.
+ *Images used only once (e.g. while scrolling a long list) won't push out the images used again and again.*/
+#ifndef LV_IMAGE_CACHE_SCAN_RESISTANT
+    #ifdef CONFIG_LV_IMAGE_CACHE_SCAN_RESISTANT
+        #define LV_IMAGE_CACHE_SCAN_RESISTANT CONFIG_LV_IMAGE_CACHE_SCAN_RESISTANT
+    #else
+        #define LV_IMAGE_CACHE_SCAN_RESISTANT 0
+    #endif
+#endif
+
+/*Split the image and image header caches to this many independently locked shards by the hash of the image source.
+ *Useful with multiple draw units (e.g. `LV_DRAW_SW_DRAW_UNIT_CNT > 1`) as they won't wait for each other on cache hits.
+ *Each shard has 1/LV_IMAGE_CACHE_SHARD_CNT of the cache size so a single image can't be larger than that.*/
+#ifndef LV_IMAGE_CACHE_SHARD_CNT
+    #ifdef _LV_KCONFIG_PRESENT
+        #ifdef CONFIG_LV_IMAGE_CACHE_SHARD_CNT
+            #define LV_IMAGE_CACHE_SHARD_CNT CONFIG_LV_IMAGE_CACHE_SHARD_CNT
+        #else
+            #define LV_IMAGE_CACHE_SHARD_CNT 0
+        #endif
+    #else
+        #define LV_IMAGE_CACHE_SHARD_CNT 1
+    #endif
+#endif
+
+/*Size of a second image cache tier in bytes. The images evicted from the image cache are kept here compressed
+ *and are decompressed on the next use which is much faster than decoding a PNG or JPG again.
+ *Uses LZ4 if `LV_USE_LZ4_INTERNAL` or `LV_USE_LZ4_EXTERNAL` is enabled, else RLE (`LV_USE_RLE`).
+ *0: disable the compressed tier*/
+#ifndef LV_IMAGE_CACHE_COMPRESSED_SIZE
+    #ifdef CONFIG_LV_IMAGE_CACHE_COMPRESSED_SIZE
+        #define LV_IMAGE_CACHE_COMPRESSED_SIZE CONFIG_LV_IMAGE_CACHE_COMPRESSED_SIZE
+    #else
+        #define LV_IMAGE_CACHE_COMPRESSED_SIZE 0
+    #endif
+#endif
+
+/*1: Decode the images which are not in the cache on worker threads and draw a placeholder meanwhile.
+ *Needs an OS and `LV_CACHE_DEF_SIZE > 0`. Enable it at run time with `lv_image_decoder_async_set_enabled(true)`*/
+#ifndef LV_USE_IMAGE_DECODER_ASYNC
+    #ifdef CONFIG_LV_USE_IMAGE_DECODER_ASYNC
+        #define LV_USE_IMAGE_DECODER_ASYNC CONFIG_LV_USE_IMAGE_DECODER_ASYNC
+    #else
+        #define LV_USE_IMAGE_DECODER_ASYNC 0
+    #endif
+#endif
+#if LV_USE_IMAGE_DECODER_ASYNC
+    /*Number of worker threads*/
+    #ifndef LV_IMAGE_DECODER_ASYNC_WORKER_CNT
+        #ifdef _LV_KCONFIG_PRESENT
+            #ifdef CONFIG_LV_IMAGE_DECODER_ASYNC_WORKER_CNT
+                #define LV_IMAGE_DECODER_ASYNC_WORKER_CNT CONFIG_LV_IMAGE_DECODER_ASYNC_WORKER_CNT
+            #else
+                #define LV_IMAGE_DECODER_ASYNC_WORKER_CNT 0
+            #endif
+        #else
+            #define LV_IMAGE_DECODER_ASYNC_WORKER_CNT 1
+        #endif
+    #endif
+
+    /*Max number of images waiting for decoding. If the queue is full, the images are decoded while drawing*/
+    #ifndef LV_IMAGE_DECODER_ASYNC_QUEUE_DEPTH
+        #ifdef CONFIG_LV_IMAGE_DECODER_ASYNC_QUEUE_DEPTH
+            #define LV_IMAGE_DECODER_ASYNC_QUEUE_DEPTH CONFIG_LV_IMAGE_DECODER_ASYNC_QUEUE_DEPTH
+        #else
+            #define LV_IMAGE_DECODER_ASYNC_QUEUE_DEPTH 8
+        #endif
+    #endif
+
+    /*Color of the placeholder drawn while the image is being decoded*/
+    #ifndef LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_COLOR
+        #ifdef CONFIG_LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_COLOR
+            #define LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_COLOR CONFIG_LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_COLOR
+        #else
+            #define LV_IMAGE_DECODER_ASYNC_PLACEHOLDER_COLOR 0xC0C0C0
+        #endif
+    #endif
+#endif
+
+/*Decode the images larger than this many bytes in bands of rows instead of decoding them at once.
+ *Used by the decoders which support it (`LV_USE_LIBPNG` and `LV_USE_LIBJPEG_TURBO`).
+ *The images which don't fit into the image cache are always decoded in bands. 0: use only the cache size*/
+#ifndef LV_IMAGE_DECODER_STREAM_THRESHOLD
+    #ifdef CONFIG_LV_IMAGE_DECODER_STREAM_THRESHOLD
+        #define LV_IMAGE_DECODER_STREAM_THRESHOLD CONFIG_LV_IMAGE_DECODER_STREAM_THRESHOLD
+    #else
+        #define LV_IMAGE_DECODER_STREAM_THRESHOLD 0
+    #endif
+#endif
+
+/*Number of rows decoded at once when an image is decoded in bands*/
+#ifndef LV_IMAGE_DECODER_STREAM_BAND_HEIGHT
+    #ifdef CONFIG_LV_IMAGE_DECODER_STREAM_BAND_HEIGHT
+        #define LV_IMAGE_DECODER_STREAM_BAND_HEIGHT CONFIG_LV_IMAGE_DECODER_STREAM_BAND_HEIGHT
+    #else
+        #define LV_IMAGE_DECODER_STREAM_BAND_HEIGHT 16
+    #endif
+#endif
+
+/*1: Cache 1/2, 1/4 or 1/8 sized versions (mipmaps) of the images drawn at less than half of their size
+ *and draw them instead of the original images. It's faster and has less aliasing.
+ *Needs `LV_CACHE_DEF_SIZE > 0`. Enable it at run time with `lv_image_cache_set_mipmap_enabled(true)`*/
+#ifndef LV_USE_IMAGE_MIPMAP
+    #ifdef CONFIG_LV_USE_IMAGE_MIPMAP
+        #define LV_USE_IMAGE_MIPMAP CONFIG_LV_USE_IMAGE_MIPMAP
+    #else
+        #define LV_USE_IMAGE_MIPMAP 0
+    #endif
+#endif
+
 /*Number of stops allowed per gradient. Increase this to allow more stops.
  *This adds (sizeof(lv_color_t) + 1) bytes per additional stop*/
 #ifndef LV_GRADIENT_MAX_STOPS
@@ -1312,6 +1444,27 @@
     #endif
 #endif
 
+/*Size of the cache in bytes to store the decoded glyph bitmaps of the built-in and binary fonts (0: to disable)
+ *Useful mainly with compressed fonts as this way the glyphs don't need to be decompressed on every redraw.
+ *Therefore a small cache is used by default if compressed fonts are enabled.*/
+#ifndef LV_FONT_GLYPH_CACHE_SIZE
+    #ifdef CONFIG_LV_FONT_GLYPH_CACHE_SIZE
+        #define LV_FONT_GLYPH_CACHE_SIZE CONFIG_LV_FONT_GLYPH_CACHE_SIZE
+    #else
+        #define LV_FONT_GLYPH_CACHE_SIZE (LV_USE_FONT_COMPRESSED ? (8 * 1024) : 0)
+    #endif
+#endif
+
+/*Enable packing the glyphs of selected fonts into a single A8 texture (see `lv_font_glyph_atlas_create()`)
+ *so that the glyphs of a label can be drawn in batches from it*/
+#ifndef LV_USE_FONT_GLYPH_ATLAS
+    #ifdef CONFIG_LV_USE_FONT_GLYPH_ATLAS
+        #define LV_USE_FONT_GLYPH_ATLAS CONFIG_LV_USE_FONT_GLYPH_ATLAS
+    #else
+        #define LV_USE_FONT_GLYPH_ATLAS 0
+    #endif
+#endif
+
 /*=================
  *  TEXT SETTINGS
  *=================*/
@@ -1667,6 +1820,13 @@
             #define LV_LABEL_LONG_TXT_HINT 1  /*Store some extra info in labels to speed up drawing of very long texts*/
         #endif
     #endif
+    #ifndef LV_LABEL_LINE_INDEX
+        #ifdef CONFIG_LV_LABEL_LINE_INDEX
+            #define LV_LABEL_LINE_INDEX CONFIG_LV_LABEL_LINE_INDEX
+        #else
+            #define LV_LABEL_LINE_INDEX 0     /*Store the start of each line (8 bytes/line) to draw and edit very long wrapped texts faster*/
+        #endif
+    #endif
     #ifndef LV_LABEL_WAIT_CHAR_COUNT
         #ifdef CONFIG_LV_LABEL_WAIT_CHAR_COUNT
             #define LV_LABEL_WAIT_CHAR_COUNT CONFIG_LV_LABEL_WAIT_CHAR_COUNT
@@ -2073,6 +2233,13 @@
             #define LV_FS_POSIX_CACHE_SIZE 0    /*>0 to cache this number of bytes in lv_fs_read()*/
         #endif
     #endif
+    #ifndef LV_FS_POSIX_MMAP
+        #ifdef CONFIG_LV_FS_POSIX_MMAP
+            #define LV_FS_POSIX_MMAP CONFIG_LV_FS_POSIX_MMAP
+        #else
+            #define LV_FS_POSIX_MMAP 0          /*1: Support lv_fs_map() with mmap() to use e.g. .bin images without copying them to RAM*/
+        #endif
+    #endif
 #endif
 
 /*API for CreateFile, ReadFile, etc*/
@@ -2321,6 +2488,15 @@
             #define LV_FREETYPE_CACHE_FT_GLYPH_CNT 256
         #endif
     #endif
+
+    /* Stack size of the thread pre-rendering the glyphs if LV_USE_OS is enabled [bytes] */
+    #ifndef LV_FREETYPE_PRERENDER_STACK_SIZE
+        #ifdef CONFIG_LV_FREETYPE_PRERENDER_STACK_SIZE
+            #define LV_FREETYPE_PRERENDER_STACK_SIZE CONFIG_LV_FREETYPE_PRERENDER_STACK_SIZE
+        #else
+            #define LV_FREETYPE_PRERENDER_STACK_SIZE (8 * 1024)
+        #endif
+    #endif
 #endif
 
 /* Built-in TTF decoder */
@@ -2340,6 +2516,30 @@
             #define LV_TINY_TTF_FILE_SUPPORT 0
         #endif
     #endif
+    /* Size of the cache of the rendered glyphs shared by all Tiny TTF fonts and font sizes [bytes] */
+    #ifndef LV_TINY_TTF_CACHE_SIZE
+        #ifdef CONFIG_LV_TINY_TTF_CACHE_SIZE
+            #define LV_TINY_TTF_CACHE_SIZE CONFIG_LV_TINY_TTF_CACHE_SIZE
+        #else
+            #define LV_TINY_TTF_CACHE_SIZE (64 * 1024)
+        #endif
+    #endif
+    /* Number of letters whose metrics are remembered by each font (28 bytes each). Power of 2 or 0 to disable */
+    #ifndef LV_TINY_TTF_GLYPH_MEMO_CNT
+        #ifdef CONFIG_LV_TINY_TTF_GLYPH_MEMO_CNT
+            #define LV_TINY_TTF_GLYPH_MEMO_CNT CONFIG_LV_TINY_TTF_GLYPH_MEMO_CNT
+        #else
+            #define LV_TINY_TTF_GLYPH_MEMO_CNT 128
+        #endif
+    #endif
+    /* Number of letter pairs whose kerning is remembered by each font (8 bytes each). Power of 2 or 0 to disable */
+    #ifndef LV_TINY_TTF_KERN_MEMO_CNT
+        #ifdef CONFIG_LV_TINY_TTF_KERN_MEMO_CNT
+            #define LV_TINY_TTF_KERN_MEMO_CNT CONFIG_LV_TINY_TTF_KERN_MEMO_CNT
+        #else
+            #define LV_TINY_TTF_KERN_MEMO_CNT 256
+        #endif
+    #endif
 #endif
 
 /*Rlottie library*/
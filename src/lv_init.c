@@ -203,6 +203,18 @@ void lv_init(void)
     _lv_image_decoder_init();
     lv_bin_decoder_init();  /*LVGL built-in binary image decoder*/
 
+#if LV_USE_IMAGE_DECODER_ASYNC
+    _lv_image_decoder_async_init();
+#endif
+
+    _lv_draw_label_init();
+
+    _lv_font_fmt_txt_init();
+
+#if LV_USE_FONT_GLYPH_ATLAS
+    _lv_font_glyph_atlas_init();
+#endif
+
 #if LV_USE_DRAW_VG_LITE
     lv_draw_vg_lite_init();
 #endif
@@ -360,8 +372,20 @@ void lv_deinit(void)
     lv_theme_mono_deinit();
 #endif
 
+#if LV_USE_IMAGE_DECODER_ASYNC
+    _lv_image_decoder_async_deinit();
+#endif
+
     _lv_image_decoder_deinit();
 
+    _lv_draw_label_deinit();
+
+    _lv_font_fmt_txt_deinit();
+
+#if LV_USE_FONT_GLYPH_ATLAS
+    _lv_font_glyph_atlas_deinit();
+#endif
+
     _lv_refr_deinit();
 
     _lv_obj_style_deinit();
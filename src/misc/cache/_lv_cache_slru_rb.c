@@ -0,0 +1,477 @@
+/**
+* @file _lv_cache_slru_rb.c
+*
+*/
+
+/***************************************************************************\
+*                                                                           *
+*   Segmented LRU: the entries are in one of two LRU lists                  *
+*                                                                           *
+*            insert                         hit again                       *
+*              │                                │                           *
+*              ▼                                ▼                           *
+*      ┌──────────────────┐  hit again  ┌──────────────────┐                *
+*      │   Probationary   │ ──────────▶ │    Protected     │                *
+*      │   head ... tail  │ ◀────────── │  head ... tail   │                *
+*      └──────────────────┘   demote    └──────────────────┘                *
+*              │            (if > 3/4)          │                           *
+*              ▼                                ▼                           *
+*        evicted first                   evicted only if the                *
+*                                        probationary list is empty         *
+*                                                                           *
+*   The hits in the same access period (see `lv_cache_next_period()`)       *
+*   count as one, so an entry used many times during a refresh isn't        *
+*   "hit again" until the next refresh.                                     *
+*                                                                           *
+\***************************************************************************/
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "_lv_cache_slru_rb.h"
+#include "../../stdlib/lv_sprintf.h"
+#include "../../stdlib/lv_string.h"
+#include "../lv_ll.h"
+#include "../lv_rb.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*The protected segment can use this part of the cache*/
+#define PROTECTED_RATIO_NUM 3
+#define PROTECTED_RATIO_DEN 4
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef uint32_t (get_data_size_cb_t)(const void * data);
+
+/*Stored in the linked lists*/
+typedef struct {
+    lv_rb_node_t * rb_node;
+    uint32_t period;        /**< The access period of the cache when the entry was last used*/
+    bool is_protected;
+} slru_node_t;
+
+struct _lv_slru_rb_t {
+    lv_cache_t cache;
+
+    lv_rb_t rb;
+    lv_ll_t probation_ll;
+    lv_ll_t protected_ll;
+    uint32_t protected_size;
+
+    get_data_size_cb_t * get_data_size_cb;
+};
+typedef struct _lv_slru_rb_t lv_slru_rb_t_;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void * alloc_cb(void);
+static bool init_cnt_cb(lv_cache_t * cache);
+static bool init_size_cb(lv_cache_t * cache);
+static void  destroy_cb(lv_cache_t * cache, void * user_data);
+
+static lv_cache_entry_t * get_cb(lv_cache_t * cache, const void * key, void * user_data);
+static lv_cache_entry_t * add_cb(lv_cache_t * cache, const void * key, void * user_data);
+static void remove_cb(lv_cache_t * cache, lv_cache_entry_t * entry, void * user_data);
+static void drop_cb(lv_cache_t * cache, const void * key, void * user_data);
+static void drop_all_cb(lv_cache_t * cache, void * user_data);
+static lv_cache_entry_t * get_victim_cb(lv_cache_t * cache, void * user_data);
+static lv_cache_reserve_cond_res_t reserve_cond_cb(lv_cache_t * cache, const void * key, size_t reserved_size,
+                                                   void * user_data);
+
+static bool init_common(lv_slru_rb_t_ * slru);
+static slru_node_t * get_slru_node(lv_slru_rb_t_ * slru, lv_rb_node_t * node);
+static void unlink_node(lv_slru_rb_t_ * slru, lv_rb_node_t * node);
+static void shrink_protected(lv_slru_rb_t_ * slru);
+static lv_cache_entry_t * find_victim(lv_slru_rb_t_ * slru, lv_ll_t * ll);
+
+static uint32_t cnt_get_data_size_cb(const void * data);
+static uint32_t size_get_data_size_cb(const void * data);
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+const lv_cache_class_t lv_cache_class_slru_rb_count = {
+    .alloc_cb = alloc_cb,
+    .init_cb = init_cnt_cb,
+    .destroy_cb = destroy_cb,
+
+    .get_cb = get_cb,
+    .add_cb = add_cb,
+    .remove_cb = remove_cb,
+    .drop_cb = drop_cb,
+    .drop_all_cb = drop_all_cb,
+    .get_victim_cb = get_victim_cb,
+    .reserve_cond_cb = reserve_cond_cb
+};
+
+const lv_cache_class_t lv_cache_class_slru_rb_size = {
+    .alloc_cb = alloc_cb,
+    .init_cb = init_size_cb,
+    .destroy_cb = destroy_cb,
+
+    .get_cb = get_cb,
+    .add_cb = add_cb,
+    .remove_cb = remove_cb,
+    .drop_cb = drop_cb,
+    .drop_all_cb = drop_all_cb,
+    .get_victim_cb = get_victim_cb,
+    .reserve_cond_cb = reserve_cond_cb
+};
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void * alloc_cb(void)
+{
+    void * res = lv_malloc(sizeof(lv_slru_rb_t_));
+    LV_ASSERT_MALLOC(res);
+    if(res == NULL) {
+        LV_LOG_ERROR("malloc failed");
+        return NULL;
+    }
+
+    lv_memzero(res, sizeof(lv_slru_rb_t_));
+    return res;
+}
+
+static bool init_cnt_cb(lv_cache_t * cache)
+{
+    lv_slru_rb_t_ * slru = (lv_slru_rb_t_ *)cache;
+    slru->get_data_size_cb = cnt_get_data_size_cb;
+    return init_common(slru);
+}
+
+static bool init_size_cb(lv_cache_t * cache)
+{
+    lv_slru_rb_t_ * slru = (lv_slru_rb_t_ *)cache;
+    slru->get_data_size_cb = size_get_data_size_cb;
+    return init_common(slru);
+}
+
+static void destroy_cb(lv_cache_t * cache, void * user_data)
+{
+    LV_ASSERT_NULL(cache);
+
+    if(cache == NULL) {
+        return;
+    }
+
+    cache->clz->drop_all_cb(cache, user_data);
+}
+
+static lv_cache_entry_t * get_cb(lv_cache_t * cache, const void * key, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    lv_slru_rb_t_ * slru = (lv_slru_rb_t_ *)cache;
+
+    LV_ASSERT_NULL(slru);
+    LV_ASSERT_NULL(key);
+
+    if(slru == NULL || key == NULL) {
+        return NULL;
+    }
+
+    lv_rb_node_t * node = lv_rb_find(&slru->rb, key);
+    if(node == NULL) {
+        return NULL;
+    }
+
+    slru_node_t * slru_node = get_slru_node(slru, node);
+    if(slru_node->is_protected) {
+        void * head = _lv_ll_get_head(&slru->protected_ll);
+        if(head != slru_node) _lv_ll_move_before(&slru->protected_ll, slru_node, head);
+    }
+    else if(slru_node->period == cache->period) {
+        /*Looked up again in the same period (e.g. by the same refresh). It's still one use.*/
+        void * head = _lv_ll_get_head(&slru->probation_ll);
+        if(head != slru_node) _lv_ll_move_before(&slru->probation_ll, slru_node, head);
+    }
+    else {
+        /*Used again so it's worth protecting*/
+        _lv_ll_chg_list(&slru->probation_ll, &slru->protected_ll, slru_node, true);
+        slru_node->is_protected = true;
+        slru->protected_size += slru->get_data_size_cb(node->data);
+        shrink_protected(slru);
+    }
+    slru_node->period = cache->period;
+
+    return lv_cache_entry_get_entry(node->data, cache->node_size);
+}
+
+static lv_cache_entry_t * add_cb(lv_cache_t * cache, const void * key, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    lv_slru_rb_t_ * slru = (lv_slru_rb_t_ *)cache;
+
+    LV_ASSERT_NULL(slru);
+    LV_ASSERT_NULL(key);
+
+    if(slru == NULL || key == NULL) {
+        return NULL;
+    }
+
+    lv_rb_node_t * node = lv_rb_insert(&slru->rb, (void *)key);
+    if(node == NULL) {
+        return NULL;
+    }
+
+    void * data = node->data;
+    lv_memcpy(data, key, cache->node_size);
+
+    slru_node_t * slru_node = _lv_ll_ins_head(&slru->probation_ll);
+    if(slru_node == NULL) {
+        lv_rb_drop_node(&slru->rb, node);
+        return NULL;
+    }
+
+    slru_node->rb_node = node;
+    slru_node->period = cache->period;
+    slru_node->is_protected = false;
+    lv_memcpy((char *)data + slru->rb.size - sizeof(void *), &slru_node, sizeof(void *));
+
+    lv_cache_entry_t * entry = lv_cache_entry_get_entry(data, cache->node_size);
+    lv_cache_entry_init(entry, cache, cache->node_size);
+
+    cache->size += slru->get_data_size_cb(key);
+
+    return entry;
+}
+
+static void remove_cb(lv_cache_t * cache, lv_cache_entry_t * entry, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    lv_slru_rb_t_ * slru = (lv_slru_rb_t_ *)cache;
+
+    LV_ASSERT_NULL(slru);
+    LV_ASSERT_NULL(entry);
+
+    if(slru == NULL || entry == NULL) {
+        return;
+    }
+
+    void * data = lv_cache_entry_get_data(entry);
+    lv_rb_node_t * node = lv_rb_find(&slru->rb, data);
+    if(node == NULL) {
+        return;
+    }
+
+    unlink_node(slru, node);
+    lv_rb_remove_node(&slru->rb, node);
+
+    cache->size -= slru->get_data_size_cb(data);
+}
+
+static void drop_cb(lv_cache_t * cache, const void * key, void * user_data)
+{
+    lv_slru_rb_t_ * slru = (lv_slru_rb_t_ *)cache;
+
+    LV_ASSERT_NULL(slru);
+    LV_ASSERT_NULL(key);
+
+    if(slru == NULL || key == NULL) {
+        return;
+    }
+
+    lv_rb_node_t * node = lv_rb_find(&slru->rb, key);
+    if(node == NULL) {
+        return;
+    }
+
+    void * data = node->data;
+
+    cache->ops.free_cb(data, user_data);
+    cache->size -= slru->get_data_size_cb(data);
+
+    lv_cache_entry_t * entry = lv_cache_entry_get_entry(data, cache->node_size);
+
+    unlink_node(slru, node);
+    lv_rb_remove_node(&slru->rb, node);
+    lv_cache_entry_delete(entry);
+}
+
+static void drop_all_cb(lv_cache_t * cache, void * user_data)
+{
+    lv_slru_rb_t_ * slru = (lv_slru_rb_t_ *)cache;
+
+    LV_ASSERT_NULL(slru);
+
+    if(slru == NULL) {
+        return;
+    }
+
+    uint32_t used_cnt = 0;
+    lv_ll_t * lists[2] = {&slru->probation_ll, &slru->protected_ll};
+    uint32_t i;
+    for(i = 0; i < 2; i++) {
+        slru_node_t * slru_node;
+        _LV_LL_READ(lists[i], slru_node) {
+            /*free user handled data and do other clean up*/
+            void * data = slru_node->rb_node->data;
+            lv_cache_entry_t * entry = lv_cache_entry_get_entry(data, cache->node_size);
+            if(lv_cache_entry_get_ref(entry) == 0) {
+                cache->ops.free_cb(data, user_data);
+            }
+            else {
+                LV_LOG_WARN("entry (%p) is still referenced (%" LV_PRId32 ")", (void *)entry, lv_cache_entry_get_ref(entry));
+                used_cnt++;
+            }
+        }
+    }
+    if(used_cnt > 0) {
+        LV_LOG_WARN("%" LV_PRId32 " entries are still referenced", used_cnt);
+    }
+
+    lv_rb_destroy(&slru->rb);
+    _lv_ll_clear(&slru->probation_ll);
+    _lv_ll_clear(&slru->protected_ll);
+
+    cache->size = 0;
+    slru->protected_size = 0;
+}
+
+static lv_cache_entry_t * get_victim_cb(lv_cache_t * cache, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    lv_slru_rb_t_ * slru = (lv_slru_rb_t_ *)cache;
+
+    LV_ASSERT_NULL(slru);
+
+    lv_cache_entry_t * entry = find_victim(slru, &slru->probation_ll);
+    if(entry == NULL) entry = find_victim(slru, &slru->protected_ll);
+
+    return entry;
+}
+
+static lv_cache_reserve_cond_res_t reserve_cond_cb(lv_cache_t * cache, const void * key, size_t reserved_size,
+                                                   void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    lv_slru_rb_t_ * slru = (lv_slru_rb_t_ *)cache;
+
+    LV_ASSERT_NULL(slru);
+
+    if(slru == NULL) {
+        return LV_CACHE_RESERVE_COND_ERROR;
+    }
+
+    uint32_t data_size = key ? slru->get_data_size_cb(key) : 0;
+    if(data_size > cache->max_size) {
+        LV_LOG_ERROR("data size (%" LV_PRIu32 ") is larger than max size (%" LV_PRIu32 ")", data_size, cache->max_size);
+        return LV_CACHE_RESERVE_COND_TOO_LARGE;
+    }
+
+    return cache->size + reserved_size + data_size > cache->max_size
+           ? LV_CACHE_RESERVE_COND_NEED_VICTIM
+           : LV_CACHE_RESERVE_COND_OK;
+}
+
+static bool init_common(lv_slru_rb_t_ * slru)
+{
+    lv_cache_t * cache = &slru->cache;
+
+    LV_ASSERT_NULL(cache->ops.compare_cb);
+    LV_ASSERT_NULL(cache->ops.free_cb);
+    LV_ASSERT(cache->node_size > 0);
+
+    if(cache->node_size <= 0 || cache->max_size <= 0
+       || cache->ops.compare_cb == NULL || cache->ops.free_cb == NULL) {
+        return false;
+    }
+
+    /*add void* to store the ll node pointer*/
+    if(!lv_rb_init(&slru->rb, cache->ops.compare_cb, lv_cache_entry_get_size(cache->node_size) + sizeof(void *))) {
+        return false;
+    }
+    _lv_ll_init(&slru->probation_ll, sizeof(slru_node_t));
+    _lv_ll_init(&slru->protected_ll, sizeof(slru_node_t));
+
+    return true;
+}
+
+static slru_node_t * get_slru_node(lv_slru_rb_t_ * slru, lv_rb_node_t * node)
+{
+    slru_node_t * slru_node;
+    lv_memcpy(&slru_node, (char *)node->data + slru->rb.size - sizeof(void *), sizeof(void *));
+    return slru_node;
+}
+
+/**
+ * Remove the node from its list
+ */
+static void unlink_node(lv_slru_rb_t_ * slru, lv_rb_node_t * node)
+{
+    slru_node_t * slru_node = get_slru_node(slru, node);
+    if(slru_node->is_protected) {
+        slru->protected_size -= slru->get_data_size_cb(node->data);
+        _lv_ll_remove(&slru->protected_ll, slru_node);
+    }
+    else {
+        _lv_ll_remove(&slru->probation_ll, slru_node);
+    }
+    lv_free(slru_node);
+}
+
+/**
+ * Move the least recently used protected entries back to the probationary segment
+ * while the protected segment is too large. The most recent one is always kept.
+ */
+static void shrink_protected(lv_slru_rb_t_ * slru)
+{
+    uint32_t max_protected = (uint32_t)((uint64_t)slru->cache.max_size * PROTECTED_RATIO_NUM / PROTECTED_RATIO_DEN);
+
+    while(slru->protected_size > max_protected) {
+        slru_node_t * tail = _lv_ll_get_tail(&slru->protected_ll);
+        if(tail == NULL || tail == _lv_ll_get_head(&slru->protected_ll)) break;
+
+        _lv_ll_chg_list(&slru->protected_ll, &slru->probation_ll, tail, true);
+        tail->is_protected = false;
+        slru->protected_size -= slru->get_data_size_cb(tail->rb_node->data);
+    }
+}
+
+static lv_cache_entry_t * find_victim(lv_slru_rb_t_ * slru, lv_ll_t * ll)
+{
+    slru_node_t * slru_node;
+    _LV_LL_READ_BACK(ll, slru_node) {
+        lv_cache_entry_t * entry = lv_cache_entry_get_entry(slru_node->rb_node->data, slru->cache.node_size);
+        if(lv_cache_entry_get_ref(entry) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static uint32_t cnt_get_data_size_cb(const void * data)
+{
+    LV_UNUSED(data);
+    return 1;
+}
+
+static uint32_t size_get_data_size_cb(const void * data)
+{
+    lv_cache_slot_size_t * slot = (lv_cache_slot_size_t *)data;
+    return slot->size;
+}
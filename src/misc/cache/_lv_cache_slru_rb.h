@@ -0,0 +1,51 @@
+/**
+* @file _lv_cache_slru_rb.h
+*
+*/
+
+#ifndef LV_CACHE_SLRU_RB_H
+#define LV_CACHE_SLRU_RB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_cache_entry.h"
+#include "lv_cache_private.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/*************************
+ *    GLOBAL VARIABLES
+ *************************/
+
+/**
+ * Segmented LRU caches. New entries are added to a probationary segment and are moved to a protected
+ * segment (at most 3/4 of the cache) only when they are used again. Entries are evicted from the
+ * probationary segment first, so a single pass over many entries (e.g. scrolling through a gallery)
+ * can't flush the frequently used ones.
+ */
+LV_ATTRIBUTE_EXTERN_DATA extern const lv_cache_class_t lv_cache_class_slru_rb_count;
+LV_ATTRIBUTE_EXTERN_DATA extern const lv_cache_class_t lv_cache_class_slru_rb_size;
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_CACHE_SLRU_RB_H*/
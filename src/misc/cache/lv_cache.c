@@ -25,6 +25,8 @@
 static void cache_drop_internal_no_lock(lv_cache_t * cache, const void * key, void * user_data);
 static bool cache_evict_one_internal_no_lock(lv_cache_t * cache, void * user_data);
 static lv_cache_entry_t * cache_add_internal_no_lock(lv_cache_t * cache, const void * key, void * user_data);
+static void cache_evicted_flush(lv_cache_t * cache, void * user_data);
+static lv_cache_t * get_shard(lv_cache_t * cache, const void * key);
 /**********************
  *  GLOBAL VARIABLES
  **********************/
@@ -61,6 +63,48 @@ lv_cache_t * lv_cache_create(const lv_cache_class_t * cache_class,
     }
 
     lv_mutex_init(&cache->lock);
+    _lv_ll_init(&cache->evicted_ll, sizeof(lv_cache_entry_t *));
+
+    return cache;
+}
+
+lv_cache_t * lv_cache_create_sharded(const lv_cache_class_t * cache_class,
+                                     size_t node_size, size_t max_size,
+                                     lv_cache_ops_t ops, uint32_t shard_cnt)
+{
+    LV_ASSERT_NULL(ops.hash_cb);
+
+    /*Each shard should be able to hold at least one entry*/
+    if(shard_cnt > max_size) shard_cnt = (uint32_t)max_size;
+    if(shard_cnt <= 1 || ops.hash_cb == NULL) return lv_cache_create(cache_class, node_size, max_size, ops);
+
+    lv_cache_t * cache = lv_malloc_zeroed(sizeof(lv_cache_t));
+    LV_ASSERT_MALLOC(cache);
+    if(cache == NULL) return NULL;
+
+    cache->shards = lv_malloc_zeroed(shard_cnt * sizeof(lv_cache_t *));
+    LV_ASSERT_MALLOC(cache->shards);
+    if(cache->shards == NULL) {
+        lv_free(cache);
+        return NULL;
+    }
+
+    cache->clz = cache_class;
+    cache->node_size = node_size;
+    cache->max_size = max_size;
+    cache->ops = ops;
+    cache->shard_cnt = shard_cnt;
+    lv_mutex_init(&cache->lock);
+    _lv_ll_init(&cache->evicted_ll, sizeof(lv_cache_entry_t *));
+
+    uint32_t i;
+    for(i = 0; i < shard_cnt; i++) {
+        cache->shards[i] = lv_cache_create(cache_class, node_size, max_size / shard_cnt, ops);
+        if(cache->shards[i] == NULL) {
+            lv_cache_destroy(cache, NULL);
+            return NULL;
+        }
+    }
 
     return cache;
 }
@@ -69,6 +113,19 @@ void lv_cache_destroy(lv_cache_t * cache, void * user_data)
 {
     LV_ASSERT_NULL(cache);
 
+    if(cache->shards) {
+        uint32_t i;
+        for(i = 0; i < cache->shard_cnt; i++) {
+            if(cache->shards[i]) lv_cache_destroy(cache->shards[i], user_data);
+        }
+        lv_free(cache->shards);
+        lv_mutex_delete(&cache->lock);
+        lv_free(cache);
+        return;
+    }
+
+    cache_evicted_flush(cache, user_data);
+
     lv_mutex_lock(&cache->lock);
     cache->clz->destroy_cb(cache, user_data);
     lv_mutex_unlock(&cache->lock);
@@ -81,10 +138,15 @@ lv_cache_entry_t * lv_cache_acquire(lv_cache_t * cache, const void * key, void *
     LV_ASSERT_NULL(cache);
     LV_ASSERT_NULL(key);
 
+    cache = get_shard(cache, key);
     lv_mutex_lock(&cache->lock);
     lv_cache_entry_t * entry = cache->clz->get_cb(cache, key, user_data);
     if(entry != NULL) {
         lv_cache_entry_acquire_data(entry);
+        cache->hit_cnt++;
+    }
+    else {
+        cache->miss_cnt++;
     }
     lv_mutex_unlock(&cache->lock);
     return entry;
@@ -93,26 +155,39 @@ void lv_cache_release(lv_cache_t * cache, lv_cache_entry_t * entry, void * user_
 {
     LV_ASSERT_NULL(entry);
 
-    lv_mutex_lock(&cache->lock);
-    lv_cache_entry_release_data(entry, user_data);
+    /*The entry knows its shard*/
+    if(cache->shards) cache = (lv_cache_t *)lv_cache_entry_get_cache(entry);
 
-    if(lv_cache_entry_get_ref(entry) == 0 && lv_cache_entry_is_invalid(entry)) {
+#if LV_CACHE_ENTRY_REF_ATOMIC
+    /*Only the entries which are already removed from the cache need the lock*/
+    if(lv_cache_entry_release_data(entry, user_data)) {
+        lv_mutex_lock(&cache->lock);
+        cache->ops.free_cb(lv_cache_entry_get_data(entry), user_data);
+        lv_cache_entry_delete(entry);
+        lv_mutex_unlock(&cache->lock);
+    }
+#else
+    lv_mutex_lock(&cache->lock);
+    if(lv_cache_entry_release_data(entry, user_data)) {
         cache->ops.free_cb(lv_cache_entry_get_data(entry), user_data);
         lv_cache_entry_delete(entry);
     }
     lv_mutex_unlock(&cache->lock);
+#endif
 }
 lv_cache_entry_t * lv_cache_add(lv_cache_t * cache, const void * key, void * user_data)
 {
     LV_ASSERT_NULL(cache);
     LV_ASSERT_NULL(key);
 
+    cache = get_shard(cache, key);
     lv_mutex_lock(&cache->lock);
     lv_cache_entry_t * entry = cache_add_internal_no_lock(cache, key, user_data);
     if(entry != NULL) {
         lv_cache_entry_acquire_data(entry);
     }
     lv_mutex_unlock(&cache->lock);
+    cache_evicted_flush(cache, user_data);
 
     return entry;
 }
@@ -121,16 +196,20 @@ lv_cache_entry_t * lv_cache_acquire_or_create(lv_cache_t * cache, const void * k
     LV_ASSERT_NULL(cache);
     LV_ASSERT_NULL(key);
 
+    cache = get_shard(cache, key);
     lv_mutex_lock(&cache->lock);
     lv_cache_entry_t * entry = cache->clz->get_cb(cache, key, user_data);
     if(entry != NULL) {
         lv_cache_entry_acquire_data(entry);
+        cache->hit_cnt++;
         lv_mutex_unlock(&cache->lock);
         return entry;
     }
+    cache->miss_cnt++;
     entry = cache_add_internal_no_lock(cache, key, user_data);
     if(entry == NULL) {
         lv_mutex_unlock(&cache->lock);
+        cache_evicted_flush(cache, user_data);
         return NULL;
     }
     bool create_res = cache->ops.create_cb(lv_cache_entry_get_data(entry), user_data);
@@ -143,23 +222,36 @@ lv_cache_entry_t * lv_cache_acquire_or_create(lv_cache_t * cache, const void * k
         lv_cache_entry_acquire_data(entry);
     }
     lv_mutex_unlock(&cache->lock);
+    cache_evicted_flush(cache, user_data);
     return entry;
 }
 void lv_cache_reserve(lv_cache_t * cache, uint32_t reserved_size, void * user_data)
 {
     LV_ASSERT_NULL(cache);
 
+    if(cache->shards) {
+        /*The key is unknown so make room evenly in the shards*/
+        uint32_t shard_reserved_size = (reserved_size + cache->shard_cnt - 1) / cache->shard_cnt;
+        uint32_t i;
+        for(i = 0; i < cache->shard_cnt; i++) lv_cache_reserve(cache->shards[i], shard_reserved_size, user_data);
+        return;
+    }
+
+    lv_mutex_lock(&cache->lock);
     for(lv_cache_reserve_cond_res_t reserve_cond_res = cache->clz->reserve_cond_cb(cache, NULL, reserved_size, user_data);
         reserve_cond_res == LV_CACHE_RESERVE_COND_NEED_VICTIM;
-        reserve_cond_res = cache->clz->reserve_cond_cb(cache, NULL, reserved_size, user_data))
-        cache_evict_one_internal_no_lock(cache, user_data);
-
+        reserve_cond_res = cache->clz->reserve_cond_cb(cache, NULL, reserved_size, user_data)) {
+        if(!cache_evict_one_internal_no_lock(cache, user_data)) break;
+    }
+    lv_mutex_unlock(&cache->lock);
+    cache_evicted_flush(cache, user_data);
 }
 void lv_cache_drop(lv_cache_t * cache, const void * key, void * user_data)
 {
     LV_ASSERT_NULL(cache);
     LV_ASSERT_NULL(key);
 
+    cache = get_shard(cache, key);
     lv_mutex_lock(&cache->lock);
     cache_drop_internal_no_lock(cache, key, user_data);
     lv_mutex_unlock(&cache->lock);
@@ -168,9 +260,28 @@ bool lv_cache_evict_one(lv_cache_t * cache, void * user_data)
 {
     LV_ASSERT_NULL(cache);
 
+    if(cache->shards) {
+        /*Evict from the fullest shard*/
+        lv_cache_t * fullest = NULL;
+        uint32_t fullest_size = 0;
+        uint32_t i;
+        for(i = 0; i < cache->shard_cnt; i++) {
+            lv_cache_t * shard = cache->shards[i];
+            lv_mutex_lock(&shard->lock);
+            uint32_t shard_size = shard->size;
+            lv_mutex_unlock(&shard->lock);
+            if(shard_size > fullest_size) {
+                fullest = shard;
+                fullest_size = shard_size;
+            }
+        }
+        return fullest ? lv_cache_evict_one(fullest, user_data) : false;
+    }
+
     lv_mutex_lock(&cache->lock);
     bool res = cache_evict_one_internal_no_lock(cache, user_data);
     lv_mutex_unlock(&cache->lock);
+    cache_evicted_flush(cache, user_data);
 
     return res;
 }
@@ -178,6 +289,12 @@ void lv_cache_drop_all(lv_cache_t * cache, void * user_data)
 {
     LV_ASSERT_NULL(cache);
 
+    if(cache->shards) {
+        uint32_t i;
+        for(i = 0; i < cache->shard_cnt; i++) lv_cache_drop_all(cache->shards[i], user_data);
+        return;
+    }
+
     lv_mutex_lock(&cache->lock);
     cache->clz->drop_all_cb(cache, user_data);
     lv_mutex_unlock(&cache->lock);
@@ -187,36 +304,102 @@ void lv_cache_set_max_size(lv_cache_t * cache, size_t max_size, void * user_data
 {
     LV_UNUSED(user_data);
     cache->max_size = max_size;
+
+    uint32_t i;
+    for(i = 0; i < cache->shard_cnt; i++) lv_cache_set_max_size(cache->shards[i], max_size / cache->shard_cnt, user_data);
 }
 size_t lv_cache_get_max_size(lv_cache_t * cache, void * user_data)
 {
     LV_UNUSED(user_data);
     return cache->max_size;
 }
+size_t lv_cache_get_max_entry_size(lv_cache_t * cache, void * user_data)
+{
+    LV_UNUSED(user_data);
+    if(cache->shard_cnt == 0) return cache->max_size;
+    return cache->shards[0]->max_size;
+}
 size_t lv_cache_get_size(lv_cache_t * cache, void * user_data)
 {
     LV_UNUSED(user_data);
-    return cache->size;
+
+    size_t size = cache->size;
+    uint32_t i;
+    for(i = 0; i < cache->shard_cnt; i++) size += cache->shards[i]->size;
+    return size;
 }
 size_t lv_cache_get_free_size(lv_cache_t * cache, void * user_data)
+{
+    return cache->max_size - lv_cache_get_size(cache, user_data);
+}
+uint32_t lv_cache_get_hit_cnt(lv_cache_t * cache, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    uint32_t i;
+    uint32_t cnt = 0;
+    for(i = 0; i < cache->shard_cnt; i++) cnt += lv_cache_get_hit_cnt(cache->shards[i], user_data);
+
+    lv_mutex_lock(&cache->lock);
+    cnt += cache->hit_cnt;
+    lv_mutex_unlock(&cache->lock);
+    return cnt;
+}
+uint32_t lv_cache_get_miss_cnt(lv_cache_t * cache, void * user_data)
 {
     LV_UNUSED(user_data);
-    return cache->max_size - cache->size;
+
+    uint32_t i;
+    uint32_t cnt = 0;
+    for(i = 0; i < cache->shard_cnt; i++) cnt += lv_cache_get_miss_cnt(cache->shards[i], user_data);
+
+    lv_mutex_lock(&cache->lock);
+    cnt += cache->miss_cnt;
+    lv_mutex_unlock(&cache->lock);
+    return cnt;
+}
+void lv_cache_reset_stats(lv_cache_t * cache, void * user_data)
+{
+    uint32_t i;
+    for(i = 0; i < cache->shard_cnt; i++) lv_cache_reset_stats(cache->shards[i], user_data);
+
+    lv_mutex_lock(&cache->lock);
+    cache->hit_cnt = 0;
+    cache->miss_cnt = 0;
+    lv_mutex_unlock(&cache->lock);
+}
+void lv_cache_next_period(lv_cache_t * cache, void * user_data)
+{
+    uint32_t i;
+    for(i = 0; i < cache->shard_cnt; i++) lv_cache_next_period(cache->shards[i], user_data);
+
+    lv_mutex_lock(&cache->lock);
+    cache->period++;
+    lv_mutex_unlock(&cache->lock);
 }
 void lv_cache_set_compare_cb(lv_cache_t * cache, lv_cache_compare_cb_t compare_cb, void * user_data)
 {
     LV_UNUSED(user_data);
     cache->ops.compare_cb = compare_cb;
+
+    uint32_t i;
+    for(i = 0; i < cache->shard_cnt; i++) lv_cache_set_compare_cb(cache->shards[i], compare_cb, user_data);
 }
 void lv_cache_set_create_cb(lv_cache_t * cache, lv_cache_create_cb_t alloc_cb, void * user_data)
 {
     LV_UNUSED(user_data);
     cache->ops.create_cb = alloc_cb;
+
+    uint32_t i;
+    for(i = 0; i < cache->shard_cnt; i++) lv_cache_set_create_cb(cache->shards[i], alloc_cb, user_data);
 }
 void lv_cache_set_free_cb(lv_cache_t * cache, lv_cache_free_cb_t free_cb, void * user_data)
 {
     LV_UNUSED(user_data);
     cache->ops.free_cb = free_cb;
+
+    uint32_t i;
+    for(i = 0; i < cache->shard_cnt; i++) lv_cache_set_free_cb(cache->shards[i], free_cb, user_data);
 }
 
 /**********************
@@ -230,15 +413,12 @@ static void cache_drop_internal_no_lock(lv_cache_t * cache, const void * key, vo
         return;
     }
 
-    if(lv_cache_entry_get_ref(entry) == 0) {
-        cache->clz->remove_cb(cache, entry, user_data);
+    /*If it's still referenced the last release will free it*/
+    cache->clz->remove_cb(cache, entry, user_data);
+    if(lv_cache_entry_mark_invalid(entry)) {
         cache->ops.free_cb(lv_cache_entry_get_data(entry), user_data);
         lv_cache_entry_delete(entry);
     }
-    else {
-        lv_cache_entry_set_invalid(entry, true);
-        cache->clz->remove_cb(cache, entry, user_data);
-    }
 }
 
 static bool cache_evict_one_internal_no_lock(lv_cache_t * cache, void * user_data)
@@ -251,11 +431,45 @@ static bool cache_evict_one_internal_no_lock(lv_cache_t * cache, void * user_dat
     }
 
     cache->clz->remove_cb(cache, victim, user_data);
+
+    /*`evict_cb` might be slow so it's called by `cache_evicted_flush()` after unlocking*/
+    lv_cache_entry_t ** evicted = cache->ops.evict_cb ? _lv_ll_ins_tail(&cache->evicted_ll) : NULL;
+    if(evicted) {
+        *evicted = victim;
+        return true;
+    }
+
     cache->ops.free_cb(lv_cache_entry_get_data(victim), user_data);
     lv_cache_entry_delete(victim);
     return true;
 }
 
+/**
+ * Call `evict_cb` and free the evicted entries. Call it without holding the cache lock.
+ */
+static void cache_evicted_flush(lv_cache_t * cache, void * user_data)
+{
+    if(cache->ops.evict_cb == NULL) return;
+
+    while(1) {
+        lv_mutex_lock(&cache->lock);
+        lv_cache_entry_t ** evicted = _lv_ll_get_head(&cache->evicted_ll);
+        lv_cache_entry_t * victim = evicted ? *evicted : NULL;
+        if(evicted) {
+            _lv_ll_remove(&cache->evicted_ll, evicted);
+            lv_free(evicted);
+        }
+        lv_mutex_unlock(&cache->lock);
+
+        if(victim == NULL) break;
+
+        /*It's not in the cache anymore so no one else can access it*/
+        cache->ops.evict_cb(lv_cache_entry_get_data(victim), user_data);
+        cache->ops.free_cb(lv_cache_entry_get_data(victim), user_data);
+        lv_cache_entry_delete(victim);
+    }
+}
+
 static lv_cache_entry_t * cache_add_internal_no_lock(lv_cache_t * cache, const void * key, void * user_data)
 {
     lv_cache_reserve_cond_res_t reserve_cond_res = cache->clz->reserve_cond_cb(cache, key, 0, user_data);
@@ -272,3 +486,14 @@ static lv_cache_entry_t * cache_add_internal_no_lock(lv_cache_t * cache, const v
 
     return entry;
 }
+
+/**
+ * Get the shard of a key in a sharded cache
+ * @return      the shard or `cache` itself if it's not sharded
+ */
+static lv_cache_t * get_shard(lv_cache_t * cache, const void * key)
+{
+    if(cache->shards == NULL) return cache;
+
+    return cache->shards[cache->ops.hash_cb(key) % cache->shard_cnt];
+}
@@ -19,6 +19,7 @@ extern "C" {
 #include <stdlib.h>
 
 #include "_lv_cache_lru_rb.h"
+#include "_lv_cache_slru_rb.h"
 
 #include "lv_image_cache.h"
 /*********************
@@ -49,6 +50,21 @@ lv_cache_t * lv_cache_create(const lv_cache_class_t * cache_class,
                              size_t node_size, size_t max_size,
                              lv_cache_ops_t ops);
 
+/**
+ * Create a cache split to shards by the hash of the keys. Each shard is a separate cache with
+ * its own lock and `max_size / shard_cnt` size, so threads using different keys don't wait for each other.
+ * All the cache functions can be used with the returned cache.
+ * @param cache_class   The class of the shards. See `lv_cache_create()`.
+ * @param node_size     The node size is the size of the data stored in the cache.
+ * @param max_size      The total max size of the shards.
+ * @param ops           A set of operations that can be performed on the cache. @lv_cache_ops_t::hash_cb is required.
+ * @param shard_cnt     Number of shards. With 0 or 1 a normal cache is created.
+ * @return              Returns a pointer to the created cache object on success, @NULL on error.
+ */
+lv_cache_t * lv_cache_create_sharded(const lv_cache_class_t * cache_class,
+                                     size_t node_size, size_t max_size,
+                                     lv_cache_ops_t ops, uint32_t shard_cnt);
+
 /**
  * Destroy a cache object.
  * @param cache         The cache object pointer to destroy.
@@ -152,6 +168,15 @@ void   lv_cache_set_max_size(lv_cache_t * cache, size_t max_size, void * user_da
  */
 size_t lv_cache_get_max_size(lv_cache_t * cache, void * user_data);
 
+/**
+ * Get the size of the largest entry which can be added to the cache.
+ * It's smaller than the max size of the cache if the cache is sharded.
+ * @param cache         The cache object pointer to get the maximum entry size.
+ * @param user_data     A user data pointer that will be passed to the free callback.
+ * @return              Returns the maximum size of an entry.
+ */
+size_t lv_cache_get_max_entry_size(lv_cache_t * cache, void * user_data);
+
 /**
  * Get the current size of the cache.
  * @param cache         The cache object pointer to get the current size.
@@ -168,6 +193,38 @@ size_t lv_cache_get_size(lv_cache_t * cache, void * user_data);
  */
 size_t lv_cache_get_free_size(lv_cache_t * cache, void * user_data);
 
+/**
+ * Get how many times an entry was found by `lv_cache_acquire()` or `lv_cache_acquire_or_create()`.
+ * @param cache         The cache object pointer to get the hit count.
+ * @param user_data     A user data pointer that will be passed to the free callback.
+ * @return              Returns the number of cache hits since the creation or the last `lv_cache_reset_stats()`.
+ */
+uint32_t lv_cache_get_hit_cnt(lv_cache_t * cache, void * user_data);
+
+/**
+ * Get how many times an entry was not found by `lv_cache_acquire()` or `lv_cache_acquire_or_create()`.
+ * @param cache         The cache object pointer to get the miss count.
+ * @param user_data     A user data pointer that will be passed to the free callback.
+ * @return              Returns the number of cache misses since the creation or the last `lv_cache_reset_stats()`.
+ */
+uint32_t lv_cache_get_miss_cnt(lv_cache_t * cache, void * user_data);
+
+/**
+ * Clear the hit and miss counters of the cache.
+ * @param cache         The cache object pointer to reset the counters of.
+ * @param user_data     A user data pointer that will be passed to the free callback.
+ */
+void lv_cache_reset_stats(lv_cache_t * cache, void * user_data);
+
+/**
+ * Start a new access period (e.g. a new display refresh) of the cache.
+ * The scan resistant caches promote an entry only if it's used again in a later period,
+ * so looking up the same entry many times during one refresh doesn't protect it.
+ * @param cache         The cache object pointer to start the new period of.
+ * @param user_data     A user data pointer that will be passed to the free callback.
+ */
+void lv_cache_next_period(lv_cache_t * cache, void * user_data);
+
 /**
  * Set the compare callback of the cache.
  * @param cache         The cache object pointer to set the compare callback.
@@ -15,20 +15,34 @@
 /*********************
  *      DEFINES
  *********************/
+/*The invalid flag is stored with the reference count to update them together*/
+#define ENTRY_INVALID   0x80000000U
+#define ENTRY_REF_MASK  (ENTRY_INVALID - 1)
+
+#if LV_CACHE_ENTRY_REF_ATOMIC
+    #define REF_LOAD(e)             __atomic_load_n(&(e)->state, __ATOMIC_ACQUIRE)
+    #define REF_CAS(e, old, new)    __atomic_compare_exchange_n(&(e)->state, old, new, false, \
+                                                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+    #define REF_LOAD(e)             ((e)->state)
+    #define REF_CAS(e, old, new)    ref_cas(&(e)->state, old, new)
+#endif
 
 /**********************
  *      TYPEDEFS
  **********************/
 struct _lv_cache_entry_t {
     const lv_cache_t * cache;
-    int32_t ref_cnt;
+    uint32_t state;         /*The reference count and `ENTRY_INVALID`*/
     uint32_t node_size;
-
-    bool is_invalid;
 };
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static uint32_t ref_update(lv_cache_entry_t * entry, int32_t diff, uint32_t set_flags, uint32_t clear_flags);
+#if !LV_CACHE_ENTRY_REF_ATOMIC
+    static bool ref_cas(uint32_t * state, uint32_t * old, uint32_t new_state);
+#endif
 
 /**********************
  *  GLOBAL VARIABLES
@@ -49,26 +63,23 @@ struct _lv_cache_entry_t {
 void lv_cache_entry_reset_ref(lv_cache_entry_t * entry)
 {
     LV_ASSERT_NULL(entry);
-    entry->ref_cnt = 0;
+    uint32_t state = REF_LOAD(entry);
+    while(!REF_CAS(entry, &state, state & ENTRY_INVALID));
 }
 void lv_cache_entry_inc_ref(lv_cache_entry_t * entry)
 {
     LV_ASSERT_NULL(entry);
-    entry->ref_cnt++;
+    ref_update(entry, 1, 0, 0);
 }
 void lv_cache_entry_dec_ref(lv_cache_entry_t * entry)
 {
     LV_ASSERT_NULL(entry);
-    entry->ref_cnt--;
-    if(entry->ref_cnt < 0) {
-        LV_LOG_WARN("ref_cnt(%" LV_PRIu32 ") < 0", entry->ref_cnt);
-        entry->ref_cnt = 0;
-    }
+    ref_update(entry, -1, 0, 0);
 }
 int32_t lv_cache_entry_get_ref(lv_cache_entry_t * entry)
 {
     LV_ASSERT_NULL(entry);
-    return entry->ref_cnt;
+    return (int32_t)(REF_LOAD(entry) & ENTRY_REF_MASK);
 }
 uint32_t lv_cache_entry_get_node_size(lv_cache_entry_t * entry)
 {
@@ -82,12 +93,19 @@ void lv_cache_entry_set_node_size(lv_cache_entry_t * entry, uint32_t node_size)
 void lv_cache_entry_set_invalid(lv_cache_entry_t * entry, bool is_invalid)
 {
     LV_ASSERT_NULL(entry);
-    entry->is_invalid = is_invalid;
+    if(is_invalid) ref_update(entry, 0, ENTRY_INVALID, 0);
+    else ref_update(entry, 0, 0, ENTRY_INVALID);
+}
+bool lv_cache_entry_mark_invalid(lv_cache_entry_t * entry)
+{
+    LV_ASSERT_NULL(entry);
+    uint32_t state = ref_update(entry, 0, ENTRY_INVALID, 0);
+    return state == ENTRY_INVALID;
 }
 bool lv_cache_entry_is_invalid(lv_cache_entry_t * entry)
 {
     LV_ASSERT_NULL(entry);
-    return entry->is_invalid;
+    return (REF_LOAD(entry) & ENTRY_INVALID) != 0;
 }
 void * lv_cache_entry_get_data(lv_cache_entry_t * entry)
 {
@@ -101,17 +119,18 @@ void * lv_cache_entry_acquire_data(lv_cache_entry_t * entry)
     lv_cache_entry_inc_ref(entry);
     return lv_cache_entry_get_data(entry);
 }
-void lv_cache_entry_release_data(lv_cache_entry_t * entry, void * user_data)
+bool lv_cache_entry_release_data(lv_cache_entry_t * entry, void * user_data)
 {
     LV_UNUSED(user_data);
 
     LV_ASSERT_NULL(entry);
     if(lv_cache_entry_get_ref(entry) == 0) {
-        LV_LOG_ERROR("ref_cnt(%" LV_PRIu32 ") == 0", entry->ref_cnt);
-        return;
+        LV_LOG_ERROR("ref_cnt(%" LV_PRIu32 ") == 0", lv_cache_entry_get_ref(entry));
+        return false;
     }
 
-    lv_cache_entry_dec_ref(entry);
+    /*Only one release can see the last reference of an invalid entry disappearing*/
+    return ref_update(entry, -1, 0, 0) == ENTRY_INVALID;
 }
 lv_cache_entry_t * lv_cache_entry_get_entry(void * data, const uint32_t node_size)
 {
@@ -152,8 +171,7 @@ void lv_cache_entry_init(lv_cache_entry_t * entry, const lv_cache_t * cache, con
 
     entry->cache = cache;
     entry->node_size = node_size;
-    entry->ref_cnt = 0;
-    entry->is_invalid = false;
+    entry->state = 0;
 }
 void lv_cache_entry_delete(lv_cache_entry_t * entry)
 {
@@ -165,3 +183,40 @@ void lv_cache_entry_delete(lv_cache_entry_t * entry)
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+/**
+ * Atomically change the reference count and the flags of an entry
+ * @param entry         pointer to an entry
+ * @param diff          add this to the reference count. The count doesn't go below 0.
+ * @param set_flags     flags to set
+ * @param clear_flags   flags to clear
+ * @return              the new state
+ */
+static uint32_t ref_update(lv_cache_entry_t * entry, int32_t diff, uint32_t set_flags, uint32_t clear_flags)
+{
+    uint32_t state = REF_LOAD(entry);
+    uint32_t new_state;
+    do {
+        uint32_t ref_cnt = state & ENTRY_REF_MASK;
+        if(diff < 0 && ref_cnt == 0) {
+            LV_LOG_WARN("ref_cnt(%" LV_PRIu32 ") < 0", ref_cnt);
+            diff = 0;
+        }
+        ref_cnt += diff;
+        new_state = (((state & ~ENTRY_REF_MASK) | set_flags) & ~clear_flags) | (ref_cnt & ENTRY_REF_MASK);
+    } while(!REF_CAS(entry, &state, new_state));
+
+    return new_state;
+}
+
+#if !LV_CACHE_ENTRY_REF_ATOMIC
+static bool ref_cas(uint32_t * state, uint32_t * old, uint32_t new_state)
+{
+    if(*state != *old) {
+        *old = *state;
+        return false;
+    }
+    *state = new_state;
+    return true;
+}
+#endif
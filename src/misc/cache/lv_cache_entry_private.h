@@ -20,6 +20,12 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+/*With atomic reference counting the entries can be released without locking the cache*/
+#if defined(__GNUC__) || defined(__clang__)
+    #define LV_CACHE_ENTRY_REF_ATOMIC 1
+#else
+    #define LV_CACHE_ENTRY_REF_ATOMIC 0
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -33,9 +39,19 @@ void   lv_cache_entry_inc_ref(lv_cache_entry_t * entry);
 void   lv_cache_entry_dec_ref(lv_cache_entry_t * entry);
 void   lv_cache_entry_set_node_size(lv_cache_entry_t * entry, uint32_t node_size);
 void   lv_cache_entry_set_invalid(lv_cache_entry_t * entry, bool is_invalid);
+/**
+ * Mark an entry invalid. An entry removed from the cache can't be acquired again,
+ * so the last release will free it.
+ * @return true: the entry is not referenced so the caller needs to free it
+ */
+bool   lv_cache_entry_mark_invalid(lv_cache_entry_t * entry);
 void   lv_cache_entry_set_cache(lv_cache_entry_t * entry, const lv_cache_t * cache);
 void * lv_cache_entry_acquire_data(lv_cache_entry_t * entry);
-void   lv_cache_entry_release_data(lv_cache_entry_t * entry, void * user_data);
+/**
+ * Drop a reference of an entry.
+ * @return true: it was the last reference of an invalid entry so the caller needs to free it
+ */
+bool   lv_cache_entry_release_data(lv_cache_entry_t * entry, void * user_data);
 /*************************
  *    GLOBAL VARIABLES
  *************************/
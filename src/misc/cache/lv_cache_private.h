@@ -17,6 +17,7 @@ extern "C" {
 #include <stdbool.h>
 #include <stdlib.h>
 #include "../../osal/lv_os.h"
+#include "../lv_ll.h"
 
 /*********************
  *      DEFINES
@@ -50,6 +51,8 @@ typedef int8_t lv_cache_compare_res_t;
 typedef bool (*lv_cache_create_cb_t)(void * node, void * user_data);
 typedef void (*lv_cache_free_cb_t)(void * node, void * user_data);
 typedef lv_cache_compare_res_t (*lv_cache_compare_cb_t)(const void * a, const void * b);
+typedef uint32_t (*lv_cache_hash_cb_t)(const void * key);
+typedef void (*lv_cache_evict_cb_t)(void * node, void * user_data);
 
 /**
  * The cache instance allocation function, used by the cache class to allocate memory for cache instances.
@@ -116,6 +119,11 @@ struct _lv_cache_ops_t {
     lv_cache_compare_cb_t compare_cb;    /**< Compare function for keys */
     lv_cache_create_cb_t create_cb;      /**< Create function for nodes */
     lv_cache_free_cb_t free_cb;          /**< Free function for nodes */
+    lv_cache_hash_cb_t hash_cb;          /**< Hash function for keys. Needed only by sharded caches.
+                                          *   Keys comparing equal must have the same hash. */
+    lv_cache_evict_cb_t evict_cb;        /**< Called before freeing a node evicted to make room for others.
+                                          *   Called without holding the cache lock, so it can do slow
+                                          *   work, e.g. compress the data. Not called for dropped nodes. Optional. */
 };
 
 /**
@@ -124,7 +132,9 @@ struct _lv_cache_ops_t {
 struct _lv_cache_t {
     const lv_cache_class_t * clz;     /**< The cache class. There are two built-in classes:
                                        * @lv_cache_class_lru_rb_count for LRU-based cache with count-based eviction policy.
-                                       * @lv_cache_class_lru_rb_size for LRU-based cache with size-based eviction policy. */
+                                       * @lv_cache_class_lru_rb_size for LRU-based cache with size-based eviction policy.
+                                       * @lv_cache_class_slru_rb_count and @lv_cache_class_slru_rb_size are their
+                                       * scan resistant (segmented LRU) variants. */
 
     uint32_t node_size;               /**< The size of a node */
 
@@ -134,6 +144,18 @@ struct _lv_cache_t {
     lv_cache_ops_t ops;               /**< The cache operations struct @lv_cache_ops_t */
 
     lv_mutex_t lock;                  /**< The cache lock used to protect the cache in multithreading environments */
+
+    uint32_t hit_cnt;                 /**< Number of the successful lookups */
+    uint32_t miss_cnt;                /**< Number of the failed lookups */
+
+    uint32_t period;                  /**< Incremented by `lv_cache_next_period()`. Scan resistant caches
+                                       * count the hits of an entry in the same period as one use. */
+
+    lv_ll_t evicted_ll;               /**< The evicted entries (`lv_cache_entry_t *`) waiting for `evict_cb`
+                                       * until the cache lock is released */
+
+    lv_cache_t ** shards;             /**< The independently locked sub-caches of a sharded cache, else @NULL */
+    uint32_t shard_cnt;               /**< Number of shards */
 };
 
 /**
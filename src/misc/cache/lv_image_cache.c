@@ -9,18 +9,36 @@
 #include "../lv_assert.h"
 #include "lv_image_cache.h"
 #include "../../core/lv_global.h"
+#include "../../draw/lv_image_decoder.h"
+#include "../../draw/lv_image_decoder_async.h"
+#include "lv_image_cache_compressed.h"
 /*********************
  *      DEFINES
  *********************/
 #define img_cache_p (LV_GLOBAL_DEFAULT()->img_cache)
 #define img_header_cache_p (LV_GLOBAL_DEFAULT()->img_header_cache)
+#define img_cache_compressed_p (LV_GLOBAL_DEFAULT()->img_cache_compressed)
+
+#if LV_USE_IMAGE_MIPMAP && LV_CACHE_DEF_SIZE == 0
+    #error "LV_USE_IMAGE_MIPMAP requires LV_CACHE_DEF_SIZE > 0"
+#endif
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    lv_image_cache_prefetch_prio_t prio;
+    size_t budget;          /**< The images larger than this are skipped*/
+    uint32_t cnt;
+} prefetch_ctx_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if LV_CACHE_DEF_SIZE > 0
+    static void prefetch_init(prefetch_ctx_t * ctx, lv_image_cache_prefetch_prio_t prio);
+    static void prefetch_src(prefetch_ctx_t * ctx, const void * src);
+    static void get_tier_stats(lv_cache_t * cache, lv_image_cache_tier_stats_t * stats);
+#endif
 
 /**********************
  *  GLOBAL VARIABLES
@@ -43,6 +61,10 @@ void lv_image_cache_drop(const void * src)
     lv_image_header_cache_drop(src);
 
 #if LV_CACHE_DEF_SIZE > 0
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+    _lv_image_cache_compressed_drop(src);
+#endif
+
     if(src == NULL) {
         lv_cache_drop_all(img_cache_p, NULL);
         return;
@@ -53,7 +75,10 @@ void lv_image_cache_drop(const void * src)
         .src_type = lv_image_src_get_type(src),
     };
 
-    lv_cache_drop(img_cache_p, &search_key, NULL);
+    /*Drop the downscaled versions too*/
+    for(search_key.downscale = 0; search_key.downscale <= LV_IMAGE_DECODER_DOWNSCALE_MAX; search_key.downscale++) {
+        lv_cache_drop(img_cache_p, &search_key, NULL);
+    }
 #else
     LV_UNUSED(src);
 #endif
@@ -78,6 +103,134 @@ void lv_image_header_cache_drop(const void * src)
 #endif
 }
 
+void lv_image_cache_get_stats(lv_image_cache_stats_t * stats)
+{
+    LV_ASSERT_NULL(stats);
+    lv_memzero(stats, sizeof(lv_image_cache_stats_t));
+
+#if LV_CACHE_DEF_SIZE > 0
+    get_tier_stats(img_cache_p, &stats->decoded);
+#endif
+
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+    get_tier_stats(img_cache_compressed_p, &stats->compressed);
+#endif
+}
+
+void lv_image_cache_reset_stats(void)
+{
+#if LV_CACHE_DEF_SIZE > 0
+    lv_cache_reset_stats(img_cache_p, NULL);
+#endif
+
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+    lv_cache_reset_stats(img_cache_compressed_p, NULL);
+#endif
+}
+
+void lv_image_cache_next_period(void)
+{
+#if LV_CACHE_DEF_SIZE > 0
+    lv_cache_next_period(img_cache_p, NULL);
+#endif
+
+#if LV_IMAGE_HEADER_CACHE_DEF_CNT > 0
+    lv_cache_next_period(img_header_cache_p, NULL);
+#endif
+}
+
+void lv_image_cache_set_mipmap_enabled(bool en)
+{
+#if LV_USE_IMAGE_MIPMAP
+    LV_GLOBAL_DEFAULT()->img_mipmap_enabled = en;
+#else
+    LV_UNUSED(en);
+#endif
+}
+
+bool lv_image_cache_is_mipmap_enabled(void)
+{
+#if LV_USE_IMAGE_MIPMAP
+    return LV_GLOBAL_DEFAULT()->img_mipmap_enabled;
+#else
+    return false;
+#endif
+}
+
+uint32_t lv_image_cache_prefetch(const void * const src[], uint32_t count, lv_image_cache_prefetch_prio_t prio)
+{
+#if LV_CACHE_DEF_SIZE > 0
+    LV_ASSERT_NULL(src);
+
+    prefetch_ctx_t ctx;
+    prefetch_init(&ctx, prio);
+
+    uint32_t i;
+    for(i = 0; i < count; i++) {
+        prefetch_src(&ctx, src[i]);
+    }
+
+    return ctx.cnt;
+#else
+    LV_UNUSED(src);
+    LV_UNUSED(count);
+    LV_UNUSED(prio);
+    return 0;
+#endif
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+#if LV_CACHE_DEF_SIZE > 0
+
+static void prefetch_init(prefetch_ctx_t * ctx, lv_image_cache_prefetch_prio_t prio)
+{
+    ctx->prio = prio;
+    ctx->cnt = 0;
+    /*More images would evict the ones prefetched earlier*/
+    ctx->budget = prio == LV_IMAGE_CACHE_PREFETCH_PRIO_LOW ? lv_cache_get_free_size(img_cache_p, NULL) :
+                  lv_cache_get_max_size(img_cache_p, NULL);
+}
+
+static void prefetch_src(prefetch_ctx_t * ctx, const void * src)
+{
+    if(src == NULL) return;
+
+    lv_image_src_t src_type = lv_image_src_get_type(src);
+    if(src_type != LV_IMAGE_SRC_FILE && src_type != LV_IMAGE_SRC_VARIABLE) return;
+
+    lv_image_header_t header;
+    if(lv_image_decoder_get_info(src, &header) != LV_RESULT_OK) return;
+
+    uint32_t stride = header.stride ? header.stride : lv_draw_buf_width_to_stride(header.w, header.cf);
+    size_t size = (size_t)stride * header.h;
+    if(size > ctx->budget) return;
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+    if(!lv_image_decoder_async_prefetch(src, ctx->prio)) return;
+#else
+    /*Opening adds it to the cache*/
+    lv_image_decoder_dsc_t decoder_dsc;
+    if(lv_image_decoder_open(&decoder_dsc, src, NULL) != LV_RESULT_OK) return;
+    bool cached = decoder_dsc.cache_entry != NULL;
+    lv_image_decoder_close(&decoder_dsc);
+    if(!cached) return;
+#endif
+
+    ctx->budget -= size;
+    ctx->cnt++;
+}
+
+static void get_tier_stats(lv_cache_t * cache, lv_image_cache_tier_stats_t * stats)
+{
+    if(cache == NULL) return;
+
+    stats->size = lv_cache_get_size(cache, NULL);
+    stats->max_size = lv_cache_get_max_size(cache, NULL);
+    stats->hit_cnt = lv_cache_get_hit_cnt(cache, NULL);
+    stats->miss_cnt = lv_cache_get_miss_cnt(cache, NULL);
+}
+
+#endif /*LV_CACHE_DEF_SIZE > 0*/
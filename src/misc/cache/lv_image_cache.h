@@ -23,6 +23,23 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+typedef enum {
+    LV_IMAGE_CACHE_PREFETCH_PRIO_LOW,   /**< Decode only into the free space of the cache, after the other images*/
+    LV_IMAGE_CACHE_PREFETCH_PRIO_HIGH,  /**< Can evict the least recently used images*/
+} lv_image_cache_prefetch_prio_t;
+
+typedef struct {
+    size_t size;            /**< Used memory in bytes*/
+    size_t max_size;        /**< Memory budget in bytes*/
+    uint32_t hit_cnt;
+    uint32_t miss_cnt;      /**< Misses of the compressed tier are counted only on misses of the decoded tier*/
+} lv_image_cache_tier_stats_t;
+
+typedef struct {
+    lv_image_cache_tier_stats_t decoded;    /**< The decoded images ready to be drawn*/
+    lv_image_cache_tier_stats_t compressed; /**< The evicted images kept compressed. Zero if disabled.*/
+} lv_image_cache_stats_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -40,6 +57,51 @@ void lv_image_cache_drop(const void * src);
  */
 void lv_image_header_cache_drop(const void * src);
 
+/**
+ * Get the memory usage and hit statistics of the image cache per tier
+ * @param stats     store the statistics here
+ */
+void lv_image_cache_get_stats(lv_image_cache_stats_t * stats);
+
+/**
+ * Reset the hit and miss counters of all tiers of the image cache
+ */
+void lv_image_cache_reset_stats(void);
+
+/**
+ * Start a new access period of the image and image header caches.
+ * Called after each display refresh so that drawing an image many times
+ * during a refresh counts as only one use (see `lv_cache_next_period()`).
+ */
+void lv_image_cache_next_period(void);
+
+/**
+ * Enable or disable the mipmaps. It's disabled by default and needs `LV_USE_IMAGE_MIPMAP`.
+ * When enabled, the images drawn at less than half of their size are downscaled to 1/2, 1/4 or 1/8
+ * of their size once and the downscaled versions are cached and drawn instead.
+ * @param en        true: enable; false: disable
+ */
+void lv_image_cache_set_mipmap_enabled(bool en);
+
+/**
+ * Check if the mipmaps are enabled
+ * @return          true: enabled
+ */
+bool lv_image_cache_is_mipmap_enabled(void);
+
+/**
+ * Decode images into the image cache before they are drawn, e.g. before loading a screen.
+ * With `LV_USE_IMAGE_DECODER_ASYNC` they are decoded by the worker threads, else they are decoded
+ * here. The sum of the decoded image sizes is limited to the free cache size with
+ * `LV_IMAGE_CACHE_PREFETCH_PRIO_LOW` and to the cache size with `LV_IMAGE_CACHE_PREFETCH_PRIO_HIGH`.
+ * At most `LV_IMAGE_DECODER_ASYNC_QUEUE_DEPTH` images are queued, the others are skipped.
+ * @param src       array of image sources
+ * @param count     number of sources in `src`
+ * @param prio      priority of the decoding
+ * @return          number of images queued (or decoded) to the cache
+ */
+uint32_t lv_image_cache_prefetch(const void * const src[], uint32_t count, lv_image_cache_prefetch_prio_t prio);
+
 /*************************
  *    GLOBAL VARIABLES
  *************************/
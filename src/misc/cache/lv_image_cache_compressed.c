@@ -0,0 +1,287 @@
+/**
+* @file lv_image_cache_compressed.c
+*
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_image_cache_compressed.h"
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+
+#include "../lv_assert.h"
+#include "../../core/lv_global.h"
+#include "../../stdlib/lv_mem.h"
+#include "../../stdlib/lv_string.h"
+#include "../../libs/rle/lv_rle.h"
+
+#if LV_USE_LZ4_EXTERNAL
+    #include <lz4.h>
+#endif
+
+#if LV_USE_LZ4_INTERNAL
+    #include "../../libs/lz4/lz4.h"
+#endif
+
+#if !LV_USE_LZ4 && !LV_USE_RLE
+    #error "LV_IMAGE_CACHE_COMPRESSED_SIZE requires LV_USE_LZ4_INTERNAL, LV_USE_LZ4_EXTERNAL or LV_USE_RLE"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define img_cache_compressed_p (LV_GLOBAL_DEFAULT()->img_cache_compressed)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_cache_slot_size_t slot;          /**< Size of the compressed data*/
+
+    const void * src;
+    lv_image_src_t src_type;
+    uint8_t downscale;                  /**< See `lv_image_cache_data_t`*/
+
+    const lv_image_decoder_t * decoder; /**< The decoder which decoded the image*/
+    lv_image_header_t header;           /**< Header of the decoded draw buffer*/
+    uint32_t data_size;                 /**< Size of the decoded data*/
+    uint8_t * data;                     /**< The compressed data*/
+} compressed_data_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t compress(const lv_draw_buf_t * decoded, uint8_t * out, uint32_t out_size);
+static bool decompress(const compressed_data_t * compressed, uint8_t * out);
+#if !LV_USE_LZ4
+    static uint8_t get_rle_blk_size(const lv_image_header_t * header, uint32_t data_size);
+#endif
+static lv_cache_compare_res_t compressed_compare_cb(const compressed_data_t * lhs, const compressed_data_t * rhs);
+static void compressed_free_cb(compressed_data_t * entry, void * user_data);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void _lv_image_cache_compressed_init(void)
+{
+    img_cache_compressed_p = lv_cache_create(&lv_cache_class_lru_rb_size,
+    sizeof(compressed_data_t), LV_IMAGE_CACHE_COMPRESSED_SIZE, (lv_cache_ops_t) {
+        .compare_cb = (lv_cache_compare_cb_t)compressed_compare_cb,
+        .create_cb = NULL,
+        .free_cb = (lv_cache_free_cb_t)compressed_free_cb,
+    });
+}
+
+void _lv_image_cache_compressed_deinit(void)
+{
+    if(img_cache_compressed_p == NULL) return;
+
+    lv_cache_destroy(img_cache_compressed_p, NULL);
+    img_cache_compressed_p = NULL;
+}
+
+void _lv_image_cache_compressed_store(const lv_image_cache_data_t * cached)
+{
+    if(img_cache_compressed_p == NULL) return;
+
+    /*The draw buffer is recreated with `lv_draw_buf_create()`, so the restored entry is marked as
+     *created by LVGL and freed in the general way, even if the decoder has its own cache free callback*/
+    const lv_image_decoder_t * decoder = cached->decoder;
+    const lv_draw_buf_t * decoded = cached->decoded;
+    if(decoder == NULL || decoded == NULL || decoded->data == NULL) return;
+    if(!lv_draw_buf_has_flag((lv_draw_buf_t *)decoded, LV_IMAGE_FLAGS_ALLOCATED)) return;
+    if(cached->src_type != LV_IMAGE_SRC_FILE && cached->src_type != LV_IMAGE_SRC_VARIABLE) return;
+
+    /*It's useful only if it's smaller than the decoded image*/
+    uint32_t data_size = decoded->data_size;
+    uint32_t max_size = LV_MIN(data_size, lv_cache_get_max_size(img_cache_compressed_p, NULL));
+    uint8_t * buf = lv_malloc(max_size);
+    if(buf == NULL) return;
+
+    uint32_t compressed_size = compress(decoded, buf, max_size);
+    if(compressed_size == 0) {
+        lv_free(buf);
+        return;
+    }
+
+    uint8_t * buf_shrunk = lv_realloc(buf, compressed_size);
+    if(buf_shrunk) buf = buf_shrunk;
+
+    compressed_data_t search_key;
+    lv_memzero(&search_key, sizeof(search_key));
+    search_key.slot.size = compressed_size;
+    search_key.src = cached->src;
+    search_key.src_type = cached->src_type;
+    search_key.downscale = cached->downscale;
+
+    /*Replace the older version if any*/
+    lv_cache_drop(img_cache_compressed_p, &search_key, NULL);
+
+    search_key.src = cached->src_type == LV_IMAGE_SRC_FILE ? lv_strdup(cached->src) : cached->src;
+    search_key.decoder = decoder;
+    search_key.header = decoded->header;
+    search_key.data_size = data_size;
+    search_key.data = buf;
+
+    lv_cache_entry_t * entry = search_key.src ? lv_cache_add(img_cache_compressed_p, &search_key, NULL) : NULL;
+    if(entry == NULL) {
+        compressed_free_cb(&search_key, NULL);
+        return;
+    }
+
+    lv_cache_release(img_cache_compressed_p, entry, NULL);
+}
+
+lv_result_t _lv_image_cache_compressed_restore(lv_image_decoder_dsc_t * dsc, uint32_t downscale)
+{
+    if(img_cache_compressed_p == NULL) return LV_RESULT_INVALID;
+
+    compressed_data_t search_key;
+    lv_memzero(&search_key, sizeof(search_key));
+    search_key.src = dsc->src;
+    search_key.src_type = dsc->src_type;
+    search_key.downscale = (uint8_t)downscale;
+
+    lv_cache_entry_t * entry = lv_cache_acquire(img_cache_compressed_p, &search_key, NULL);
+    if(entry == NULL) return LV_RESULT_INVALID;
+
+    const compressed_data_t * compressed = lv_cache_entry_get_data(entry);
+    lv_image_decoder_t * decoder = (lv_image_decoder_t *)compressed->decoder;
+    const lv_image_header_t * header = &compressed->header;
+
+    lv_draw_buf_t * decoded = lv_draw_buf_create(header->w, header->h, header->cf, header->stride);
+    bool ok = decoded && decoded->data_size >= compressed->data_size && decompress(compressed, decoded->data);
+    if(ok) {
+        decoded->header.flags = header->flags;
+        lv_draw_buf_invalidate_cache(decoded, NULL);
+    }
+
+    lv_cache_release(img_cache_compressed_p, entry, NULL);
+
+    /*It's moved back to the image cache*/
+    lv_cache_drop(img_cache_compressed_p, &search_key, NULL);
+
+    if(!ok) {
+        if(decoded) lv_draw_buf_destroy(decoded);
+        return LV_RESULT_INVALID;
+    }
+
+    lv_image_cache_data_t cache_key;
+    lv_memzero(&cache_key, sizeof(cache_key));
+    cache_key.slot.size = decoded->data_size;
+    cache_key.src = dsc->src;
+    cache_key.src_type = dsc->src_type;
+    cache_key.downscale = (uint8_t)downscale;
+
+    lv_cache_entry_t * cache_entry = lv_image_decoder_add_to_cache(decoder, &cache_key, decoded, NULL);
+    if(cache_entry == NULL) {
+        lv_draw_buf_destroy(decoded);
+        return LV_RESULT_INVALID;
+    }
+
+    ((lv_image_cache_data_t *)lv_cache_entry_get_data(cache_entry))->core_created = 1;
+
+    dsc->decoded = decoded;
+    dsc->decoder = decoder;
+    dsc->cache_entry = cache_entry;
+
+    return LV_RESULT_OK;
+}
+
+void _lv_image_cache_compressed_drop(const void * src)
+{
+    if(img_cache_compressed_p == NULL) return;
+
+    if(src == NULL) {
+        lv_cache_drop_all(img_cache_compressed_p, NULL);
+        return;
+    }
+
+    compressed_data_t search_key;
+    lv_memzero(&search_key, sizeof(search_key));
+    search_key.src = src;
+    search_key.src_type = lv_image_src_get_type(src);
+
+    for(search_key.downscale = 0; search_key.downscale <= LV_IMAGE_DECODER_DOWNSCALE_MAX; search_key.downscale++) {
+        lv_cache_drop(img_cache_compressed_p, &search_key, NULL);
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Compress the data of a draw buffer
+ * @return      size of the compressed data or 0 if it didn't fit into `out`
+ */
+static uint32_t compress(const lv_draw_buf_t * decoded, uint8_t * out, uint32_t out_size)
+{
+#if LV_USE_LZ4
+    int res = LZ4_compress_default((const char *)decoded->data, (char *)out, (int)decoded->data_size, (int)out_size);
+    return res > 0 ? (uint32_t)res : 0;
+#else
+    return lv_rle_compress(decoded->data, decoded->data_size, out, out_size,
+                           get_rle_blk_size(&decoded->header, decoded->data_size));
+#endif
+}
+
+static bool decompress(const compressed_data_t * compressed, uint8_t * out)
+{
+#if LV_USE_LZ4
+    int res = LZ4_decompress_safe((const char *)compressed->data, (char *)out, (int)compressed->slot.size,
+                                  (int)compressed->data_size);
+    return res == (int)compressed->data_size;
+#else
+    uint32_t res = lv_rle_decompress(compressed->data, compressed->slot.size, out, compressed->data_size,
+                                     get_rle_blk_size(&compressed->header, compressed->data_size));
+    return res == compressed->data_size;
+#endif
+}
+
+#if !LV_USE_LZ4
+/**
+ * Compress whole pixels if possible as the neighbor pixels are often the same
+ */
+static uint8_t get_rle_blk_size(const lv_image_header_t * header, uint32_t data_size)
+{
+    uint8_t blk_size = lv_color_format_get_size(header->cf);
+    if(blk_size == 0 || data_size % blk_size != 0) return 1;
+    return blk_size;
+}
+#endif
+
+static lv_cache_compare_res_t compressed_compare_cb(const compressed_data_t * lhs, const compressed_data_t * rhs)
+{
+    if(lhs->src_type != rhs->src_type) return lhs->src_type > rhs->src_type ? 1 : -1;
+    if(lhs->downscale != rhs->downscale) return lhs->downscale > rhs->downscale ? 1 : -1;
+
+    if(lhs->src_type == LV_IMAGE_SRC_FILE) {
+        int32_t cmp_res = lv_strcmp(lhs->src, rhs->src);
+        if(cmp_res != 0) return cmp_res > 0 ? 1 : -1;
+    }
+    else if(lhs->src != rhs->src) {
+        return lhs->src > rhs->src ? 1 : -1;
+    }
+
+    return 0;
+}
+
+static void compressed_free_cb(compressed_data_t * entry, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+    if(entry->src_type == LV_IMAGE_SRC_FILE) lv_free((void *)entry->src);
+    lv_free(entry->data);
+}
+
+#endif /*LV_IMAGE_CACHE_COMPRESSED_SIZE > 0*/
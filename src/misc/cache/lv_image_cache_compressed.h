@@ -0,0 +1,80 @@
+/**
+* @file lv_image_cache_compressed.h
+*
+ */
+
+#ifndef LV_IMAGE_CACHE_COMPRESSED_H
+#define LV_IMAGE_CACHE_COMPRESSED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "../../lv_conf_internal.h"
+
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+
+#include "../../draw/lv_image_decoder.h"
+
+#if LV_CACHE_DEF_SIZE == 0
+#error "LV_IMAGE_CACHE_COMPRESSED_SIZE requires LV_CACHE_DEF_SIZE > 0"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create the cache of the compressed images. Called by the image decoder module.
+ */
+void _lv_image_cache_compressed_init(void);
+
+/**
+ * Free the cache of the compressed images. Called by the image decoder module.
+ */
+void _lv_image_cache_compressed_deinit(void);
+
+/**
+ * Compress an image evicted from the image cache and keep it in the compressed cache.
+ * Only the draw buffers allocated by the decoders and freed by the image cache are kept.
+ * @param cached    the data of the evicted image cache entry
+ */
+void _lv_image_cache_compressed_store(const lv_image_cache_data_t * cached);
+
+/**
+ * Decompress an image to the image cache if it's in the compressed cache.
+ * @param dsc       decoder descriptor with `src` and `src_type` set. On success `decoded`,
+ *                  `decoder` and `cache_entry` are set like on an image cache hit.
+ * @param downscale the downscaled version of the image to look for (see `lv_image_cache_data_t`)
+ * @return          LV_RESULT_OK: the image was found and decompressed
+ */
+lv_result_t _lv_image_cache_compressed_restore(lv_image_decoder_dsc_t * dsc, uint32_t downscale);
+
+/**
+ * Drop an image from the compressed cache
+ * @param src       pointer to an image source or NULL to drop all images
+ */
+void _lv_image_cache_compressed_drop(const void * src);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_IMAGE_CACHE_COMPRESSED_SIZE > 0*/
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_IMAGE_CACHE_COMPRESSED_H*/
@@ -281,6 +281,92 @@ void lv_bidi_calculate_align(lv_text_align_t * align, lv_base_dir_t * base_dir,
     }
 }
 
+lv_result_t _lv_bidi_cache_build(lv_bidi_cache_t * cache, const char * txt, const lv_font_t * font,
+                                 int32_t letter_space, int32_t max_width, lv_text_flag_t flag, lv_base_dir_t base_dir)
+{
+    /*The lines don't depend on the width in these cases*/
+    if(flag & (LV_TEXT_FLAG_EXPAND | LV_TEXT_FLAG_FIT)) max_width = LV_COORD_MAX;
+
+    cache->valid = 0;
+    cache->font = font;
+    cache->letter_space = letter_space;
+    cache->max_width = max_width;
+    cache->flag = flag;
+    cache->base_dir = base_dir;
+
+    uint32_t txt_len = lv_strlen(txt);
+    uint32_t letter_cnt = _lv_text_get_encoded_length(txt);
+
+    char * buf = lv_realloc(cache->txt, txt_len + 1);
+    if(buf == NULL) return LV_RESULT_INVALID;
+    cache->txt = buf;
+    buf[0] = '\0';
+
+    uint16_t * pos_conv = lv_realloc(cache->pos_conv, (letter_cnt + 1) * sizeof(uint16_t));
+    if(pos_conv == NULL) return LV_RESULT_INVALID;
+    cache->pos_conv = pos_conv;
+
+    /*Process the lines one by one as the text is drawn line by line*/
+    bool reordered = false;
+    uint32_t line_start = 0;
+    uint32_t letter_start = 0;
+    while(txt[line_start] != '\0') {
+        uint32_t line_len = _lv_text_get_next_line(&txt[line_start], font, letter_space, max_width, NULL, flag);
+        if(line_len == 0) return LV_RESULT_INVALID;
+
+        /*The positions are stored on 15 bits*/
+        uint32_t line_letter_cnt = get_txt_len(&txt[line_start], line_len);
+        if(line_letter_cnt > 0x7FFF || letter_start + line_letter_cnt > letter_cnt) return LV_RESULT_INVALID;
+
+        _lv_bidi_process_paragraph(&txt[line_start], &buf[line_start], line_len, base_dir, &pos_conv[letter_start],
+                                   (uint16_t)line_letter_cnt);
+
+        uint32_t i;
+        for(i = 0; i < line_letter_cnt; i++) {
+            pos_conv[letter_start + i] = GET_POS(pos_conv[letter_start + i]);
+            if(pos_conv[letter_start + i] != i) reordered = true;
+        }
+
+        line_start += line_len;
+        letter_start += line_letter_cnt;
+    }
+
+    /*Don't keep a copy of texts which are already in visual order (e.g. LTR only texts)*/
+    if(!reordered && lv_strcmp(buf, txt) == 0) {
+        lv_free(cache->txt);
+        lv_free(cache->pos_conv);
+        cache->txt = NULL;
+        cache->pos_conv = NULL;
+    }
+
+    cache->txt_len = txt_len;
+    cache->valid = 1;
+
+    return LV_RESULT_OK;
+}
+
+bool _lv_bidi_cache_is_valid(const lv_bidi_cache_t * cache, const lv_font_t * font, int32_t letter_space,
+                             int32_t max_width, lv_text_flag_t flag, lv_base_dir_t base_dir)
+{
+    if(flag & (LV_TEXT_FLAG_EXPAND | LV_TEXT_FLAG_FIT)) max_width = LV_COORD_MAX;
+
+    return cache->valid &&
+           cache->font == font &&
+           cache->letter_space == letter_space &&
+           cache->max_width == max_width &&
+           cache->flag == flag &&
+           cache->base_dir == base_dir;
+}
+
+void _lv_bidi_cache_free(lv_bidi_cache_t * cache)
+{
+    lv_free(cache->txt);
+    lv_free(cache->pos_conv);
+    cache->txt = NULL;
+    cache->pos_conv = NULL;
+    cache->valid = 0;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
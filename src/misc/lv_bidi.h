@@ -45,6 +45,25 @@ typedef _lv_base_dir_t lv_base_dir_t;
 typedef uint8_t lv_base_dir_t;
 #endif /*DOXYGEN*/
 
+/**
+ * The lines of a text in visual order. Created once after the text has changed
+ * to draw the text without running the bidi algorithm on every redraw.
+ */
+typedef struct {
+    char * txt;                 /**< The text with each line reordered separately. NULL if it's the same as the
+                                 *   original text*/
+    uint16_t * pos_conv;        /**< Logical index of each visual letter relative to the first letter of its line*/
+    uint32_t txt_len;           /**< Length of the text in bytes*/
+
+    /*The parameters the lines were created with*/
+    const lv_font_t * font;
+    int32_t letter_space;
+    int32_t max_width;
+    lv_text_flag_t flag;
+    lv_base_dir_t base_dir;
+    uint8_t valid : 1;          /**< 1: the lines are processed and describe the current text*/
+} lv_bidi_cache_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -117,6 +136,41 @@ void _lv_bidi_process_paragraph(const char * str_in, char * str_out, uint32_t le
  */
 void lv_bidi_calculate_align(lv_text_align_t * align, lv_base_dir_t * base_dir, const char * txt);
 
+/**
+ * Wrap a text to lines and store the visual order of each line in a cache.
+ * The buffers of the cache are reused if it was built earlier.
+ * @param cache         pointer to a cache to build (initialized with zeros or built earlier)
+ * @param txt           a '\0' terminated text
+ * @param font          font of the text
+ * @param letter_space  letter space of the text
+ * @param max_width     max width of the lines
+ * @param flag          settings for the text from 'txt_flag_t' enum
+ * @param base_dir      `LV_BASE_DIR_LTR` or `LV_BASE_DIR_RTL`
+ * @return              LV_RESULT_OK: the cache is built; LV_RESULT_INVALID: out of memory or too long lines
+ */
+lv_result_t _lv_bidi_cache_build(lv_bidi_cache_t * cache, const char * txt, const lv_font_t * font,
+                                 int32_t letter_space, int32_t max_width, lv_text_flag_t flag, lv_base_dir_t base_dir);
+
+/**
+ * Check if a cache is built and was created with the given parameters.
+ * Invalidating it when the text changes is the responsibility of the owner (`cache->valid = 0`).
+ * @param cache         pointer to a cache
+ * @param font          font of the text
+ * @param letter_space  letter space of the text
+ * @param max_width     max width of the lines
+ * @param flag          settings for the text from 'txt_flag_t' enum
+ * @param base_dir      `LV_BASE_DIR_LTR` or `LV_BASE_DIR_RTL`
+ * @return              true: the cache can be used
+ */
+bool _lv_bidi_cache_is_valid(const lv_bidi_cache_t * cache, const lv_font_t * font, int32_t letter_space,
+                             int32_t max_width, lv_text_flag_t flag, lv_base_dir_t base_dir);
+
+/**
+ * Free the buffers of a cache
+ * @param cache         pointer to a cache
+ */
+void _lv_bidi_cache_free(lv_bidi_cache_t * cache);
+
 /**********************
  *      MACROS
  **********************/
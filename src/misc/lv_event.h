@@ -95,6 +95,7 @@ typedef enum {
     LV_EVENT_STYLE_CHANGED,       /**< Object's style has changed*/
     LV_EVENT_LAYOUT_CHANGED,      /**< The children position has changed due to a layout recalculation*/
     LV_EVENT_GET_SELF_SIZE,       /**< Get the internal size of a widget*/
+    LV_EVENT_GET_IMAGE_SRCS,      /**< Get the image sources used by a widget. Add them with `lv_event_add_image_src()`*/
 
     /** Events of optional LVGL components*/
     LV_EVENT_INVALIDATE_AREA,
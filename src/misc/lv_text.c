@@ -20,6 +20,13 @@
  *********************/
 #define NO_BREAK_FOUND UINT32_MAX
 
+/*Number of letters decoded at once while measuring a text*/
+#define TEXT_DECODE_BATCH 32
+
+/*Number of letters decoded at once while looking for the end of a word.
+ *Less than `TEXT_DECODE_BATCH` as the words are usually short.*/
+#define WORD_DECODE_BATCH 16
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -33,6 +40,8 @@
     static uint32_t lv_text_unicode_to_utf8(uint32_t letter_uni);
     static uint32_t lv_text_utf8_conv_wc(uint32_t c);
     static uint32_t lv_text_utf8_next(const char * txt, uint32_t * i);
+    static uint32_t lv_text_utf8_decode(const char * txt, uint32_t * i, uint32_t length, uint32_t * letters,
+                                        uint32_t * letter_ofs, uint32_t letter_cnt);
     static uint32_t lv_text_utf8_prev(const char * txt, uint32_t * i_start);
     static uint32_t lv_text_utf8_get_byte_id(const char * txt, uint32_t utf8_id);
     static uint32_t lv_text_utf8_get_char_id(const char * txt, uint32_t byte_id);
@@ -42,11 +51,17 @@
     static uint32_t lv_text_unicode_to_iso8859_1(uint32_t letter_uni);
     static uint32_t lv_text_iso8859_1_conv_wc(uint32_t c);
     static uint32_t lv_text_iso8859_1_next(const char * txt, uint32_t * i);
+    static uint32_t lv_text_iso8859_1_decode(const char * txt, uint32_t * i, uint32_t length, uint32_t * letters,
+                                             uint32_t * letter_ofs, uint32_t letter_cnt);
     static uint32_t lv_text_iso8859_1_prev(const char * txt, uint32_t * i_start);
     static uint32_t lv_text_iso8859_1_get_byte_id(const char * txt, uint32_t utf8_id);
     static uint32_t lv_text_iso8859_1_get_char_id(const char * txt, uint32_t byte_id);
     static uint32_t lv_text_iso8859_1_get_length(const char * txt);
 #endif
+static uint32_t text_get_next_line(const char * txt, uint32_t length, const lv_font_t * font, int32_t letter_space,
+                                   int32_t max_width, int32_t * used_width, lv_text_flag_t flag);
+static lv_result_t line_index_reserve(lv_text_line_index_t * index, uint32_t line_cnt);
+static lv_result_t line_index_add(lv_text_line_index_t * index, uint32_t line_start, int32_t line_width);
 /**********************
  *  STATIC VARIABLES
  **********************/
@@ -59,6 +74,8 @@
     uint32_t (*_lv_text_unicode_to_encoded)(uint32_t)                = lv_text_unicode_to_utf8;
     uint32_t (*_lv_text_encoded_conv_wc)(uint32_t)                   = lv_text_utf8_conv_wc;
     uint32_t (*_lv_text_encoded_next)(const char *, uint32_t *)      = lv_text_utf8_next;
+    uint32_t (*_lv_text_encoded_decode)(const char *, uint32_t *, uint32_t, uint32_t *, uint32_t *,
+                                        uint32_t) = lv_text_utf8_decode;
     uint32_t (*_lv_text_encoded_prev)(const char *, uint32_t *)      = lv_text_utf8_prev;
     uint32_t (*_lv_text_encoded_get_byte_id)(const char *, uint32_t) = lv_text_utf8_get_byte_id;
     uint32_t (*_lv_text_encoded_get_char_id)(const char *, uint32_t) = lv_text_utf8_get_char_id;
@@ -68,6 +85,8 @@
     uint32_t (*_lv_text_unicode_to_encoded)(uint32_t)                = lv_text_unicode_to_iso8859_1;
     uint32_t (*_lv_text_encoded_conv_wc)(uint32_t)                   = lv_text_iso8859_1_conv_wc;
     uint32_t (*_lv_text_encoded_next)(const char *, uint32_t *)      = lv_text_iso8859_1_next;
+    uint32_t (*_lv_text_encoded_decode)(const char *, uint32_t *, uint32_t, uint32_t *, uint32_t *,
+                                        uint32_t) = lv_text_iso8859_1_decode;
     uint32_t (*_lv_text_encoded_prev)(const char *, uint32_t *)      = lv_text_iso8859_1_prev;
     uint32_t (*_lv_text_encoded_get_byte_id)(const char *, uint32_t) = lv_text_iso8859_1_get_byte_id;
     uint32_t (*_lv_text_encoded_get_char_id)(const char *, uint32_t)     = lv_text_iso8859_1_get_char_id;
@@ -102,11 +121,13 @@ void lv_text_get_size(lv_point_t * size_res, const char * text, const lv_font_t
 
     uint32_t line_start     = 0;
     uint32_t new_line_start = 0;
+    uint32_t length = lv_strlen(text);
     uint16_t letter_height = lv_font_get_line_height(font);
 
     /*Calc. the height and longest line*/
     while(text[line_start] != '\0') {
-        new_line_start += _lv_text_get_next_line(&text[line_start], font, letter_space, max_width, NULL, flag);
+        new_line_start += text_get_next_line(&text[line_start], length - line_start, font, letter_space, max_width,
+                                             NULL, flag);
 
         if((unsigned long)size_res->y + (unsigned long)letter_height + (unsigned long)line_space > LV_MAX_OF(int32_t)) {
             LV_LOG_WARN("integer overflow while calculating text height");
@@ -159,6 +180,7 @@ void lv_text_get_size(lv_point_t * size_res, const char * text, const lv_font_t
  * max_width is reached. In current usage, this has no impact.
  *
  * @param txt a '\0' terminated string
+ * @param length length of `txt` in bytes or `UINT32_MAX` if unknown. The letters are decoded faster if it's known.
  * @param font pointer to a font
  * @param letter_space letter space
  * @param max_width max width of the text (break the lines to fit this size). Set COORD_MAX to avoid line breaks
@@ -167,7 +189,7 @@ void lv_text_get_size(lv_point_t * size_res, const char * text, const lv_font_t
  * @param force Force return the fraction of the word that can fit in the provided space.
  * @return the index of the first char of the next word (in byte index not letter index. With UTF-8 they are different)
  */
-static uint32_t lv_text_get_next_word(const char * txt, const lv_font_t * font,
+static uint32_t lv_text_get_next_word(const char * txt, uint32_t length, const lv_font_t * font,
                                       int32_t letter_space, int32_t max_width,
                                       lv_text_flag_t flag, uint32_t * word_w_ptr, bool force)
 {
@@ -176,7 +198,7 @@ static uint32_t lv_text_get_next_word(const char * txt, const lv_font_t * font,
 
     if(flag & LV_TEXT_FLAG_EXPAND) max_width = LV_COORD_MAX;
 
-    uint32_t i = 0, i_next = 0, i_next_next = 0;  /*Iterating index into txt*/
+    uint32_t i = 0, i_next = 0;  /*Iterating index into txt*/
     uint32_t letter = 0;      /*Letter at i*/
     uint32_t letter_next = 0; /*Letter at i_next*/
     int32_t letter_w;
@@ -185,12 +207,26 @@ static uint32_t lv_text_get_next_word(const char * txt, const lv_font_t * font,
     uint32_t break_index = NO_BREAK_FOUND; /*only used for "long" words*/
     uint32_t break_letter_count = 0; /*Number of characters up to the long word break point*/
 
-    letter = _lv_text_encoded_next(txt, &i_next);
-    i_next_next = i_next;
+    /*Decode the letters in batches. `letters[k]` is the letter at `i`,
+     *`letters[k + 1]` and `letter_ofs[k + 1]` are the next letter and its index*/
+    uint32_t letters[WORD_DECODE_BATCH + 1];
+    uint32_t letter_ofs[WORD_DECODE_BATCH + 1];
+    uint32_t letter_cnt = 0;
+    uint32_t k = 0;
 
     /*Obtain the full word, regardless if it fits or not in max_width*/
     while(txt[i] != '\0') {
-        letter_next = _lv_text_encoded_next(txt, &i_next_next);
+        /*Decode the next batch starting with the current letter if the next letter is not decoded yet*/
+        if(k + 1 >= letter_cnt) {
+            uint32_t i_end = i;
+            letter_cnt = _lv_text_encoded_decode(txt, &i_end, length, letters, letter_ofs, WORD_DECODE_BATCH);
+            letters[letter_cnt] = 0;
+            letter_ofs[letter_cnt] = i_end;
+            k = 0;
+        }
+        letter = letters[k];
+        letter_next = letters[k + 1];
+        i_next = letter_ofs[k + 1];
         word_len++;
 
         letter_w = lv_font_get_glyph_width(font, letter, letter_next);
@@ -226,8 +262,8 @@ static uint32_t lv_text_get_next_word(const char * txt, const lv_font_t * font,
         if(word_w_ptr != NULL && break_index == NO_BREAK_FOUND) *word_w_ptr = cur_w;
 
         i = i_next;
-        i_next = i_next_next;
         letter = letter_next;
+        k++;
     }
 
     /*Entire Word fits in the provided space*/
@@ -277,94 +313,221 @@ uint32_t _lv_text_get_next_line(const char * txt, const lv_font_t * font,
                                 int32_t letter_space, int32_t max_width,
                                 int32_t * used_width, lv_text_flag_t flag)
 {
-    if(used_width) *used_width = 0;
+    return text_get_next_line(txt, UINT32_MAX, font, letter_space, max_width, used_width, flag);
+}
 
+int32_t lv_text_get_width(const char * txt, uint32_t length, const lv_font_t * font, int32_t letter_space)
+{
     if(txt == NULL) return 0;
-    if(txt[0] == '\0') return 0;
     if(font == NULL) return 0;
+    if(txt[0] == '\0') return 0;
 
-    int32_t line_w = 0;
+    uint32_t i                   = 0;
+    int32_t width             = 0;
 
-    /*If max_width doesn't matter simply find the new line character
-     *without thinking about word wrapping*/
-    if((flag & LV_TEXT_FLAG_EXPAND) || (flag & LV_TEXT_FLAG_FIT)) {
-        uint32_t i;
-        for(i = 0; txt[i] != '\n' && txt[i] != '\r' && txt[i] != '\0'; i++) {
-            /*Just find the new line chars or string ends by incrementing `i`*/
+    if(length != 0) {
+        /*Decode the letters in batches and keep one extra slot for the letter following the batch
+         *which is required for kerning*/
+        uint32_t letters[TEXT_DECODE_BATCH + 1];
+        while(i < length) {
+            uint32_t letter_cnt = _lv_text_encoded_decode(txt, &i, length, letters, NULL, TEXT_DECODE_BATCH);
+            if(letter_cnt == 0) break;
+
+            letters[letter_cnt] = _lv_text_encoded_next(&txt[i], NULL);
+
+            uint32_t k;
+            for(k = 0; k < letter_cnt; k++) {
+                uint32_t letter_next = letters[k] != 0 ? letters[k + 1] : 0;
+                int32_t char_width = lv_font_get_glyph_width(font, letters[k], letter_next);
+                if(char_width > 0) {
+                    width += char_width;
+                    width += letter_space;
+                }
+            }
+        }
+
+        if(width > 0) {
+            width -= letter_space; /*Trim the last letter space. Important if the text is center
+                                      aligned*/
         }
-        if(txt[i] != '\0') i++;    /*To go beyond `\n`*/
-        if(used_width) *used_width = -1;
-        return i;
     }
 
-    if(flag & LV_TEXT_FLAG_EXPAND) max_width = LV_COORD_MAX;
-    uint32_t i = 0;                                        /*Iterating index into txt*/
+    return width;
+}
 
-    while(txt[i] != '\0' && max_width > 0) {
-        uint32_t word_w = 0;
-        uint32_t advance = lv_text_get_next_word(&txt[i], font, letter_space, max_width, flag, &word_w, i == 0);
-        max_width -= word_w;
-        line_w += word_w;
+lv_result_t lv_text_line_index_build(lv_text_line_index_t * index, const char * txt, const lv_font_t * font,
+                                     int32_t letter_space, int32_t max_width, lv_text_flag_t flag)
+{
+    LV_ASSERT_NULL(index);
 
-        if(advance == 0) {
-            break;
+    if(flag & LV_TEXT_FLAG_EXPAND) max_width = LV_COORD_MAX;
+
+    index->font = font;
+    index->letter_space = letter_space;
+    index->max_width = max_width;
+    index->flag = flag;
+    index->line_cnt = 0;
+    index->txt_len = 0;
+    index->max_line_width = 0;
+    index->valid = 0;
+
+    if(txt == NULL || font == NULL) return LV_RESULT_INVALID;
+
+    uint32_t line_start = 0;
+    uint32_t length = lv_strlen(txt);
+    while(txt[line_start] != '\0') {
+        uint32_t line_len = text_get_next_line(&txt[line_start], length - line_start, font, letter_space, max_width,
+                                               NULL, flag);
+        int32_t line_width = lv_text_get_width(&txt[line_start], line_len, font, letter_space);
+        if(line_index_add(index, line_start, line_width) != LV_RESULT_OK) {
+            lv_text_line_index_free(index);
+            return LV_RESULT_INVALID;
         }
+        index->max_line_width = LV_MAX(index->max_line_width, line_width);
+        line_start += line_len;
+    }
 
-        i += advance;
+    index->txt_len = line_start;
+    index->changed_line = 0;
+    index->changed_line_end = index->line_cnt;
+    index->valid = 1;
+    return LV_RESULT_OK;
+}
 
-        if(txt[0] == '\n' || txt[0] == '\r') break;
+lv_result_t lv_text_line_index_update(lv_text_line_index_t * index, const char * txt, uint32_t byte_pos,
+                                      int32_t byte_diff)
+{
+    LV_ASSERT_NULL(index);
+    if(!index->valid) return LV_RESULT_INVALID;
 
-        if(txt[i] == '\n' || txt[i] == '\r') {
-            i++;  /*Include the following newline in the current line*/
-            break;
+    /*Long words might be wrapped depending on their length which can be far from the modification,
+     *so wrap the whole text in this case*/
+    if(LV_TXT_LINE_BREAK_LONG_LEN > 0 || index->line_cnt == 0 || byte_pos > index->txt_len) {
+        return lv_text_line_index_build(index, txt, index->font, index->letter_space, index->max_width, index->flag);
+    }
+
+    /*The end of the previous line also depends on the first word of the modified line*/
+    uint32_t first_line = lv_text_line_index_find_line(index, byte_pos);
+    if(first_line > 0) first_line--;
+
+    uint32_t edit_end = byte_pos + (byte_diff > 0 ? (uint32_t)byte_diff : 0);
+
+    /*Wrap the text again until a line starts where an old line started after the modification.
+     *From there the lines are the same as before, only shifted by `byte_diff`.*/
+    lv_text_line_index_t new_lines;
+    lv_memzero(&new_lines, sizeof(new_lines));
+    uint32_t old_cnt = index->line_cnt;
+    uint32_t sync_line = old_cnt;
+    uint32_t line_start = index->line_starts[first_line];
+    uint32_t length = lv_strlen(txt);
+    while(txt[line_start] != '\0') {
+        if(line_start >= edit_end) {
+            uint32_t old_line_start = line_start - byte_diff;
+            uint32_t old_line = lv_text_line_index_find_line(index, old_line_start);
+            if(index->line_starts[old_line] == old_line_start) {
+                sync_line = old_line;
+                break;
+            }
         }
 
+        uint32_t line_len = text_get_next_line(&txt[line_start], length - line_start, index->font, index->letter_space,
+                                               index->max_width, NULL, index->flag);
+        int32_t line_width = lv_text_get_width(&txt[line_start], line_len, index->font, index->letter_space);
+        if(line_index_add(&new_lines, line_start, line_width) != LV_RESULT_OK) {
+            lv_text_line_index_free(&new_lines);
+            lv_text_line_index_free(index);
+            return LV_RESULT_INVALID;
+        }
+        line_start += line_len;
     }
 
-    /*Always step at least one to avoid infinite loops*/
-    if(i == 0) {
-        uint32_t letter = _lv_text_encoded_next(txt, &i);
-        if(used_width != NULL) {
-            line_w = lv_font_get_glyph_width(font, letter, '\0');
-        }
+    /*Replace the lines from `first_line` to `sync_line` with the new lines*/
+    uint32_t tail_cnt = old_cnt - sync_line;
+    uint32_t new_cnt = first_line + new_lines.line_cnt + tail_cnt;
+    if(line_index_reserve(index, new_cnt) != LV_RESULT_OK) {
+        lv_text_line_index_free(&new_lines);
+        lv_text_line_index_free(index);
+        return LV_RESULT_INVALID;
     }
 
-    if(used_width != NULL) {
-        *used_width = line_w;
+    uint32_t tail_start = first_line + new_lines.line_cnt;
+    lv_memmove(&index->line_starts[tail_start], &index->line_starts[sync_line], tail_cnt * sizeof(uint32_t));
+    lv_memmove(&index->line_widths[tail_start], &index->line_widths[sync_line], tail_cnt * sizeof(int32_t));
+    uint32_t i;
+    for(i = tail_start; i < new_cnt; i++) {
+        index->line_starts[i] += byte_diff;
     }
 
-    return i;
+    if(new_lines.line_cnt) {
+        lv_memcpy(&index->line_starts[first_line], new_lines.line_starts, new_lines.line_cnt * sizeof(uint32_t));
+        lv_memcpy(&index->line_widths[first_line], new_lines.line_widths, new_lines.line_cnt * sizeof(int32_t));
+    }
+    lv_text_line_index_free(&new_lines);
+
+    index->line_cnt = new_cnt;
+    index->txt_len += byte_diff;
+    index->changed_line = first_line;
+    index->changed_line_end = tail_start;
+    index->max_line_width = 0;
+    for(i = 0; i < new_cnt; i++) {
+        index->max_line_width = LV_MAX(index->max_line_width, index->line_widths[i]);
+    }
+
+    return LV_RESULT_OK;
 }
 
-int32_t lv_text_get_width(const char * txt, uint32_t length, const lv_font_t * font, int32_t letter_space)
+bool lv_text_line_index_is_valid(const lv_text_line_index_t * index, const lv_font_t * font, int32_t letter_space,
+                                 int32_t max_width, lv_text_flag_t flag)
 {
-    if(txt == NULL) return 0;
-    if(font == NULL) return 0;
-    if(txt[0] == '\0') return 0;
+    if(flag & LV_TEXT_FLAG_EXPAND) max_width = LV_COORD_MAX;
 
-    uint32_t i                   = 0;
-    int32_t width             = 0;
+    return index->valid && index->font == font && index->letter_space == letter_space &&
+           index->max_width == max_width && index->flag == flag;
+}
 
-    if(length != 0) {
-        while(i < length) {
-            uint32_t letter;
-            uint32_t letter_next;
-            _lv_text_encoded_letter_next_2(txt, &letter, &letter_next, &i);
-
-            int32_t char_width = lv_font_get_glyph_width(font, letter, letter_next);
-            if(char_width > 0) {
-                width += char_width;
-                width += letter_space;
-            }
-        }
+void lv_text_line_index_get_size(const lv_text_line_index_t * index, const char * txt, int32_t line_space,
+                                 lv_point_t * size_res)
+{
+    int32_t letter_height = lv_font_get_line_height(index->font);
 
-        if(width > 0) {
-            width -= letter_space; /*Trim the last letter space. Important if the text is center
-                                      aligned*/
-        }
+    size_res->x = index->max_line_width;
+    size_res->y = index->line_cnt * (letter_height + line_space);
+
+    /*Make the text one line taller if the last character is '\n' or '\r'*/
+    if(index->txt_len != 0 && (txt[index->txt_len - 1] == '\n' || txt[index->txt_len - 1] == '\r')) {
+        size_res->y += letter_height + line_space;
     }
 
-    return width;
+    /*Correction with the last line space or set the height manually if the text is empty*/
+    if(size_res->y == 0) size_res->y = letter_height;
+    else size_res->y -= line_space;
+}
+
+uint32_t lv_text_line_index_find_line(const lv_text_line_index_t * index, uint32_t byte_pos)
+{
+    if(index->line_cnt == 0) return 0;
+
+    /*Find the last line starting before or at `byte_pos`*/
+    uint32_t min = 0;
+    uint32_t max = index->line_cnt - 1;
+    while(min < max) {
+        uint32_t mid = (min + max + 1) / 2;
+        if(index->line_starts[mid] <= byte_pos) min = mid;
+        else max = mid - 1;
+    }
+
+    return min;
+}
+
+void lv_text_line_index_free(lv_text_line_index_t * index)
+{
+    lv_free(index->line_starts);
+    lv_free(index->line_widths);
+    index->line_starts = NULL;
+    index->line_widths = NULL;
+    index->line_cnt = 0;
+    index->line_cap = 0;
+    index->valid = 0;
 }
 
 void _lv_text_ins(char * txt_buf, uint32_t pos, const char * ins_txt)
@@ -452,6 +615,108 @@ void _lv_text_encoded_letter_next_2(const char * txt, uint32_t * letter, uint32_
     *letter_next = *letter != '\0' ? _lv_text_encoded_next(&txt[*ofs], NULL) : 0;
 }
 
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Get the next line of text like `_lv_text_get_next_line()`.
+ * @param length    length of `txt` in bytes or `UINT32_MAX` if unknown
+ */
+static uint32_t text_get_next_line(const char * txt, uint32_t length, const lv_font_t * font, int32_t letter_space,
+                                   int32_t max_width, int32_t * used_width, lv_text_flag_t flag)
+{
+    if(used_width) *used_width = 0;
+
+    if(txt == NULL) return 0;
+    if(txt[0] == '\0') return 0;
+    if(font == NULL) return 0;
+
+    int32_t line_w = 0;
+
+    /*If max_width doesn't matter simply find the new line character
+     *without thinking about word wrapping*/
+    if((flag & LV_TEXT_FLAG_EXPAND) || (flag & LV_TEXT_FLAG_FIT)) {
+        uint32_t i;
+        for(i = 0; txt[i] != '\n' && txt[i] != '\r' && txt[i] != '\0'; i++) {
+            /*Just find the new line chars or string ends by incrementing `i`*/
+        }
+        if(txt[i] != '\0') i++;    /*To go beyond `\n`*/
+        if(used_width) *used_width = -1;
+        return i;
+    }
+
+    if(flag & LV_TEXT_FLAG_EXPAND) max_width = LV_COORD_MAX;
+    uint32_t i = 0;                                        /*Iterating index into txt*/
+
+    while(txt[i] != '\0' && max_width > 0) {
+        uint32_t word_w = 0;
+        uint32_t advance = lv_text_get_next_word(&txt[i], length == UINT32_MAX ? UINT32_MAX : length - i, font,
+                                                 letter_space, max_width, flag, &word_w, i == 0);
+        max_width -= word_w;
+        line_w += word_w;
+
+        if(advance == 0) {
+            break;
+        }
+
+        i += advance;
+
+        if(txt[0] == '\n' || txt[0] == '\r') break;
+
+        if(txt[i] == '\n' || txt[i] == '\r') {
+            i++;  /*Include the following newline in the current line*/
+            break;
+        }
+
+    }
+
+    /*Always step at least one to avoid infinite loops*/
+    if(i == 0) {
+        uint32_t letter = _lv_text_encoded_next(txt, &i);
+        if(used_width != NULL) {
+            line_w = lv_font_get_glyph_width(font, letter, '\0');
+        }
+    }
+
+    if(used_width != NULL) {
+        *used_width = line_w;
+    }
+
+    return i;
+}
+
+static lv_result_t line_index_reserve(lv_text_line_index_t * index, uint32_t line_cnt)
+{
+    if(line_cnt <= index->line_cap) return LV_RESULT_OK;
+
+    uint32_t new_cap = index->line_cap ? index->line_cap : 16;
+    while(new_cap < line_cnt) new_cap *= 2;
+
+    uint32_t * new_starts = lv_realloc(index->line_starts, new_cap * sizeof(uint32_t));
+    LV_ASSERT_MALLOC(new_starts);
+    if(new_starts == NULL) return LV_RESULT_INVALID;
+    index->line_starts = new_starts;
+
+    int32_t * new_widths = lv_realloc(index->line_widths, new_cap * sizeof(int32_t));
+    LV_ASSERT_MALLOC(new_widths);
+    if(new_widths == NULL) return LV_RESULT_INVALID;
+    index->line_widths = new_widths;
+
+    index->line_cap = new_cap;
+    return LV_RESULT_OK;
+}
+
+static lv_result_t line_index_add(lv_text_line_index_t * index, uint32_t line_start, int32_t line_width)
+{
+    if(line_index_reserve(index, index->line_cnt + 1) != LV_RESULT_OK) return LV_RESULT_INVALID;
+
+    index->line_starts[index->line_cnt] = line_start;
+    index->line_widths[index->line_cnt] = line_width;
+    index->line_cnt++;
+    return LV_RESULT_OK;
+}
+
 #if LV_TXT_ENC == LV_TXT_ENC_UTF8
 /*******************************
  *   UTF-8 ENCODER/DECODER
@@ -612,6 +877,63 @@ static uint32_t lv_text_utf8_next(const char * txt, uint32_t * i)
     return result;
 }
 
+/**
+ * Decode UTF-8 characters from a string into an array.
+ * Runs of ASCII characters are processed 4 bytes at once.
+ * @param txt pointer to '\0' terminated string
+ * @param i start byte index in 'txt'. After the call it will point to the first not decoded character.
+ * @param length decode the characters starting before this byte index
+ * @param letters store the decoded Unicode characters here
+ * @param letter_ofs store the byte index of each character here. Can be NULL.
+ * @param letter_cnt size of `letters` and `letter_ofs`
+ * @return number of decoded characters
+ */
+static uint32_t lv_text_utf8_decode(const char * txt, uint32_t * i, uint32_t length, uint32_t * letters,
+                                    uint32_t * letter_ofs, uint32_t letter_cnt)
+{
+    uint32_t pos = *i;
+    uint32_t cnt = 0;
+    while(cnt < letter_cnt && pos < length && txt[pos] != '\0') {
+        /*Check 4 bytes at once. The word has no byte with the MSB set or a zero byte
+         *only if all the 4 characters are ASCII. Not possible if the length is unknown
+         *as the bytes after the terminating '\0' must not be read.*/
+        if(cnt + 4 <= letter_cnt && length != UINT32_MAX && pos + 4 <= length) {
+            uint32_t word;
+            lv_memcpy(&word, &txt[pos], sizeof(word));
+            if((((word - 0x01010101U) | word) & 0x80808080U) == 0) {
+                const uint8_t * bytes = (const uint8_t *)&txt[pos];
+                letters[cnt] = bytes[0];
+                letters[cnt + 1] = bytes[1];
+                letters[cnt + 2] = bytes[2];
+                letters[cnt + 3] = bytes[3];
+                if(letter_ofs) {
+                    letter_ofs[cnt] = pos;
+                    letter_ofs[cnt + 1] = pos + 1;
+                    letter_ofs[cnt + 2] = pos + 2;
+                    letter_ofs[cnt + 3] = pos + 3;
+                }
+                cnt += 4;
+                pos += 4;
+                continue;
+            }
+        }
+
+        if(letter_ofs) letter_ofs[cnt] = pos;
+        uint8_t c = (uint8_t)txt[pos];
+        if(LV_IS_ASCII(c)) {
+            letters[cnt] = c;
+            pos++;
+        }
+        else {
+            letters[cnt] = lv_text_utf8_next(txt, &pos);
+        }
+        cnt++;
+    }
+
+    *i = pos;
+    return cnt;
+}
+
 /**
  * Get previous UTF-8 character form a string.
  * @param txt pointer to '\0' terminated string
@@ -761,6 +1083,32 @@ static uint32_t lv_text_iso8859_1_next(const char * txt, uint32_t * i)
     return letter;
 }
 
+/**
+ * Decode ISO8859-1 characters from a string into an array.
+ * @param txt pointer to '\0' terminated string
+ * @param i start byte index in 'txt'. After the call it will point to the first not decoded character.
+ * @param length decode the characters starting before this byte index
+ * @param letters store the decoded characters here
+ * @param letter_ofs store the byte index of each character here. Can be NULL.
+ * @param letter_cnt size of `letters` and `letter_ofs`
+ * @return number of decoded characters
+ */
+static uint32_t lv_text_iso8859_1_decode(const char * txt, uint32_t * i, uint32_t length, uint32_t * letters,
+                                         uint32_t * letter_ofs, uint32_t letter_cnt)
+{
+    uint32_t pos = *i;
+    uint32_t cnt = 0;
+    while(cnt < letter_cnt && pos < length && txt[pos] != '\0') {
+        if(letter_ofs) letter_ofs[cnt] = pos;
+        letters[cnt] = (uint8_t)txt[pos];
+        pos++;
+        cnt++;
+    }
+
+    *i = pos;
+    return cnt;
+}
+
 /**
  * Get previous ISO8859-1 character form a string.
  * @param txt pointer to '\0' terminated string
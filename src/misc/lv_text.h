@@ -63,6 +63,30 @@ typedef _lv_text_align_t lv_text_align_t;
 typedef uint8_t lv_text_align_t;
 #endif /*DOXYGEN*/
 
+/**
+ * Start and width of each line of a text wrapped with given parameters.
+ * Allows finding a line without wrapping the text from the beginning and
+ * updating the lines only around the modified part of the text.
+ */
+typedef struct {
+    uint32_t * line_starts;     /**< Byte index of the first letter of each line*/
+    int32_t * line_widths;      /**< Width of each line in pixels*/
+    uint32_t line_cnt;          /**< Number of lines*/
+    uint32_t line_cap;          /**< Number of lines `line_starts` and `line_widths` can store*/
+    uint32_t txt_len;           /**< Length of the text in bytes*/
+    int32_t max_line_width;     /**< Width of the longest line*/
+    uint32_t changed_line;      /**< First line changed by the last `lv_text_line_index_update()`*/
+    uint32_t changed_line_end;  /**< The line after the lines changed by the last update (lines from here might be
+                                 *   only moved if the number of lines has changed)*/
+
+    /*The parameters the lines were created with*/
+    const lv_font_t * font;
+    int32_t letter_space;
+    int32_t max_width;
+    lv_text_flag_t flag;
+    uint8_t valid : 1;          /**< 1: the index is built and describes the current text*/
+} lv_text_line_index_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -109,6 +133,69 @@ uint32_t _lv_text_get_next_line(const char * txt, const lv_font_t * font, int32_
  */
 int32_t lv_text_get_width(const char * txt, uint32_t length, const lv_font_t * font, int32_t letter_space);
 
+/**
+ * Wrap a text and store the start and width of all lines in a line index.
+ * @param index         pointer to an initialized (e.g. zeroed) line index
+ * @param txt           a '\0' terminated string
+ * @param font          pointer to a font
+ * @param letter_space  letter space
+ * @param max_width     max width of the lines. Set LV_COORD_MAX to avoid line breaks
+ * @param flag          settings for the text from ::lv_text_flag_t
+ * @return              LV_RESULT_OK: the index is built; LV_RESULT_INVALID: out of memory, the index is invalid
+ */
+lv_result_t lv_text_line_index_build(lv_text_line_index_t * index, const char * txt, const lv_font_t * font,
+                                     int32_t letter_space, int32_t max_width, lv_text_flag_t flag);
+
+/**
+ * Update a line index after a part of the text was inserted or deleted.
+ * Only the lines from the one before the modification are wrapped again until
+ * a line starts at the same place (relative to the end of the text) as before.
+ * The range of the changed lines is saved in `changed_line` and `changed_line_end`.
+ * @param index         pointer to a valid line index describing the text before the modification
+ * @param txt           the modified '\0' terminated string
+ * @param byte_pos      byte index where the text was inserted or deleted
+ * @param byte_diff     number of inserted (> 0) or deleted (< 0) bytes
+ * @return              LV_RESULT_OK: the index is updated; LV_RESULT_INVALID: out of memory, the index is invalid
+ */
+lv_result_t lv_text_line_index_update(lv_text_line_index_t * index, const char * txt, uint32_t byte_pos,
+                                      int32_t byte_diff);
+
+/**
+ * Check if a line index was built with the given parameters.
+ * @param index         pointer to a line index
+ * @param font          pointer to a font
+ * @param letter_space  letter space
+ * @param max_width     max width of the lines
+ * @param flag          settings for the text from ::lv_text_flag_t
+ * @return              true: the lines of the index can be used with these parameters
+ */
+bool lv_text_line_index_is_valid(const lv_text_line_index_t * index, const lv_font_t * font, int32_t letter_space,
+                                 int32_t max_width, lv_text_flag_t flag);
+
+/**
+ * Get the size of the text described by a line index. Same as `lv_text_get_size()`.
+ * @param index         pointer to a valid line index
+ * @param txt           the text of the index
+ * @param line_space    line space of the text
+ * @param size_res      store the result here
+ */
+void lv_text_line_index_get_size(const lv_text_line_index_t * index, const char * txt, int32_t line_space,
+                                 lv_point_t * size_res);
+
+/**
+ * Get the line containing a byte of the text.
+ * @param index         pointer to a valid line index
+ * @param byte_pos      byte index in the text
+ * @return              index of the line (0 if there are no lines)
+ */
+uint32_t lv_text_line_index_find_line(const lv_text_line_index_t * index, uint32_t byte_pos);
+
+/**
+ * Free the memory allocated by a line index and make it invalid.
+ * @param index         pointer to a line index
+ */
+void lv_text_line_index_free(lv_text_line_index_t * index);
+
 /**
  * Insert a string into an other
  * @param txt_buf the original text (must be big enough for the result text and NULL terminated)
@@ -290,6 +377,23 @@ extern uint32_t (*_lv_text_encoded_conv_wc)(uint32_t c);
  */
 extern uint32_t (*_lv_text_encoded_next)(const char *, uint32_t *);
 
+/**
+ * Decode the encoded characters of a string into an array of Unicode characters.
+ * Faster than calling `_lv_text_encoded_next` for each character.
+ * @param txt pointer to '\0' terminated string
+ * @param i start byte index in 'txt' where to start.
+ *          After the call it will point to the first character which was not decoded.
+ * @param length decode only the characters starting before this byte index.
+ *               Can't be larger than the length of the text as the bytes before it might be read at once.
+ *               `UINT32_MAX` if the length is unknown: decode until the terminating '\0'.
+ * @param letters store the decoded characters here
+ * @param letter_ofs store the byte index of each decoded character here. Can be NULL.
+ * @param letter_cnt size of `letters` and `letter_ofs`
+ * @return number of decoded characters. Less than `letter_cnt` if `length` or the end of the text was reached.
+ */
+extern uint32_t (*_lv_text_encoded_decode)(const char * txt, uint32_t * i, uint32_t length, uint32_t * letters,
+                                           uint32_t * letter_ofs, uint32_t letter_cnt);
+
 /**
  * Get the previous encoded character form a string.
  * @param txt pointer to '\0' terminated string
@@ -660,6 +660,9 @@ static void lv_image_event(const lv_obj_class_t * class_p, lv_event_t * e)
         p->x = img->w;
         p->y = img->h;
     }
+    else if(code == LV_EVENT_GET_IMAGE_SRCS) {
+        lv_event_add_image_src(e, img->src);
+    }
     else if(code == LV_EVENT_DRAW_MAIN || code == LV_EVENT_DRAW_POST || code == LV_EVENT_COVER_CHECK) {
         draw_image(e);
     }
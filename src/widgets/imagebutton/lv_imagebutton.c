@@ -174,6 +174,15 @@ static void lv_imagebutton_event(const lv_obj_class_t * class_p, lv_event_t * e)
             p->x = LV_MAX(p->x, imagebutton->src_mid[state].header.w);
         }
     }
+    else if(code == LV_EVENT_GET_IMAGE_SRCS) {
+        lv_imagebutton_t * imagebutton = (lv_imagebutton_t *)obj;
+        uint32_t i;
+        for(i = 0; i < _LV_IMAGEBUTTON_STATE_NUM; i++) {
+            lv_event_add_image_src(e, imagebutton->src_left[i].img_src);
+            lv_event_add_image_src(e, imagebutton->src_mid[i].img_src);
+            lv_event_add_image_src(e, imagebutton->src_right[i].img_src);
+        }
+    }
 }
 
 static void draw_main(lv_event_t * e)
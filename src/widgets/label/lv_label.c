@@ -53,6 +53,14 @@ static void set_ofs_y_anim(void * obj, int32_t v);
 static size_t get_text_length(const char * text);
 static void copy_text_to_label(lv_label_t * label, const char * text);
 static lv_text_flag_t get_label_flags(lv_label_t * label);
+static void get_text_size(lv_obj_t * obj, lv_point_t * size_res, const lv_font_t * font, int32_t letter_space,
+                          int32_t line_space, int32_t max_width, lv_text_flag_t flag);
+static void invalidate_line_index(lv_label_t * label);
+#if LV_LABEL_LINE_INDEX
+static const lv_text_line_index_t * get_line_index(lv_obj_t * obj, const lv_font_t * font, int32_t letter_space,
+                                                   int32_t max_width, lv_text_flag_t flag);
+static void refr_changed_lines(lv_obj_t * obj, uint32_t old_line_cnt);
+#endif
 static void calculate_x_coordinate(int32_t * x, const lv_text_align_t align, const char * txt,
                                    uint32_t length, const lv_font_t * font, int32_t letter_space, lv_area_t * txt_coords);
 
@@ -96,6 +104,7 @@ void lv_label_set_text(lv_obj_t * obj, const char * text)
     lv_label_t * label = (lv_label_t *)obj;
 
     lv_obj_invalidate(obj);
+    invalidate_line_index(label);
 
     /*If text is NULL then just refresh with the current text*/
     if(text == NULL) text = label->text;
@@ -140,6 +149,7 @@ void lv_label_set_text_fmt(lv_obj_t * obj, const char * fmt, ...)
 
     lv_obj_invalidate(obj);
     lv_label_t * label = (lv_label_t *)obj;
+    invalidate_line_index(label);
 
     /*If text is NULL then refresh*/
     if(fmt == NULL) {
@@ -165,6 +175,7 @@ void lv_label_set_text_static(lv_obj_t * obj, const char * text)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
     lv_label_t * label = (lv_label_t *)obj;
+    invalidate_line_index(label);
 
     if(label->static_txt == 0 && label->text != NULL) {
         lv_free(label->text);
@@ -201,6 +212,7 @@ void lv_label_set_long_mode(lv_obj_t * obj, lv_label_long_mode_t long_mode)
     }
 
     label->long_mode = long_mode;
+    invalidate_line_index(label);
     lv_label_refr_text(obj);
 }
 
@@ -294,13 +306,26 @@ void lv_label_get_letter_pos(const lv_obj_t * obj, uint32_t char_id, lv_point_t
     int32_t y = 0;
     uint32_t line_start = 0;
     uint32_t new_line_start = 0;
-    while(txt[new_line_start] != '\0') {
-        new_line_start += _lv_text_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
-        if(byte_id < new_line_start || txt[new_line_start] == '\0')
-            break; /*The line of 'index' letter begins at 'line_start'*/
+#if LV_LABEL_LINE_INDEX
+    const lv_text_line_index_t * index = get_line_index((lv_obj_t *)obj, font, letter_space, max_w, flag);
+    if(index && index->line_cnt > 0) {
+        /*Look up the line of the letter instead of wrapping the text from the beginning*/
+        uint32_t line = lv_text_line_index_find_line(index, byte_id);
+        line_start = index->line_starts[line];
+        new_line_start = line + 1 < index->line_cnt ? index->line_starts[line + 1] : index->txt_len;
+        y = (int32_t)line * (letter_height + line_space);
+    }
+    else
+#endif
+    {
+        while(txt[new_line_start] != '\0') {
+            new_line_start += _lv_text_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+            if(byte_id < new_line_start || txt[new_line_start] == '\0')
+                break; /*The line of 'index' letter begins at 'line_start'*/
 
-        y += letter_height + line_space;
-        line_start = new_line_start;
+            y += letter_height + line_space;
+            line_start = new_line_start;
+        }
     }
 
     /*If the last character is line break then go to the next line*/
@@ -379,21 +404,49 @@ uint32_t lv_label_get_letter_on(const lv_obj_t * obj, lv_point_t * pos_in, bool
     lv_text_flag_t flag = get_label_flags(label);
 
     /*Search the line of the index letter*/;
-    while(txt[line_start] != '\0') {
-        new_line_start += _lv_text_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+#if LV_LABEL_LINE_INDEX
+    const lv_text_line_index_t * index = get_line_index((lv_obj_t *)obj, font, letter_space, max_w, flag);
+    if(index) {
+        /*Calculate the line from the y coordinate instead of wrapping the text from the beginning*/
+        uint32_t line = 0;
+        if(pos.y > letter_height) {
+            const int32_t row_height = letter_height + line_space;
+            line = (pos.y - letter_height + row_height - 1) / row_height;
+        }
+
+        if(line < index->line_cnt) {
+            line_start = index->line_starts[line];
+            new_line_start = line + 1 < index->line_cnt ? index->line_starts[line + 1] : index->txt_len;
 
-        if(pos.y <= y + letter_height) {
-            /*The line is found (stored in 'line_start')*/
             /*Include the NULL terminator in the last line*/
             uint32_t tmp = new_line_start;
-            uint32_t letter;
-            letter = _lv_text_encoded_prev(txt, &tmp);
+            uint32_t letter = _lv_text_encoded_prev(txt, &tmp);
             if(letter != '\n' && txt[new_line_start] == '\0') new_line_start++;
-            break;
         }
-        y += letter_height + line_space;
+        else {
+            line_start = index->txt_len;
+            new_line_start = index->txt_len;
+        }
+    }
+    else
+#endif
+    {
+        while(txt[line_start] != '\0') {
+            new_line_start += _lv_text_get_next_line(&txt[line_start], font, letter_space, max_w, NULL, flag);
+
+            if(pos.y <= y + letter_height) {
+                /*The line is found (stored in 'line_start')*/
+                /*Include the NULL terminator in the last line*/
+                uint32_t tmp = new_line_start;
+                uint32_t letter;
+                letter = _lv_text_encoded_prev(txt, &tmp);
+                if(letter != '\n' && txt[new_line_start] == '\0') new_line_start++;
+                break;
+            }
+            y += letter_height + line_space;
 
-        line_start = new_line_start;
+            line_start = new_line_start;
+        }
     }
 
     char * bidi_txt;
@@ -577,8 +630,6 @@ void lv_label_ins_text(lv_obj_t * obj, uint32_t pos, const char * txt)
     /*Can not append to static text*/
     if(label->static_txt != 0) return;
 
-    lv_obj_invalidate(obj);
-
     /*Allocate space for the new text*/
     size_t old_len = lv_strlen(label->text);
     size_t ins_len = lv_strlen(txt);
@@ -591,25 +642,89 @@ void lv_label_ins_text(lv_obj_t * obj, uint32_t pos, const char * txt)
         pos = _lv_text_get_encoded_length(label->text);
     }
 
+#if LV_LABEL_LINE_INDEX && LV_USE_ARABIC_PERSIAN_CHARS == 0
+    uint32_t byte_pos = _lv_text_encoded_get_byte_id(label->text, pos);
     _lv_text_ins(label->text, pos, txt);
+
+    /*Wrap and redraw only the lines around the inserted text*/
+    uint32_t old_line_cnt = label->line_index.line_cnt;
+    if(label->line_index.valid &&
+       lv_text_line_index_update(&label->line_index, label->text, byte_pos, (int32_t)ins_len) == LV_RESULT_OK) {
+        refr_changed_lines(obj, old_line_cnt);
+        return;
+    }
+#else
+    _lv_text_ins(label->text, pos, txt);
+#endif
+
+    lv_obj_invalidate(obj);
     lv_label_set_text(obj, NULL);
 }
 
-void lv_label_cut_text(lv_obj_t * obj, uint32_t pos, uint32_t cnt)
+void lv_label_append_text(lv_obj_t * obj, const char * txt)
 {
     LV_ASSERT_OBJ(obj, MY_CLASS);
+    LV_ASSERT_NULL(txt);
+
     lv_label_t * label = (lv_label_t *)obj;
 
     /*Can not append to static text*/
-    if(label->static_txt) return;
+    if(label->static_txt != 0) return;
+
+    size_t old_len = lv_strlen(label->text);
+    size_t ins_len = lv_strlen(txt);
+    label->text = lv_realloc(label->text, old_len + ins_len + 1);
+    LV_ASSERT_MALLOC(label->text);
+    if(label->text == NULL) return;
+
+    lv_memcpy(&label->text[old_len], txt, ins_len + 1);
+
+#if LV_LABEL_LINE_INDEX && LV_USE_ARABIC_PERSIAN_CHARS == 0
+    /*Wrap and redraw only the last line and the new lines*/
+    uint32_t old_line_cnt = label->line_index.line_cnt;
+    if(label->line_index.valid &&
+       lv_text_line_index_update(&label->line_index, label->text, (uint32_t)old_len, (int32_t)ins_len) == LV_RESULT_OK) {
+        refr_changed_lines(obj, old_line_cnt);
+        return;
+    }
+#endif
 
     lv_obj_invalidate(obj);
+    lv_label_set_text(obj, NULL);
+}
+
+void lv_label_cut_text(lv_obj_t * obj, uint32_t pos, uint32_t cnt)
+{
+    LV_ASSERT_OBJ(obj, MY_CLASS);
+    lv_label_t * label = (lv_label_t *)obj;
+
+    /*Can not append to static text*/
+    if(label->static_txt) return;
 
     char * label_txt = lv_label_get_text(obj);
+
+#if LV_LABEL_LINE_INDEX
+    uint32_t byte_pos = _lv_text_encoded_get_byte_id(label_txt, pos);
+    size_t old_len = lv_strlen(label_txt);
+#endif
+
     /*Delete the characters*/
     _lv_text_cut(label_txt, pos, cnt);
 
+#if LV_LABEL_LINE_INDEX
+    /*Wrap and redraw only the lines around the deleted text*/
+    uint32_t old_line_cnt = label->line_index.line_cnt;
+    if(label->line_index.valid) {
+        int32_t byte_diff = (int32_t)lv_strlen(label_txt) - (int32_t)old_len;
+        if(lv_text_line_index_update(&label->line_index, label_txt, byte_pos, byte_diff) == LV_RESULT_OK) {
+            refr_changed_lines(obj, old_line_cnt);
+            return;
+        }
+    }
+#endif
+
     /*Refresh the label*/
+    lv_obj_invalidate(obj);
     lv_label_refr_text(obj);
 }
 
@@ -658,6 +773,13 @@ static void lv_label_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
     lv_label_dot_tmp_free(obj);
     if(!label->static_txt) lv_free(label->text);
     label->text = NULL;
+
+#if LV_LABEL_LINE_INDEX
+    lv_text_line_index_free(&label->line_index);
+#endif
+#if LV_USE_BIDI
+    _lv_bidi_cache_free(&label->bidi_cache);
+#endif
 }
 
 static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
@@ -700,7 +822,7 @@ static void lv_label_event(const lv_obj_class_t * class_p, lv_event_t * e)
 
             w = LV_MIN(w, lv_obj_get_style_max_width(obj, 0));
 
-            lv_text_get_size(&label->size_cache, label->text, font, letter_space, line_space, w, flag);
+            get_text_size(obj, &label->size_cache, font, letter_space, line_space, w, flag);
             label->invalid_size_cache = false;
         }
 
@@ -734,6 +856,9 @@ static void draw_main(lv_event_t * e)
         label_draw_dsc.hint = &label->hint;
     }
 #endif
+#if LV_LABEL_LINE_INDEX
+    if(label->line_index.valid) label_draw_dsc.line_index = &label->line_index;
+#endif
 
     label_draw_dsc.flag = flag;
     lv_obj_init_draw_label_dsc(obj, LV_PART_MAIN, &label_draw_dsc);
@@ -764,6 +889,16 @@ static void draw_main(lv_event_t * e)
         return;
     }
 
+#if LV_USE_BIDI
+    /*Reorder the lines only once after the text has changed and not on every redraw*/
+    if(_lv_bidi_cache_is_valid(&label->bidi_cache, label_draw_dsc.font, label_draw_dsc.letter_space,
+                               lv_area_get_width(&txt_coords), label_draw_dsc.flag, label_draw_dsc.bidi_dir) ||
+       _lv_bidi_cache_build(&label->bidi_cache, label->text, label_draw_dsc.font, label_draw_dsc.letter_space,
+                            lv_area_get_width(&txt_coords), label_draw_dsc.flag, label_draw_dsc.bidi_dir) == LV_RESULT_OK) {
+        label_draw_dsc.bidi_cache = &label->bidi_cache;
+    }
+#endif
+
     if(label->long_mode == LV_LABEL_LONG_WRAP) {
         int32_t s = lv_obj_get_scroll_top(obj);
         lv_area_move(&txt_coords, 0, -s);
@@ -843,6 +978,9 @@ static void lv_label_refr_text(lv_obj_t * obj)
     if(label->text == NULL) return;
 #if LV_LABEL_LONG_TXT_HINT
     label->hint.line_start = -1; /*The hint is invalid if the text changes*/
+#endif
+#if LV_USE_BIDI
+    label->bidi_cache.valid = 0;
 #endif
     label->invalid_size_cache = true;
 
@@ -857,7 +995,7 @@ static void lv_label_refr_text(lv_obj_t * obj)
     lv_point_t size;
     lv_text_flag_t flag = get_label_flags(label);
 
-    lv_text_get_size(&size, label->text, font, letter_space, line_space, max_w, flag);
+    get_text_size(obj, &size, font, letter_space, line_space, max_w, flag);
 
     lv_obj_refresh_self_size(obj);
 
@@ -1241,6 +1379,99 @@ static void copy_text_to_label(lv_label_t * label, const char * text)
 #endif
 }
 
+/**
+ * Get the size of the label's text. In WRAP and CLIP mode use (and update if required) the line index
+ * to avoid wrapping the whole text again.
+ */
+static void get_text_size(lv_obj_t * obj, lv_point_t * size_res, const lv_font_t * font, int32_t letter_space,
+                          int32_t line_space, int32_t max_width, lv_text_flag_t flag)
+{
+    lv_label_t * label = (lv_label_t *)obj;
+
+#if LV_LABEL_LINE_INDEX
+    /*In the other modes the text is modified (dots) or measured differently*/
+    if(label->long_mode == LV_LABEL_LONG_WRAP || label->long_mode == LV_LABEL_LONG_CLIP) {
+        lv_text_line_index_t * index = &label->line_index;
+        if(lv_text_line_index_is_valid(index, font, letter_space, max_width, flag) ||
+           lv_text_line_index_build(index, label->text, font, letter_space, max_width, flag) == LV_RESULT_OK) {
+            lv_text_line_index_get_size(index, label->text, line_space, size_res);
+            return;
+        }
+    }
+#endif
+
+    lv_text_get_size(size_res, label->text, font, letter_space, line_space, max_width, flag);
+}
+
+static void invalidate_line_index(lv_label_t * label)
+{
+#if LV_LABEL_LINE_INDEX
+    label->line_index.valid = 0;
+#else
+    LV_UNUSED(label);
+#endif
+}
+
+#if LV_LABEL_LINE_INDEX
+/**
+ * Get the line index of the label if it's up to date for the given parameters
+ * @return pointer to the line index or NULL if it can't be used
+ */
+static const lv_text_line_index_t * get_line_index(lv_obj_t * obj, const lv_font_t * font, int32_t letter_space,
+                                                   int32_t max_width, lv_text_flag_t flag)
+{
+    lv_label_t * label = (lv_label_t *)obj;
+    if(label->long_mode != LV_LABEL_LONG_WRAP && label->long_mode != LV_LABEL_LONG_CLIP) return NULL;
+    if(!lv_text_line_index_is_valid(&label->line_index, font, letter_space, max_width, flag)) return NULL;
+
+    return &label->line_index;
+}
+
+/**
+ * Refresh the label after its line index was updated incrementally.
+ * Only the lines changed by the update are invalidated, or all lines
+ * from the first changed line if the lines below have moved.
+ * @param obj           pointer to a label object
+ * @param old_line_cnt  number of lines before the update
+ */
+static void refr_changed_lines(lv_obj_t * obj, uint32_t old_line_cnt)
+{
+    lv_label_t * label = (lv_label_t *)obj;
+    const lv_text_line_index_t * index = &label->line_index;
+#if LV_LABEL_LONG_TXT_HINT
+    label->hint.line_start = -1; /*The hint is invalid if the text changes*/
+#endif
+#if LV_USE_BIDI
+    label->bidi_cache.valid = 0;
+#endif
+    label->invalid_size_cache = true;
+
+    /*If the size changes the old and new areas are invalidated too*/
+    lv_obj_refresh_self_size(obj);
+
+    const lv_font_t * font = lv_obj_get_style_text_font(obj, LV_PART_MAIN);
+    const int32_t line_height = lv_font_get_line_height(font) + lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
+    const int32_t ext_size = _lv_obj_get_ext_draw_size(obj);
+
+    lv_area_t txt_coords;
+    lv_obj_get_content_coords(obj, &txt_coords);
+
+    lv_area_t inv_area;
+    inv_area.x1 = obj->coords.x1 - ext_size;
+    inv_area.x2 = obj->coords.x2 + ext_size;
+    inv_area.y1 = txt_coords.y1 + (int32_t)index->changed_line * line_height - ext_size;
+    if(index->line_cnt != old_line_cnt) {
+        int32_t lines_y2 = txt_coords.y1 + (int32_t)LV_MAX(index->line_cnt, old_line_cnt) * line_height;
+        inv_area.y2 = LV_MAX(obj->coords.y2, lines_y2) + ext_size;
+    }
+    else {
+        inv_area.y2 = txt_coords.y1 + (int32_t)index->changed_line_end * line_height - 1 + ext_size;
+    }
+
+    lv_obj_invalidate_area(obj, &inv_area);
+}
+#endif
+
 static lv_text_flag_t get_label_flags(lv_label_t * label)
 {
     lv_text_flag_t flag = LV_TEXT_FLAG_NONE;
@@ -72,6 +72,14 @@ typedef struct {
     lv_draw_label_hint_t hint;
 #endif
 
+#if LV_LABEL_LINE_INDEX
+    lv_text_line_index_t line_index;
+#endif
+
+#if LV_USE_BIDI
+    lv_bidi_cache_t bidi_cache;
+#endif
+
 #if LV_LABEL_TEXT_SELECTION
     uint32_t sel_start;
     uint32_t sel_end;
@@ -220,6 +228,14 @@ uint32_t lv_label_get_text_selection_end(const lv_obj_t * obj);
  */
 void lv_label_ins_text(lv_obj_t * obj, uint32_t pos, const char * txt);
 
+/**
+ * Append a text to the end of a label. The label text can not be static.
+ * With `LV_LABEL_LINE_INDEX` only the last lines are wrapped again so it's fast even with very long texts.
+ * @param obj       pointer to a label object
+ * @param txt       pointer to the text to append
+ */
+void lv_label_append_text(lv_obj_t * obj, const char * txt);
+
 /**
  * Delete characters from a label. The label text can not be static.
  * @param obj       pointer to a label object
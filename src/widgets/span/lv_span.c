@@ -37,6 +37,26 @@ struct _snippet_stack {
     uint32_t        index;
 };
 
+typedef struct {
+    uint32_t snippet_start;     /* index of the first snippet of the line */
+    uint32_t snippet_cnt;       /* number of snippets in the line */
+    int32_t max_line_h;         /* the max height of span-font in the line */
+    int32_t max_baseline;       /* baseline of the highest span */
+} lv_span_line_t;
+
+typedef struct _lv_span_layout_t {
+    lv_snippet_t * snippets;    /* the snippets of all lines */
+    uint32_t snippet_cnt;
+    uint32_t snippet_cap;
+    lv_span_line_t * lines;
+    uint32_t line_cnt;
+    uint32_t line_cap;
+    int32_t max_width;          /* the width the lines were broken for */
+    int32_t line_space;
+    int32_t indent;
+    uint32_t valid : 1;
+} lv_span_layout_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -64,6 +84,13 @@ static uint32_t lv_get_snippet_count(void);
 static void lv_snippet_push(lv_snippet_t * item);
 static lv_snippet_t * lv_get_snippet(uint32_t index);
 static int32_t convert_indent_pct(lv_obj_t * spans, int32_t width);
+static lv_span_layout_t * get_layout(lv_obj_t * obj, int32_t max_width);
+static lv_result_t build_layout(lv_obj_t * obj, lv_span_layout_t * layout);
+static lv_result_t layout_add_line(lv_span_layout_t * layout, int32_t max_line_h, int32_t max_baseline);
+static bool layout_styles_changed(lv_obj_t * obj, const lv_span_layout_t * layout);
+static int32_t layout_get_height(lv_obj_t * obj, const lv_span_layout_t * layout);
+static void delete_layout(lv_span_layout_t * layout);
+static void free_layout(lv_obj_t * obj);
 
 /**********************
  *  STATIC VARIABLES
@@ -424,101 +451,30 @@ int32_t lv_spangroup_get_expand_height(lv_obj_t * obj, int32_t width)
         return 0;
     }
 
-    /* init draw variable */
-    lv_text_flag_t txt_flag = LV_TEXT_FLAG_NONE;
-    int32_t line_space = lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
-    int32_t max_width = width;
-    int32_t indent = convert_indent_pct(obj, max_width);
-    int32_t max_w  = max_width - indent; /* first line need minus indent */
-
-    /* coords of draw span-txt */
-    lv_point_t txt_pos;
-    lv_point_set(&txt_pos, 0, indent); /* first line need add indent */
-
-    lv_span_t * cur_span = _lv_ll_get_head(&spans->child_ll);
-    const char * cur_txt = cur_span->txt;
-    span_text_check(&cur_txt);
-    uint32_t cur_txt_ofs = 0;
-    lv_snippet_t snippet;   /* use to save cur_span info and push it to stack */
-    memset(&snippet, 0, sizeof(snippet));
-
-    int32_t line_cnt = 0;
-    int32_t lines = spans->lines < 0 ? INT32_MAX : spans->lines;
-    /* the loop control how many lines need to draw */
-    while(cur_span) {
-        int snippet_cnt = 0;
-        int32_t max_line_h = 0;  /* the max height of span-font when a line have a lot of span */
-
-        /* the loop control to find a line and push the relevant span info into stack  */
-        while(1) {
-            /* switch to the next span when current is end */
-            if(cur_txt[cur_txt_ofs] == '\0') {
-                cur_span = _lv_ll_get_next(&spans->child_ll, cur_span);
-                if(cur_span == NULL) break;
-                cur_txt = cur_span->txt;
-                span_text_check(&cur_txt);
-                cur_txt_ofs = 0;
-                /* maybe also cur_txt[cur_txt_ofs] == '\0' */
-                continue;
-            }
+    /* don't replace the cached layout of the current width by the layout of an other width,
+     * else the layout would be built again on each call and on each redraw */
+    if(spans->layout && spans->layout->valid && spans->layout->max_width != width) {
+        lv_span_layout_t tmp_layout;
+        lv_memzero(&tmp_layout, sizeof(tmp_layout));
+        tmp_layout.max_width = width;
+        tmp_layout.line_space = lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
+        tmp_layout.indent = convert_indent_pct(obj, width);
 
-            /* init span info to snippet. */
-            if(cur_txt_ofs == 0) {
-                snippet.span = cur_span;
-                snippet.font = lv_span_get_style_text_font(obj, cur_span);
-                snippet.letter_space = lv_span_get_style_text_letter_space(obj, cur_span);
-                snippet.line_h = lv_font_get_line_height(snippet.font) + line_space;
-            }
-
-            /* get current span text line info */
-            uint32_t next_ofs = 0;
-            int32_t use_width = 0;
-            bool isfill = lv_text_get_snippet(&cur_txt[cur_txt_ofs], snippet.font, snippet.letter_space,
-                                              max_w, txt_flag, &use_width, &next_ofs);
-
-            /* break word deal width */
-            if(isfill && next_ofs > 0 && snippet_cnt > 0) {
-                if(max_w < use_width) {
-                    break;
-                }
-
-                uint32_t tmp_ofs = next_ofs;
-                uint32_t letter = _lv_text_encoded_prev(&cur_txt[cur_txt_ofs], &tmp_ofs);
-                if(!(letter == '\0' || letter == '\n' || letter == '\r' || _lv_text_is_break_char(letter))) {
-                    tmp_ofs = 0;
-                    letter = _lv_text_encoded_next(&cur_txt[cur_txt_ofs + next_ofs], &tmp_ofs);
-                    if(!(letter == '\0' || letter == '\n'  || letter == '\r' || _lv_text_is_break_char(letter))) {
-                        break;
-                    }
-                }
-            }
-
-            snippet.txt = &cur_txt[cur_txt_ofs];
-            snippet.bytes = next_ofs;
-            snippet.txt_w = use_width;
-            cur_txt_ofs += next_ofs;
-            if(max_line_h < snippet.line_h) {
-                max_line_h = snippet.line_h;
-            }
-            snippet_cnt ++;
-            max_w = max_w - use_width - snippet.letter_space;
-            if(isfill  || max_w <= 0) {
-                break;
-            }
+        int32_t height = 0;
+        if(build_layout(obj, &tmp_layout) == LV_RESULT_OK) {
+            height = layout_get_height(obj, &tmp_layout);
         }
+        lv_free(tmp_layout.snippets);
+        lv_free(tmp_layout.lines);
+        return height;
+    }
 
-        /* next line init */
-        txt_pos.x = 0;
-        txt_pos.y += max_line_h;
-        max_w = max_width;
-        line_cnt += 1;
-        if(line_cnt >= lines) {
-            break;
-        }
+    lv_span_layout_t * layout = get_layout(obj, width);
+    if(layout == NULL) {
+        return 0;
     }
-    txt_pos.y -= line_space;
 
-    return txt_pos.y;
+    return layout_get_height(obj, layout);
 }
 
 /**********************
@@ -537,6 +493,7 @@ static void lv_spangroup_constructor(const lv_obj_class_t * class_p, lv_obj_t *
     spans->cache_w = 0;
     spans->cache_h = 0;
     spans->refresh = 1;
+    spans->layout = NULL;
 }
 
 static void lv_spangroup_destructor(const lv_obj_class_t * class_p, lv_obj_t * obj)
@@ -554,6 +511,8 @@ static void lv_spangroup_destructor(const lv_obj_class_t * class_p, lv_obj_t * o
         lv_free(cur_span);
         cur_span = _lv_ll_get_head(&spans->child_ll);
     }
+
+    free_layout(obj);
 }
 
 static void lv_spangroup_event(const lv_obj_class_t * class_p, lv_event_t * e)
@@ -810,11 +769,14 @@ static void lv_draw_span(lv_obj_t * obj, lv_layer_t * layer)
     layer->_clip_area = clip_area;
 
     /* init draw variable */
-    lv_text_flag_t txt_flag = LV_TEXT_FLAG_NONE;
-    int32_t line_space = lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);;
     int32_t max_width = lv_area_get_width(&coords);
-    int32_t indent = convert_indent_pct(obj, max_width);
-    int32_t max_w  = max_width - indent; /* first line need minus indent */
+    lv_span_layout_t * layout = get_layout(obj, max_width);
+    if(layout == NULL) {
+        layer->_clip_area = clip_area_ori;
+        return;
+    }
+    int32_t line_space = layout->line_space;
+    int32_t indent = layout->indent;
     lv_opa_t obj_opa = lv_obj_get_style_opa_recursive(obj, LV_PART_MAIN);
 
     /* coords of draw span-txt */
@@ -822,110 +784,39 @@ static void lv_draw_span(lv_obj_t * obj, lv_layer_t * layer)
     txt_pos.y = coords.y1;
     txt_pos.x = coords.x1 + indent; /* first line need add indent */
 
-    lv_span_t * cur_span = _lv_ll_get_head(&spans->child_ll);
-    const char * cur_txt = cur_span->txt;
-    span_text_check(&cur_txt);
-    uint32_t cur_txt_ofs = 0;
-    lv_snippet_t snippet;   /* use to save cur_span info and push it to stack */
-    lv_memzero(&snippet, sizeof(snippet));
-
     lv_draw_label_dsc_t label_draw_dsc;
     lv_draw_label_dsc_init(&label_draw_dsc);
 
     bool is_first_line = true;
     /* the loop control how many lines need to draw */
-    while(cur_span) {
+    uint32_t line_id;
+    for(line_id = 0; line_id < layout->line_cnt; line_id++) {
+        const lv_span_line_t * line = &layout->lines[line_id];
+        lv_snippet_t * line_snippets = &layout->snippets[line->snippet_start];
+        uint32_t item_cnt = line->snippet_cnt;
+        int32_t max_line_h = line->max_line_h;
+        int32_t max_baseline = line->max_baseline;
         bool is_end_line = false;
         bool ellipsis_valid = false;
-        int32_t max_line_h = 0;  /* the max height of span-font when a line have a lot of span */
-        int32_t max_baseline = 0; /*baseline of the highest span*/
-        lv_snippet_clear();
-
-        /* the loop control to find a line and push the relevant span info into stack  */
-        while(1) {
-            /* switch to the next span when current is end */
-            if(cur_txt[cur_txt_ofs] == '\0') {
-                cur_span = _lv_ll_get_next(&spans->child_ll, cur_span);
-                if(cur_span == NULL) break;
-                cur_txt = cur_span->txt;
-                span_text_check(&cur_txt);
-                cur_txt_ofs = 0;
-                /* maybe also cur_txt[cur_txt_ofs] == '\0' */
-                continue;
-            }
-
-            /* init span info to snippet. */
-            if(cur_txt_ofs == 0) {
-                snippet.span = cur_span;
-                snippet.font = lv_span_get_style_text_font(obj, cur_span);
-                snippet.letter_space = lv_span_get_style_text_letter_space(obj, cur_span);
-                snippet.line_h = lv_font_get_line_height(snippet.font) + line_space;
-            }
-
-            /* get current span text line info */
-            uint32_t next_ofs = 0;
-            int32_t use_width = 0;
-            bool isfill = lv_text_get_snippet(&cur_txt[cur_txt_ofs], snippet.font, snippet.letter_space,
-                                              max_w, txt_flag, &use_width, &next_ofs);
-
-            if(isfill) {
-                if(next_ofs > 0 && lv_get_snippet_count() > 0) {
-                    /* To prevent infinite loops, the _lv_text_get_next_line() may return incomplete words, */
-                    /* This phenomenon should be avoided when lv_get_snippet_count() > 0 */
-                    if(max_w < use_width) {
-                        break;
-                    }
-                    uint32_t tmp_ofs = next_ofs;
-                    uint32_t letter = _lv_text_encoded_prev(&cur_txt[cur_txt_ofs], &tmp_ofs);
-                    if(!(letter == '\0' || letter == '\n' || letter == '\r' || _lv_text_is_break_char(letter))) {
-                        tmp_ofs = 0;
-                        letter = _lv_text_encoded_next(&cur_txt[cur_txt_ofs + next_ofs], &tmp_ofs);
-                        if(!(letter == '\0' || letter == '\n'  || letter == '\r' || _lv_text_is_break_char(letter))) {
-                            break;
-                        }
-                    }
-                }
-            }
-
-            snippet.txt = &cur_txt[cur_txt_ofs];
-            snippet.bytes = next_ofs;
-            snippet.txt_w = use_width;
-            cur_txt_ofs += next_ofs;
-            if(max_line_h < snippet.line_h) {
-                max_line_h = snippet.line_h;
-                max_baseline = snippet.font->base_line;
-            }
-
-            lv_snippet_push(&snippet);
-            max_w = max_w - use_width - snippet.letter_space;
-            if(isfill || max_w <= 0) {
-                break;
-            }
-        }
 
-        /* start current line deal with */
-
-        uint32_t item_cnt = lv_get_snippet_count();
-        if(item_cnt == 0) {     /* break if stack is empty */
-            break;
-        }
+        /* the last snippet might be modified for the overflow, so don't touch the cached one */
+        lv_snippet_t last_snippet = line_snippets[item_cnt - 1];
 
         /* Whether the current line is the end line and does overflow processing */
         {
-            lv_snippet_t * last_snippet = lv_get_snippet(item_cnt - 1);
-            int32_t next_line_h = last_snippet->line_h;
-            if(last_snippet->txt[last_snippet->bytes] == '\0') {
+            int32_t next_line_h = last_snippet.line_h;
+            if(last_snippet.txt[last_snippet.bytes] == '\0') {
                 next_line_h = 0;
-                lv_span_t * next_span = _lv_ll_get_next(&spans->child_ll, last_snippet->span);
+                lv_span_t * next_span = _lv_ll_get_next(&spans->child_ll, last_snippet.span);
                 if(next_span) { /* have the next line */
                     next_line_h = lv_font_get_line_height(lv_span_get_style_text_font(obj, next_span)) + line_space;
                 }
             }
             if(txt_pos.y + max_line_h + next_line_h - line_space > coords.y2 + 1) { /* for overflow if is end line. */
-                if(last_snippet->txt[last_snippet->bytes] != '\0') {
-                    last_snippet->bytes = lv_strlen(last_snippet->txt);
-                    last_snippet->txt_w = lv_text_get_width(last_snippet->txt, last_snippet->bytes, last_snippet->font,
-                                                            last_snippet->letter_space);
+                if(last_snippet.txt[last_snippet.bytes] != '\0') {
+                    last_snippet.bytes = lv_strlen(last_snippet.txt);
+                    last_snippet.txt_w = lv_text_get_width(last_snippet.txt, last_snippet.bytes, last_snippet.font,
+                                                           last_snippet.letter_space);
                 }
                 ellipsis_valid = spans->overflow == LV_SPAN_OVERFLOW_ELLIPSIS;
                 is_end_line = true;
@@ -944,10 +835,10 @@ static void lv_draw_span(lv_obj_t * obj, lv_layer_t * layer)
             int32_t txts_w = is_first_line ? indent : 0;
             uint32_t i;
             for(i = 0; i < item_cnt; i++) {
-                lv_snippet_t * pinfo = lv_get_snippet(i);
+                lv_snippet_t * pinfo = i == item_cnt - 1 ? &last_snippet : &line_snippets[i];
                 txts_w = txts_w + pinfo->txt_w + pinfo->letter_space;
             }
-            txts_w -= lv_get_snippet(item_cnt - 1)->letter_space;
+            txts_w -= last_snippet.letter_space;
             align_ofs = max_width > txts_w ? max_width - txts_w : 0;
             if(align == LV_TEXT_ALIGN_CENTER) {
                 align_ofs = align_ofs >> 1;
@@ -958,7 +849,7 @@ static void lv_draw_span(lv_obj_t * obj, lv_layer_t * layer)
         /* draw line letters */
         uint32_t i;
         for(i = 0; i < item_cnt; i++) {
-            lv_snippet_t * pinfo = lv_get_snippet(i);
+            lv_snippet_t * pinfo = i == item_cnt - 1 ? &last_snippet : &line_snippets[i];
 
             /* bidi deal with:todo */
             const char * bidi_txt = pinfo->txt;
@@ -968,7 +859,7 @@ static void lv_draw_span(lv_obj_t * obj, lv_layer_t * layer)
             pos.y = txt_pos.y + max_line_h - pinfo->line_h - (max_baseline - pinfo->font->base_line);
             label_draw_dsc.color = lv_span_get_style_text_color(obj, pinfo->span);
             label_draw_dsc.opa = lv_span_get_style_text_opa(obj, pinfo->span);
-            label_draw_dsc.font = lv_span_get_style_text_font(obj, pinfo->span);
+            label_draw_dsc.font = pinfo->font;
             label_draw_dsc.blend_mode = lv_span_get_style_text_blend_mode(obj, pinfo->span);
             if(obj_opa < LV_OPA_MAX) {
                 label_draw_dsc.opa = LV_OPA_MIX2(label_draw_dsc.opa, obj_opa);
@@ -1056,15 +947,259 @@ Next_line_init:
             layer->_clip_area = clip_area_ori;
             return;
         }
-        max_w = max_width;
     }
     layer->_clip_area = clip_area_ori;
 }
 
+/**
+ * Get the spans broken into lines for the given width. The layout is cached on the spangroup
+ * and replaced by a new one only if the spans, the styles or the width has changed.
+ * @param obj           pointer to a spangroup
+ * @param max_width     the width of the lines
+ * @return              the layout or NULL on error
+ */
+static lv_span_layout_t * get_layout(lv_obj_t * obj, int32_t max_width)
+{
+    lv_spangroup_t * spans = (lv_spangroup_t *)obj;
+
+    lv_span_layout_t * layout = spans->layout;
+    int32_t line_space = lv_obj_get_style_text_line_space(obj, LV_PART_MAIN);
+    int32_t indent = convert_indent_pct(obj, max_width);
+    if(layout && layout->valid && layout->max_width == max_width && layout->line_space == line_space &&
+       layout->indent == indent && !layout_styles_changed(obj, layout)) {
+        return layout;
+    }
+
+    layout = lv_malloc_zeroed(sizeof(lv_span_layout_t));
+    LV_ASSERT_MALLOC(layout);
+    if(layout == NULL) return NULL;
+
+    layout->max_width = max_width;
+    layout->line_space = line_space;
+    layout->indent = indent;
+    if(build_layout(obj, layout) != LV_RESULT_OK) {
+        delete_layout(layout);
+        return NULL;
+    }
+    layout->valid = 1;
+
+    /*Free the old layout only now, so the new one always has an other address*/
+    free_layout(obj);
+    spans->layout = layout;
+
+    return layout;
+}
+
+/**
+ * Break the spans into lines and store the snippets of each line in the layout
+ * @param obj           pointer to a spangroup
+ * @param layout        store the lines here. `max_width`, `line_space` and `indent` need to be set.
+ * @return              LV_RESULT_OK: no error; LV_RESULT_INVALID: out of memory
+ */
+static lv_result_t build_layout(lv_obj_t * obj, lv_span_layout_t * layout)
+{
+    lv_spangroup_t * spans = (lv_spangroup_t *)obj;
+
+    layout->snippet_cnt = 0;
+    layout->line_cnt = 0;
+
+    lv_span_t * cur_span = _lv_ll_get_head(&spans->child_ll);
+    if(cur_span == NULL) return LV_RESULT_OK;
+
+    lv_text_flag_t txt_flag = LV_TEXT_FLAG_NONE;
+    int32_t line_space = layout->line_space;
+    int32_t max_width = layout->max_width;
+    int32_t max_w  = max_width - layout->indent; /* first line need minus indent */
+
+    const char * cur_txt = cur_span->txt;
+    span_text_check(&cur_txt);
+    uint32_t cur_txt_ofs = 0;
+    lv_snippet_t snippet;   /* use to save cur_span info and push it to stack */
+    lv_memzero(&snippet, sizeof(snippet));
+
+    /* the loop control how many lines need to draw */
+    while(cur_span) {
+        int32_t max_line_h = 0;  /* the max height of span-font when a line have a lot of span */
+        int32_t max_baseline = 0; /*baseline of the highest span*/
+        lv_snippet_clear();
+
+        /* the loop control to find a line and push the relevant span info into stack  */
+        while(1) {
+            /* switch to the next span when current is end */
+            if(cur_txt[cur_txt_ofs] == '\0') {
+                cur_span = _lv_ll_get_next(&spans->child_ll, cur_span);
+                if(cur_span == NULL) break;
+                cur_txt = cur_span->txt;
+                span_text_check(&cur_txt);
+                cur_txt_ofs = 0;
+                /* maybe also cur_txt[cur_txt_ofs] == '\0' */
+                continue;
+            }
+
+            /* init span info to snippet. */
+            if(cur_txt_ofs == 0) {
+                snippet.span = cur_span;
+                snippet.font = lv_span_get_style_text_font(obj, cur_span);
+                snippet.letter_space = lv_span_get_style_text_letter_space(obj, cur_span);
+                snippet.line_h = lv_font_get_line_height(snippet.font) + line_space;
+            }
+
+            /* get current span text line info */
+            uint32_t next_ofs = 0;
+            int32_t use_width = 0;
+            bool isfill = lv_text_get_snippet(&cur_txt[cur_txt_ofs], snippet.font, snippet.letter_space,
+                                              max_w, txt_flag, &use_width, &next_ofs);
+
+            if(isfill) {
+                if(next_ofs > 0 && lv_get_snippet_count() > 0) {
+                    /* To prevent infinite loops, the _lv_text_get_next_line() may return incomplete words, */
+                    /* This phenomenon should be avoided when lv_get_snippet_count() > 0 */
+                    if(max_w < use_width) {
+                        break;
+                    }
+                    uint32_t tmp_ofs = next_ofs;
+                    uint32_t letter = _lv_text_encoded_prev(&cur_txt[cur_txt_ofs], &tmp_ofs);
+                    if(!(letter == '\0' || letter == '\n' || letter == '\r' || _lv_text_is_break_char(letter))) {
+                        tmp_ofs = 0;
+                        letter = _lv_text_encoded_next(&cur_txt[cur_txt_ofs + next_ofs], &tmp_ofs);
+                        if(!(letter == '\0' || letter == '\n'  || letter == '\r' || _lv_text_is_break_char(letter))) {
+                            break;
+                        }
+                    }
+                }
+            }
+
+            snippet.txt = &cur_txt[cur_txt_ofs];
+            snippet.bytes = next_ofs;
+            snippet.txt_w = use_width;
+            cur_txt_ofs += next_ofs;
+            if(max_line_h < snippet.line_h) {
+                max_line_h = snippet.line_h;
+                max_baseline = snippet.font->base_line;
+            }
+
+            lv_snippet_push(&snippet);
+            max_w = max_w - use_width - snippet.letter_space;
+            if(isfill || max_w <= 0) {
+                break;
+            }
+        }
+
+        /* break if stack is empty */
+        if(lv_get_snippet_count() == 0) {
+            break;
+        }
+
+        if(layout_add_line(layout, max_line_h, max_baseline) != LV_RESULT_OK) {
+            return LV_RESULT_INVALID;
+        }
+
+        /* next line init */
+        max_w = max_width;
+    }
+
+    return LV_RESULT_OK;
+}
+
+/**
+ * Add the snippets of the snippet stack to the layout as a new line
+ */
+static lv_result_t layout_add_line(lv_span_layout_t * layout, int32_t max_line_h, int32_t max_baseline)
+{
+    uint32_t item_cnt = lv_get_snippet_count();
+
+    if(layout->snippet_cnt + item_cnt > layout->snippet_cap) {
+        uint32_t new_cap = LV_MAX(layout->snippet_cap * 2, layout->snippet_cnt + item_cnt);
+        lv_snippet_t * snippets = lv_realloc(layout->snippets, new_cap * sizeof(lv_snippet_t));
+        LV_ASSERT_MALLOC(snippets);
+        if(snippets == NULL) return LV_RESULT_INVALID;
+        layout->snippets = snippets;
+        layout->snippet_cap = new_cap;
+    }
+
+    if(layout->line_cnt == layout->line_cap) {
+        uint32_t new_cap = layout->line_cap ? layout->line_cap * 2 : 4;
+        lv_span_line_t * lines = lv_realloc(layout->lines, new_cap * sizeof(lv_span_line_t));
+        LV_ASSERT_MALLOC(lines);
+        if(lines == NULL) return LV_RESULT_INVALID;
+        layout->lines = lines;
+        layout->line_cap = new_cap;
+    }
+
+    lv_span_line_t * line = &layout->lines[layout->line_cnt];
+    line->snippet_start = layout->snippet_cnt;
+    line->snippet_cnt = item_cnt;
+    line->max_line_h = max_line_h;
+    line->max_baseline = max_baseline;
+    layout->line_cnt++;
+
+    lv_memcpy(&layout->snippets[layout->snippet_cnt], lv_get_snippet(0), item_cnt * sizeof(lv_snippet_t));
+    layout->snippet_cnt += item_cnt;
+
+    return LV_RESULT_OK;
+}
+
+/**
+ * Check whether the style of a span was changed directly (e.g. `lv_style_set_text_font(&span->style, ...)`)
+ * since the layout was built.
+ * @param obj           pointer to a spangroup
+ * @param layout        the layout to check
+ * @return              true: the font or letter space of a span is different than in the layout
+ */
+static bool layout_styles_changed(lv_obj_t * obj, const lv_span_layout_t * layout)
+{
+    const lv_span_t * prev_span = NULL;
+    uint32_t i;
+    for(i = 0; i < layout->snippet_cnt; i++) {
+        const lv_snippet_t * snippet = &layout->snippets[i];
+        if(snippet->span == prev_span) continue;
+        prev_span = snippet->span;
+
+        if(lv_span_get_style_text_font(obj, snippet->span) != snippet->font ||
+           lv_span_get_style_text_letter_space(obj, snippet->span) != snippet->letter_space) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static int32_t layout_get_height(lv_obj_t * obj, const lv_span_layout_t * layout)
+{
+    lv_spangroup_t * spans = (lv_spangroup_t *)obj;
+
+    /* at least one line is counted */
+    uint32_t lines = spans->lines < 0 ? UINT32_MAX : (uint32_t)LV_MAX(spans->lines, 1);
+    int32_t height = layout->indent; /* first line need add indent */
+    uint32_t i;
+    for(i = 0; i < layout->line_cnt && i < lines; i++) {
+        height += layout->lines[i].max_line_h;
+    }
+
+    return height - layout->line_space;
+}
+
+static void delete_layout(lv_span_layout_t * layout)
+{
+    lv_free(layout->snippets);
+    lv_free(layout->lines);
+    lv_free(layout);
+}
+
+static void free_layout(lv_obj_t * obj)
+{
+    lv_spangroup_t * spans = (lv_spangroup_t *)obj;
+    if(spans->layout == NULL) return;
+
+    delete_layout(spans->layout);
+    spans->layout = NULL;
+}
+
 static void refresh_self_size(lv_obj_t * obj)
 {
     lv_spangroup_t * spans = (lv_spangroup_t *)obj;
     spans->refresh = 1;
+    if(spans->layout) spans->layout->valid = 0;
     lv_obj_invalidate(obj);
     lv_obj_refresh_self_size(obj);
 }
@@ -59,6 +59,8 @@ typedef struct {
     uint32_t static_flag : 1;/* the text is static flag */
 } lv_span_t;
 
+struct _lv_span_layout_t;
+
 /** Data of label*/
 typedef struct {
     lv_obj_t obj;
@@ -70,6 +72,7 @@ typedef struct {
     uint32_t mode : 2;       /* details see lv_span_mode_t */
     uint32_t overflow : 1;   /* details see lv_span_overflow_t */
     uint32_t refresh : 1;    /* the spangroup need refresh cache_w and cache_h */
+    struct _lv_span_layout_t * layout; /* the spans broken into lines, reused until a span or the width changes */
 } lv_spangroup_t;
 
 LV_ATTRIBUTE_EXTERN_DATA extern const lv_obj_class_t lv_spangroup_class;
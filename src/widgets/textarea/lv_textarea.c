@@ -235,6 +235,10 @@ void lv_textarea_delete_char(lv_obj_t * obj)
     lv_result_t res = insert_handler(obj, del_buf);
     if(res != LV_RESULT_OK) return;
 
+#if LV_USE_ARABIC_PERSIAN_CHARS == 0
+    /*Delete a character. The label wraps and redraws only the affected lines if it can*/
+    lv_label_cut_text(ta->label, ta->cursor.pos - 1, 1);
+#else
     char * label_txt = lv_label_get_text(ta->label);
 
     /*Delete a character*/
@@ -242,6 +246,7 @@ void lv_textarea_delete_char(lv_obj_t * obj)
 
     /*Refresh the label*/
     lv_label_set_text(ta->label, label_txt);
+#endif
     lv_textarea_clear_selection(obj);
 
     /*If the textarea became empty, invalidate it to hide the placeholder*/
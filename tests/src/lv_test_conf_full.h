@@ -41,11 +41,13 @@
 #define LV_FONT_DEFAULT         &lv_font_montserrat_14
 #define LV_FONT_FMT_TXT_LARGE   1
 #define LV_USE_FONT_COMPRESSED  1
+#define LV_USE_FONT_GLYPH_ATLAS 1
 #define LV_USE_BIDI 1
 #define LV_USE_ARABIC_PERSIAN_CHARS 1
 #define LV_USE_PERF_MONITOR         1
 #define LV_USE_MEM_MONITOR          1
 #define LV_LABEL_TEXT_SELECTION     1
+#define LV_LABEL_LINE_INDEX         1
 
 #define LV_USE_FLEX 1
 #define LV_USE_GRID 1
@@ -55,6 +57,7 @@
 #define LV_FS_STDIO_CACHE_SIZE 512
 #define LV_USE_FS_POSIX     1
 #define LV_FS_POSIX_LETTER  'B'
+#define LV_FS_POSIX_MMAP    1
 #define LV_USE_FS_MEMFS     1
 #define LV_FS_MEMFS_LETTER  'M'
 
@@ -100,6 +103,15 @@
 #define LV_BIN_DECODER_RAM_LOAD 1
 
 #define LV_CACHE_DEF_SIZE       (10 * 1024 * 1024)
+#define LV_IMAGE_CACHE_SCAN_RESISTANT 1
+#define LV_IMAGE_CACHE_SHARD_CNT 4
+#define LV_IMAGE_CACHE_COMPRESSED_SIZE (2 * 1024 * 1024)
+#define LV_USE_IMAGE_MIPMAP     1
+#define LV_DRAW_SW_KEEP_INDEXED 1
+#ifdef LVGL_CI_USING_SYS_HEAP    /*Uses pthread*/
+    #define LV_USE_IMAGE_DECODER_ASYNC 1
+    #define LV_IMAGE_DECODER_ASYNC_WORKER_CNT 2
+#endif
 
 #ifndef LV_USE_LINUX_DRM
     #define LV_USE_LINUX_DRM    1
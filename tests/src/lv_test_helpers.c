@@ -9,4 +9,41 @@ void lv_test_wait(uint32_t ms)
     lv_refr_now(NULL);
 }
 
+void lv_test_image_decoder_args_downscaled(lv_image_decoder_args_t * args, int32_t target_w, int32_t target_h)
+{
+    lv_memzero(args, sizeof(*args));
+    args->stride_align = LV_DRAW_BUF_STRIDE_ALIGN != 1;
+    args->target_w = target_w;
+    args->target_h = target_h;
+}
+
+lv_result_t lv_test_image_decoder_open_downscaled(lv_image_decoder_dsc_t * dsc, const void * src,
+                                                  int32_t target_w, int32_t target_h)
+{
+    lv_image_decoder_args_t args;
+    lv_test_image_decoder_args_downscaled(&args, target_w, target_h);
+
+    return lv_image_decoder_open(dsc, src, &args);
+}
+
+void lv_test_image_decoder_use_png_jpg_libs(void)
+{
+#if LV_USE_LODEPNG
+    lv_lodepng_deinit();
+#endif
+#if LV_USE_TJPGD
+    lv_tjpgd_deinit();
+#endif
+}
+
+void lv_test_image_decoder_restore_png_jpg(void)
+{
+#if LV_USE_LODEPNG
+    lv_lodepng_init();
+#endif
+#if LV_USE_TJPGD
+    lv_tjpgd_init();
+#endif
+}
+
 #endif
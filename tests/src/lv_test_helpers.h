@@ -24,4 +24,33 @@ static inline size_t lv_test_get_free_mem(void)
 
 void lv_test_wait(uint32_t ms);
 
+/**
+ * Initialize image decoder args to request an image downscaled to fit the target size
+ * @param args      the args to initialize
+ * @param target_w  the width the image will be drawn with
+ * @param target_h  the height the image will be drawn with
+ */
+void lv_test_image_decoder_args_downscaled(lv_image_decoder_args_t * args, int32_t target_w, int32_t target_h);
+
+/**
+ * Open an image downscaled to fit the target size
+ * @param dsc       the decoder descriptor to open
+ * @param src       the image source
+ * @param target_w  the width the image will be drawn with
+ * @param target_h  the height the image will be drawn with
+ * @return          the result of `lv_image_decoder_open()`
+ */
+lv_result_t lv_test_image_decoder_open_downscaled(lv_image_decoder_dsc_t * dsc, const void * src,
+                                                  int32_t target_w, int32_t target_h);
+
+/**
+ * Remove lodepng and tjpgd to decode the PNG and JPG images with libpng and libjpeg-turbo
+ */
+void lv_test_image_decoder_use_png_jpg_libs(void);
+
+/**
+ * Add back lodepng and tjpgd removed by `lv_test_image_decoder_use_png_jpg_libs()`
+ */
+void lv_test_image_decoder_restore_png_jpg(void);
+
 #endif /*LV_TEST_HELPERS_H*/
@@ -150,4 +150,255 @@ void test_cache_1(void)
     TEST_ASSERT_EQUAL(40, lv_cache_get_free_size(cache, NULL));
 }
 
+/*Look up a key and add it on miss. Return true on hit.*/
+static bool cache_access(lv_cache_t * c, int32_t key)
+{
+    test_data search_key = {
+        .key1 = key,
+        .key2 = 0
+    };
+
+    lv_cache_entry_t * entry = lv_cache_acquire(c, &search_key, NULL);
+    bool hit = entry != NULL;
+    if(entry == NULL) entry = lv_cache_add(c, &search_key, NULL);
+    TEST_ASSERT_NOT_NULL(entry);
+    lv_cache_release(c, entry, NULL);
+
+    return hit;
+}
+
+void test_cache_slru_scan_resistant(void)
+{
+    lv_cache_ops_t ops = {
+        .compare_cb = (lv_cache_compare_cb_t) compare_cb,
+        .create_cb = NULL,
+        .free_cb = (lv_cache_free_cb_t)free_cb,
+    };
+    lv_cache_t * slru = lv_cache_create(&lv_cache_class_slru_rb_count, sizeof(test_data), 4, ops);
+    TEST_ASSERT_NOT_NULL(slru);
+
+    /*Use 1 and 2 in two periods to protect them*/
+    TEST_ASSERT_FALSE(cache_access(slru, 1));
+    TEST_ASSERT_FALSE(cache_access(slru, 2));
+    lv_cache_next_period(slru, NULL);
+    TEST_ASSERT_TRUE(cache_access(slru, 1));
+    TEST_ASSERT_TRUE(cache_access(slru, 2));
+
+    /*Scan through many keys used only once*/
+    int32_t i;
+    for(i = 100; i < 120; i++) {
+        TEST_ASSERT_FALSE(cache_access(slru, i));
+    }
+    TEST_ASSERT_EQUAL(4, lv_cache_get_size(slru, NULL));
+
+    /*The frequently used ones survived, the scanned ones didn't*/
+    TEST_ASSERT_TRUE(cache_access(slru, 1));
+    TEST_ASSERT_TRUE(cache_access(slru, 2));
+    TEST_ASSERT_FALSE(cache_access(slru, 100));
+
+    TEST_ASSERT_EQUAL(4, lv_cache_get_hit_cnt(slru, NULL));
+    TEST_ASSERT_EQUAL(23, lv_cache_get_miss_cnt(slru, NULL));
+
+    lv_cache_reset_stats(slru, NULL);
+    TEST_ASSERT_EQUAL(0, lv_cache_get_hit_cnt(slru, NULL));
+    TEST_ASSERT_EQUAL(0, lv_cache_get_miss_cnt(slru, NULL));
+
+    lv_cache_destroy(slru, NULL);
+}
+
+void test_cache_slru_scan_with_repeated_hits_per_period(void)
+{
+    lv_cache_ops_t ops = {
+        .compare_cb = (lv_cache_compare_cb_t) compare_cb,
+        .create_cb = NULL,
+        .free_cb = (lv_cache_free_cb_t)free_cb,
+    };
+    lv_cache_t * slru = lv_cache_create(&lv_cache_class_slru_rb_count, sizeof(test_data), 4, ops);
+    TEST_ASSERT_NOT_NULL(slru);
+
+    /*1 and 2 are drawn in every frame, so they are protected from the second frame*/
+    int32_t frame;
+    for(frame = 0; frame < 3; frame++) {
+        cache_access(slru, 1);
+        cache_access(slru, 2);
+        lv_cache_next_period(slru, NULL);
+    }
+
+    /*Scroll through many images, each looked up several times (header, draw, ...) in one frame*/
+    int32_t i;
+    for(i = 100; i < 120; i++) {
+        TEST_ASSERT_FALSE(cache_access(slru, i));
+        TEST_ASSERT_TRUE(cache_access(slru, i));
+        TEST_ASSERT_TRUE(cache_access(slru, i));
+        lv_cache_next_period(slru, NULL);
+    }
+
+    /*The repeated hits in one frame didn't protect the scanned images*/
+    TEST_ASSERT_TRUE(cache_access(slru, 1));
+    TEST_ASSERT_TRUE(cache_access(slru, 2));
+    TEST_ASSERT_FALSE(cache_access(slru, 100));
+
+    /*An entry hit many times in a single period is still evicted first*/
+    lv_cache_next_period(slru, NULL);
+    for(i = 0; i < 5; i++) cache_access(slru, 200);
+    lv_cache_next_period(slru, NULL);
+    TEST_ASSERT_FALSE(cache_access(slru, 201));
+    TEST_ASSERT_FALSE(cache_access(slru, 202));
+    lv_cache_next_period(slru, NULL);
+    TEST_ASSERT_TRUE(cache_access(slru, 1));
+    TEST_ASSERT_TRUE(cache_access(slru, 2));
+    TEST_ASSERT_FALSE(cache_access(slru, 200));
+
+    lv_cache_destroy(slru, NULL);
+}
+
+void test_cache_lru_scan_flushes(void)
+{
+    lv_cache_ops_t ops = {
+        .compare_cb = (lv_cache_compare_cb_t) compare_cb,
+        .create_cb = NULL,
+        .free_cb = (lv_cache_free_cb_t)free_cb,
+    };
+    lv_cache_t * lru = lv_cache_create(&lv_cache_class_lru_rb_count, sizeof(test_data), 4, ops);
+    TEST_ASSERT_NOT_NULL(lru);
+
+    cache_access(lru, 1);
+    cache_access(lru, 1);
+
+    int32_t i;
+    for(i = 100; i < 120; i++) {
+        cache_access(lru, i);
+    }
+
+    /*A plain LRU forgets the frequently used entry*/
+    TEST_ASSERT_FALSE(cache_access(lru, 1));
+
+    lv_cache_destroy(lru, NULL);
+}
+
+static uint32_t hash_cb(const test_data * key)
+{
+    return (uint32_t)key->key1;
+}
+
+void test_cache_sharded(void)
+{
+    lv_cache_ops_t ops = {
+        .compare_cb = (lv_cache_compare_cb_t) compare_cb,
+        .create_cb = NULL,
+        .free_cb = (lv_cache_free_cb_t)free_cb,
+        .hash_cb = (lv_cache_hash_cb_t)hash_cb,
+    };
+    lv_cache_t * sharded = lv_cache_create_sharded(&lv_cache_class_lru_rb_count, sizeof(test_data), 8, ops, 4);
+    TEST_ASSERT_NOT_NULL(sharded);
+
+    /*Each shard can hold 2 entries and key N goes to shard N % 4*/
+    int32_t i;
+    for(i = 0; i < 8; i++) {
+        TEST_ASSERT_FALSE(cache_access(sharded, i));
+    }
+    TEST_ASSERT_EQUAL(8, lv_cache_get_size(sharded, NULL));
+    TEST_ASSERT_EQUAL(0, lv_cache_get_free_size(sharded, NULL));
+
+    for(i = 0; i < 8; i++) {
+        TEST_ASSERT_TRUE(cache_access(sharded, i));
+    }
+
+    /*Only the least recently used entry of the same shard is evicted*/
+    TEST_ASSERT_FALSE(cache_access(sharded, 8));
+    TEST_ASSERT_TRUE(cache_access(sharded, 1));
+    TEST_ASSERT_TRUE(cache_access(sharded, 4));
+    TEST_ASSERT_FALSE(cache_access(sharded, 0));
+
+    TEST_ASSERT_EQUAL(10, lv_cache_get_hit_cnt(sharded, NULL));
+    TEST_ASSERT_EQUAL(10, lv_cache_get_miss_cnt(sharded, NULL));
+
+    /*A dropped but still used entry is freed by the last release*/
+    test_data search_key = {
+        .key1 = 3,
+        .key2 = 0
+    };
+    lv_cache_entry_t * entry = lv_cache_acquire(sharded, &search_key, NULL);
+    TEST_ASSERT_NOT_NULL(entry);
+    lv_cache_drop(sharded, &search_key, NULL);
+    TEST_ASSERT_EQUAL(7, lv_cache_get_size(sharded, NULL));
+    TEST_ASSERT_NULL(lv_cache_acquire(sharded, &search_key, NULL));
+    TEST_ASSERT_TRUE(lv_cache_entry_is_invalid(entry));
+    lv_cache_release(sharded, entry, NULL);
+
+    lv_cache_drop_all(sharded, NULL);
+    TEST_ASSERT_EQUAL(0, lv_cache_get_size(sharded, NULL));
+
+    /*Reserving is split between the shards*/
+    for(i = 0; i < 8; i++) {
+        TEST_ASSERT_FALSE(cache_access(sharded, i));
+    }
+    lv_cache_reserve(sharded, 4, NULL);
+    TEST_ASSERT_EQUAL(4, lv_cache_get_size(sharded, NULL));
+    lv_cache_reserve(sharded, 2, NULL);
+    TEST_ASSERT_EQUAL(4, lv_cache_get_size(sharded, NULL));
+
+    /*Evict from the fullest shard*/
+    TEST_ASSERT_FALSE(cache_access(sharded, 100));
+    TEST_ASSERT_TRUE(lv_cache_evict_one(sharded, NULL));
+    TEST_ASSERT_EQUAL(4, lv_cache_get_size(sharded, NULL));
+    TEST_ASSERT_TRUE(cache_access(sharded, 100));
+
+    lv_cache_drop_all(sharded, NULL);
+    TEST_ASSERT_FALSE(lv_cache_evict_one(sharded, NULL));
+
+    lv_cache_destroy(sharded, NULL);
+}
+
+static lv_cache_t * evict_cache;
+static int32_t evicted_keys[4];
+static uint32_t evicted_cnt;
+static bool evicted_locked;
+
+static void evict_cb(test_data * node, void * user_data)
+{
+    LV_UNUSED(user_data);
+
+#if LV_USE_OS == LV_OS_PTHREAD
+    /*The slow work of `evict_cb` mustn't block the other users of the cache*/
+    if(pthread_mutex_trylock(&evict_cache->lock) == 0) pthread_mutex_unlock(&evict_cache->lock);
+    else evicted_locked = true;
+#endif
+
+    if(evicted_cnt < 4) evicted_keys[evicted_cnt] = node->key1;
+    evicted_cnt++;
+}
+
+void test_cache_evict_cb(void)
+{
+    lv_cache_ops_t ops = {
+        .compare_cb = (lv_cache_compare_cb_t) compare_cb,
+        .create_cb = NULL,
+        .free_cb = (lv_cache_free_cb_t)free_cb,
+        .evict_cb = (lv_cache_evict_cb_t)evict_cb,
+    };
+    evict_cache = lv_cache_create(&lv_cache_class_lru_rb_count, sizeof(test_data), 2, ops);
+    TEST_ASSERT_NOT_NULL(evict_cache);
+    evicted_cnt = 0;
+    evicted_locked = false;
+
+    TEST_ASSERT_FALSE(cache_access(evict_cache, 1));
+    TEST_ASSERT_FALSE(cache_access(evict_cache, 2));
+    TEST_ASSERT_FALSE(cache_access(evict_cache, 3));
+    TEST_ASSERT_EQUAL_UINT32(1, evicted_cnt);
+    TEST_ASSERT_EQUAL_INT32(1, evicted_keys[0]);
+
+    TEST_ASSERT_TRUE(lv_cache_evict_one(evict_cache, NULL));
+    TEST_ASSERT_EQUAL_UINT32(2, evicted_cnt);
+    TEST_ASSERT_EQUAL_INT32(2, evicted_keys[1]);
+
+    /*Dropped entries aren't evicted*/
+    lv_cache_drop_all(evict_cache, NULL);
+    TEST_ASSERT_EQUAL_UINT32(2, evicted_cnt);
+    TEST_ASSERT_FALSE(evicted_locked);
+
+    lv_cache_destroy(evict_cache, NULL);
+    evict_cache = NULL;
+}
+
 #endif
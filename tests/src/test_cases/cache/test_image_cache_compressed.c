@@ -0,0 +1,124 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "lv_test_helpers.h"
+
+#include "unity/unity.h"
+
+#if LV_IMAGE_CACHE_COMPRESSED_SIZE > 0
+
+#define IMG_SRC "A:src/test_assets/test_img_lvgl_logo.png"
+
+void setUp(void)
+{
+    lv_image_cache_drop(NULL);
+    lv_image_cache_reset_stats();
+}
+
+void tearDown(void)
+{
+    lv_image_cache_drop(NULL);
+}
+
+/*Decode the image and return a copy of its pixels*/
+static uint8_t * decode_copy(uint32_t * data_size)
+{
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, IMG_SRC, NULL));
+    TEST_ASSERT_NOT_NULL(dsc.decoded);
+    TEST_ASSERT_NOT_NULL(dsc.cache_entry);
+
+    *data_size = dsc.decoded->data_size;
+    uint8_t * copy = lv_malloc(*data_size);
+    TEST_ASSERT_NOT_NULL(copy);
+    lv_memcpy(copy, dsc.decoded->data, *data_size);
+    lv_image_decoder_close(&dsc);
+
+    return copy;
+}
+
+static void evict_all(void)
+{
+    while(lv_cache_get_size(LV_GLOBAL_DEFAULT()->img_cache, NULL) > 0) {
+        TEST_ASSERT_TRUE(lv_cache_evict_one(LV_GLOBAL_DEFAULT()->img_cache, NULL));
+    }
+}
+
+void test_image_cache_compressed_evict_and_restore(void)
+{
+    uint32_t data_size;
+    uint8_t * original = decode_copy(&data_size);
+
+    lv_image_cache_stats_t stats;
+    lv_image_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(data_size, stats.decoded.size);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.compressed.size);
+    TEST_ASSERT_EQUAL_UINT32(LV_IMAGE_CACHE_COMPRESSED_SIZE, stats.compressed.max_size);
+
+    /*The evicted image is kept compressed*/
+    evict_all();
+    lv_image_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.decoded.size);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.compressed.size);
+    TEST_ASSERT_LESS_THAN_UINT32(data_size, stats.compressed.size);
+
+    /*It's decompressed instead of decoded again*/
+    uint32_t restored_size;
+    uint8_t * restored = decode_copy(&restored_size);
+    TEST_ASSERT_EQUAL_UINT32(data_size, restored_size);
+    TEST_ASSERT_EQUAL_MEMORY(original, restored, data_size);
+
+    lv_image_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(data_size, stats.decoded.size);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.compressed.size);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.compressed.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.compressed.miss_cnt);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.decoded.miss_cnt);
+
+    lv_free(original);
+    lv_free(restored);
+}
+
+void test_image_cache_compressed_drop(void)
+{
+    uint32_t data_size;
+    lv_free(decode_copy(&data_size));
+    evict_all();
+
+    lv_image_cache_stats_t stats;
+    lv_image_cache_get_stats(&stats);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.compressed.size);
+
+    /*Dropping an image (e.g. because the file has changed) drops the compressed version too*/
+    lv_image_cache_drop(IMG_SRC);
+    lv_image_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.compressed.size);
+
+    /*Dropping from the decoded tier doesn't compress it*/
+    lv_free(decode_copy(&data_size));
+    lv_image_cache_drop(IMG_SRC);
+    lv_image_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.decoded.size);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.compressed.size);
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_image_cache_compressed_evict_and_restore(void)
+{
+}
+
+void test_image_cache_compressed_drop(void)
+{
+}
+
+#endif
+
+#endif
@@ -122,4 +122,143 @@ void test_label_decor(void)
     TEST_ASSERT_EQUAL_SCREENSHOT("draw/label_decor.png");
 }
 
+#if LV_FONT_GLYPH_CACHE_SIZE > 0
+void test_draw_label_glyph_cache(void)
+{
+    lv_cache_t * cache = LV_GLOBAL_DEFAULT()->font_glyph_cache;
+    lv_draw_label_glyph_cache_drop_all();
+    TEST_ASSERT_EQUAL_UINT32(0, lv_cache_get_size(cache, NULL));
+
+    all_labels_create("normal", NULL);
+    size_t size = lv_cache_get_size(cache, NULL);
+    TEST_ASSERT_GREATER_THAN(0, size);
+
+    /*Redrawing the same glyphs should use the cached bitmaps*/
+    lv_obj_invalidate(lv_screen_active());
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(size, lv_cache_get_size(cache, NULL));
+
+    lv_draw_label_glyph_cache_drop_all();
+    TEST_ASSERT_EQUAL_UINT32(0, lv_cache_get_size(cache, NULL));
+}
+#endif
+
+#if LV_USE_FONT_COMPRESSED
+void test_draw_label_glyph_cache_default_with_compressed_fonts(void)
+{
+    /*The test config leaves the size at its default*/
+    TEST_ASSERT_EQUAL_UINT32(8 * 1024, LV_FONT_GLYPH_CACHE_SIZE);
+
+    lv_cache_t * cache = LV_GLOBAL_DEFAULT()->font_glyph_cache;
+    TEST_ASSERT_EQUAL_UINT32(8 * 1024, lv_cache_get_max_size(cache, NULL));
+    lv_draw_label_glyph_cache_drop_all();
+
+    /*The compressed glyphs are decompressed once and found in the cache on redraw.
+     *Use only a few letters as the glyphs are stored with the 64 bytes stride alignment of the tests*/
+    LV_FONT_DECLARE(test_font_montserrat_ascii_4bpp_compressed);
+    lv_obj_t * label = lv_label_create(lv_screen_active());
+    lv_label_set_text(label, "lvgl");
+    lv_obj_set_style_text_font(label, &test_font_montserrat_ascii_4bpp_compressed, 0);
+    lv_refr_now(NULL);
+    size_t size = lv_cache_get_size(cache, NULL);
+    TEST_ASSERT_GREATER_THAN(0, size);
+
+    lv_cache_reset_stats(cache, NULL);
+    lv_obj_invalidate(lv_screen_active());
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(size, lv_cache_get_size(cache, NULL));
+    TEST_ASSERT_GREATER_THAN(0, lv_cache_get_hit_cnt(cache, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, lv_cache_get_miss_cnt(cache, NULL));
+
+    lv_draw_label_glyph_cache_drop_all();
+}
+#endif
+
+#if LV_USE_FONT_GLYPH_ATLAS
+void test_draw_label_glyph_atlas(void)
+{
+    LV_FONT_DECLARE(test_font_montserrat_ascii_1bpp);
+    LV_FONT_DECLARE(test_font_montserrat_ascii_2bpp);
+    LV_FONT_DECLARE(test_font_montserrat_ascii_4bpp);
+    LV_FONT_DECLARE(test_font_montserrat_ascii_4bpp_compressed);
+
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_font_glyph_atlas_create(&test_font_montserrat_ascii_1bpp, 256, 256));
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_font_glyph_atlas_create(&test_font_montserrat_ascii_2bpp, 256, 256));
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_font_glyph_atlas_create(&test_font_montserrat_ascii_4bpp_compressed, 256, 256));
+    /*Too small for all glyphs, the rest should be drawn without the atlas*/
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_font_glyph_atlas_create(&test_font_montserrat_ascii_4bpp, 32, 32));
+
+    /*The result should be the same as without atlas*/
+    static lv_style_t style;
+    lv_style_init(&style);
+    lv_style_set_text_color(&style, lv_palette_main(LV_PALETTE_RED));
+    all_labels_create("color", &style);
+
+    lv_font_glyph_atlas_t * atlas_1bpp = lv_font_glyph_atlas_acquire(&test_font_montserrat_ascii_1bpp);
+    TEST_ASSERT_NOT_NULL(atlas_1bpp);
+    uint32_t glyph_cnt = atlas_1bpp->glyph_cnt;
+    TEST_ASSERT_GREATER_THAN(20, glyph_cnt);
+
+    lv_font_glyph_atlas_t * atlas = lv_font_glyph_atlas_acquire(&test_font_montserrat_ascii_4bpp);
+    TEST_ASSERT_NOT_NULL(atlas);
+    TEST_ASSERT_GREATER_THAN(0, atlas->glyph_cnt);
+    TEST_ASSERT_LESS_THAN(glyph_cnt, atlas->glyph_cnt);
+    lv_font_glyph_atlas_release(atlas);
+
+    lv_font_glyph_atlas_delete(&test_font_montserrat_ascii_1bpp);
+    lv_font_glyph_atlas_delete(&test_font_montserrat_ascii_2bpp);
+    lv_font_glyph_atlas_delete(&test_font_montserrat_ascii_4bpp);
+    lv_font_glyph_atlas_delete(&test_font_montserrat_ascii_4bpp_compressed);
+    TEST_ASSERT_NULL(lv_font_glyph_atlas_acquire(&test_font_montserrat_ascii_1bpp));
+
+    /*An acquired atlas stays valid after deleting it*/
+    TEST_ASSERT_EQUAL(glyph_cnt, atlas_1bpp->glyph_cnt);
+    TEST_ASSERT_NOT_NULL(atlas_1bpp->draw_buf);
+    lv_font_glyph_atlas_release(atlas_1bpp);
+}
+
+void test_draw_label_glyph_atlas_invalidate(void)
+{
+    LV_FONT_DECLARE(test_font_montserrat_ascii_4bpp);
+    const lv_font_t * font = &test_font_montserrat_ascii_4bpp;
+
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_font_glyph_atlas_create(font, 128, 64));
+    lv_font_glyph_atlas_t * atlas_old = lv_font_glyph_atlas_acquire(font);
+    TEST_ASSERT_NOT_NULL(atlas_old);
+
+    /*Creating it again keeps the existing atlas*/
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_font_glyph_atlas_create(font, 256, 256));
+    lv_font_glyph_atlas_t * atlas = lv_font_glyph_atlas_acquire(font);
+    TEST_ASSERT_EQUAL_PTR(atlas_old, atlas);
+    lv_font_glyph_atlas_release(atlas);
+
+    lv_obj_t * label = lv_label_create(lv_screen_active());
+    lv_obj_set_style_text_font(label, font, 0);
+    lv_label_set_text(label, "Hello world");
+    lv_refr_now(NULL);
+    uint32_t glyph_cnt = atlas_old->glyph_cnt;
+    TEST_ASSERT_GREATER_THAN(0, glyph_cnt);
+
+    /*It's replaced by an empty atlas of the same size, the old one stays valid until released*/
+    lv_font_glyph_atlas_invalidate(font);
+    atlas = lv_font_glyph_atlas_acquire(font);
+    TEST_ASSERT_NOT_NULL(atlas);
+    TEST_ASSERT_NOT_EQUAL(atlas_old, atlas);
+    TEST_ASSERT_EQUAL_UINT32(0, atlas->glyph_cnt);
+    TEST_ASSERT_EQUAL_UINT32(128, atlas->draw_buf->header.w);
+    TEST_ASSERT_EQUAL_UINT32(64, atlas->draw_buf->header.h);
+    TEST_ASSERT_EQUAL_UINT32(glyph_cnt, atlas_old->glyph_cnt);
+    lv_font_glyph_atlas_release(atlas_old);
+
+    lv_obj_invalidate(label);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_UINT32(glyph_cnt, atlas->glyph_cnt);
+    lv_font_glyph_atlas_release(atlas);
+
+    lv_obj_delete(label);
+    lv_font_glyph_atlas_delete(font);
+    TEST_ASSERT_NULL(lv_font_glyph_atlas_acquire(font));
+}
+#endif
+
 #endif
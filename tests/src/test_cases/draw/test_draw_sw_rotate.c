@@ -221,4 +221,73 @@ void test_rotate270_ARGB8888(void)
     TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedArray, dstArray, sizeof(dstArray));
 }
 
+
+/*Larger than a rotation tile and not a multiple of it to cover the partial tiles on the edges*/
+#define TILED_W 70
+#define TILED_H 45
+
+void test_rotate90_ARGB8888_tiled(void)
+{
+    static uint32_t srcArray[TILED_W * TILED_H];
+    static uint32_t dstArray[TILED_H * TILED_W];
+
+    for(uint32_t i = 0; i < TILED_W * TILED_H; i++) srcArray[i] = i;
+
+    lv_draw_sw_rotate(srcArray, dstArray,
+                      TILED_W, TILED_H,
+                      TILED_W * sizeof(uint32_t),
+                      TILED_H * sizeof(uint32_t),
+                      LV_DISPLAY_ROTATION_90,
+                      LV_COLOR_FORMAT_ARGB8888);
+
+    for(int32_t y = 0; y < TILED_H; y++) {
+        for(int32_t x = 0; x < TILED_W; x++) {
+            TEST_ASSERT_EQUAL_UINT32(srcArray[y * TILED_W + x], dstArray[x * TILED_H + (TILED_H - y - 1)]);
+        }
+    }
+}
+
+void test_rotate270_RGB565_tiled(void)
+{
+    static uint16_t srcArray[TILED_W * TILED_H];
+    static uint16_t dstArray[TILED_H * TILED_W];
+
+    for(uint32_t i = 0; i < TILED_W * TILED_H; i++) srcArray[i] = (uint16_t)i;
+
+    lv_draw_sw_rotate(srcArray, dstArray,
+                      TILED_W, TILED_H,
+                      TILED_W * sizeof(uint16_t),
+                      TILED_H * sizeof(uint16_t),
+                      LV_DISPLAY_ROTATION_270,
+                      LV_COLOR_FORMAT_RGB565);
+
+    for(int32_t y = 0; y < TILED_H; y++) {
+        for(int32_t x = 0; x < TILED_W; x++) {
+            TEST_ASSERT_EQUAL_UINT16(srcArray[y * TILED_W + x], dstArray[(TILED_W - x - 1) * TILED_H + y]);
+        }
+    }
+}
+
+void test_rotate90_RGB888_tiled(void)
+{
+    static uint8_t srcArray[TILED_W * TILED_H * 3];
+    static uint8_t dstArray[TILED_H * TILED_W * 3];
+
+    for(uint32_t i = 0; i < TILED_W * TILED_H * 3; i++) srcArray[i] = (uint8_t)(i * 7);
+
+    lv_draw_sw_rotate(srcArray, dstArray,
+                      TILED_W, TILED_H,
+                      TILED_W * 3,
+                      TILED_H * 3,
+                      LV_DISPLAY_ROTATION_90,
+                      LV_COLOR_FORMAT_RGB888);
+
+    for(int32_t y = 0; y < TILED_H; y++) {
+        for(int32_t x = 0; x < TILED_W; x++) {
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(&srcArray[(y * TILED_W + x) * 3],
+                                          &dstArray[((TILED_W - x - 1) * TILED_H + y) * 3], 3);
+        }
+    }
+}
+
 #endif
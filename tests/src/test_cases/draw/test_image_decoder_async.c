@@ -0,0 +1,336 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+#include "lv_test_helpers.h"
+
+#if LV_USE_IMAGE_DECODER_ASYNC
+
+#include <unistd.h>
+
+void setUp(void)
+{
+    lv_image_cache_drop(NULL);
+    lv_image_decoder_async_set_enabled(true);
+}
+
+void tearDown(void)
+{
+    lv_image_decoder_async_set_enabled(false);
+    lv_obj_clean(lv_screen_active());
+}
+
+static void create_images(void)
+{
+    lv_obj_clean(lv_screen_active());
+
+    lv_obj_t * img;
+    lv_obj_t * label;
+
+    LV_IMG_DECLARE(test_img_lvgl_logo_png);
+    img = lv_image_create(lv_screen_active());
+    lv_image_set_src(img, &test_img_lvgl_logo_png);
+    lv_obj_align(img, LV_ALIGN_CENTER, -100, -20);
+
+    label = lv_label_create(lv_screen_active());
+    lv_label_set_text(label, "Array");
+    lv_obj_align(label, LV_ALIGN_CENTER, -100, 20);
+
+    img = lv_image_create(lv_screen_active());
+    lv_image_set_src(img, "A:src/test_assets/test_img_lvgl_logo.png");
+    lv_obj_align(img, LV_ALIGN_CENTER, 100, -100);
+
+    label = lv_label_create(lv_screen_active());
+    lv_label_set_text(label, "File (32 bit)");
+    lv_obj_align(label, LV_ALIGN_CENTER, 100, -60);
+
+    img = lv_image_create(lv_screen_active());
+    lv_image_set_src(img, "A:src/test_assets/test_img_lvgl_logo_8bit_palette.png");
+    lv_obj_align(img, LV_ALIGN_CENTER, 100, 60);
+
+    label = lv_label_create(lv_screen_active());
+    lv_label_set_text(label, "File (8 bit palette)");
+    lv_obj_align(label, LV_ALIGN_CENTER, 100, 100);
+}
+
+static void wait_for_workers(void)
+{
+    uint32_t i;
+    for(i = 0; i < 5000 && lv_image_decoder_async_get_pending_cnt() > 0; i++) {
+        usleep(1000);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, lv_image_decoder_async_get_pending_cnt());
+
+    /*Let the timer invalidate the decoded images*/
+    lv_test_wait(100);
+}
+
+void test_image_decoder_async_request(void)
+{
+    /*Not cached file: it's queued*/
+    TEST_ASSERT_TRUE(lv_image_decoder_async_request("A:src/test_assets/test_img_lvgl_logo.png", NULL, NULL, NULL));
+
+    /*Plain C arrays are fast to open and are never deferred*/
+    LV_IMG_DECLARE(test_arc_bg);
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request(&test_arc_bg, NULL, NULL, NULL));
+
+    wait_for_workers();
+
+    /*It's in the cache now*/
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request("A:src/test_assets/test_img_lvgl_logo.png", NULL, NULL, NULL));
+
+    /*Disabled: never deferred*/
+    lv_image_cache_drop(NULL);
+    lv_image_decoder_async_set_enabled(false);
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request("A:src/test_assets/test_img_lvgl_logo.png", NULL, NULL, NULL));
+}
+
+void test_image_decoder_async_request_downscaled(void)
+{
+#if LV_USE_LIBJPEG_TURBO
+    /*tjpgd doesn't decode downscaled images*/
+    lv_tjpgd_deinit();
+
+    const char * src = "A:src/test_assets/test_img_lvgl_logo.jpg";
+    lv_image_decoder_args_t args;
+    lv_test_image_decoder_args_downscaled(&args, 26, 8);
+
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, src, &args));
+    TEST_ASSERT_NOT_NULL(dsc.cache_entry);
+    lv_image_decoder_close(&dsc);
+
+    /*Only the draws at the same size can use the downscaled version*/
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request(src, &args, NULL, NULL));
+    TEST_ASSERT_TRUE(lv_image_decoder_async_request(src, NULL, NULL, NULL));
+    wait_for_workers();
+
+    /*The workers decode the original size which is good for any size*/
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request(src, NULL, NULL, NULL));
+    args.target_w = 13;
+    args.target_h = 4;
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request(src, &args, NULL, NULL));
+
+    lv_image_cache_drop(NULL);
+    lv_tjpgd_init();
+#endif
+}
+
+void test_image_decoder_async_draw(void)
+{
+    create_images();
+    lv_refr_now(NULL);
+
+    wait_for_workers();
+
+    /*The images are drawn from the cache as if they were decoded synchronously*/
+    TEST_ASSERT_EQUAL_SCREENSHOT("libs/png_1.png");
+
+    size_t mem_before = lv_test_get_free_mem();
+    uint32_t i;
+    for(i = 0; i < 10; i++) {
+        lv_image_cache_drop(NULL);
+        create_images();
+        lv_refr_now(NULL);
+        wait_for_workers();
+    }
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("libs/png_1.png");
+
+    TEST_ASSERT_MEM_LEAK_LESS_THAN(mem_before, 40);
+}
+
+static void invalidate_area_cb(lv_event_t * e)
+{
+    lv_area_t * inv_area = lv_event_get_user_data(e);
+    const lv_area_t * area = lv_event_get_param(e);
+    if(lv_area_get_width(inv_area) <= 0) *inv_area = *area;
+    else _lv_area_join(inv_area, inv_area, area);
+}
+
+void test_image_decoder_async_invalidate_placeholders(void)
+{
+    /*Images drawn by other widgets than lv_image are redrawn when they are decoded too*/
+    lv_image_decoder_async_set_enabled(false);
+    lv_obj_t * imagebutton = lv_imagebutton_create(lv_screen_active());
+    lv_imagebutton_set_src(imagebutton, LV_IMAGEBUTTON_STATE_RELEASED, NULL,
+                           "A:src/test_assets/test_img_lvgl_logo_8bit_palette.png", NULL);
+    lv_obj_set_width(imagebutton, 105);
+    lv_obj_align(imagebutton, LV_ALIGN_TOP_LEFT, 20, 20);
+
+    static const void * anim_srcs[] = {"A:src/test_assets/test_img_lvgl_logo.png"};
+    lv_obj_t * animimg = lv_animimg_create(lv_screen_active());
+    lv_animimg_set_src(animimg, anim_srcs, 1);
+    lv_image_set_src(animimg, anim_srcs[0]); /*Show the first frame without starting the animation*/
+    lv_obj_align(animimg, LV_ALIGN_BOTTOM_RIGHT, -20, -20);
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("draw/image_decoder_async_placeholders.png");
+
+    /*Draw the placeholders first*/
+    lv_image_cache_drop(NULL);
+    lv_image_decoder_async_set_enabled(true);
+    lv_obj_invalidate(lv_screen_active());
+    lv_refr_now(NULL);
+
+    /*The areas of the placeholders are invalidated when the images are decoded*/
+    lv_area_t inv_area;
+    lv_area_set(&inv_area, 0, 0, -1, -1);
+    lv_display_t * disp = lv_display_get_default();
+    lv_display_add_event_cb(disp, invalidate_area_cb, LV_EVENT_INVALIDATE_AREA, &inv_area);
+    wait_for_workers();
+    lv_display_remove_event_cb_with_user_data(disp, invalidate_area_cb, &inv_area);
+
+    lv_area_t coords;
+    lv_obj_get_coords(imagebutton, &coords);
+    TEST_ASSERT_TRUE(_lv_area_is_in(&coords, &inv_area, 0));
+    lv_obj_get_coords(animimg, &coords);
+    TEST_ASSERT_TRUE(_lv_area_is_in(&coords, &inv_area, 0));
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("draw/image_decoder_async_placeholders.png");
+}
+
+void test_image_decoder_async_invalidate_transformed_placeholder(void)
+{
+    lv_obj_t * img = lv_image_create(lv_screen_active());
+    lv_image_set_src(img, "A:src/test_assets/test_img_lvgl_logo.png");
+    lv_image_set_scale(img, 512);
+    lv_obj_center(img);
+
+    /*Draw the placeholder first*/
+    lv_refr_now(NULL);
+
+    lv_area_t inv_area;
+    lv_area_set(&inv_area, 0, 0, -1, -1);
+    lv_display_t * disp = lv_display_get_default();
+    lv_display_add_event_cb(disp, invalidate_area_cb, LV_EVENT_INVALIDATE_AREA, &inv_area);
+    wait_for_workers();
+    lv_display_remove_event_cb_with_user_data(disp, invalidate_area_cb, &inv_area);
+
+    /*The placeholder covers the scaled image which is larger than the object*/
+    lv_area_t coords;
+    lv_obj_get_coords(img, &coords);
+    lv_point_t pivot;
+    lv_image_get_pivot(img, &pivot);
+    lv_area_t drawn_area;
+    _lv_image_buf_get_transformed_area(&drawn_area, lv_area_get_width(&coords), lv_area_get_height(&coords),
+                                       0, 512, 512, &pivot);
+    lv_area_move(&drawn_area, coords.x1, coords.y1);
+    TEST_ASSERT_FALSE(_lv_area_is_in(&drawn_area, &coords, 0));
+
+    /*It's clipped to the area where the object can draw*/
+    lv_area_t clip_area = coords;
+    int32_t ext_size = _lv_obj_get_ext_draw_size(img);
+    lv_area_increase(&clip_area, ext_size, ext_size);
+    TEST_ASSERT_TRUE(_lv_area_intersect(&drawn_area, &drawn_area, &clip_area));
+    TEST_ASSERT_TRUE(_lv_area_is_in(&drawn_area, &inv_area, 0));
+}
+
+void test_image_decoder_async_canvas(void)
+{
+    /*A canvas is not redrawn so its images are drawn directly*/
+    LV_DRAW_BUF_DEFINE(draw_buf, 120, 120, LV_COLOR_FORMAT_ARGB8888);
+    lv_obj_t * canvas = lv_canvas_create(lv_screen_active());
+    lv_canvas_set_draw_buf(canvas, &draw_buf);
+    lv_canvas_fill_bg(canvas, lv_color_white(), LV_OPA_COVER);
+
+    lv_layer_t layer;
+    lv_canvas_init_layer(canvas, &layer);
+    lv_draw_image_dsc_t dsc;
+    lv_draw_image_dsc_init(&dsc);
+    dsc.src = "A:src/test_assets/test_img_lvgl_logo.png";
+    lv_area_t coords = {0, 0, 104, 32};
+    lv_draw_image(&layer, &dsc, &coords);
+    lv_canvas_finish_layer(canvas, &layer);
+
+    TEST_ASSERT_EQUAL_UINT32(0, lv_image_decoder_async_get_pending_cnt());
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request(dsc.src, NULL, NULL, NULL));
+}
+
+void test_image_decoder_async_prefetch(void)
+{
+    const void * srcs[] = {
+        "A:src/test_assets/test_img_lvgl_logo.png",
+        "A:src/test_assets/test_img_lvgl_logo_8bit_palette.png",
+        NULL,
+    };
+
+    /*Works even if drawing asynchronously is disabled*/
+    lv_image_decoder_async_set_enabled(false);
+    TEST_ASSERT_EQUAL_UINT32(2, lv_image_cache_prefetch(srcs, 3, LV_IMAGE_CACHE_PREFETCH_PRIO_HIGH));
+    wait_for_workers();
+
+    /*Already cached*/
+    TEST_ASSERT_EQUAL_UINT32(0, lv_image_cache_prefetch(srcs, 3, LV_IMAGE_CACHE_PREFETCH_PRIO_HIGH));
+    lv_image_decoder_async_set_enabled(true);
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request(srcs[0], NULL, NULL, NULL));
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request(srcs[1], NULL, NULL, NULL));
+}
+
+void test_image_decoder_async_prefetch_obj_tree(void)
+{
+    lv_obj_t * scr = lv_obj_create(NULL);
+    lv_obj_set_style_bg_image_src(scr, "A:src/test_assets/test_img_lvgl_logo.png", 0);
+
+    lv_obj_t * imagebutton = lv_imagebutton_create(scr);
+    lv_imagebutton_set_src(imagebutton, LV_IMAGEBUTTON_STATE_RELEASED, NULL,
+                           "A:src/test_assets/test_img_lvgl_logo_8bit_palette.png", NULL);
+
+    /*Same as the background, queued once*/
+    lv_obj_t * img = lv_image_create(scr);
+    lv_image_set_src(img, "A:src/test_assets/test_img_lvgl_logo.png");
+
+    TEST_ASSERT_EQUAL_UINT32(2, lv_obj_tree_prefetch_images(scr, LV_IMAGE_CACHE_PREFETCH_PRIO_HIGH));
+    wait_for_workers();
+
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request("A:src/test_assets/test_img_lvgl_logo.png", NULL, NULL, NULL));
+    TEST_ASSERT_FALSE(lv_image_decoder_async_request("A:src/test_assets/test_img_lvgl_logo_8bit_palette.png", NULL, NULL, NULL));
+
+    lv_obj_delete(scr);
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_image_decoder_async_request(void)
+{
+}
+
+void test_image_decoder_async_request_downscaled(void)
+{
+}
+
+void test_image_decoder_async_draw(void)
+{
+}
+
+void test_image_decoder_async_invalidate_placeholders(void)
+{
+}
+
+void test_image_decoder_async_invalidate_transformed_placeholder(void)
+{
+}
+
+void test_image_decoder_async_canvas(void)
+{
+}
+
+void test_image_decoder_async_prefetch(void)
+{
+}
+
+void test_image_decoder_async_prefetch_obj_tree(void)
+{
+}
+
+#endif /*LV_USE_IMAGE_DECODER_ASYNC*/
+
+#endif
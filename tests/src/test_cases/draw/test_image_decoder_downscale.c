@@ -0,0 +1,175 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "lv_test_helpers.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_LIBPNG && LV_USE_LIBJPEG_TURBO && LV_CACHE_DEF_SIZE > 0
+
+#define PNG_SRC "A:src/test_assets/test_img_lvgl_logo.png"
+#define JPG_SRC "A:src/test_assets/test_img_lvgl_logo.jpg"
+
+void setUp(void)
+{
+    lv_test_image_decoder_use_png_jpg_libs();
+
+    lv_image_cache_drop(NULL);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_screen_active());
+    lv_image_cache_drop(NULL);
+
+    lv_test_image_decoder_restore_png_jpg();
+}
+
+void test_image_decoder_downscale_level(void)
+{
+    lv_image_decoder_dsc_t dsc;
+    lv_memzero(&dsc, sizeof(dsc));
+    dsc.header.w = 105;
+    dsc.header.h = 33;
+
+    TEST_ASSERT_EQUAL_UINT32(0, lv_image_decoder_get_downscale(&dsc));
+
+    /*ceil(105 / 2) x ceil(33 / 2) = 53 x 17 is still large enough*/
+    dsc.args.target_w = 52;
+    dsc.args.target_h = 16;
+    TEST_ASSERT_EQUAL_UINT32(1, lv_image_decoder_get_downscale(&dsc));
+
+    dsc.args.target_w = 54;
+    TEST_ASSERT_EQUAL_UINT32(0, lv_image_decoder_get_downscale(&dsc));
+
+    /*Only one dimension is limited*/
+    dsc.args.target_w = 0;
+    dsc.args.target_h = 9;
+    TEST_ASSERT_EQUAL_UINT32(2, lv_image_decoder_get_downscale(&dsc));
+
+    /*At most 1/8*/
+    dsc.args.target_w = 1;
+    dsc.args.target_h = 1;
+    TEST_ASSERT_EQUAL_UINT32(LV_IMAGE_DECODER_DOWNSCALE_MAX, lv_image_decoder_get_downscale(&dsc));
+}
+
+void test_image_decoder_downscale_jpg(void)
+{
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_test_image_decoder_open_downscaled(&dsc, JPG_SRC, 26, 8));
+    TEST_ASSERT_NOT_NULL(dsc.cache_entry);
+    TEST_ASSERT_EQUAL_INT32(27, dsc.decoded->header.w);
+    TEST_ASSERT_EQUAL_INT32(9, dsc.decoded->header.h);
+    const lv_draw_buf_t * downscaled = dsc.decoded;
+    lv_image_decoder_close(&dsc);
+
+    /*The downscaled image is cached separately from the original*/
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_test_image_decoder_open_downscaled(&dsc, JPG_SRC, 26, 8));
+    TEST_ASSERT_EQUAL_PTR(downscaled, dsc.decoded);
+    lv_image_decoder_close(&dsc);
+
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, JPG_SRC, NULL));
+    TEST_ASSERT_EQUAL_INT32(105, dsc.decoded->header.w);
+    TEST_ASSERT_EQUAL_INT32(33, dsc.decoded->header.h);
+    lv_image_decoder_close(&dsc);
+
+    /*Dropping the image drops all of its versions*/
+    lv_image_cache_drop(JPG_SRC);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_cache_get_size(LV_GLOBAL_DEFAULT()->img_cache, NULL));
+}
+
+void test_image_decoder_downscale_png(void)
+{
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, PNG_SRC, NULL));
+    lv_draw_buf_t * whole = lv_draw_buf_dup(dsc.decoded);
+    lv_image_decoder_close(&dsc);
+
+    /*Else the cached original would be used*/
+    lv_image_cache_drop(PNG_SRC);
+
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_test_image_decoder_open_downscaled(&dsc, PNG_SRC, 53, 17));
+    const lv_draw_buf_t * half = dsc.decoded;
+    TEST_ASSERT_EQUAL_INT32(53, half->header.w);
+    TEST_ASSERT_EQUAL_INT32(17, half->header.h);
+    TEST_ASSERT_EQUAL(LV_COLOR_FORMAT_ARGB8888, half->header.cf);
+
+    /*Each pixel is the average of a 2x2 block weighted by the opacity*/
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < half->header.h - 1; y++) {
+        for(x = 0; x < half->header.w - 1; x++) {
+            uint32_t sum[4] = {0};
+            int32_t i;
+            for(i = 0; i < 4; i++) {
+                const uint8_t * px = whole->data + (y * 2 + i / 2) * whole->header.stride + (x * 2 + i % 2) * 4;
+                sum[0] += px[0] * px[3];
+                sum[1] += px[1] * px[3];
+                sum[2] += px[2] * px[3];
+                sum[3] += px[3];
+            }
+
+            const uint8_t * px = half->data + y * half->header.stride + x * 4;
+            TEST_ASSERT_EQUAL_UINT8(sum[3] / 4, px[3]);
+            if(sum[3]) {
+                TEST_ASSERT_EQUAL_UINT8(sum[0] / sum[3], px[0]);
+                TEST_ASSERT_EQUAL_UINT8(sum[1] / sum[3], px[1]);
+                TEST_ASSERT_EQUAL_UINT8(sum[2] / sum[3], px[2]);
+            }
+        }
+    }
+
+    lv_image_decoder_close(&dsc);
+    lv_draw_buf_destroy(whole);
+}
+
+void test_image_decoder_downscale_draw(void)
+{
+    lv_obj_t * img = lv_image_create(lv_screen_active());
+    lv_image_set_src(img, PNG_SRC);
+    lv_image_set_scale(img, 128);
+    lv_obj_align(img, LV_ALIGN_CENTER, -100, 0);
+
+    img = lv_image_create(lv_screen_active());
+    lv_image_set_src(img, JPG_SRC);
+    lv_image_set_scale(img, 64);
+    lv_obj_align(img, LV_ALIGN_CENTER, 100, 0);
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("draw/image_decoder_downscale.png");
+
+    /*Only the downscaled images were decoded*/
+    lv_image_cache_stats_t stats;
+    lv_image_cache_get_stats(&stats);
+    uint32_t png_size = lv_draw_buf_width_to_stride(53, LV_COLOR_FORMAT_ARGB8888) * 17;
+    uint32_t jpg_size = lv_draw_buf_width_to_stride(27, LV_COLOR_FORMAT_RGB888) * 9;
+    TEST_ASSERT_EQUAL_UINT32(png_size + jpg_size, stats.decoded.size);
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_image_decoder_downscale_level(void)
+{
+}
+
+void test_image_decoder_downscale_jpg(void)
+{
+}
+
+void test_image_decoder_downscale_png(void)
+{
+}
+
+void test_image_decoder_downscale_draw(void)
+{
+}
+
+#endif
+
+#endif
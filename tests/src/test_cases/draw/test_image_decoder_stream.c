@@ -0,0 +1,145 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "lv_test_helpers.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_LIBPNG && LV_USE_LIBJPEG_TURBO && LV_CACHE_DEF_SIZE > 0
+
+#define PNG_SRC "A:src/test_assets/test_img_lvgl_logo.png"
+#define JPG_SRC "A:src/test_assets/test_img_lvgl_logo.jpg"
+
+static size_t cache_max_size;
+
+void setUp(void)
+{
+    lv_test_image_decoder_use_png_jpg_libs();
+
+    lv_image_cache_drop(NULL);
+    cache_max_size = lv_cache_get_max_size(LV_GLOBAL_DEFAULT()->img_cache, NULL);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_screen_active());
+    lv_image_cache_drop(NULL);
+    lv_cache_set_max_size(LV_GLOBAL_DEFAULT()->img_cache, cache_max_size, NULL);
+
+    lv_test_image_decoder_restore_png_jpg();
+}
+
+/*Decode the image at once and return a copy of it*/
+static lv_draw_buf_t * decode_whole(const void * src)
+{
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, src, NULL));
+    TEST_ASSERT_NOT_NULL(dsc.decoded);
+
+    lv_draw_buf_t * copy = lv_draw_buf_dup(dsc.decoded);
+    TEST_ASSERT_NOT_NULL(copy);
+    lv_image_decoder_close(&dsc);
+
+    return copy;
+}
+
+/*Open the image with an image cache which is too small for it*/
+static void open_streamed(lv_image_decoder_dsc_t * dsc, const void * src)
+{
+    lv_image_cache_drop(NULL);
+    lv_cache_set_max_size(LV_GLOBAL_DEFAULT()->img_cache, 1024, NULL);
+
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(dsc, src, NULL));
+    TEST_ASSERT_NULL(dsc->decoded);
+    TEST_ASSERT_NULL(dsc->cache_entry);
+}
+
+/*Decode the rows between y1 and y2 in bands and compare them with the whole image*/
+static void check_bands(lv_image_decoder_dsc_t * dsc, const lv_draw_buf_t * whole, int32_t y1, int32_t y2)
+{
+    lv_area_t full_area = {0, y1, whole->header.w - 1, y2};
+    lv_area_t decoded_area = {LV_COORD_MIN, LV_COORD_MIN, LV_COORD_MIN, LV_COORD_MIN};
+    uint32_t row_size = whole->header.w * lv_color_format_get_size(whole->header.cf);
+    int32_t y = y1;
+
+    while(lv_image_decoder_get_area(dsc, &full_area, &decoded_area) == LV_RESULT_OK) {
+        const lv_draw_buf_t * band = dsc->decoded;
+        TEST_ASSERT_EQUAL_INT32(y, decoded_area.y1);
+        TEST_ASSERT_EQUAL_INT32(lv_area_get_height(&decoded_area), band->header.h);
+        TEST_ASSERT_LESS_OR_EQUAL_INT32(LV_IMAGE_DECODER_STREAM_BAND_HEIGHT, band->header.h);
+
+        int32_t i;
+        for(i = 0; i < band->header.h; i++) {
+            TEST_ASSERT_EQUAL_MEMORY(whole->data + (y + i) * whole->header.stride,
+                                     band->data + i * band->header.stride, row_size);
+        }
+        y = decoded_area.y2 + 1;
+    }
+
+    TEST_ASSERT_EQUAL_INT32(y2 + 1, y);
+}
+
+static void check_stream(const void * src)
+{
+    lv_draw_buf_t * whole = decode_whole(src);
+    int32_t h = whole->header.h;
+
+    lv_image_decoder_dsc_t dsc;
+    open_streamed(&dsc, src);
+    check_bands(&dsc, whole, 0, h - 1);
+    check_bands(&dsc, whole, h / 2, h - 1);     /*Skip the rows above*/
+    check_bands(&dsc, whole, 3, h / 2);         /*Start again to go back*/
+    lv_image_decoder_close(&dsc);
+
+    lv_draw_buf_destroy(whole);
+}
+
+void test_image_decoder_stream_png(void)
+{
+    check_stream(PNG_SRC);
+}
+
+void test_image_decoder_stream_jpg(void)
+{
+    check_stream(JPG_SRC);
+}
+
+void test_image_decoder_stream_draw(void)
+{
+    lv_image_cache_drop(NULL);
+    lv_cache_set_max_size(LV_GLOBAL_DEFAULT()->img_cache, 1024, NULL);
+
+    lv_obj_t * img = lv_image_create(lv_screen_active());
+    lv_image_set_src(img, PNG_SRC);
+    lv_obj_center(img);
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("libs/png_2.png");
+
+    /*Nothing was cached*/
+    TEST_ASSERT_EQUAL_UINT32(0, lv_cache_get_size(LV_GLOBAL_DEFAULT()->img_cache, NULL));
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_image_decoder_stream_png(void)
+{
+}
+
+void test_image_decoder_stream_jpg(void)
+{
+}
+
+void test_image_decoder_stream_draw(void)
+{
+}
+
+#endif
+
+#endif
@@ -0,0 +1,163 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "lv_test_helpers.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_DRAW_SW && LV_DRAW_SW_KEEP_INDEXED && LV_BIN_DECODER_RAM_LOAD && LV_CACHE_DEF_SIZE > 0
+
+#define SRC(cf)     "A:src/test_files/binimages/cogwheel." cf ".bin"
+
+static const char * srcs[] = {SRC("I1"), SRC("I2"), SRC("I4"), SRC("I8")};
+
+void setUp(void)
+{
+    lv_image_cache_drop(NULL);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_screen_active());
+    lv_image_cache_drop(NULL);
+}
+
+/*Decode an image to ARGB8888 like without LV_DRAW_SW_KEEP_INDEXED*/
+static lv_draw_buf_t * decode_argb8888(const char * src)
+{
+    lv_image_decoder_args_t args;
+    lv_memzero(&args, sizeof(args));
+    args.no_cache = true;
+
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, src, &args));
+    TEST_ASSERT_EQUAL(LV_COLOR_FORMAT_ARGB8888, dsc.decoded->header.cf);
+    lv_draw_buf_t * decoded = lv_draw_buf_dup(dsc.decoded);
+    lv_image_decoder_close(&dsc);
+
+    return decoded;
+}
+
+void test_image_indexed_cache(void)
+{
+    uint32_t i;
+    for(i = 0; i < sizeof(srcs) / sizeof(srcs[0]); i++) {
+        lv_image_decoder_dsc_t dsc;
+        TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, srcs[i], NULL));
+        TEST_ASSERT_NOT_NULL(dsc.cache_entry);
+        TEST_ASSERT_TRUE(LV_COLOR_FORMAT_IS_INDEXED(dsc.decoded->header.cf));
+        lv_image_decoder_close(&dsc);
+    }
+
+    /*Only the palettes and the indices are cached*/
+    uint32_t size = 0;
+    lv_color_format_t cf;
+    for(cf = LV_COLOR_FORMAT_I1; cf <= LV_COLOR_FORMAT_I8; cf++) {
+        size += LV_COLOR_INDEXED_PALETTE_SIZE(cf) * sizeof(lv_color32_t) + lv_draw_buf_width_to_stride(100, cf) * 100;
+    }
+
+    lv_image_cache_stats_t stats;
+    lv_image_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(size, stats.decoded.size);
+    TEST_ASSERT_LESS_THAN_UINT32(lv_draw_buf_width_to_stride(100, LV_COLOR_FORMAT_ARGB8888) * 100, size);
+}
+
+void test_image_indexed_convert(void)
+{
+    /*Start in the middle of the bytes*/
+    lv_area_t area = {3, 5, 93, 90};
+    int32_t w = lv_area_get_width(&area);
+    int32_t h = lv_area_get_height(&area);
+    lv_color32_t * buf = lv_malloc(w * h * sizeof(lv_color32_t));
+
+    uint32_t i;
+    for(i = 0; i < sizeof(srcs) / sizeof(srcs[0]); i++) {
+        lv_draw_buf_t * expected = decode_argb8888(srcs[i]);
+
+        lv_image_decoder_dsc_t dsc;
+        TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, srcs[i], NULL));
+        const lv_draw_buf_t * indexed = dsc.decoded;
+        lv_draw_sw_indexed_to_argb8888(buf, w * sizeof(lv_color32_t), indexed->data, indexed->header.stride,
+                                       indexed->header.cf, &area);
+        lv_image_decoder_close(&dsc);
+
+        int32_t y;
+        for(y = 0; y < h; y++) {
+            const uint8_t * row = lv_draw_buf_goto_xy(expected, area.x1, area.y1 + y);
+            TEST_ASSERT_EQUAL_MEMORY(row, buf + y * w, w * sizeof(lv_color32_t));
+        }
+
+        lv_draw_buf_destroy(expected);
+    }
+
+    lv_free(buf);
+}
+
+static void images_create(const void * srcs_to_draw[])
+{
+    uint32_t i;
+    for(i = 0; i < sizeof(srcs) / sizeof(srcs[0]); i++) {
+        lv_obj_t * img = lv_image_create(lv_screen_active());
+        lv_image_set_src(img, srcs_to_draw[i]);
+        lv_obj_set_pos(img, 50 + i * 180, 20);
+
+        img = lv_image_create(lv_screen_active());
+        lv_image_set_src(img, srcs_to_draw[i]);
+        lv_image_set_rotation(img, 300);
+        lv_image_set_scale(img, 300);
+        lv_obj_set_pos(img, 50 + i * 180, 170);
+
+        img = lv_image_create(lv_screen_active());
+        lv_image_set_src(img, srcs_to_draw[i]);
+        lv_obj_set_style_image_recolor(img, lv_palette_main(LV_PALETTE_RED), 0);
+        lv_obj_set_style_image_recolor_opa(img, LV_OPA_50, 0);
+        lv_obj_set_pos(img, 50 + i * 180, 350);
+    }
+}
+
+void test_image_indexed_draw(void)
+{
+    images_create((const void **)srcs);
+    TEST_ASSERT_EQUAL_SCREENSHOT("draw/image_indexed.png");
+    lv_obj_clean(lv_screen_active());
+
+    /*It looks the same as the images converted to ARGB8888 in advance*/
+    lv_draw_buf_t * converted[sizeof(srcs) / sizeof(srcs[0])];
+    uint32_t i;
+    for(i = 0; i < sizeof(srcs) / sizeof(srcs[0]); i++) {
+        converted[i] = decode_argb8888(srcs[i]);
+    }
+
+    images_create((const void **)converted);
+    TEST_ASSERT_EQUAL_SCREENSHOT("draw/image_indexed.png");
+    lv_obj_clean(lv_screen_active());
+
+    for(i = 0; i < sizeof(srcs) / sizeof(srcs[0]); i++) {
+        lv_draw_buf_destroy(converted[i]);
+    }
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_image_indexed_cache(void)
+{
+}
+
+void test_image_indexed_convert(void)
+{
+}
+
+void test_image_indexed_draw(void)
+{
+}
+
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "lv_test_helpers.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_IMAGE_MIPMAP
+
+LV_IMAGE_DECLARE(test_image_cogwheel_argb8888);
+LV_IMAGE_DECLARE(test_image_cogwheel_xrgb8888);
+
+void setUp(void)
+{
+    lv_image_cache_drop(NULL);
+    lv_image_cache_set_mipmap_enabled(true);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_screen_active());
+    lv_image_cache_set_mipmap_enabled(false);
+    lv_image_cache_drop(NULL);
+}
+
+void test_image_mipmap_create(void)
+{
+    const lv_image_dsc_t * src = &test_image_cogwheel_argb8888;
+
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_test_image_decoder_open_downscaled(&dsc, src, 30, 30));
+    const lv_draw_buf_t * mipmap = dsc.decoded;
+    TEST_ASSERT_NOT_NULL(dsc.cache_entry);
+    TEST_ASSERT_EQUAL_INT32(50, mipmap->header.w);
+    TEST_ASSERT_EQUAL_INT32(50, mipmap->header.h);
+    TEST_ASSERT_EQUAL(LV_COLOR_FORMAT_ARGB8888, mipmap->header.cf);
+
+    /*Each pixel is the average of a 2x2 block weighted by the opacity*/
+    int32_t x;
+    int32_t y;
+    for(y = 0; y < 50; y++) {
+        for(x = 0; x < 50; x++) {
+            uint32_t sum[4] = {0};
+            int32_t i;
+            for(i = 0; i < 4; i++) {
+                const uint8_t * px = src->data + (y * 2 + i / 2) * src->header.stride + (x * 2 + i % 2) * 4;
+                sum[0] += px[0] * px[3];
+                sum[1] += px[1] * px[3];
+                sum[2] += px[2] * px[3];
+                sum[3] += px[3];
+            }
+
+            const uint8_t * px = mipmap->data + y * mipmap->header.stride + x * 4;
+            TEST_ASSERT_EQUAL_UINT8((sum[3] + 2) / 4, px[3]);
+            if(sum[3]) {
+                TEST_ASSERT_EQUAL_UINT8((sum[0] + sum[3] / 2) / sum[3], px[0]);
+                TEST_ASSERT_EQUAL_UINT8((sum[1] + sum[3] / 2) / sum[3], px[1]);
+                TEST_ASSERT_EQUAL_UINT8((sum[2] + sum[3] / 2) / sum[3], px[2]);
+            }
+        }
+    }
+    lv_image_decoder_close(&dsc);
+
+    /*It's created only once*/
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_test_image_decoder_open_downscaled(&dsc, src, 30, 30));
+    TEST_ASSERT_EQUAL_PTR(mipmap, dsc.decoded);
+    lv_image_decoder_close(&dsc);
+
+    /*The smallest level which is still large enough is used*/
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_test_image_decoder_open_downscaled(&dsc, src, 13, 13));
+    TEST_ASSERT_EQUAL_INT32(13, dsc.decoded->header.w);
+    lv_image_decoder_close(&dsc);
+
+    /*The mipmaps are dropped with the image*/
+    lv_image_cache_drop(src);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_cache_get_size(LV_GLOBAL_DEFAULT()->img_cache, NULL));
+}
+
+void test_image_mipmap_not_used(void)
+{
+    lv_image_decoder_dsc_t dsc;
+
+    /*Not needed for larger than half size*/
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_test_image_decoder_open_downscaled(&dsc, &test_image_cogwheel_argb8888, 51, 51));
+    TEST_ASSERT_EQUAL_INT32(100, dsc.decoded->header.w);
+    lv_image_decoder_close(&dsc);
+
+    /*Disabled*/
+    lv_image_cache_set_mipmap_enabled(false);
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_test_image_decoder_open_downscaled(&dsc, &test_image_cogwheel_argb8888, 30, 30));
+    TEST_ASSERT_EQUAL_INT32(100, dsc.decoded->header.w);
+    lv_image_decoder_close(&dsc);
+    lv_image_cache_set_mipmap_enabled(true);
+
+    /*The content of a draw buffer can change*/
+    lv_draw_buf_t * draw_buf = lv_draw_buf_create(100, 100, LV_COLOR_FORMAT_ARGB8888, 0);
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_test_image_decoder_open_downscaled(&dsc, draw_buf, 30, 30));
+    TEST_ASSERT_EQUAL_PTR(draw_buf, dsc.decoded);
+    lv_image_decoder_close(&dsc);
+    lv_draw_buf_destroy(draw_buf);
+}
+
+void test_image_mipmap_draw(void)
+{
+    lv_obj_t * img = lv_image_create(lv_screen_active());
+    lv_image_set_src(img, &test_image_cogwheel_argb8888);
+    lv_image_set_scale(img, 64);
+    lv_obj_align(img, LV_ALIGN_CENTER, -100, 0);
+
+    img = lv_image_create(lv_screen_active());
+    lv_image_set_src(img, &test_image_cogwheel_xrgb8888);
+    lv_image_set_scale(img, 100);
+    lv_image_set_rotation(img, 300);
+    lv_obj_align(img, LV_ALIGN_CENTER, 100, 0);
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("draw/image_mipmap.png");
+
+    /*The mipmap was cached while drawing*/
+    lv_image_cache_reset_stats();
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_test_image_decoder_open_downscaled(&dsc, &test_image_cogwheel_argb8888, 25, 25));
+    TEST_ASSERT_EQUAL_INT32(25, dsc.decoded->header.w);
+    lv_image_decoder_close(&dsc);
+
+    lv_image_cache_stats_t stats;
+    lv_image_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.decoded.hit_cnt);
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_image_mipmap_create(void)
+{
+}
+
+void test_image_mipmap_not_used(void)
+{
+}
+
+void test_image_mipmap_draw(void)
+{
+}
+
+#endif
+
+#endif
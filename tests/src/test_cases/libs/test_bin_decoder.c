@@ -0,0 +1,172 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+#include "lv_test_helpers.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_FS_POSIX && LV_FS_POSIX_MMAP
+
+/*'A' reads the files, 'B' can map them*/
+#define READ_SRC(cf)    "A:src/test_files/binimages/cogwheel." cf ".bin"
+#define MAP_SRC(cf)     "B:src/test_files/binimages/cogwheel." cf ".bin"
+
+static lv_draw_buf_align_cb align_pointer_cb;
+
+static void * align_pointer_keep(void * buf, lv_color_format_t color_format)
+{
+    LV_UNUSED(color_format);
+    return buf;
+}
+
+void setUp(void)
+{
+    /*The tests' LV_DRAW_BUF_ALIGN is too large for the data after the file header*/
+    align_pointer_cb = lv_draw_buf_get_handlers()->align_pointer_cb;
+    lv_draw_buf_get_handlers()->align_pointer_cb = align_pointer_keep;
+    lv_image_cache_drop(NULL);
+}
+
+void tearDown(void)
+{
+    lv_obj_clean(lv_screen_active());
+    lv_image_cache_drop(NULL);
+    lv_draw_buf_get_handlers()->align_pointer_cb = align_pointer_cb;
+}
+
+static void check_mapped(const char * read_src, const char * map_src, bool use_indexed)
+{
+    lv_image_decoder_args_t args;
+    lv_memzero(&args, sizeof(args));
+    args.use_indexed = use_indexed;
+
+    lv_image_decoder_dsc_t read_dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&read_dsc, read_src, &args));
+    TEST_ASSERT_NOT_NULL(read_dsc.cache_entry);
+
+    lv_image_decoder_dsc_t map_dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&map_dsc, map_src, &args));
+
+    /*The mapped file is used directly instead of a copy, and the mapping is kept in the cache
+     *unless it depends on `use_indexed`*/
+    const lv_draw_buf_t * mapped = map_dsc.decoded;
+    TEST_ASSERT_NOT_NULL(mapped);
+    if(use_indexed) TEST_ASSERT_NULL(map_dsc.cache_entry);
+    else TEST_ASSERT_NOT_NULL(map_dsc.cache_entry);
+    TEST_ASSERT_FALSE(mapped->header.flags & (LV_IMAGE_FLAGS_ALLOCATED | LV_IMAGE_FLAGS_MODIFIABLE));
+
+    const lv_draw_buf_t * read = read_dsc.decoded;
+    TEST_ASSERT_EQUAL(read->header.cf, mapped->header.cf);
+    TEST_ASSERT_EQUAL_UINT32(read->header.stride, mapped->header.stride);
+    TEST_ASSERT_EQUAL_MEMORY(read->data, mapped->data, read->header.stride * read->header.h);
+
+    lv_image_decoder_close(&map_dsc);
+    lv_image_decoder_close(&read_dsc);
+}
+
+void test_bin_decoder_map_rgb(void)
+{
+    check_mapped(READ_SRC("ARGB8888"), MAP_SRC("ARGB8888"), false);
+    check_mapped(READ_SRC("RGB565A8"), MAP_SRC("RGB565A8"), false);
+    check_mapped(READ_SRC("A8"), MAP_SRC("A8"), false);
+}
+
+void test_bin_decoder_map_cached(void)
+{
+    /*The stride in the file isn't aligned as the default args need*/
+    lv_image_decoder_args_t args;
+    lv_memzero(&args, sizeof(args));
+
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, MAP_SRC("ARGB8888"), &args));
+    const lv_draw_buf_t * mapped = dsc.decoded;
+    TEST_ASSERT_FALSE(mapped->header.flags & LV_IMAGE_FLAGS_ALLOCATED);
+    lv_image_decoder_close(&dsc);
+
+    /*Opening it again reuses the mapping instead of mapping the file again*/
+    lv_image_cache_reset_stats();
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, MAP_SRC("ARGB8888"), &args));
+    TEST_ASSERT_EQUAL_PTR(mapped, dsc.decoded);
+    TEST_ASSERT_NOT_NULL(dsc.cache_entry);
+    lv_image_decoder_close(&dsc);
+
+    lv_image_cache_stats_t stats;
+    lv_image_cache_get_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.decoded.hit_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.decoded.miss_cnt);
+
+    /*The mapping is counted with its size, so the cache can't keep too many files open*/
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(mapped->data_size, stats.decoded.size);
+
+    /*Dropping it unmaps and closes the file*/
+    lv_image_cache_drop(MAP_SRC("ARGB8888"));
+    TEST_ASSERT_EQUAL_UINT32(0, lv_cache_get_size(LV_GLOBAL_DEFAULT()->img_cache, NULL));
+}
+
+void test_bin_decoder_map_indexed(void)
+{
+    check_mapped(READ_SRC("I4"), MAP_SRC("I4"), true);
+
+    /*It needs to be converted to ARGB8888 if it can't be used as indexed*/
+    lv_image_decoder_args_t args;
+    lv_memzero(&args, sizeof(args));
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, MAP_SRC("I4"), &args));
+    TEST_ASSERT_EQUAL(LV_COLOR_FORMAT_ARGB8888, dsc.decoded->header.cf);
+    TEST_ASSERT_NOT_NULL(dsc.cache_entry);
+    lv_image_decoder_close(&dsc);
+}
+
+void test_bin_decoder_map_unaligned(void)
+{
+    /*Read the file if the data is not aligned as the draw buffers need*/
+    lv_draw_buf_get_handlers()->align_pointer_cb = align_pointer_cb;
+
+    lv_image_decoder_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_image_decoder_open(&dsc, MAP_SRC("ARGB8888"), NULL));
+    TEST_ASSERT_NOT_NULL(dsc.cache_entry);
+    TEST_ASSERT_TRUE(dsc.decoded->header.flags & LV_IMAGE_FLAGS_ALLOCATED);
+    lv_image_decoder_close(&dsc);
+}
+
+void test_bin_decoder_map_draw(void)
+{
+    lv_obj_t * img = lv_image_create(lv_screen_active());
+    lv_image_set_src(img, MAP_SRC("RGB565"));
+    lv_obj_center(img);
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("libs/bin_decoder_map.png");
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_bin_decoder_map_rgb(void)
+{
+}
+
+void test_bin_decoder_map_cached(void)
+{
+}
+
+void test_bin_decoder_map_indexed(void)
+{
+}
+
+void test_bin_decoder_map_unaligned(void)
+{
+}
+
+void test_bin_decoder_map_draw(void)
+{
+}
+
+#endif
+
+#endif
@@ -2,6 +2,7 @@
 #include "../lvgl.h"
 
 #include "unity/unity.h"
+#include <unistd.h>
 
 #if __WORDSIZE == 64
     #define TEST_FREETYPE_ASSERT_EQUAL_SCREENSHOT(NAME) TEST_ASSERT_EQUAL_SCREENSHOT("libs/freetype_" NAME ".lp64.png")
@@ -517,6 +518,39 @@ void test_freetype_outline_rendering_test(void)
 #endif
 }
 
+void test_freetype_prerender(void)
+{
+#if LV_USE_FREETYPE
+    /*Use the font shipped with LVGL to run it even without the test fonts*/
+    lv_font_t * font = lv_freetype_font_create("../src/libs/freetype/arial.ttf",
+                                               LV_FREETYPE_FONT_RENDER_MODE_BITMAP,
+                                               20,
+                                               LV_FREETYPE_FONT_STYLE_NORMAL);
+    TEST_ASSERT_NOT_NULL(font);
+
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_freetype_font_prerender_text(font, "Hello\nWorld"));
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_freetype_font_prerender_range(font, '0', '9'));
+    /*The thread might have rendered some of them already*/
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(20, lv_freetype_prerender_get_pending_cnt());
+
+    /*Wait for the thread, or for the timer without OS*/
+    uint32_t i;
+    for(i = 0; i < 5000 && lv_freetype_prerender_get_pending_cnt() > 0; i++) {
+        lv_tick_inc(1);
+        lv_timer_handler();
+        usleep(1000);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, lv_freetype_prerender_get_pending_cnt());
+
+    /*The pending requests of a deleted font are dropped*/
+    lv_freetype_font_prerender_range(font, 0x4E00, 0x4FFF);
+    lv_freetype_font_delete(font);
+    TEST_ASSERT_EQUAL_UINT32(0, lv_freetype_prerender_get_pending_cnt());
+#else
+    TEST_PASS();
+#endif
+}
+
 static void freetype_outline_event_cb(lv_event_t * e)
 {
     lv_event_code_t code = lv_event_get_code(e);
@@ -0,0 +1,82 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+#if LV_USE_RLE
+
+#include "../../src/libs/rle/lv_rle.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static void round_trip(const uint8_t * data, uint32_t len, uint8_t blk_size)
+{
+    uint8_t compressed[1024];
+    uint8_t decompressed[512];
+
+    uint32_t compressed_len = lv_rle_compress(data, len, compressed, sizeof(compressed), blk_size);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, compressed_len);
+
+    uint32_t decompressed_len = lv_rle_decompress(compressed, compressed_len, decompressed, len, blk_size);
+    TEST_ASSERT_EQUAL_UINT32(len, decompressed_len);
+    TEST_ASSERT_EQUAL_MEMORY(data, decompressed, len);
+}
+
+void test_rle_compress_round_trip(void)
+{
+    uint8_t data[480];
+    uint32_t i;
+
+    /*Long runs, longer than a control byte can describe*/
+    lv_memset(data, 0x55, sizeof(data));
+    round_trip(data, sizeof(data), 1);
+    round_trip(data, sizeof(data), 4);
+
+    /*No runs at all*/
+    for(i = 0; i < sizeof(data); i++) data[i] = (uint8_t)(i * 7);
+    round_trip(data, sizeof(data), 1);
+    round_trip(data, sizeof(data), 3);
+
+    /*Mixed runs and literals*/
+    for(i = 0; i < sizeof(data); i++) data[i] = (uint8_t)((i / 40) % 2 ? i : 0xAA);
+    round_trip(data, sizeof(data), 1);
+    round_trip(data, sizeof(data), 2);
+}
+
+void test_rle_compress_output_too_small(void)
+{
+    uint8_t data[64];
+    uint8_t compressed[16];
+    uint32_t i;
+    for(i = 0; i < sizeof(data); i++) data[i] = (uint8_t)i;
+
+    TEST_ASSERT_EQUAL_UINT32(0, lv_rle_compress(data, sizeof(data), compressed, sizeof(compressed), 1));
+}
+
+#else
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_rle_compress_round_trip(void)
+{
+}
+
+void test_rle_compress_output_too_small(void)
+{
+}
+
+#endif
+
+#endif
@@ -79,4 +79,134 @@ void test_tiny_ttf_kerning(void)
 #endif
 }
 
+void test_tiny_ttf_remembered_metrics_follow_the_size(void)
+{
+#if LV_USE_TINY_TTF
+    extern const uint8_t test_kern_one_otf[];
+    extern size_t test_kern_one_otf_size;
+    lv_font_t * font = lv_tiny_ttf_create_data(test_kern_one_otf, test_kern_one_otf_size, 40);
+    const char * txt = "ıTuTuTı";
+
+    int32_t w_40 = lv_text_get_width(txt, lv_strlen(txt), font, 0);
+    TEST_ASSERT_EQUAL_INT32(w_40, lv_text_get_width(txt, lv_strlen(txt), font, 0));
+
+    lv_tiny_ttf_set_size(font, 80);
+    int32_t w_80 = lv_text_get_width(txt, lv_strlen(txt), font, 0);
+    TEST_ASSERT_INT32_WITHIN(2 * lv_strlen(txt), 2 * w_40, w_80);
+
+    lv_tiny_ttf_set_size(font, 40);
+    TEST_ASSERT_EQUAL_INT32(w_40, lv_text_get_width(txt, lv_strlen(txt), font, 0));
+
+    /*The kerning is applied*/
+    lv_font_set_kerning(font, LV_FONT_KERNING_NONE);
+    TEST_ASSERT_NOT_EQUAL(w_40, lv_text_get_width(txt, lv_strlen(txt), font, 0));
+
+    lv_tiny_ttf_destroy(font);
+#else
+    TEST_PASS();
+#endif
+}
+
+#if LV_USE_TINY_TTF && LV_USE_OS != LV_OS_NONE
+
+#define METRICS_LETTER_START    0x20
+#define METRICS_LETTER_CNT      0x160   /*More than the remembered letters to reuse the slots*/
+
+typedef struct {
+    const lv_font_t * font;
+    const lv_font_glyph_dsc_t * dscs_ref;
+    bool reverse;
+    uint32_t mismatch_cnt;
+} metrics_thread_data_t;
+
+static void metrics_thread_cb(void * user_data)
+{
+    metrics_thread_data_t * data = user_data;
+    uint32_t round;
+    for(round = 0; round < 200; round++) {
+        uint32_t i;
+        for(i = 0; i < METRICS_LETTER_CNT; i++) {
+            uint32_t id = data->reverse ? METRICS_LETTER_CNT - 1 - i : i;
+            lv_font_glyph_dsc_t dsc;
+            lv_memzero(&dsc, sizeof(dsc));
+            lv_font_get_glyph_dsc(data->font, &dsc, METRICS_LETTER_START + id, 0);
+            const lv_font_glyph_dsc_t * ref = &data->dscs_ref[id];
+            if(dsc.adv_w != ref->adv_w || dsc.box_w != ref->box_w || dsc.box_h != ref->box_h ||
+               dsc.ofs_x != ref->ofs_x || dsc.ofs_y != ref->ofs_y) {
+                data->mismatch_cnt++;
+            }
+        }
+    }
+}
+
+#endif
+
+void test_tiny_ttf_metrics_from_parallel_threads(void)
+{
+#if LV_USE_TINY_TTF && LV_USE_OS != LV_OS_NONE
+    extern const uint8_t test_ubuntu_font[];
+    extern size_t test_ubuntu_font_size;
+    lv_font_t * font = lv_tiny_ttf_create_data(test_ubuntu_font, test_ubuntu_font_size, 30);
+
+    static lv_font_glyph_dsc_t dscs_ref[METRICS_LETTER_CNT];
+    uint32_t i;
+    for(i = 0; i < METRICS_LETTER_CNT; i++) {
+        lv_memzero(&dscs_ref[i], sizeof(dscs_ref[i]));
+        lv_font_get_glyph_dsc(font, &dscs_ref[i], METRICS_LETTER_START + i, 0);
+    }
+
+    /*The threads use the same slots of the remembered metrics for different letters*/
+    metrics_thread_data_t data[2] = {
+        {.font = font, .dscs_ref = dscs_ref, .reverse = false},
+        {.font = font, .dscs_ref = dscs_ref, .reverse = true},
+    };
+    lv_thread_t threads[2];
+    for(i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_thread_init(&threads[i], LV_THREAD_PRIO_MID, metrics_thread_cb, 0, &data[i]));
+    }
+    for(i = 0; i < 2; i++) {
+        lv_thread_delete(&threads[i]);
+        TEST_ASSERT_EQUAL_UINT32(0, data[i].mismatch_cnt);
+    }
+
+    lv_tiny_ttf_destroy(font);
+#else
+    TEST_PASS();
+#endif
+}
+
+
+void test_tiny_ttf_set_size_invalidates_the_glyph_atlas(void)
+{
+#if LV_USE_TINY_TTF && LV_USE_FONT_GLYPH_ATLAS
+    extern const uint8_t test_ubuntu_font[];
+    extern size_t test_ubuntu_font_size;
+    lv_font_t * font = lv_tiny_ttf_create_data(test_ubuntu_font, test_ubuntu_font_size, 30);
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_font_glyph_atlas_create(font, 256, 256));
+
+    lv_obj_t * label = lv_label_create(lv_screen_active());
+    lv_obj_set_style_text_font(label, font, 0);
+    lv_label_set_text(label, "Hello world");
+    lv_refr_now(NULL);
+
+    lv_font_glyph_atlas_t * atlas = lv_font_glyph_atlas_acquire(font);
+    TEST_ASSERT_NOT_NULL(atlas);
+    TEST_ASSERT_GREATER_THAN(0, atlas->glyph_cnt);
+    lv_font_glyph_atlas_release(atlas);
+
+    /*The glyphs of the old size shouldn't be used anymore*/
+    lv_tiny_ttf_set_size(font, 20);
+    atlas = lv_font_glyph_atlas_acquire(font);
+    TEST_ASSERT_NOT_NULL(atlas);
+    TEST_ASSERT_EQUAL_UINT32(0, atlas->glyph_cnt);
+    lv_font_glyph_atlas_release(atlas);
+
+    lv_obj_delete(label);
+    lv_tiny_ttf_destroy(font);
+    TEST_ASSERT_NULL(lv_font_glyph_atlas_acquire(font));
+#else
+    TEST_PASS();
+#endif
+}
+
 #endif
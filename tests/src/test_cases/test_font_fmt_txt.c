@@ -0,0 +1,333 @@
+#if LV_BUILD_TEST
+#include "../lvgl.h"
+
+#include "unity/unity.h"
+
+void setUp(void)
+{
+    /* Function run before every test */
+}
+
+void tearDown(void)
+{
+    /* Function run after every test */
+    lv_obj_clean(lv_screen_active());
+}
+
+static void glyph_dscs_get(const lv_font_t * font, lv_font_glyph_dsc_t * dscs, bool * found, uint32_t cnt)
+{
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        found[i] = lv_font_get_glyph_dsc(font, &dscs[i], i, i + 1);
+    }
+}
+
+void test_font_fmt_txt_glyph_id_table(void)
+{
+    const lv_font_t * font = &lv_font_simsun_16_cjk;
+    uint32_t cnt = 0x10000;
+    lv_font_glyph_dsc_t * dscs_ref = lv_malloc_zeroed(cnt * sizeof(lv_font_glyph_dsc_t));
+    lv_font_glyph_dsc_t * dscs = lv_malloc_zeroed(cnt * sizeof(lv_font_glyph_dsc_t));
+    bool * found_ref = lv_malloc_zeroed(cnt * sizeof(bool));
+    bool * found = lv_malloc_zeroed(cnt * sizeof(bool));
+
+    glyph_dscs_get(font, dscs_ref, found_ref, cnt);
+
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_font_fmt_txt_glyph_id_table_create(font));
+    /*Creating it again should be ignored*/
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_font_fmt_txt_glyph_id_table_create(font));
+    TEST_ASSERT_EQUAL_PTR(LV_GLOBAL_DEFAULT()->font_fmt_txt_glyph_id_tables,
+                          *((const lv_font_fmt_txt_dsc_t *)font->dsc)->glyph_id_table);
+
+    /*Fonts without a place for the table can't have one*/
+    TEST_ASSERT_EQUAL(LV_RESULT_INVALID, lv_font_fmt_txt_glyph_id_table_create(&lv_font_montserrat_14));
+    glyph_dscs_get(font, dscs, found, cnt);
+
+    /*The lookup table should give the same result as the search*/
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        TEST_ASSERT_EQUAL(found_ref[i], found[i]);
+        if(found[i]) {
+            TEST_ASSERT_EQUAL(dscs_ref[i].adv_w, dscs[i].adv_w);
+            TEST_ASSERT_EQUAL(dscs_ref[i].box_w, dscs[i].box_w);
+            TEST_ASSERT_EQUAL(dscs_ref[i].box_h, dscs[i].box_h);
+            TEST_ASSERT_EQUAL(dscs_ref[i].ofs_x, dscs[i].ofs_x);
+            TEST_ASSERT_EQUAL(dscs_ref[i].ofs_y, dscs[i].ofs_y);
+        }
+    }
+
+    lv_font_fmt_txt_glyph_id_table_delete(font);
+    TEST_ASSERT_NULL(*((const lv_font_fmt_txt_dsc_t *)font->dsc)->glyph_id_table);
+    TEST_ASSERT_NULL(LV_GLOBAL_DEFAULT()->font_fmt_txt_glyph_id_tables);
+
+    lv_free(dscs_ref);
+    lv_free(dscs);
+    lv_free(found_ref);
+    lv_free(found);
+}
+
+void test_font_fmt_txt_kern_pair_hash(void)
+{
+    /*A font with the letters A..Z having kerning pairs between every 3rd glyph*/
+    static lv_font_fmt_txt_glyph_dsc_t glyph_dsc[27];
+    static uint8_t kern_ids[2 * 26 * 9];
+    static int8_t kern_values[26 * 9];
+    uint32_t i;
+    uint32_t j;
+    uint32_t pair_cnt = 0;
+    for(i = 1; i <= 26; i++) {
+        glyph_dsc[i].adv_w = 10 * 16;
+        for(j = 1; j <= 26; j += 3) {
+            kern_ids[pair_cnt * 2] = (uint8_t)i;
+            kern_ids[pair_cnt * 2 + 1] = (uint8_t)j;
+            kern_values[pair_cnt] = (int8_t)(-16 - (int32_t)(i + j));
+            pair_cnt++;
+        }
+    }
+
+    static lv_font_fmt_txt_kern_pair_t kern_pairs;
+    kern_pairs.glyph_ids = kern_ids;
+    kern_pairs.values = kern_values;
+    kern_pairs.pair_cnt = pair_cnt;
+    kern_pairs.glyph_ids_size = 0;
+
+    static const lv_font_fmt_txt_cmap_t cmap = {
+        .range_start = 'A', .range_length = 26, .glyph_id_start = 1,
+        .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY
+    };
+
+    static lv_font_fmt_txt_dsc_t font_dsc;
+    font_dsc.glyph_dsc = glyph_dsc;
+    font_dsc.cmaps = &cmap;
+    font_dsc.cmap_num = 1;
+    font_dsc.kern_dsc = &kern_pairs;
+    font_dsc.kern_scale = 16;
+    font_dsc.bpp = 1;
+    static lv_font_fmt_txt_glyph_id_table_t * glyph_id_table;
+    font_dsc.glyph_id_table = &glyph_id_table;
+
+    static lv_font_t font;
+    font.get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+    font.get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+    font.dsc = &font_dsc;
+
+    int32_t widths_ref[26][26];
+    for(i = 0; i < 26; i++) {
+        for(j = 0; j < 26; j++) {
+            widths_ref[i][j] = lv_font_get_glyph_width(&font, 'A' + i, 'A' + j);
+        }
+    }
+    /*Test the test: there should be some kerning*/
+    TEST_ASSERT_NOT_EQUAL(widths_ref[0][0], widths_ref[0][1]);
+
+    TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_font_fmt_txt_glyph_id_table_create(&font));
+    for(i = 0; i < 26; i++) {
+        for(j = 0; j < 26; j++) {
+            TEST_ASSERT_EQUAL(widths_ref[i][j], lv_font_get_glyph_width(&font, 'A' + i, 'A' + j));
+        }
+    }
+    TEST_ASSERT_NOT_NULL(glyph_id_table->kern_keys);
+
+    lv_font_fmt_txt_glyph_id_table_delete(&font);
+}
+
+/*Expand the pixels one by one like the opacity tables do*/
+static uint8_t unpack_pixel_ref(const uint8_t * bitmap, uint32_t bit_ofs, uint8_t bpp)
+{
+    uint32_t mask = (1 << bpp) - 1;
+    uint32_t shift = 8 - bpp - (bit_ofs & 0x7);
+    uint32_t value = (bitmap[bit_ofs >> 3] >> shift) & mask;
+    return (uint8_t)(value * 255 / mask);
+}
+
+void test_font_fmt_txt_unpack_pixels(void)
+{
+    uint8_t bitmap[64];
+    uint32_t seed = 1234;
+    uint32_t i;
+    for(i = 0; i < sizeof(bitmap); i++) {
+        seed = seed * 1103515245 + 12345;
+        bitmap[i] = (uint8_t)(seed >> 16);
+    }
+
+    static const uint8_t bpps[] = {1, 2, 4, 8};
+    for(i = 0; i < sizeof(bpps); i++) {
+        uint8_t bpp = bpps[i];
+        uint32_t px_max = (sizeof(bitmap) * 8) / bpp;
+
+        /*Start and stop in the middle of the bytes and at byte boundaries too*/
+        uint32_t px_start;
+        for(px_start = 0; px_start < 16; px_start++) {
+            int32_t px_cnt;
+            for(px_cnt = 0; px_cnt < 40 && px_start + px_cnt <= px_max; px_cnt++) {
+                uint8_t out[48];
+                lv_memset(out, 0xAA, sizeof(out));
+                lv_font_fmt_txt_unpack_pixels(bitmap, px_start * bpp, bpp, out, px_cnt);
+
+                int32_t x;
+                for(x = 0; x < px_cnt; x++) {
+                    TEST_ASSERT_EQUAL_UINT8(unpack_pixel_ref(bitmap, (px_start + x) * bpp, bpp), out[x]);
+                }
+
+                /*Nothing is written after the last pixel*/
+                TEST_ASSERT_EQUAL_UINT8(0xAA, out[px_cnt]);
+            }
+        }
+    }
+}
+
+static void packed_glyphs_check(const lv_font_t * font, uint32_t letter_start, uint32_t letter_end)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    uint32_t checked = 0;
+    uint32_t letter;
+    for(letter = letter_start; letter <= letter_end; letter++) {
+        lv_font_glyph_dsc_t g;
+        if(!lv_font_get_glyph_dsc(font, &g, letter, 0)) continue;
+
+        const uint8_t * packed = lv_font_get_packed_bitmap_fmt_txt(&g, letter);
+        if(g.box_w == 0 || g.box_h == 0) {
+            TEST_ASSERT_NULL(packed);
+            continue;
+        }
+        TEST_ASSERT_NOT_NULL(packed);
+
+        /*The rows are packed without padding, so unpack each row from its bit offset*/
+        uint8_t row[256];
+        TEST_ASSERT_LESS_OR_EQUAL(sizeof(row), g.box_w);
+        int32_t y;
+        for(y = 0; y < g.box_h; y++) {
+            uint32_t bit_ofs = (uint32_t)y * g.box_w * fdsc->bpp;
+            lv_font_fmt_txt_unpack_pixels(packed, bit_ofs, (uint8_t)fdsc->bpp, row, g.box_w);
+            int32_t x;
+            for(x = 0; x < g.box_w; x++) {
+                TEST_ASSERT_EQUAL_UINT8(unpack_pixel_ref(packed, bit_ofs + x * fdsc->bpp, (uint8_t)fdsc->bpp), row[x]);
+            }
+        }
+        checked++;
+    }
+
+    TEST_ASSERT_GREATER_THAN(0, checked);
+}
+
+void test_font_fmt_txt_packed_glyphs(void)
+{
+    /*1 bpp*/
+    packed_glyphs_check(&lv_font_unscii_8, 0x20, 0x7E);
+    /*4 bpp*/
+    packed_glyphs_check(&lv_font_simsun_16_cjk, 0x4E00, 0x4EFF);
+}
+
+#if LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28 && LV_FONT_MONTSERRAT_28_COMPRESSED
+
+#define DECOMPRESS_LETTER_FIRST 0x20
+#define DECOMPRESS_LETTER_LAST  0x7E
+#define DECOMPRESS_LETTER_CNT   (DECOMPRESS_LETTER_LAST - DECOMPRESS_LETTER_FIRST + 1)
+
+typedef struct {
+    lv_draw_buf_t * bufs[DECOMPRESS_LETTER_CNT];    /*Decompressed into these*/
+    lv_draw_buf_t * bufs_ref[DECOMPRESS_LETTER_CNT];
+    bool reverse;
+    uint32_t mismatch_cnt;
+} decompress_thread_data_t;
+
+static lv_draw_buf_t * glyph_bitmap_create(const lv_font_t * font, uint32_t letter)
+{
+    lv_font_glyph_dsc_t g;
+    if(!lv_font_get_glyph_dsc(font, &g, letter, 0) || g.box_w == 0 || g.box_h == 0) return NULL;
+
+    lv_draw_buf_t * buf = lv_draw_buf_create(g.box_w, g.box_h, LV_COLOR_FORMAT_A8, LV_STRIDE_AUTO);
+    TEST_ASSERT_NOT_NULL(buf);
+    lv_draw_buf_clear(buf, NULL);
+    return buf;
+}
+
+/*Decompress the glyphs into the buffers and count the ones different from the uncompressed font*/
+static uint32_t glyphs_decompress(lv_draw_buf_t * bufs[], lv_draw_buf_t * bufs_ref[], bool reverse)
+{
+    uint32_t mismatch_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < DECOMPRESS_LETTER_CNT; i++) {
+        uint32_t idx = reverse ? DECOMPRESS_LETTER_CNT - 1 - i : i;
+        if(bufs[idx] == NULL) continue;
+
+        uint32_t letter = DECOMPRESS_LETTER_FIRST + idx;
+        lv_font_glyph_dsc_t g;
+        lv_font_get_glyph_dsc(&lv_font_montserrat_28_compressed, &g, letter, 0);
+        lv_font_get_glyph_bitmap(&g, letter, bufs[idx]);
+
+        int32_t y;
+        for(y = 0; y < g.box_h; y++) {
+            if(memcmp(lv_draw_buf_goto_xy(bufs[idx], 0, y), lv_draw_buf_goto_xy(bufs_ref[idx], 0, y), g.box_w)) {
+                mismatch_cnt++;
+                break;
+            }
+        }
+    }
+
+    return mismatch_cnt;
+}
+
+#if LV_USE_OS != LV_OS_NONE
+static void decompress_thread_cb(void * user_data)
+{
+    decompress_thread_data_t * data = user_data;
+    uint32_t round;
+    for(round = 0; round < 50; round++) {
+        data->mismatch_cnt += glyphs_decompress(data->bufs, data->bufs_ref, data->reverse);
+    }
+}
+#endif
+
+void test_font_fmt_txt_decompress(void)
+{
+    /*The same glyphs are stored without compression in lv_font_montserrat_28*/
+    lv_draw_buf_t * bufs_ref[DECOMPRESS_LETTER_CNT];
+    decompress_thread_data_t data[2];
+    lv_memzero(data, sizeof(data));
+    data[1].reverse = true;
+
+    uint32_t i;
+    uint32_t glyph_cnt = 0;
+    for(i = 0; i < DECOMPRESS_LETTER_CNT; i++) {
+        uint32_t letter = DECOMPRESS_LETTER_FIRST + i;
+        bufs_ref[i] = glyph_bitmap_create(&lv_font_montserrat_28, letter);
+        if(bufs_ref[i] == NULL) continue;
+
+        lv_font_glyph_dsc_t g;
+        lv_font_get_glyph_dsc(&lv_font_montserrat_28, &g, letter, 0);
+        lv_font_get_glyph_bitmap(&g, letter, bufs_ref[i]);
+
+        data[0].bufs[i] = glyph_bitmap_create(&lv_font_montserrat_28_compressed, letter);
+        data[1].bufs[i] = glyph_bitmap_create(&lv_font_montserrat_28_compressed, letter);
+        data[0].bufs_ref[i] = bufs_ref[i];
+        data[1].bufs_ref[i] = bufs_ref[i];
+        glyph_cnt++;
+    }
+    TEST_ASSERT_GREATER_THAN(90, glyph_cnt);
+
+    TEST_ASSERT_EQUAL_UINT32(0, glyphs_decompress(data[0].bufs, bufs_ref, false));
+
+#if LV_USE_OS != LV_OS_NONE
+    /*Decompress the glyphs in parallel in different order*/
+    lv_thread_t threads[2];
+    for(i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(LV_RESULT_OK, lv_thread_init(&threads[i], LV_THREAD_PRIO_MID, decompress_thread_cb, 0, &data[i]));
+    }
+    for(i = 0; i < 2; i++) {
+        lv_thread_delete(&threads[i]);
+        TEST_ASSERT_EQUAL_UINT32(0, data[i].mismatch_cnt);
+    }
+#endif
+
+    for(i = 0; i < DECOMPRESS_LETTER_CNT; i++) {
+        if(bufs_ref[i] == NULL) continue;
+        lv_draw_buf_destroy(bufs_ref[i]);
+        lv_draw_buf_destroy(data[0].bufs[i]);
+        lv_draw_buf_destroy(data[1].bufs[i]);
+    }
+}
+
+#endif /*LV_USE_FONT_COMPRESSED && LV_FONT_MONTSERRAT_28 && LV_FONT_MONTSERRAT_28_COMPRESSED*/
+
+#endif
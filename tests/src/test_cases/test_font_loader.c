@@ -28,6 +28,8 @@ static int compare_fonts(lv_font_t * f1, lv_font_t * f2);
 void test_font_loader_with_cache(void);
 void test_font_loader_no_cache(void);
 void test_font_loader_from_buffer(void);
+void test_font_loader_lazy(void);
+void test_font_loader_lazy_from_buffer(void);
 
 /**********************
  *  STATIC VARIABLES
@@ -145,6 +147,38 @@ void test_font_loader_from_buffer(void)
     common();
 }
 
+void test_font_loader_lazy(void)
+{
+    /*Load only the glyph descriptors and read the bitmaps on demand*/
+
+    font_1_bin = lv_binfont_create_lazy("B:src/test_assets/test_font_1.fnt");
+    TEST_ASSERT_NOT_NULL(font_1_bin);
+
+    font_2_bin = lv_binfont_create_lazy("B:src/test_assets/test_font_2.fnt");
+    TEST_ASSERT_NOT_NULL(font_2_bin);
+
+    font_3_bin = lv_binfont_create_lazy("B:src/test_assets/test_font_3.fnt");
+    TEST_ASSERT_NOT_NULL(font_3_bin);
+
+    TEST_ASSERT_NULL(((lv_font_fmt_txt_dsc_t *)font_1_bin->dsc)->glyph_bitmap);
+
+    common();
+}
+
+void test_font_loader_lazy_from_buffer(void)
+{
+    font_1_bin = lv_binfont_create_lazy_from_buffer((void *)&test_font_1_buf, sizeof(test_font_1_buf));
+    TEST_ASSERT_NOT_NULL(font_1_bin);
+
+    font_2_bin = lv_binfont_create_lazy_from_buffer((void *)&test_font_2_buf, sizeof(test_font_2_buf));
+    TEST_ASSERT_NOT_NULL(font_2_bin);
+
+    font_3_bin = lv_binfont_create_lazy_from_buffer((void *)&test_font_3_buf, sizeof(test_font_3_buf));
+    TEST_ASSERT_NOT_NULL(font_3_bin);
+
+    common();
+}
+
 void test_font_loader_reload(void)
 {
     /*Reload a font which is being used by a label*/
@@ -297,7 +331,8 @@ static int compare_fonts(lv_font_t * f1, lv_font_t * f2)
     lv_font_fmt_txt_glyph_dsc_t * glyph_dsc2 = (lv_font_fmt_txt_glyph_dsc_t *)dsc2->glyph_dsc;
 
     for(int i = 0; i < total_glyphs; ++i) {
-        if(i < total_glyphs - 1) {
+        /*Lazily loaded fonts have no bitmaps in the RAM*/
+        if(i < total_glyphs - 1 && dsc2->glyph_bitmap != NULL) {
             int size1 = glyph_dsc1[i + 1].bitmap_index - glyph_dsc1[i].bitmap_index;
 
             if(size1 > 0) {
@@ -63,6 +63,37 @@ void test_read(void)
     lv_fs_close(&fb);
 }
 
+void test_map(void)
+{
+    lv_fs_file_t f;
+    const void * buf;
+    uint32_t size;
+
+    /*'A' can't map files*/
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "A:src/test_files/readtest.txt", LV_FS_MODE_RD));
+    TEST_ASSERT_EQUAL(LV_FS_RES_NOT_IMP, lv_fs_map(&f, &buf, &size));
+    TEST_ASSERT_NULL(buf);
+    lv_fs_close(&f);
+
+    /*'B' maps them with mmap()*/
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, "B:src/test_files/readtest.txt", LV_FS_MODE_RD));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_map(&f, &buf, &size));
+    TEST_ASSERT_EQUAL_UINT32(lv_strlen(read_exp) + 1, size);   /*With the new line at the end*/
+    TEST_ASSERT_EQUAL_MEMORY(read_exp, buf, size - 1);
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_unmap(&f, buf, size));
+    lv_fs_close(&f);
+
+    /*Memory-mapped files are in the memory already*/
+    lv_fs_path_ex_t path;
+    lv_fs_make_path_from_buffer(&path, 'M', read_exp, 100);
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_open(&f, (const char *)&path, LV_FS_MODE_RD));
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_map(&f, &buf, &size));
+    TEST_ASSERT_EQUAL_PTR(read_exp, buf);
+    TEST_ASSERT_EQUAL_UINT32(100, size);
+    TEST_ASSERT_EQUAL(LV_FS_RES_OK, lv_fs_unmap(&f, buf, size));
+    lv_fs_close(&f);
+}
+
 void test_read_random(void)
 {
     read_random_drv('A', 8);
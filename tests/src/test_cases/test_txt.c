@@ -136,4 +136,153 @@ void test_txt_next_line_should_handle_empty_string(void)
     TEST_ASSERT_EQUAL_UINT32(0, next_line);
 }
 
+static void line_index_assert_equal(const lv_text_line_index_t * ref, const lv_text_line_index_t * index)
+{
+    TEST_ASSERT_TRUE(index->valid);
+    TEST_ASSERT_EQUAL_UINT32(ref->line_cnt, index->line_cnt);
+    TEST_ASSERT_EQUAL_UINT32(ref->txt_len, index->txt_len);
+    TEST_ASSERT_EQUAL_INT32(ref->max_line_width, index->max_line_width);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(ref->line_starts, index->line_starts, ref->line_cnt);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(ref->line_widths, index->line_widths, ref->line_cnt);
+}
+
+void test_txt_line_index_update_should_match_full_wrap(void)
+{
+    const lv_font_t * font = &lv_font_montserrat_14;
+    char txt[512];
+    lv_text_line_index_t ref;
+    lv_text_line_index_t index;
+    lv_memzero(&ref, sizeof(ref));
+    lv_memzero(&index, sizeof(index));
+
+    lv_strcpy(txt, "Lorem ipsum dolor sit amet,\nconsectetur adipiscing elit, sed do eiusmod tempor "
+              "incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud");
+    lv_text_line_index_build(&index, txt, font, 0, 100, LV_TEXT_FLAG_NONE);
+
+    lv_point_t size_ref;
+    lv_point_t size;
+    lv_text_get_size(&size_ref, txt, font, 0, 5, 100, LV_TEXT_FLAG_NONE);
+    lv_text_line_index_get_size(&index, txt, 5, &size);
+    TEST_ASSERT_EQUAL_INT32(size_ref.x, size.x);
+    TEST_ASSERT_EQUAL_INT32(size_ref.y, size.y);
+
+    /*Insert into the middle of a line*/
+    _lv_text_ins(txt, 30, "a very long word");
+    lv_text_line_index_update(&index, txt, 30, 16);
+    lv_text_line_index_build(&ref, txt, font, 0, 100, LV_TEXT_FLAG_NONE);
+    line_index_assert_equal(&ref, &index);
+
+    /*Delete from the beginning*/
+    _lv_text_cut(txt, 0, 12);
+    lv_text_line_index_update(&index, txt, 0, -12);
+    lv_text_line_index_build(&ref, txt, font, 0, 100, LV_TEXT_FLAG_NONE);
+    line_index_assert_equal(&ref, &index);
+
+    /*Delete a line break*/
+    char * nl = strchr(txt, '\n');
+    uint32_t nl_pos = nl - txt;
+    _lv_text_cut(txt, nl_pos, 1);
+    lv_text_line_index_update(&index, txt, nl_pos, -1);
+    lv_text_line_index_build(&ref, txt, font, 0, 100, LV_TEXT_FLAG_NONE);
+    line_index_assert_equal(&ref, &index);
+
+    /*Append new lines*/
+    uint32_t len = lv_strlen(txt);
+    lv_strcpy(&txt[len], " end\nof the\ntext\n");
+    lv_text_line_index_update(&index, txt, len, lv_strlen(txt) - len);
+    lv_text_line_index_build(&ref, txt, font, 0, 100, LV_TEXT_FLAG_NONE);
+    line_index_assert_equal(&ref, &index);
+
+    TEST_ASSERT_TRUE(lv_text_line_index_is_valid(&index, font, 0, 100, LV_TEXT_FLAG_NONE));
+    TEST_ASSERT_FALSE(lv_text_line_index_is_valid(&index, font, 0, 101, LV_TEXT_FLAG_NONE));
+
+    lv_text_line_index_get_size(&index, txt, 5, &size);
+    lv_text_get_size(&size_ref, txt, font, 0, 5, 100, LV_TEXT_FLAG_NONE);
+    TEST_ASSERT_EQUAL_INT32(size_ref.x, size.x);
+    TEST_ASSERT_EQUAL_INT32(size_ref.y, size.y);
+
+    lv_text_line_index_free(&ref);
+    lv_text_line_index_free(&index);
+}
+
+void test_txt_decode_should_match_decoding_letter_by_letter(void)
+{
+    const char * txt = "Hello, World! \xC3\x81rv\xC3\xADzt\xC5\xB1r\xC5\x91 t\xC3\xBCk\xC3\xB6rf\xC3\xBAr\xC3\xB3g\xC3\xA9p "
+                       "\xE2\x82\xAC \xF0\x9F\x98\x80 AVAVAVAV kerning Ty To Te";
+    uint32_t len = lv_strlen(txt);
+    uint32_t letters[8];
+    uint32_t letter_ofs[8];
+    uint32_t i = 0;
+    uint32_t i_ref = 0;
+
+    while(i < len) {
+        uint32_t cnt = _lv_text_encoded_decode(txt, &i, len, letters, letter_ofs, 8);
+        TEST_ASSERT_NOT_EQUAL(0, cnt);
+        uint32_t k;
+        for(k = 0; k < cnt; k++) {
+            TEST_ASSERT_EQUAL_UINT32(i_ref, letter_ofs[k]);
+            TEST_ASSERT_EQUAL_UINT32(_lv_text_encoded_next(txt, &i_ref), letters[k]);
+        }
+        TEST_ASSERT_EQUAL_UINT32(i_ref, i);
+    }
+
+    /*Stop at the given length and at the end of the text*/
+    i = 0;
+    TEST_ASSERT_EQUAL_UINT32(3, _lv_text_encoded_decode(txt, &i, 3, letters, NULL, 8));
+    TEST_ASSERT_EQUAL_UINT32(3, i);
+    i = len - 2;
+    TEST_ASSERT_EQUAL_UINT32(2, _lv_text_encoded_decode(txt, &i, len + 1, letters, NULL, 8));
+    TEST_ASSERT_EQUAL_UINT32(len, i);
+    i = len - 2;
+    TEST_ASSERT_EQUAL_UINT32(2, _lv_text_encoded_decode(txt, &i, UINT32_MAX, letters, NULL, 8));
+    TEST_ASSERT_EQUAL_UINT32(len, i);
+}
+
+void test_txt_get_width_should_match_measuring_letter_by_letter(void)
+{
+    const char * txt = "AVAVAVAV Ty To Te kerning \xC3\x81rv\xC3\xADzt\xC5\xB1r\xC5\x91 t\xC3\xBCk\xC3\xB6rf\xC3\xBAr\xC3\xB3g\xC3\xA9p "
+                       "and a much longer ASCII only part to cover more than one batch of letters";
+    const lv_font_t * font = &lv_font_montserrat_14;
+    uint32_t len = lv_strlen(txt);
+    uint32_t length;
+
+    for(length = 0; length <= len; length++) {
+        int32_t width_ref = 0;
+        uint32_t i = 0;
+        while(i < length) {
+            uint32_t letter;
+            uint32_t letter_next;
+            _lv_text_encoded_letter_next_2(txt, &letter, &letter_next, &i);
+            int32_t char_width = lv_font_get_glyph_width(font, letter, letter_next);
+            if(char_width > 0) width_ref += char_width + 2;
+        }
+        if(width_ref > 0) width_ref -= 2;
+
+        TEST_ASSERT_EQUAL_INT32(width_ref, lv_text_get_width(txt, length, font, 2));
+    }
+}
+
+
+void test_txt_get_size_should_match_breaking_lines_of_unknown_length(void)
+{
+    const char * txt = "AVAVAVAV Ty To Te kerning\r\n\xC3\x81rv\xC3\xADzt\xC5\xB1r\xC5\x91 t\xC3\xBCk\xC3\xB6rf\xC3\xBAr\xC3\xB3g\xC3\xA9p\n"
+                       "and a much longer ASCII only part with averyveryverylongwordwhichdoesntfit to cover more batches";
+    const lv_font_t * font = &lv_font_montserrat_14;
+    int32_t max_width;
+
+    for(max_width = 10; max_width <= 400; max_width += 13) {
+        /*`_lv_text_get_next_line()` doesn't know the length of the text*/
+        int32_t line_cnt = 0;
+        uint32_t line_start = 0;
+        while(txt[line_start] != '\0') {
+            line_start += _lv_text_get_next_line(&txt[line_start], font, 2, max_width, NULL, LV_TEXT_FLAG_NONE);
+            line_cnt++;
+        }
+
+        lv_point_t size;
+        lv_text_get_size(&size, txt, font, 2, 0, max_width, LV_TEXT_FLAG_NONE);
+        TEST_ASSERT_EQUAL_INT32(line_cnt * lv_font_get_line_height(font), size.y);
+    }
+}
+
 #endif
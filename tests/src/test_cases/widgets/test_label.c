@@ -589,6 +589,47 @@ void test_label_rtl_dot_long_mode(void)
     TEST_ASSERT_EQUAL_SCREENSHOT("widgets/label_rtl_dot_long_mode.png");
 }
 
+void test_label_rtl_lines_are_reordered_only_when_the_text_changes(void)
+{
+    const char * message =
+        "מעבד, או בשמו המלא יחידת עיבוד מרכזית (באנגלית: CPU - Central Processing Unit).";
+
+    lv_obj_t * screen = lv_obj_create(lv_scr_act());
+    lv_obj_remove_style_all(screen);
+    lv_obj_set_size(screen, 800, 480);
+    lv_obj_center(screen);
+    lv_obj_set_style_bg_color(screen, lv_color_white(), 0);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_100, 0);
+    lv_obj_set_style_pad_all(screen, 0, 0);
+
+    lv_obj_t * test_label = lv_label_create(screen);
+    lv_label_t * rtl_label = (lv_label_t *)test_label;
+    lv_obj_set_style_text_font(test_label, &lv_font_dejavu_16_persian_hebrew, 0);
+    lv_label_set_long_mode(test_label, LV_LABEL_LONG_DOT);
+    lv_obj_set_style_base_dir(test_label, LV_BASE_DIR_RTL, 0);
+    lv_obj_set_size(test_label, 300, lv_font_dejavu_16_persian_hebrew.line_height);
+    lv_label_set_text(test_label, "עיבוד");
+    lv_obj_center(test_label);
+
+    lv_refr_now(NULL);
+    TEST_ASSERT_TRUE(rtl_label->bidi_cache.valid);
+    TEST_ASSERT_NOT_NULL(rtl_label->bidi_cache.txt);
+
+    /*The cache is invalidated by the new text and created again on the next redraw*/
+    lv_label_set_text(test_label, message);
+    TEST_ASSERT_FALSE(rtl_label->bidi_cache.valid);
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("widgets/label_rtl_dot_long_mode.png");
+    TEST_ASSERT_TRUE(rtl_label->bidi_cache.valid);
+
+    /*No copy is stored for texts which are already in visual order*/
+    lv_obj_set_style_base_dir(test_label, LV_BASE_DIR_LTR, 0);
+    lv_label_set_text(test_label, "Central Processing Unit");
+    lv_refr_now(NULL);
+    TEST_ASSERT_TRUE(rtl_label->bidi_cache.valid);
+    TEST_ASSERT_NULL(rtl_label->bidi_cache.txt);
+}
+
 void test_label_max_width(void)
 {
     lv_obj_clean(lv_screen_active());
@@ -609,4 +650,26 @@ void test_label_max_width(void)
     TEST_ASSERT_EQUAL_SCREENSHOT("widgets/label_max_width.png");
 }
 
+void test_label_append_text(void)
+{
+    lv_obj_t * test_label = lv_label_create(lv_screen_active());
+    lv_obj_set_width(test_label, 150);
+    lv_label_set_text(test_label, "First line");
+
+    uint32_t i;
+    for(i = 0; i < 20; i++) {
+        lv_label_append_text(test_label, "\nappended line with some words");
+    }
+    lv_label_ins_text(test_label, 5, " inserted");
+    lv_label_cut_text(test_label, 0, 3);
+
+    lv_obj_t * ref_label = lv_label_create(lv_screen_active());
+    lv_obj_set_width(ref_label, 150);
+    lv_label_set_text(ref_label, lv_label_get_text(test_label));
+
+    lv_obj_update_layout(lv_screen_active());
+    TEST_ASSERT_EQUAL_INT32(lv_obj_get_height(ref_label), lv_obj_get_height(test_label));
+    TEST_ASSERT_EQUAL_STRING_LEN("st inserted line\nappended", lv_label_get_text(test_label), 25);
+}
+
 #endif
@@ -241,6 +241,69 @@ void test_spangroup_draw(void)
     TEST_ASSERT_EQUAL_SCREENSHOT("widgets/span_05.png");
 }
 
+void test_spangroup_layout_is_reused_until_a_span_changes(void)
+{
+    active_screen = lv_screen_active();
+    spangroup = lv_spangroup_create(active_screen);
+    lv_spangroup_set_mode(spangroup, LV_SPAN_MODE_BREAK);
+    lv_obj_set_width(spangroup, 100);
+    lv_span_t * span_1 = lv_spangroup_new_span(spangroup);
+    lv_span_set_text(span_1, "This text is over 100 pixels width");
+    lv_span_t * span_2 = lv_spangroup_new_span(spangroup);
+    lv_span_set_text(span_2, "Short");
+
+    lv_refr_now(NULL);
+    lv_spangroup_t * spans = (lv_spangroup_t *)spangroup;
+    const struct _lv_span_layout_t * layout = spans->layout;
+    TEST_ASSERT_NOT_NULL(layout);
+    int32_t height = lv_obj_get_height(spangroup);
+
+    /*Redrawing shouldn't break the lines again*/
+    lv_obj_invalidate(spangroup);
+    lv_refr_now(NULL);
+    TEST_ASSERT_EQUAL_PTR(layout, spans->layout);
+    TEST_ASSERT_EQUAL_INT32(height, lv_spangroup_get_expand_height(spangroup, lv_obj_get_content_width(spangroup)));
+    TEST_ASSERT_EQUAL_PTR(layout, spans->layout);
+
+    /*Changing the text should break the lines again*/
+    lv_span_set_text(span_2, "This text is also over 100 pixels width");
+    lv_style_set_text_decor(&span_2->style, LV_TEXT_DECOR_STRIKETHROUGH);
+    lv_refr_now(NULL);
+    TEST_ASSERT_NOT_NULL(spans->layout);
+    TEST_ASSERT_NOT_EQUAL(layout, spans->layout);
+    TEST_ASSERT_GREATER_THAN_INT32(height, lv_obj_get_height(spangroup));
+
+    TEST_ASSERT_EQUAL_SCREENSHOT("widgets/span_02.png");
+}
+
+void test_spangroup_layout_follows_the_style_of_the_spans(void)
+{
+    active_screen = lv_screen_active();
+    spangroup = lv_spangroup_create(active_screen);
+    lv_spangroup_set_mode(spangroup, LV_SPAN_MODE_BREAK);
+    lv_obj_set_width(spangroup, 100);
+    lv_span_t * span = lv_spangroup_new_span(spangroup);
+    lv_span_set_text(span, "This text is over 100 pixels width");
+
+    lv_refr_now(NULL);
+    int32_t width = lv_obj_get_content_width(spangroup);
+    int32_t height = lv_spangroup_get_expand_height(spangroup, width);
+
+    /*Querying an other width shouldn't replace the layout of the current width*/
+    int32_t wide_height = lv_spangroup_get_expand_height(spangroup, 1000);
+    TEST_ASSERT_LESS_THAN_INT32(height, wide_height);
+    TEST_ASSERT_EQUAL_INT32(wide_height, lv_spangroup_get_expand_height(spangroup, 1000));
+    TEST_ASSERT_EQUAL_INT32(height, lv_spangroup_get_expand_height(spangroup, width));
+
+    /*Changing the style of a span directly should break the lines again without `lv_spangroup_refr_mode()`*/
+    lv_style_set_text_font(&span->style, &lv_font_montserrat_24);
+    TEST_ASSERT_GREATER_THAN_INT32(height, lv_spangroup_get_expand_height(spangroup, width));
+    height = lv_spangroup_get_expand_height(spangroup, width);
+
+    lv_style_set_text_letter_space(&span->style, 10);
+    TEST_ASSERT_GREATER_THAN_INT32(height, lv_spangroup_get_expand_height(spangroup, width));
+}
+
 void test_spangroup_get_child(void)
 {
     const int32_t span_1_idx = 0;
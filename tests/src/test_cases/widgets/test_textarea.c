@@ -104,4 +104,57 @@ void test_textarea_in_one_line_mode_should_ignore_line_break_characters(void)
     TEST_ASSERT_EQUAL_STRING(textarea_default_text, lv_textarea_get_text(textarea));
 }
 
+void test_textarea_typing_should_match_setting_the_text(void)
+{
+    const char * text = "The quick brown fox jumps over the lazy dog.\nLorem ipsum dolor sit amet, "
+                        "consectetur adipiscing elit, sed do eiusmod tempor.";
+    lv_obj_set_size(textarea, 150, 200);
+
+    /*Type the text and correct some typos on the way*/
+    const char * c;
+    for(c = text; *c; c++) {
+        lv_textarea_add_char(textarea, *c);
+        if(*c == ' ') {
+            lv_textarea_add_text(textarea, "xyz");
+            lv_textarea_delete_char(textarea);
+            lv_textarea_delete_char(textarea);
+            lv_textarea_delete_char(textarea);
+        }
+    }
+    lv_textarea_set_cursor_pos(textarea, 10);
+    lv_textarea_add_text(textarea, "abcdefghijklmnopqrstuvwxyz ");
+    lv_textarea_set_cursor_pos(textarea, 10);
+    uint32_t i;
+    for(i = 0; i < 27; i++) lv_textarea_delete_char_forward(textarea);
+
+    TEST_ASSERT_EQUAL_STRING(text, lv_textarea_get_text(textarea));
+
+    lv_obj_t * ref = lv_textarea_create(active_screen);
+    lv_obj_set_size(ref, 150, 200);
+    lv_textarea_set_text(ref, text);
+
+    lv_obj_update_layout(active_screen);
+
+    lv_obj_t * label = lv_textarea_get_label(textarea);
+    lv_obj_t * ref_label = lv_textarea_get_label(ref);
+    TEST_ASSERT_EQUAL_INT32(lv_obj_get_height(ref_label), lv_obj_get_height(label));
+
+    uint32_t len = lv_strlen(text);
+    for(i = 0; i <= len; i++) {
+        lv_point_t pos;
+        lv_point_t ref_pos;
+        lv_label_get_letter_pos(label, i, &pos);
+        lv_label_get_letter_pos(ref_label, i, &ref_pos);
+        TEST_ASSERT_EQUAL_INT32(ref_pos.x, pos.x);
+        TEST_ASSERT_EQUAL_INT32(ref_pos.y, pos.y);
+    }
+
+    lv_point_t p;
+    for(p.y = 0; p.y < lv_obj_get_height(label) + 20; p.y += 7) {
+        for(p.x = 0; p.x < 150; p.x += 11) {
+            TEST_ASSERT_EQUAL_UINT32(lv_label_get_letter_on(ref_label, &p, false), lv_label_get_letter_on(label, &p, false));
+        }
+    }
+}
+
 #endif